@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <cstring>
 #include <chrono>
+#include <mutex>
 #include <algorithm>
 
 namespace CoopNet
@@ -84,7 +85,7 @@ void AssetStreamer::Stop()
 
 void AssetStreamer::Submit(Task&& t)
 {
-    m_tasks.Push(t);
+    m_tasks.Push(std::move(t));
 }
 
 bool AssetStreamer::Poll(Result& out)
@@ -105,7 +106,9 @@ void AssetStreamer::Worker()
         if (m_tasks.Pop(t))
         {
             bool ok = Process(t);
-            m_results.Push({t.pluginId, ok});
+            // Wait for the tick to make room, unless we are shutting down.
+            while (!m_results.TryPush({t.pluginId, ok}) && m_running)
+                std::this_thread::yield();
         }
         else
         {
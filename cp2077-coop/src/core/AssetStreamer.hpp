@@ -1,5 +1,5 @@
 #pragma once
-#include "ThreadSafeQueue.hpp"
+#include "SpscRing.hpp"
 #include <cstdint>
 #include <vector>
 #include <atomic>
@@ -34,8 +34,8 @@ private:
     void Worker();
     bool Process(const Task& t);
 
-    ThreadSafeQueue<Task> m_tasks;
-    ThreadSafeQueue<Result> m_results;
+    SpscRing<Task, 64> m_tasks;     // tick -> worker
+    SpscRing<Result, 64> m_results; // worker -> tick
     std::jthread m_thread;
     std::atomic<bool> m_running{false};
 };
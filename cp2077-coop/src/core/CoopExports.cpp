@@ -1,6 +1,7 @@
 #include "HttpClient.hpp"
 #include <memory>
 #include "GameProcess.hpp"
+#include "GameClock.hpp"
 #include "../net/Net.hpp" // FIX: expose networking helpers
 #include "../voice/VoiceEncoder.hpp"
 #include "../voice/VoiceDecoder.hpp"
@@ -8,6 +9,7 @@
 #include "../runtime/InventoryController.hpp"
 #include "../runtime/InventoryDatabase.hpp"
 #include "../physics/EnhancedVehiclePhysics.hpp"
+#include "../server/GrenadeController.hpp"
 #include "../quest/EnhancedQuestManager.hpp"
 #include "../save/SaveGameManager.hpp"
 #include "../voice/VoiceManager.hpp"
@@ -163,6 +165,14 @@ static void NetPollFn(RED4ext::IScriptable*, RED4ext::CStackFrame* aFrame, void*
     uint32_t maxMs = 0;
     RED4ext::GetParameter(aFrame, &maxMs);
     aFrame->code++;
+    // Scripts pump the network once per frame; grenades are simulated
+    // locally from their spawn packet, so they advance here too.
+    static uint64_t s_lastPollMs = 0;
+    const uint64_t nowMs = CoopNet::GameClock::GetTimeMs();
+    if (s_lastPollMs != 0)
+        CoopNet::GrenadeController_Tick(static_cast<float>(nowMs - s_lastPollMs));
+    s_lastPollMs = nowMs;
+    Net_FlushReplication();
     Net_Poll(maxMs);
 }
 
@@ -4,6 +4,8 @@
 #include "Logger.hpp"
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <thread>
 
 namespace CoopNet {
 
@@ -49,6 +51,12 @@ bool CoopNetCore::Initialize() {
         auto& systemManager = SystemManager::Instance();
         systemManager.SetEventCallbacks(events);
 
+        // A few workers are enough: the widest level of the system DAG is small
+        // and the game thread helps while it waits.
+        const size_t workers = std::min<size_t>(3, std::max(1u, std::thread::hardware_concurrency()) - 1);
+        m_updateGraph.Start(workers);
+        systemManager.SetTaskGraph(&m_updateGraph);
+
         // Initialize all systems
         if (!systemManager.Initialize(config)) {
             m_lastError = "Failed to initialize system manager";
@@ -95,6 +103,8 @@ void CoopNetCore::Shutdown() {
 
         // Shutdown system manager
         SystemManager::Instance().Shutdown();
+        SystemManager::Instance().SetTaskGraph(nullptr);
+        m_updateGraph.Stop();
 
         m_initialized = false;
         m_systemsReady = false;
@@ -2,6 +2,7 @@
 
 #include <RED4ext/RED4ext.hpp>
 #include "SystemManager.hpp"
+#include "TaskGraph.hpp"
 #include "../net/Connection.hpp"
 #include <memory>
 #include <string>
@@ -86,6 +87,9 @@ private:
 
     mutable std::mutex m_stateMutex;
     std::string m_lastError;
+
+    // Runs independent systems' updates side by side
+    TaskGraph m_updateGraph;
 };
 
 // Global convenience functions for easy access from existing codebase
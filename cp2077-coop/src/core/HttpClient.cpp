@@ -1,10 +1,12 @@
 #include "HttpClient.hpp"
 #include "../../third_party/httplib.h"
-#include "ThreadSafeQueue.hpp"
+#include "MpscRing.hpp"
 #include <string>
 #include <cstdlib>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <mutex>
 
 namespace CoopNet {
 
@@ -145,7 +147,12 @@ HttpResponse Http_Post(const std::string& url, const std::string& body, const st
 }
 
 static std::atomic<uint32_t> g_nextToken{1};
-static ThreadSafeQueue<HttpAsyncResult> g_asyncQueue;
+static MpscRing<HttpAsyncResult, 64> g_asyncQueue; // request threads -> game thread
+// Results that found the ring full (the game thread is not polling, e.g. on
+// a loading screen). Request threads never wait on the poller.
+static std::mutex g_asyncSpillMutex;
+static std::deque<HttpAsyncResult> g_asyncSpill;
+static std::atomic<bool> g_asyncSpilled{false};
 
 uint32_t Http_GetAsync(const std::string& url, int timeoutMs, int retries)
 {
@@ -157,14 +164,30 @@ uint32_t Http_GetAsync(const std::string& url, int timeoutMs, int retries)
             if (r.status != 0)
                 break;
         }
-        g_asyncQueue.Push({id, r});
+        HttpAsyncResult result{id, std::move(r)};
+        if (!g_asyncQueue.TryPush(std::move(result)))
+        {
+            std::lock_guard lock(g_asyncSpillMutex);
+            g_asyncSpill.push_back(std::move(result));
+            g_asyncSpilled.store(true, std::memory_order_release);
+        }
     }).detach();
     return id;
 }
 
 bool Http_PollAsync(HttpAsyncResult& out)
 {
-    return g_asyncQueue.Pop(out);
+    if (g_asyncQueue.TryPop(out))
+        return true;
+    if (!g_asyncSpilled.load(std::memory_order_acquire))
+        return false;
+    std::lock_guard lock(g_asyncSpillMutex);
+    if (g_asyncSpill.empty())
+        return false;
+    out = std::move(g_asyncSpill.front());
+    g_asyncSpill.pop_front();
+    g_asyncSpilled.store(!g_asyncSpill.empty(), std::memory_order_release);
+    return true;
 }
 
 } // namespace CoopNet
@@ -0,0 +1,83 @@
+#pragma once
+
+// Fixed-bucket latency histogram for per-tick timing.
+// Samples are recorded in milliseconds into 0.25 ms buckets covering 0-20 ms
+// plus one overflow bucket; percentiles report the bucket's upper edge.
+// Not synchronized: record and read from the owning (tick) thread.
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace CoopNet
+{
+class LatencyHistogram
+{
+public:
+    static constexpr float kBucketMs = 0.25f;
+    static constexpr uint32_t kBuckets = 80; // 0..20 ms, then overflow
+
+    void Record(float ms)
+    {
+        if (ms < 0.f)
+            ms = -ms;
+        uint32_t idx = static_cast<uint32_t>(ms / kBucketMs);
+        if (idx > kBuckets)
+            idx = kBuckets;
+        ++m_counts[idx];
+        ++m_total;
+        m_sumMs += ms;
+        if (ms > m_maxMs)
+            m_maxMs = ms;
+    }
+
+    void Reset()
+    {
+        m_counts.fill(0);
+        m_total = 0;
+        m_sumMs = 0.0;
+        m_maxMs = 0.f;
+    }
+
+    uint64_t Count() const { return m_total; }
+    float MaxMs() const { return m_maxMs; }
+    float MeanMs() const { return m_total ? static_cast<float>(m_sumMs / m_total) : 0.f; }
+
+    // p in [0,1]. Overflow samples report the observed maximum.
+    float PercentileMs(float p) const
+    {
+        if (m_total == 0)
+            return 0.f;
+        const uint64_t rank = static_cast<uint64_t>(p * static_cast<float>(m_total - 1)) + 1;
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < kBuckets; ++i)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+            {
+                const float edge = (i + 1) * kBucketMs;
+                return edge < m_maxMs ? edge : m_maxMs;
+            }
+        }
+        return m_maxMs;
+    }
+
+    uint64_t BucketCount(uint32_t idx) const { return idx <= kBuckets ? m_counts[idx] : 0; }
+
+    std::string Summary() const
+    {
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "n=%llu mean=%.2fms p50=%.2fms p99=%.2fms p999=%.2fms max=%.2fms",
+                      static_cast<unsigned long long>(m_total), MeanMs(), PercentileMs(0.5f), PercentileMs(0.99f),
+                      PercentileMs(0.999f), m_maxMs);
+        return buf;
+    }
+
+private:
+    std::array<uint64_t, kBuckets + 1> m_counts{};
+    uint64_t m_total = 0;
+    double m_sumMs = 0.0;
+    float m_maxMs = 0.f;
+};
+} // namespace CoopNet
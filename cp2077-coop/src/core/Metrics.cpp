@@ -0,0 +1,315 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace CoopNet
+{
+namespace
+{
+std::atomic<size_t> g_nextShard{0};
+
+uint64_t DoubleBits(double v)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+double BitsDouble(uint64_t bits)
+{
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+void AddDouble(std::atomic<uint64_t>& cell, double delta)
+{
+    uint64_t old = cell.load(std::memory_order_relaxed);
+    while (!cell.compare_exchange_weak(old, DoubleBits(BitsDouble(old) + delta), std::memory_order_relaxed))
+    {
+    }
+}
+
+std::string FormatDouble(double v)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+std::string FormatCount(uint64_t v)
+{
+    return std::to_string(v);
+}
+
+// HELP text escapes backslash and newline; label values are preformatted.
+std::string EscapeHelp(const std::string& s)
+{
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s)
+    {
+        if (c == '\\')
+            out += "\\\\";
+        else if (c == '\n')
+            out += "\\n";
+        else
+            out.push_back(c);
+    }
+    return out;
+}
+
+std::string LabelSet(const std::string& labels, const std::string& extra = {})
+{
+    if (labels.empty() && extra.empty())
+        return {};
+    if (labels.empty())
+        return "{" + extra + "}";
+    if (extra.empty())
+        return "{" + labels + "}";
+    return "{" + labels + "," + extra + "}";
+}
+} // namespace
+
+namespace detail
+{
+size_t MetricShard()
+{
+    thread_local const size_t shard = g_nextShard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+} // namespace detail
+
+uint64_t MetricCounter::Value() const
+{
+    uint64_t sum = 0;
+    for (const Shard& s : m_shards)
+        sum += s.value.load(std::memory_order_relaxed);
+    return sum;
+}
+
+void MetricGauge::Set(double v)
+{
+    m_value.store(v, std::memory_order_relaxed);
+}
+
+void MetricGauge::Add(double delta)
+{
+    double old = m_value.load(std::memory_order_relaxed);
+    while (!m_value.compare_exchange_weak(old, old + delta, std::memory_order_relaxed))
+    {
+    }
+}
+
+double MetricGauge::Value() const
+{
+    return m_value.load(std::memory_order_relaxed);
+}
+
+MetricHistogram::MetricHistogram(std::vector<double> bounds) : m_bounds(std::move(bounds))
+{
+    std::sort(m_bounds.begin(), m_bounds.end());
+    m_bounds.erase(std::unique(m_bounds.begin(), m_bounds.end()), m_bounds.end());
+    // Round each shard up to whole cache lines so shards never share one.
+    constexpr size_t kCellsPerLine = 64 / sizeof(std::atomic<uint64_t>);
+    m_stride = (m_bounds.size() + 2 + kCellsPerLine - 1) / kCellsPerLine * kCellsPerLine;
+    m_cells.reset(new std::atomic<uint64_t>[m_stride * kMetricShards]);
+    for (size_t i = 0; i < m_stride * kMetricShards; ++i)
+        m_cells[i].store(0, std::memory_order_relaxed);
+}
+
+void MetricHistogram::Observe(double v)
+{
+    const size_t bucket =
+        static_cast<size_t>(std::lower_bound(m_bounds.begin(), m_bounds.end(), v) - m_bounds.begin());
+    std::atomic<uint64_t>* shard = &m_cells[detail::MetricShard() * m_stride];
+    shard[bucket].fetch_add(1, std::memory_order_relaxed);
+    AddDouble(shard[m_bounds.size() + 1], v);
+}
+
+MetricHistogram::Snapshot MetricHistogram::Read() const
+{
+    Snapshot snap;
+    snap.cumulative.assign(m_bounds.size() + 1, 0);
+    for (size_t s = 0; s < kMetricShards; ++s)
+    {
+        const std::atomic<uint64_t>* shard = &m_cells[s * m_stride];
+        for (size_t b = 0; b <= m_bounds.size(); ++b)
+            snap.cumulative[b] += shard[b].load(std::memory_order_relaxed);
+        snap.sum += BitsDouble(shard[m_bounds.size() + 1].load(std::memory_order_relaxed));
+    }
+    for (size_t b = 1; b < snap.cumulative.size(); ++b)
+        snap.cumulative[b] += snap.cumulative[b - 1];
+    // Counted from the buckets so count always equals the +Inf bucket.
+    snap.count = snap.cumulative.back();
+    return snap;
+}
+
+MetricsRegistry::Series& MetricsRegistry::FindOrAdd(const std::string& name, const std::string& help, Type type,
+                                                    const std::string& labels)
+{
+    Family* family = nullptr;
+    for (auto& f : m_families)
+    {
+        if (f->name == name)
+        {
+            family = f.get();
+            break;
+        }
+    }
+    if (!family)
+    {
+        m_families.push_back(std::make_unique<Family>(Family{name, help, type, {}}));
+        family = m_families.back().get();
+    }
+    else if (family->type != type)
+    {
+        // Keep the exposition valid: a name has one type. The stray series
+        // still works, it is just never rendered.
+        std::cerr << "[Metrics] " << name << " registered again with another type" << std::endl;
+        m_orphans.push_back(std::make_unique<Series>());
+        m_orphans.back()->labels = labels;
+        return *m_orphans.back();
+    }
+    for (auto& s : family->series)
+        if (s->labels == labels)
+            return *s;
+    family->series.push_back(std::make_unique<Series>());
+    family->series.back()->labels = labels;
+    return *family->series.back();
+}
+
+MetricCounter& MetricsRegistry::Counter(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard lock(m_mutex);
+    Series& s = FindOrAdd(name, help, Type::Counter, labels);
+    if (!s.counter)
+        s.counter = std::make_unique<MetricCounter>();
+    return *s.counter;
+}
+
+MetricGauge& MetricsRegistry::Gauge(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard lock(m_mutex);
+    Series& s = FindOrAdd(name, help, Type::Gauge, labels);
+    if (!s.gauge)
+        s.gauge = std::make_unique<MetricGauge>();
+    return *s.gauge;
+}
+
+MetricHistogram& MetricsRegistry::Histogram(const std::string& name, const std::string& help,
+                                            std::vector<double> bounds, const std::string& labels)
+{
+    std::lock_guard lock(m_mutex);
+    Series& s = FindOrAdd(name, help, Type::Histogram, labels);
+    if (!s.histogram)
+        s.histogram = std::make_unique<MetricHistogram>(std::move(bounds));
+    return *s.histogram;
+}
+
+void MetricsRegistry::GaugeFn(const std::string& name, const std::string& help, std::function<double()> fn,
+                              const std::string& labels)
+{
+    std::lock_guard lock(m_mutex);
+    FindOrAdd(name, help, Type::Gauge, labels).gaugeFn = std::move(fn);
+}
+
+void MetricsRegistry::CounterFn(const std::string& name, const std::string& help, std::function<uint64_t()> fn,
+                                const std::string& labels)
+{
+    std::lock_guard lock(m_mutex);
+    FindOrAdd(name, help, Type::Counter, labels).counterFn = std::move(fn);
+}
+
+std::string MetricsRegistry::Render(bool openMetrics) const
+{
+    // Copy what to render under the lock, then read values and run the
+    // callbacks without it: a callback may take locks of its own (Net takes
+    // g_NetMutex) that are held elsewhere while a metric is registered.
+    struct Item
+    {
+        const Family* family;
+        const Series* series;
+        const MetricCounter* counter;
+        const MetricGauge* gauge;
+        const MetricHistogram* histogram;
+        std::function<double()> gaugeFn;
+        std::function<uint64_t()> counterFn;
+    };
+    std::vector<Item> items;
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto& f : m_families)
+        {
+            for (const auto& series : f->series)
+                items.push_back({f.get(), series.get(), series->counter.get(), series->gauge.get(),
+                                 series->histogram.get(), series->gaugeFn, series->counterFn});
+        }
+    }
+
+    std::string out;
+    const Family* current = nullptr;
+    for (const Item& it : items)
+    {
+        const Family& f = *it.family;
+        const std::string& labels = it.series->labels;
+        if (&f != current)
+        {
+            current = &f;
+            const char* type = f.type == Type::Counter ? "counter" : f.type == Type::Gauge ? "gauge" : "histogram";
+            // OpenMetrics names the counter family without _total; the
+            // classic text format expects the sample name itself.
+            const std::string family = f.type == Type::Counter && !openMetrics ? f.name + "_total" : f.name;
+            out += "# HELP " + family + " " + EscapeHelp(f.help) + "\n";
+            out += "# TYPE " + family + " " + type + "\n";
+        }
+        switch (f.type)
+        {
+        case Type::Counter:
+        {
+            uint64_t v = it.counter ? it.counter->Value() : 0;
+            if (it.counterFn)
+                v += it.counterFn();
+            out += f.name + "_total" + LabelSet(labels) + " " + FormatCount(v) + "\n";
+            break;
+        }
+        case Type::Gauge:
+        {
+            const double v = it.gaugeFn ? it.gaugeFn() : it.gauge ? it.gauge->Value() : 0.0;
+            out += f.name + LabelSet(labels) + " " + FormatDouble(v) + "\n";
+            break;
+        }
+        case Type::Histogram:
+        {
+            if (!it.histogram)
+                break;
+            const MetricHistogram::Snapshot snap = it.histogram->Read();
+            const auto& bounds = it.histogram->GetBounds();
+            for (size_t b = 0; b < bounds.size(); ++b)
+                out += f.name + "_bucket" + LabelSet(labels, "le=\"" + FormatDouble(bounds[b]) + "\"") + " " +
+                       FormatCount(snap.cumulative[b]) + "\n";
+            out += f.name + "_bucket" + LabelSet(labels, "le=\"+Inf\"") + " " + FormatCount(snap.count) + "\n";
+            out += f.name + "_sum" + LabelSet(labels) + " " + FormatDouble(snap.sum) + "\n";
+            out += f.name + "_count" + LabelSet(labels) + " " + FormatCount(snap.count) + "\n";
+            break;
+        }
+        }
+    }
+    if (openMetrics)
+        out += "# EOF\n";
+    return out;
+}
+
+MetricsRegistry& GetMetrics()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+std::vector<double> MetricTimeBuckets()
+{
+    return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.015, 0.02, 0.025, 0.033, 0.05, 0.1, 0.25, 0.5, 1.0};
+}
+} // namespace CoopNet
@@ -0,0 +1,143 @@
+#pragma once
+
+// Process-wide registry of counters, gauges and histograms.
+// Counters and histograms are sharded: each thread updates its own
+// cache-line-sized slot with one relaxed atomic add, so hot paths can count
+// without contending, and the shards are only summed when the registry is
+// rendered. Gauges hold a single value; values that already live elsewhere
+// can be sampled at render time through a callback instead.
+//
+// Registration takes a lock and returns a reference that stays valid for
+// the life of the process; cache it (a function-local static is enough) and
+// update through it. Asking again for the same name and labels returns the
+// same metric.
+//
+// Render() produces the Prometheus text exposition format, or OpenMetrics
+// 1.0 text when asked; InfoServer serves it on /metrics. Names follow the
+// Prometheus conventions: base units (seconds, bytes), and counters are
+// registered without the _total suffix, which is added on output. Labels
+// are passed preformatted, e.g. kind="voice".
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CoopNet
+{
+constexpr size_t kMetricShards = 16;
+
+namespace detail
+{
+// Shard for the calling thread; threads are spread round-robin.
+size_t MetricShard();
+} // namespace detail
+
+class MetricCounter
+{
+public:
+    void Add(uint64_t n = 1)
+    {
+        m_shards[detail::MetricShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t Value() const;
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+    Shard m_shards[kMetricShards];
+};
+
+class MetricGauge
+{
+public:
+    void Set(double v);
+    void Add(double delta);
+    double Value() const;
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+class MetricHistogram
+{
+public:
+    // `bounds` are the inclusive upper edges of the buckets, ascending; an
+    // implicit +Inf bucket follows the last.
+    explicit MetricHistogram(std::vector<double> bounds);
+
+    void Observe(double v);
+
+    struct Snapshot
+    {
+        std::vector<uint64_t> cumulative; // one per bound, then +Inf
+        uint64_t count = 0;
+        double sum = 0.0;
+    };
+    Snapshot Read() const;
+    const std::vector<double>& GetBounds() const { return m_bounds; }
+
+private:
+    std::vector<double> m_bounds;
+    size_t m_stride; // cells per shard: bucket counts, +Inf, then the sum's bits
+    std::unique_ptr<std::atomic<uint64_t>[]> m_cells;
+};
+
+class MetricsRegistry
+{
+public:
+    MetricCounter& Counter(const std::string& name, const std::string& help, const std::string& labels = {});
+    MetricGauge& Gauge(const std::string& name, const std::string& help, const std::string& labels = {});
+    MetricHistogram& Histogram(const std::string& name, const std::string& help, std::vector<double> bounds,
+                               const std::string& labels = {});
+    // Sampled on every Render, on the rendering thread and without the
+    // registry lock held. Registering the same series again replaces `fn`.
+    void GaugeFn(const std::string& name, const std::string& help, std::function<double()> fn,
+                 const std::string& labels = {});
+    void CounterFn(const std::string& name, const std::string& help, std::function<uint64_t()> fn,
+                   const std::string& labels = {});
+
+    std::string Render(bool openMetrics = false) const;
+
+private:
+    enum class Type
+    {
+        Counter,
+        Gauge,
+        Histogram,
+    };
+    struct Series
+    {
+        std::string labels;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+        std::function<double()> gaugeFn;
+        std::function<uint64_t()> counterFn;
+    };
+    struct Family
+    {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    Series& FindOrAdd(const std::string& name, const std::string& help, Type type, const std::string& labels);
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Family>> m_families; // in registration order
+    std::vector<std::unique_ptr<Series>> m_orphans;  // re-registered with a different type, never rendered
+};
+
+MetricsRegistry& GetMetrics();
+
+// Default buckets for durations in seconds, 0.5 ms to 1 s.
+std::vector<double> MetricTimeBuckets();
+} // namespace CoopNet
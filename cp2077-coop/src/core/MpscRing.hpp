@@ -0,0 +1,163 @@
+#pragma once
+
+// Bounded multi-producer/single-consumer ring (Vyukov's sequenced cells).
+// Any number of threads may push; one thread pops. Producers claim a cell by
+// advancing the tail with a CAS and publish it through the cell's sequence
+// number, so they never wait on each other's copies and the consumer takes no
+// lock. Capacity must be a power of two. Same interface as SpscRing.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CoopNet
+{
+template<typename T, size_t Capacity>
+class MpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MpscRing capacity must be a power of two");
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kLine = 64;
+
+    struct Cell
+    {
+        // pos: free for the producer claiming `pos`; pos + 1: holds that
+        // producer's item; pos + Capacity: free again for the next lap.
+        std::atomic<size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* Item()
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+public:
+    MpscRing()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    ~MpscRing()
+    {
+        T item;
+        while (TryPop(item))
+        {
+        }
+    }
+
+    // Any thread. Returns false when the ring is full; `item` is untouched.
+    bool TryPush(T&& item)
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &m_cells[pos & kMask];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // the consumer has not freed this cell yet
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(std::move(item));
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& item)
+    {
+        T copy(item);
+        return TryPush(std::move(copy));
+    }
+
+    // Any thread except the consumer. Yields while the ring is full.
+    void Push(T item)
+    {
+        while (!TryPush(std::move(item)))
+            std::this_thread::yield();
+    }
+
+    // Consumer side. Stops at the first cell still being written, so items
+    // come out in claim order.
+    bool TryPop(T& out)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[head & kMask];
+        if (cell.seq.load(std::memory_order_acquire) != head + 1)
+            return false;
+        T* item = cell.Item();
+        out = std::move(*item);
+        item->~T();
+        cell.seq.store(head + Capacity, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool Pop(T& out)
+    {
+        return TryPop(out);
+    }
+
+    // Consumer side. Moves every published item onto the end of `out`.
+    size_t DrainTo(std::vector<T>& out)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t start = head;
+        for (;;)
+        {
+            Cell& cell = m_cells[head & kMask];
+            if (cell.seq.load(std::memory_order_acquire) != head + 1)
+                break;
+            T* item = cell.Item();
+            out.push_back(std::move(*item));
+            item->~T();
+            cell.seq.store(head + Capacity, std::memory_order_release);
+            ++head;
+        }
+        m_head.store(head, std::memory_order_relaxed);
+        return head - start;
+    }
+
+    // Approximate: counts claimed cells, including ones still being written.
+    size_t Size() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool Empty() const
+    {
+        return Size() == 0;
+    }
+
+    static constexpr size_t GetCapacity()
+    {
+        return Capacity;
+    }
+
+private:
+    alignas(kLine) std::atomic<size_t> m_head{0}; // consumer-owned; atomic for Size()
+    alignas(kLine) std::atomic<size_t> m_tail{0};
+    alignas(kLine) Cell m_cells[Capacity];
+};
+} // namespace CoopNet
@@ -1,112 +1,287 @@
 #include "SpatialGrid.hpp"
-#include <cmath>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace CoopNet
 {
-namespace
+SpatialGrid::SpatialGrid(float cellSize)
+    : m_cellSize(cellSize > 0.f ? cellSize : kDefaultCellSize)
+    , m_invCellSize(1.f / m_cellSize)
 {
-inline bool CircleIntersects(const RED4ext::Vector3& c, float r, const RED4ext::Vector3& min, const RED4ext::Vector3& max)
-{
-    float x = std::clamp(c.X, min.X, max.X);
-    float y = std::clamp(c.Y, min.Y, max.Y);
-    float dx = c.X - x;
-    float dy = c.Y - y;
-    return dx * dx + dy * dy <= r * r;
-}
 }
 
-SpatialGrid::SpatialGrid()
+int32_t SpatialGrid::CellCoord(float v) const
 {
-    m_root = std::make_unique<QuadNode>();
-    m_root->min = {-512.f, -512.f, -100.f};
-    m_root->max = {512.f, 512.f, 100.f};
+    // Clamp before converting so NaN/huge coordinates cannot overflow.
+    const float c = std::floor(v * m_invCellSize);
+    constexpr float kLimit = static_cast<float>(1 << 30);
+    if (!(c > -kLimit))
+        return -(1 << 30);
+    if (!(c < kLimit))
+        return 1 << 30;
+    return static_cast<int32_t>(c);
 }
 
-void SpatialGrid::Insert(uint32_t id, const RED4ext::Vector3& pos)
+uint64_t SpatialGrid::CellKey(int32_t cx, int32_t cy)
 {
-    InsertRec(m_root.get(), id, pos, 0);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
 }
 
-void SpatialGrid::Move(uint32_t id, const RED4ext::Vector3& oldPos, const RED4ext::Vector3& newPos)
+uint32_t SpatialGrid::CellFor(int32_t cx, int32_t cy)
 {
-    Remove(id, oldPos);
-    Insert(id, newPos);
+    auto [it, inserted] = m_cellIndex.try_emplace(CellKey(cx, cy), 0u);
+    if (!inserted)
+        return it->second;
+    uint32_t idx;
+    if (!m_freeCells.empty())
+    {
+        idx = m_freeCells.back();
+        m_freeCells.pop_back();
+    }
+    else
+    {
+        idx = static_cast<uint32_t>(m_cells.size());
+        m_cells.emplace_back();
+    }
+    m_cells[idx].cx = cx;
+    m_cells[idx].cy = cy;
+    it->second = idx;
+    return idx;
 }
 
-void SpatialGrid::Remove(uint32_t id, const RED4ext::Vector3& pos)
+// Swap-remove from the cell, patching the back-map of the entry that moved
+// into the hole. An emptied cell goes back to the free list (its vector keeps
+// its capacity for the next occupant).
+void SpatialGrid::Unlink(const Loc& loc)
 {
-    RemoveRec(m_root.get(), id, pos);
+    Cell& cell = m_cells[loc.cell];
+    if (loc.slot + 1 != cell.entries.size())
+    {
+        cell.entries[loc.slot] = cell.entries.back();
+        m_locs[cell.entries[loc.slot].id].slot = loc.slot;
+    }
+    cell.entries.pop_back();
+    if (cell.entries.empty())
+    {
+        m_cellIndex.erase(CellKey(cell.cx, cell.cy));
+        m_freeCells.push_back(loc.cell);
+    }
 }
 
-void SpatialGrid::QueryCircle(const RED4ext::Vector3& center, float radius, std::vector<uint32_t>& outIds) const
+void SpatialGrid::Insert(uint32_t id, const RED4ext::Vector3& pos)
 {
-    outIds.clear();
-    QueryRec(m_root.get(), center, radius, outIds);
+    Move(id, pos);
 }
 
-void SpatialGrid::InsertRec(QuadNode* node, uint32_t id, const RED4ext::Vector3& pos, uint32_t depth)
+void SpatialGrid::Move(uint32_t id, const RED4ext::Vector3& pos)
 {
-    if (depth >= 6 || (node->child[0] == nullptr && node->ids.size() < kNodeCapacity))
+    const int32_t cx = CellCoord(pos.X);
+    const int32_t cy = CellCoord(pos.Y);
+    auto it = m_locs.find(id);
+    if (it != m_locs.end())
     {
-        node->ids.push_back(id);
-        return;
-    }
-    if (node->child[0] == nullptr)
-        Subdivide(node, depth);
-    for (int i = 0; i < 4; ++i)
-    {
-        auto& c = node->child[i];
-        if (pos.X >= c->min.X && pos.X <= c->max.X && pos.Y >= c->min.Y && pos.Y <= c->max.Y)
+        Cell& cur = m_cells[it->second.cell];
+        if (cur.cx == cx && cur.cy == cy)
         {
-            InsertRec(c.get(), id, pos, depth + 1);
+            cur.entries[it->second.slot] = {id, pos.X, pos.Y}; // same cell: update in place
             return;
         }
+        const Loc old = it->second;
+        m_locs.erase(it);
+        Unlink(old);
     }
-    node->ids.push_back(id);
+    const uint32_t cell = CellFor(cx, cy);
+    m_locs[id] = {cell, static_cast<uint32_t>(m_cells[cell].entries.size())};
+    m_cells[cell].entries.push_back({id, pos.X, pos.Y});
 }
 
-bool SpatialGrid::RemoveRec(QuadNode* node, uint32_t id, const RED4ext::Vector3& pos)
+void SpatialGrid::Remove(uint32_t id)
 {
-    auto it = std::find(node->ids.begin(), node->ids.end(), id);
-    if (it != node->ids.end())
-    {
-        node->ids.erase(it);
-        return true;
-    }
-    for (int i = 0; i < 4; ++i)
+    auto it = m_locs.find(id);
+    if (it == m_locs.end())
+        return;
+    const Loc old = it->second;
+    m_locs.erase(it);
+    Unlink(old);
+}
+
+void SpatialGrid::Clear()
+{
+    m_cells.clear();
+    m_freeCells.clear();
+    m_cellIndex.clear();
+    m_locs.clear();
+}
+
+bool SpatialGrid::Contains(uint32_t id) const
+{
+    return m_locs.count(id) != 0;
+}
+
+bool SpatialGrid::Locate(uint32_t id, CellId& out) const
+{
+    auto it = m_locs.find(id);
+    if (it == m_locs.end())
+        return false;
+    const Cell& cell = m_cells[it->second.cell];
+    out = {cell.cx, cell.cy};
+    return true;
+}
+
+bool SpatialGrid::GetPosition(uint32_t id, RED4ext::Vector3& out) const
+{
+    auto it = m_locs.find(id);
+    if (it == m_locs.end())
+        return false;
+    const Entry& e = m_cells[it->second.cell].entries[it->second.slot];
+    out = RED4ext::Vector3(e.x, e.y, 0.f);
+    return true;
+}
+
+void SpatialGrid::QueryCircle(const RED4ext::Vector3& center, float radius, std::vector<uint32_t>& outIds) const
+{
+    std::vector<uint32_t> offsets;
+    QueryCircles(&center, 1, radius, outIds, offsets);
+}
+
+void SpatialGrid::QueryAABB(const RED4ext::Vector3& min, const RED4ext::Vector3& max,
+                            std::vector<uint32_t>& outIds) const
+{
+    std::vector<uint32_t> offsets;
+    QueryAABBs(&min, &max, 1, outIds, offsets);
+}
+
+void SpatialGrid::QueryCircles(const RED4ext::Vector3* centers, size_t count, float radius,
+                               std::vector<uint32_t>& outIds, std::vector<uint32_t>& outOffsets) const
+{
+    std::vector<CellRange> ranges(count);
+    for (size_t i = 0; i < count; ++i)
     {
-        auto& c = node->child[i];
-        if (c && pos.X >= c->min.X && pos.X <= c->max.X && pos.Y >= c->min.Y && pos.Y <= c->max.Y)
-        {
-            if (RemoveRec(c.get(), id, pos))
-                return true;
-        }
+        const RED4ext::Vector3& c = centers[i];
+        ranges[i] = {CellCoord(c.X - radius), CellCoord(c.Y - radius), CellCoord(c.X + radius),
+                     CellCoord(c.Y + radius)};
     }
-    return false;
+    const float r2 = radius * radius;
+    QueryBatch(
+        ranges.data(), count,
+        [&](size_t q, const Entry& e) {
+            const float dx = e.x - centers[q].X;
+            const float dy = e.y - centers[q].Y;
+            return dx * dx + dy * dy <= r2;
+        },
+        outIds, outOffsets);
 }
 
-void SpatialGrid::QueryRec(const QuadNode* node, const RED4ext::Vector3& center, float radius, std::vector<uint32_t>& outIds) const
+void SpatialGrid::QueryAABBs(const RED4ext::Vector3* mins, const RED4ext::Vector3* maxs, size_t count,
+                             std::vector<uint32_t>& outIds, std::vector<uint32_t>& outOffsets) const
 {
-    if (!CircleIntersects(center, radius, node->min, node->max))
-        return;
-    outIds.insert(outIds.end(), node->ids.begin(), node->ids.end());
-    for (int i = 0; i < 4; ++i)
-        if (node->child[i])
-            QueryRec(node->child[i].get(), center, radius, outIds);
+    std::vector<CellRange> ranges(count);
+    for (size_t i = 0; i < count; ++i)
+        ranges[i] = {CellCoord(mins[i].X), CellCoord(mins[i].Y), CellCoord(maxs[i].X), CellCoord(maxs[i].Y)};
+    QueryBatch(
+        ranges.data(), count,
+        [&](size_t q, const Entry& e) {
+            return e.x >= mins[q].X && e.x <= maxs[q].X && e.y >= mins[q].Y && e.y <= maxs[q].Y;
+        },
+        outIds, outOffsets);
 }
 
-void SpatialGrid::Subdivide(QuadNode* node, uint32_t depth)
+// Pairs every query with the occupied cells its range covers, sorts the pairs
+// by cell so each cell's entries are read once for all queries touching it,
+// then counting-sorts the hits back into per-query runs.
+template <typename Test>
+void SpatialGrid::QueryBatch(const CellRange* ranges, size_t count, Test&& test, std::vector<uint32_t>& outIds,
+                             std::vector<uint32_t>& outOffsets) const
 {
-    RED4ext::Vector3 half{(node->max.X - node->min.X) * 0.5f, (node->max.Y - node->min.Y) * 0.5f, (node->max.Z - node->min.Z)};
-    for (int i = 0; i < 4; ++i)
+    struct Visit
+    {
+        uint32_t cell;
+        uint32_t query;
+    };
+    struct Hit
     {
-        node->child[i] = std::make_unique<QuadNode>();
-        float offX = (i % 2) ? half.X : 0.f;
-        float offY = (i < 2) ? 0.f : half.Y;
-        node->child[i]->min = {node->min.X + offX, node->min.Y + offY, node->min.Z};
-        node->child[i]->max = {node->child[i]->min.X + half.X, node->child[i]->min.Y + half.Y, node->max.Z};
+        uint32_t query;
+        uint32_t id;
+    };
+    thread_local std::vector<Visit> visits;
+    thread_local std::vector<Hit> hits;
+    visits.clear();
+    hits.clear();
+
+    size_t prevBegin = 0, prevEnd = 0;
+    for (size_t q = 0; q < count; ++q)
+    {
+        const CellRange& r = ranges[q];
+        if (r.x1 < r.x0 || r.y1 < r.y0)
+            continue;
+        const size_t begin = visits.size();
+        if (q > 0 && std::memcmp(&r, &ranges[q - 1], sizeof(CellRange)) == 0)
+        {
+            // Same cells as the previous query (e.g. squad mates): reuse its lookups.
+            for (size_t v = prevBegin; v < prevEnd; ++v)
+                visits.push_back({visits[v].cell, static_cast<uint32_t>(q)});
+            prevBegin = begin;
+            prevEnd = visits.size();
+            continue;
+        }
+        const uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(r.x1) - r.x0 + 1) *
+                              static_cast<uint64_t>(static_cast<int64_t>(r.y1) - r.y0 + 1);
+        if (span > m_cellIndex.size())
+        {
+            // Query wider than the populated world: walk occupied cells instead.
+            for (const auto& [key, idx] : m_cellIndex)
+            {
+                const Cell& c = m_cells[idx];
+                if (c.cx >= r.x0 && c.cx <= r.x1 && c.cy >= r.y0 && c.cy <= r.y1)
+                    visits.push_back({idx, static_cast<uint32_t>(q)});
+            }
+        }
+        else
+        {
+            for (int32_t cy = r.y0; cy <= r.y1; ++cy)
+            {
+                for (int32_t cx = r.x0; cx <= r.x1; ++cx)
+                {
+                    auto it = m_cellIndex.find(CellKey(cx, cy));
+                    if (it != m_cellIndex.end())
+                        visits.push_back({it->second, static_cast<uint32_t>(q)});
+                }
+            }
+        }
+        prevBegin = begin;
+        prevEnd = visits.size();
     }
+
+    if (count > 1)
+        std::sort(visits.begin(), visits.end(), [](const Visit& a, const Visit& b) { return a.cell < b.cell; });
+
+    for (size_t i = 0; i < visits.size();)
+    {
+        size_t end = i + 1;
+        while (end < visits.size() && visits[end].cell == visits[i].cell)
+            ++end;
+        for (const Entry& e : m_cells[visits[i].cell].entries)
+        {
+            for (size_t v = i; v < end; ++v)
+            {
+                if (test(visits[v].query, e))
+                    hits.push_back({visits[v].query, e.id});
+            }
+        }
+        i = end;
+    }
+
+    outOffsets.assign(count + 1, 0);
+    for (const Hit& h : hits)
+        ++outOffsets[h.query + 1];
+    for (size_t q = 0; q < count; ++q)
+        outOffsets[q + 1] += outOffsets[q];
+    outIds.resize(hits.size());
+    thread_local std::vector<uint32_t> cursor;
+    cursor.assign(outOffsets.begin(), outOffsets.end() - 1);
+    for (const Hit& h : hits)
+        outIds[cursor[h.query]++] = h.id;
 }
 
 } // namespace CoopNet
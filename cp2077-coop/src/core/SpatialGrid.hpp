@@ -1,49 +1,105 @@
 #pragma once
+
+// Unbounded spatial index for interest queries.
+// A uniform grid over X/Y hashed by cell coordinate, so there are no world
+// bounds: entities anywhere in Night City land in their own cell instead of
+// piling into an overflow node. Cells live in one contiguous pool (empty ones
+// are recycled) and every entity keeps an id -> (cell, slot) back-map, making
+// Move and Remove O(1). Entries store their position so queries return exact
+// results rather than every id in an overlapping node.
+
 #include <RED4ext/Scripting/Natives/Vector3.hpp>
+#include <cmath>
 #include <cstdint>
-#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace CoopNet
 {
-struct QuadNode
-{
-    RED4ext::Vector3 min{};
-    RED4ext::Vector3 max{};
-    std::vector<uint32_t> ids;
-    std::unique_ptr<QuadNode> child[4];
-};
-
 class SpatialGrid
 {
 public:
-    static constexpr uint32_t kNodeCapacity = 32;
-    SpatialGrid();
-    void Insert(uint32_t id, const RED4ext::Vector3& pos);
-    void Move(uint32_t id, const RED4ext::Vector3& oldPos, const RED4ext::Vector3& newPos);
-    void Remove(uint32_t id, const RED4ext::Vector3& pos);
-    void QueryCircle(const RED4ext::Vector3& center, float radius, std::vector<uint32_t>& outIds) const;
-    template<typename F>
-    void DepthFirst(F&& fn) const
+    static constexpr float kDefaultCellSize = 32.f; // metres; an 80 m interest query spans ~6x6 cells
+
+    struct CellId
     {
-        VisitRec(m_root.get(), 0, fn);
-    }
+        int32_t x;
+        int32_t y;
+        bool operator==(const CellId& o) const { return x == o.x && y == o.y; }
+        bool operator!=(const CellId& o) const { return !(*this == o); }
+    };
+
+    explicit SpatialGrid(float cellSize = kDefaultCellSize);
+
+    void Insert(uint32_t id, const RED4ext::Vector3& pos); // moves the entity if already present
+    void Move(uint32_t id, const RED4ext::Vector3& pos);
+    void Remove(uint32_t id);
+    void Clear();
+    bool Contains(uint32_t id) const;
+    size_t GetSize() const { return m_locs.size(); }
+    size_t GetCellCount() const { return m_cellIndex.size(); }
+    // Cell an entity is stored in; false if unknown.
+    bool Locate(uint32_t id, CellId& out) const;
+    // Stored X/Y of an entity (Z is 0); false if unknown.
+    bool GetPosition(uint32_t id, RED4ext::Vector3& out) const;
+    CellId CellOf(const RED4ext::Vector3& pos) const { return {CellCoord(pos.X), CellCoord(pos.Y)}; }
+    // Cells either side of a point's cell that a query of `radius` can touch.
+    int32_t CellReach(float radius) const { return static_cast<int32_t>(std::ceil(radius * m_invCellSize)); }
+
+    // Ids within `radius` of `center` (X/Y only). Clears `outIds`.
+    void QueryCircle(const RED4ext::Vector3& center, float radius, std::vector<uint32_t>& outIds) const;
+    // Ids inside [min, max] on X/Y. Clears `outIds`.
+    void QueryAABB(const RED4ext::Vector3& min, const RED4ext::Vector3& max, std::vector<uint32_t>& outIds) const;
+
+    // Batched queries: results for query i are outIds[outOffsets[i] ..
+    // outOffsets[i + 1]). Each occupied cell is scanned once for all queries
+    // touching it, and consecutive queries over the same cells share lookups,
+    // so pass viewers grouped by area where possible.
+    void QueryCircles(const RED4ext::Vector3* centers, size_t count, float radius, std::vector<uint32_t>& outIds,
+                      std::vector<uint32_t>& outOffsets) const;
+    void QueryAABBs(const RED4ext::Vector3* mins, const RED4ext::Vector3* maxs, size_t count,
+                    std::vector<uint32_t>& outIds, std::vector<uint32_t>& outOffsets) const;
 
 private:
-    void InsertRec(QuadNode* node, uint32_t id, const RED4ext::Vector3& pos, uint32_t depth);
-    bool RemoveRec(QuadNode* node, uint32_t id, const RED4ext::Vector3& pos);
-    void QueryRec(const QuadNode* node, const RED4ext::Vector3& center, float radius, std::vector<uint32_t>& outIds) const;
-    void Subdivide(QuadNode* node, uint32_t depth);
-    template<typename F>
-    void VisitRec(const QuadNode* node, uint32_t depth, F& fn) const
+    struct Entry
+    {
+        uint32_t id;
+        float x;
+        float y;
+    };
+
+    struct Cell
+    {
+        int32_t cx = 0;
+        int32_t cy = 0;
+        std::vector<Entry> entries;
+    };
+
+    struct Loc
     {
-        if (!node)
-            return;
-        fn(*node, depth);
-        for (int i = 0; i < 4; ++i)
-            VisitRec(node->child[i].get(), depth + 1, fn);
-    }
-
-    std::unique_ptr<QuadNode> m_root;
+        uint32_t cell;
+        uint32_t slot;
+    };
+
+    struct CellRange
+    {
+        int32_t x0, y0, x1, y1;
+    };
+
+    int32_t CellCoord(float v) const;
+    static uint64_t CellKey(int32_t cx, int32_t cy);
+    uint32_t CellFor(int32_t cx, int32_t cy);
+    void Unlink(const Loc& loc);
+
+    template <typename Test>
+    void QueryBatch(const CellRange* ranges, size_t count, Test&& test, std::vector<uint32_t>& outIds,
+                    std::vector<uint32_t>& outOffsets) const;
+
+    float m_cellSize;
+    float m_invCellSize;
+    std::vector<Cell> m_cells;
+    std::vector<uint32_t> m_freeCells;
+    std::unordered_map<uint64_t, uint32_t> m_cellIndex; // CellKey -> m_cells index
+    std::unordered_map<uint32_t, Loc> m_locs;           // id -> where it is stored
 };
 } // namespace CoopNet
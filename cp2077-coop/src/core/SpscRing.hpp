@@ -0,0 +1,150 @@
+#pragma once
+
+// Bounded single-producer/single-consumer ring.
+// One thread may push and one (possibly different) thread may pop; only Push
+// waits, and only while the ring is full. Capacity must be a power of two.
+// Head and tail live on separate cache lines and each side caches the other's
+// index so the common path touches only its own line. Push/Pop/Empty/Size
+// mirror ThreadSafeQueue so a queue with one producer can switch over.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CoopNet
+{
+template<typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kLine = 64;
+
+public:
+    SpscRing() = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing()
+    {
+        T item;
+        while (TryPop(item))
+        {
+        }
+    }
+
+    // Producer side. Returns false when the ring is full; `item` is untouched.
+    bool TryPush(T&& item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache >= Capacity)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache >= Capacity)
+                return false;
+        }
+        new (Slot(tail)) T(std::move(item));
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& item)
+    {
+        T copy(item);
+        return TryPush(std::move(copy));
+    }
+
+    // Producer side. Yields while the ring is full; never call it from the
+    // consumer thread.
+    void Push(T item)
+    {
+        while (!TryPush(std::move(item)))
+            std::this_thread::yield();
+    }
+
+    // Consumer side. Moves the oldest element into `out`.
+    bool TryPop(T& out)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+                return false;
+        }
+        T* slot = Slot(head);
+        out = std::move(*slot);
+        slot->~T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& out)
+    {
+        return TryPop(out);
+    }
+
+    // Consumer side. Moves everything currently queued onto the end of `out`
+    // and publishes the freed space once. Returns the number moved.
+    size_t DrainTo(std::vector<T>& out)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        m_tailCache = m_tail.load(std::memory_order_acquire);
+        const size_t count = m_tailCache - head;
+        out.reserve(out.size() + count);
+        for (size_t i = head; i != m_tailCache; ++i)
+        {
+            T* slot = Slot(i);
+            out.push_back(std::move(*slot));
+            slot->~T();
+        }
+        m_head.store(m_tailCache, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate from either side; exact when called by a quiescent owner.
+    size_t SizeApprox() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool EmptyApprox() const
+    {
+        return SizeApprox() == 0;
+    }
+
+    size_t Size() const
+    {
+        return SizeApprox();
+    }
+
+    bool Empty() const
+    {
+        return EmptyApprox();
+    }
+
+    static constexpr size_t GetCapacity()
+    {
+        return Capacity;
+    }
+
+private:
+    T* Slot(size_t index)
+    {
+        return std::launder(reinterpret_cast<T*>(&m_storage[(index & kMask) * sizeof(T)]));
+    }
+
+    alignas(kLine) std::atomic<size_t> m_head{0};
+    size_t m_tailCache = 0; // consumer-owned
+    alignas(kLine) std::atomic<size_t> m_tail{0};
+    size_t m_headCache = 0; // producer-owned
+    alignas(kLine) alignas(T) unsigned char m_storage[Capacity * sizeof(T)];
+};
+} // namespace CoopNet
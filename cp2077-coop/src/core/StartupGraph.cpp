@@ -0,0 +1,313 @@
+#include "StartupGraph.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace CoopNet
+{
+namespace
+{
+uint64_t NowNs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+std::string JsonEscape(const std::string& s)
+{
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out.push_back('\\');
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out.push_back(c);
+    }
+    return out;
+}
+} // namespace
+
+StartupGraph::~StartupGraph()
+{
+    // Queued steps point back at us; pinned ones never run without the caller.
+    if (!m_launched)
+        return;
+    for (auto& s : m_steps)
+        if (!s->pinned)
+            WaitUnpinned(*s);
+    std::lock_guard lock(m_mutex); // let the last Run leave its critical section
+}
+
+StartupGraph::StepId StartupGraph::Add(std::string name, std::function<void()> fn,
+                                       std::initializer_list<StepId> deps, Affinity affinity)
+{
+    auto step = std::make_unique<Step>();
+    step->name = std::move(name);
+    step->fn = std::move(fn);
+    step->pinned = affinity == Affinity::Caller;
+    for (StepId d : deps)
+    {
+        if (d >= m_steps.size())
+        {
+            std::cerr << "[Startup] " << step->name << " depends on an unknown step, ignored" << std::endl;
+            continue;
+        }
+        step->deps.push_back(d);
+        // Only the caller thread can run a pinned step, so whatever waits on
+        // one has to run there too.
+        if (m_steps[d]->pinned)
+            step->pinned = true;
+    }
+    m_steps.push_back(std::move(step));
+    return static_cast<StepId>(m_steps.size() - 1);
+}
+
+void StartupGraph::Launch(TaskGraph* graph)
+{
+    if (m_launched)
+        return;
+    m_launched = true;
+    m_graph = graph && graph->GetWorkerCount() > 0 ? graph : nullptr;
+    m_launchNs = NowNs();
+    m_pending.store(static_cast<uint32_t>(m_steps.size()), std::memory_order_relaxed);
+    ThreadIndex(); // the launching thread is thread 0
+
+    for (auto& s : m_steps)
+    {
+        if (s->pinned)
+            continue;
+        if (!m_graph)
+        {
+            Run(*s);
+            continue;
+        }
+        std::vector<TaskHandle> deps;
+        deps.reserve(s->deps.size());
+        for (StepId d : s->deps)
+            deps.push_back(m_steps[d]->handle);
+        Step* step = s.get();
+        s->handle = m_graph->Submit([this, step] { Run(*step); }, deps);
+    }
+}
+
+void StartupGraph::Run(Step& step)
+{
+    step.thread = ThreadIndex();
+    step.startNs = SinceLaunch();
+    try
+    {
+        if (step.fn)
+            step.fn();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[Startup] " << step.name << " failed: " << e.what() << std::endl;
+    }
+    step.endNs = SinceLaunch();
+    step.fn = nullptr;
+    // Notify under the lock so a waiter cannot return, and destroy us,
+    // before this thread is done with the condition variable.
+    std::lock_guard lock(m_mutex);
+    m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    step.done.store(true, std::memory_order_release);
+    m_stepDone.notify_all();
+}
+
+bool StartupGraph::DepsDone(const Step& step) const
+{
+    for (StepId d : step.deps)
+        if (!m_steps[d]->done.load(std::memory_order_acquire))
+            return false;
+    return true;
+}
+
+void StartupGraph::WaitUnpinned(Step& step)
+{
+    if (step.done.load(std::memory_order_acquire))
+        return;
+    if (m_graph && m_graph->GetWorkerCount() == 0)
+    {
+        // Nobody left to run it: help out instead of sleeping forever.
+        m_graph->Wait(step.handle);
+        return;
+    }
+    // Sleep rather than TaskGraph::Wait, which would have this thread pick up
+    // unrelated content loads while the step we need is already running.
+    std::unique_lock lock(m_mutex);
+    m_stepDone.wait(lock, [&] { return step.done.load(std::memory_order_acquire); });
+}
+
+void StartupGraph::Wait(StepId id)
+{
+    if (id >= m_steps.size() || !m_launched)
+        return;
+    Step& step = *m_steps[id];
+    if (!step.pinned)
+    {
+        WaitUnpinned(step);
+        return;
+    }
+    for (StepId d : step.deps)
+        Wait(d);
+    if (!step.done.load(std::memory_order_acquire))
+        Run(step);
+}
+
+bool StartupGraph::RunCallerSteps()
+{
+    if (!m_launched)
+        return false;
+    bool allDone = true;
+    for (auto& s : m_steps)
+    {
+        if (!s->pinned || s->done.load(std::memory_order_acquire))
+            continue;
+        if (DepsDone(*s))
+            Run(*s);
+        else
+            allDone = false;
+    }
+    return allDone;
+}
+
+void StartupGraph::WaitAll()
+{
+    for (StepId id = 0; id < m_steps.size(); ++id)
+        Wait(id);
+}
+
+bool StartupGraph::IsDone(StepId id) const
+{
+    return id < m_steps.size() && m_steps[id]->done.load(std::memory_order_acquire);
+}
+
+bool StartupGraph::AllDone() const
+{
+    return m_launched && m_pending.load(std::memory_order_acquire) == 0;
+}
+
+uint32_t StartupGraph::ThreadIndex()
+{
+    const std::thread::id self = std::this_thread::get_id();
+    std::lock_guard lock(m_mutex);
+    auto it = std::find(m_threads.begin(), m_threads.end(), self);
+    if (it != m_threads.end())
+        return static_cast<uint32_t>(it - m_threads.begin());
+    m_threads.push_back(self);
+    return static_cast<uint32_t>(m_threads.size() - 1);
+}
+
+uint64_t StartupGraph::SinceLaunch() const
+{
+    return NowNs() - m_launchNs;
+}
+
+uint64_t StartupGraph::GetWallNs() const
+{
+    uint64_t wall = 0;
+    for (const auto& s : m_steps)
+        if (s->done.load(std::memory_order_acquire))
+            wall = (std::max)(wall, s->endNs);
+    return wall;
+}
+
+uint64_t StartupGraph::GetSerialNs() const
+{
+    uint64_t serial = 0;
+    for (const auto& s : m_steps)
+        if (s->done.load(std::memory_order_acquire))
+            serial += s->endNs - s->startNs;
+    return serial;
+}
+
+std::vector<StartupGraph::StepTiming> StartupGraph::GetTimings() const
+{
+    std::vector<StepTiming> out;
+    for (const auto& s : m_steps)
+    {
+        if (!s->done.load(std::memory_order_acquire))
+            continue;
+        out.push_back({s->name, s->startNs, s->endNs, s->thread, s->pinned});
+    }
+    std::sort(out.begin(), out.end(), [](const StepTiming& a, const StepTiming& b) { return a.startNs < b.startNs; });
+    return out;
+}
+
+std::string StartupGraph::Timeline() const
+{
+    constexpr int kBarWidth = 40;
+    const auto timings = GetTimings();
+    const uint64_t wall = GetWallNs();
+    size_t threads;
+    {
+        std::lock_guard lock(m_mutex);
+        threads = m_threads.size();
+    }
+    char line[256];
+    std::snprintf(line, sizeof(line), "Startup %.1f ms (%.1f ms of work on %zu thread(s))\n", wall / 1e6,
+                  GetSerialNs() / 1e6, threads);
+    std::string out = line;
+    size_t nameWidth = 4;
+    for (const auto& t : timings)
+        nameWidth = (std::max)(nameWidth, t.name.size());
+    for (const auto& t : timings)
+    {
+        char bar[kBarWidth + 1];
+        const int from = wall ? static_cast<int>(t.startNs * kBarWidth / wall) : 0;
+        const int to = wall ? static_cast<int>((t.endNs * kBarWidth + wall - 1) / wall) : 0;
+        for (int i = 0; i < kBarWidth; ++i)
+            bar[i] = i >= from && i < (std::max)(to, from + 1) ? '#' : '.';
+        bar[kBarWidth] = '\0';
+        const std::string thread = t.thread == 0 ? "main" : "t" + std::to_string(t.thread);
+        std::snprintf(line, sizeof(line), "  %-*s %8.1f ms %8.1f ms  %-4s |%s|\n", static_cast<int>(nameWidth),
+                      t.name.c_str(), t.startNs / 1e6, (t.endNs - t.startNs) / 1e6, thread.c_str(), bar);
+        out += line;
+    }
+    return out;
+}
+
+bool StartupGraph::WriteChromeTrace(const std::string& path) const
+{
+    std::error_code ec;
+    const auto dir = std::filesystem::path(path).parent_path();
+    if (!dir.empty())
+        std::filesystem::create_directories(dir, ec);
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    // Complete ("X") events in microseconds, plus one name record per thread.
+    const auto timings = GetTimings();
+    size_t threads;
+    {
+        std::lock_guard lock(m_mutex);
+        threads = m_threads.size();
+    }
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < threads; ++i)
+    {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+            << ",\"args\":{\"name\":\"" << (i == 0 ? std::string("main") : "startup worker " + std::to_string(i))
+            << "\"}}";
+        first = false;
+    }
+    for (const auto& t : timings)
+    {
+        char nums[128];
+        std::snprintf(nums, sizeof(nums), "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u", t.startNs / 1e3,
+                      (t.endNs - t.startNs) / 1e3, t.thread);
+        out << (first ? "" : ",") << "\n{\"name\":\"" << JsonEscape(t.name) << "\",\"cat\":\"startup\",\"ph\":\"X\","
+            << nums << ",\"args\":{\"pinned\":" << (t.pinned ? "true" : "false") << "}}";
+        first = false;
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+} // namespace CoopNet
@@ -0,0 +1,115 @@
+#pragma once
+
+// Start-up steps as a dependency graph.
+// Each step names the steps it needs; Launch submits them all to a TaskGraph
+// so independent loads run side by side, and the caller only waits for the
+// ones it cannot serve without. Steps pinned to the caller thread (anything
+// that must live on the thread that later ticks it, like the Python VM) are
+// run from RunCallerSteps once their dependencies are done; a step that
+// depends on a pinned step is pinned as well.
+//
+// Every step records when it ran and on which thread, so the whole start-up
+// can be printed as a timeline or written as a Chrome trace
+// (chrome://tracing, Perfetto).
+//
+// Add every step before Launch; after that, call Wait, RunCallerSteps and
+// WaitAll from the launching thread only.
+
+#include "TaskGraph.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CoopNet
+{
+class StartupGraph
+{
+public:
+    using StepId = uint32_t;
+
+    enum class Affinity
+    {
+        Any,    // any worker of the graph
+        Caller, // the thread that called Launch, from RunCallerSteps
+    };
+
+    struct StepTiming
+    {
+        std::string name;
+        uint64_t startNs = 0; // since Launch
+        uint64_t endNs = 0;
+        uint32_t thread = 0; // 0 is the launching thread
+        bool pinned = false;
+    };
+
+    StartupGraph() = default;
+    ~StartupGraph();
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    // Dependencies must be steps added earlier.
+    StepId Add(std::string name, std::function<void()> fn, std::initializer_list<StepId> deps = {},
+               Affinity affinity = Affinity::Any);
+
+    // Submits every unpinned step; with no graph (or one without workers)
+    // they run right here, in the order they were added.
+    void Launch(TaskGraph* graph);
+
+    // Blocks until `id` has run. Pinned steps it needs are run on this thread.
+    void Wait(StepId id);
+    // Runs the pinned steps whose dependencies are done. Returns true once
+    // every pinned step has run.
+    bool RunCallerSteps();
+    // Runs what is left and blocks until every step has finished.
+    void WaitAll();
+
+    bool IsDone(StepId id) const;
+    bool AllDone() const;
+
+    // Launch to the end of the last step, and the sum of all step durations.
+    uint64_t GetWallNs() const;
+    uint64_t GetSerialNs() const;
+    std::vector<StepTiming> GetTimings() const;
+
+    // One line per step with its offset, duration, thread and a bar.
+    std::string Timeline() const;
+    bool WriteChromeTrace(const std::string& path) const;
+
+private:
+    struct Step
+    {
+        std::string name;
+        std::function<void()> fn;
+        std::vector<StepId> deps;
+        bool pinned = false;
+        TaskHandle handle;
+        std::atomic<bool> done{false};
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+        uint32_t thread = 0;
+    };
+
+    void Run(Step& step);
+    bool DepsDone(const Step& step) const;
+    void WaitUnpinned(Step& step);
+    uint32_t ThreadIndex();
+    uint64_t SinceLaunch() const;
+
+    std::vector<std::unique_ptr<Step>> m_steps;
+    TaskGraph* m_graph = nullptr;
+    bool m_launched = false;
+    uint64_t m_launchNs = 0;
+    std::atomic<uint32_t> m_pending{0};
+
+    mutable std::mutex m_mutex; // guards m_threads and pairs with m_stepDone
+    std::condition_variable m_stepDone;
+    std::vector<std::thread::id> m_threads;
+};
+} // namespace CoopNet
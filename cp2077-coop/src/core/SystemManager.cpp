@@ -2,6 +2,7 @@
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 #include "Logger.hpp"
+#include "TaskGraph.hpp"
 #include <algorithm>
 #include <fstream>
 #include <chrono>
@@ -616,6 +617,9 @@ bool SystemManager::Initialize(const InitializationConfig& config) {
         return false;
     }
 
+    // Fix which updates may overlap now that the system set is known
+    BuildUpdateGraph();
+
     // Start monitoring threads
     if (m_config.enableWatchdog) {
         EnableWatchdog(true);
@@ -872,6 +876,7 @@ bool SystemManager::RegisterSystem(SystemType type, std::shared_ptr<ISystem> sys
     m_systemInfo[type] = info;
     m_systemInfo[type].type = type; // Ensure type consistency
     m_restartCounts[type] = 0;
+    m_updateGraphDirty = true;
 
     spdlog::info("[SystemManager] Registered system: {} ({})", info.name, SystemUtils::GetSystemTypeName(type));
     return true;
@@ -1188,26 +1193,190 @@ bool SystemManager::IsSystemEssential(SystemType type) const {
 
 // Missing SystemManager public methods implementation
 void SystemManager::Update() {
-    std::lock_guard<std::recursive_mutex> lock(m_systemMutex);
+    std::vector<UpdateNode> nodes;
+    std::vector<char> running;
+    TaskGraph* graph = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_systemMutex);
 
-    if (!m_initialized) return;
+        if (!m_initialized) return;
 
-    auto now = std::chrono::steady_clock::now();
-    m_updateCount++;
-    m_lastUpdate = now;
+        m_updateCount++;
+        m_lastUpdate = std::chrono::steady_clock::now();
+
+        if (m_updateGraphDirty) {
+            BuildUpdateGraph();
+        }
+        nodes = m_updateNodes;
+        running.reserve(nodes.size());
+        for (const auto& node : nodes) {
+            running.push_back(m_systemInfo[node.type].state == SystemState::Running);
+        }
+        graph = m_taskGraph;
+    }
+
+    // Systems run without m_systemMutex held so an Update that calls back
+    // into the manager from a worker cannot deadlock against this thread.
+    using Clock = std::chrono::steady_clock;
+    std::vector<int64_t> durationsNs(nodes.size(), 0);
+    std::vector<std::string> errors(nodes.size());
+    auto runNode = [&](size_t i) {
+        if (!running[i]) return;
+        auto start = Clock::now();
+        try {
+            nodes[i].system->Update();
+        } catch (const std::exception& ex) {
+            errors[i] = "Update exception: " + std::string(ex.what());
+        }
+        durationsNs[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    };
 
-    // Update all systems
+    auto frameStart = Clock::now();
+    if (graph && graph->GetWorkerCount() > 0 && nodes.size() > 1) {
+        std::vector<TaskHandle> handles(nodes.size());
+        std::vector<TaskHandle> deps;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            deps.clear();
+            for (size_t pred : nodes[i].predecessors) {
+                deps.push_back(handles[pred]);
+            }
+            handles[i] = graph->Submit([&runNode, i] { runNode(i); }, deps);
+        }
+        for (const auto& handle : handles) {
+            graph->Wait(handle);
+        }
+    } else {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            runNode(i);
+        }
+    }
+    const int64_t wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frameStart).count();
+
+    RecordUpdateProfile(nodes, durationsNs, wallNs);
+
+    std::lock_guard<std::recursive_mutex> lock(m_systemMutex);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!errors[i].empty()) {
+            HandleSystemFailure(nodes[i].type, errors[i]);
+        }
+    }
+}
+
+void SystemManager::BuildUpdateGraph() {
+    // Kahn's algorithm; among systems that are ready at the same time the
+    // higher priority goes first, which makes the order (and the serial
+    // fallback) deterministic.
+    std::vector<SystemType> types;
     for (const auto& [type, system] : m_systems) {
-        auto& info = m_systemInfo[type];
-        if (info.state == SystemState::Running) {
-            try {
-                system->Update();
-            } catch (const std::exception& ex) {
-                std::string error = "Update exception: " + std::string(ex.what());
-                HandleSystemFailure(type, error);
+        types.push_back(type);
+    }
+    std::sort(types.begin(), types.end(), [this](SystemType a, SystemType b) {
+        const auto pa = GetSystemPriority(a), pb = GetSystemPriority(b);
+        return pa != pb ? pa < pb : a < b;
+    });
+
+    std::unordered_map<SystemType, size_t> placed;
+    m_updateNodes.clear();
+    m_updateNodes.reserve(types.size());
+    while (placed.size() < types.size()) {
+        bool progress = false;
+        for (SystemType type : types) {
+            if (placed.count(type)) continue;
+            const auto& deps = m_systemInfo[type].dependencies;
+            const bool ready = std::all_of(deps.begin(), deps.end(), [&](const SystemDependency& dep) {
+                return !m_systems.count(dep.dependsOn) || placed.count(dep.dependsOn);
+            });
+            if (!ready) continue;
+
+            UpdateNode node{type, m_systems[type], {}};
+            for (const auto& dep : deps) {
+                auto it = placed.find(dep.dependsOn);
+                if (it != placed.end()) {
+                    node.predecessors.push_back(it->second);
+                }
+            }
+            placed[type] = m_updateNodes.size();
+            m_updateNodes.push_back(std::move(node));
+            progress = true;
+            break; // restart so priority order holds among newly ready systems
+        }
+        if (!progress) {
+            // Only reachable with a cycle, which ValidateDependencies rejects
+            // at start-up; run what is left after everything else.
+            spdlog::error("[SystemManager] Circular update dependencies; remaining systems run last in sequence");
+            for (SystemType type : types) {
+                if (placed.count(type)) continue;
+                UpdateNode node{type, m_systems[type], {}};
+                if (!m_updateNodes.empty()) {
+                    node.predecessors.push_back(m_updateNodes.size() - 1);
+                }
+                placed[type] = m_updateNodes.size();
+                m_updateNodes.push_back(std::move(node));
+            }
+        }
+    }
+    m_updateGraphDirty = false;
+}
+
+void SystemManager::RecordUpdateProfile(const std::vector<UpdateNode>& nodes, const std::vector<int64_t>& durationsNs,
+                                        int64_t wallNs) {
+    // Longest path by summed duration; nodes are in topological order.
+    std::vector<int64_t> finish(nodes.size(), 0);
+    std::vector<size_t> via(nodes.size(), SIZE_MAX);
+    int64_t serialNs = 0;
+    size_t last = SIZE_MAX;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        int64_t startNs = 0;
+        for (size_t pred : nodes[i].predecessors) {
+            if (via[i] == SIZE_MAX || finish[pred] > startNs) {
+                startNs = finish[pred];
+                via[i] = pred;
             }
         }
+        finish[i] = startNs + durationsNs[i];
+        serialNs += durationsNs[i];
+        if (last == SIZE_MAX || finish[i] > finish[last]) {
+            last = i;
+        }
+    }
+
+    UpdateFrameProfile profile;
+    profile.wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(wallNs));
+    profile.serialTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(serialNs));
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        profile.updateTimes[nodes[i].type] =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(durationsNs[i]));
+    }
+    if (last != SIZE_MAX) {
+        profile.criticalPathTime =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(finish[last]));
+        for (size_t i = last; i != SIZE_MAX; i = via[i]) {
+            profile.criticalPath.push_back(nodes[i].type);
+        }
+        std::reverse(profile.criticalPath.begin(), profile.criticalPath.end());
+    }
+
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    profile.frame = m_lastUpdateProfile.frame + 1;
+    for (SystemType type : profile.criticalPath) {
+        m_criticalPathCounts[type]++;
     }
+    m_lastUpdateProfile = std::move(profile);
+}
+
+void SystemManager::SetTaskGraph(TaskGraph* graph) {
+    std::lock_guard<std::recursive_mutex> lock(m_systemMutex);
+    m_taskGraph = graph;
+}
+
+UpdateFrameProfile SystemManager::GetLastUpdateProfile() const {
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    return m_lastUpdateProfile;
+}
+
+std::unordered_map<SystemType, uint64_t> SystemManager::GetCriticalPathCounts() const {
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    return m_criticalPathCounts;
 }
 
 bool SystemManager::IsInitialized() const {
@@ -1234,6 +1403,7 @@ bool SystemManager::UnregisterSystem(SystemType type) {
     m_systemErrors.erase(type);
     m_systemTimeouts.erase(type);
     m_restartCounts.erase(type);
+    m_updateGraphDirty = true;
 
     spdlog::info("[SystemManager] Unregistered system: {}", SystemUtils::GetSystemTypeName(type));
     return true;
@@ -1476,6 +1646,23 @@ std::string SystemManager::GenerateSystemReport() const {
         report << "  Restarts: " << info.restartCount << "\n\n";
     }
 
+    const UpdateFrameProfile profile = GetLastUpdateProfile();
+    if (profile.frame != 0) {
+        report << "Last Update (frame " << profile.frame << "): " << profile.wallTime.count() << "us wall, "
+               << profile.serialTime.count() << "us serial, critical path " << profile.criticalPathTime.count()
+               << "us:";
+        for (SystemType type : profile.criticalPath) {
+            report << " " << SystemUtils::GetSystemTypeName(type) << " (" << profile.updateTimes.at(type).count()
+                   << "us)";
+        }
+        report << "\n";
+        report << "Critical Path Frames:";
+        for (const auto& [type, count] : GetCriticalPathCounts()) {
+            report << " " << SystemUtils::GetSystemTypeName(type) << "=" << count;
+        }
+        report << "\n";
+    }
+
     return report.str();
 }
 
@@ -21,6 +21,8 @@
 
 namespace CoopNet {
 
+class TaskGraph;
+
 // System states
 enum class SystemState : uint8_t {
     Uninitialized = 0,
@@ -106,6 +108,18 @@ struct SystemDependency {
     std::string description;
 };
 
+// Timing of one SystemManager::Update. The critical path is the chain of
+// dependent systems with the largest summed update time: it bounds the frame
+// however many workers run the rest.
+struct UpdateFrameProfile {
+    uint64_t frame = 0;
+    std::chrono::microseconds wallTime{0};
+    std::chrono::microseconds serialTime{0};       // sum of every system's update
+    std::chrono::microseconds criticalPathTime{0};
+    std::vector<SystemType> criticalPath;          // first to last
+    std::unordered_map<SystemType, std::chrono::microseconds> updateTimes;
+};
+
 // Initialization configuration
 struct InitializationConfig {
     std::string configDirectory = "config/";
@@ -162,8 +176,15 @@ public:
     // Core lifecycle
     bool Initialize(const InitializationConfig& config = InitializationConfig{});
     void Shutdown();
+    // Runs every running system's Update once. Systems wait only for the
+    // systems they depend on; independent ones run in parallel on the task
+    // graph set with SetTaskGraph, or one after another without one.
     void Update();
     bool IsInitialized() const;
+    void SetTaskGraph(TaskGraph* graph);
+    UpdateFrameProfile GetLastUpdateProfile() const;
+    // How many frames each system has been on the critical path.
+    std::unordered_map<SystemType, uint64_t> GetCriticalPathCounts() const;
 
     // System management
     bool RegisterSystem(SystemType type, std::shared_ptr<ISystem> system, const SystemInfo& info);
@@ -258,6 +279,16 @@ private:
     bool HasCircularDependency(SystemType type, std::unordered_set<SystemType>& visited,
                               std::unordered_set<SystemType>& recursionStack) const;
 
+    // Update DAG, rebuilt when systems are registered or removed
+    struct UpdateNode {
+        SystemType type;
+        std::shared_ptr<ISystem> system;
+        std::vector<size_t> predecessors; // indices of earlier nodes
+    };
+    void BuildUpdateGraph();
+    void RecordUpdateProfile(const std::vector<UpdateNode>& nodes, const std::vector<int64_t>& durationsNs,
+                             int64_t wallNs);
+
     // Health monitoring
     void HealthMonitoringLoop();
     void CheckSystemHealth(SystemType type);
@@ -322,6 +353,13 @@ private:
     std::chrono::steady_clock::time_point m_lastUpdate;
     uint64_t m_updateCount = 0;
 
+    // Parallel update
+    std::vector<UpdateNode> m_updateNodes; // topological order
+    bool m_updateGraphDirty = true;
+    TaskGraph* m_taskGraph = nullptr;
+    UpdateFrameProfile m_lastUpdateProfile;                  // guarded by m_metricsMutex
+    std::unordered_map<SystemType, uint64_t> m_criticalPathCounts; // guarded by m_metricsMutex
+
     // Auto-restart functionality
     bool m_autoRestartEnabled = true;
     uint32_t m_maxRestartAttempts = 3;
@@ -1,27 +1,475 @@
 #include "TaskGraph.hpp"
-#include <chrono>
+#include "TickProfiler.hpp"
+#include <algorithm>
+#include <string>
 
 namespace CoopNet
 {
-TaskGraph::TaskGraph() = default;
+using detail::Task;
+
+namespace
+{
+// The graph and slot the current thread works for, if any. Tasks scheduled
+// from such a thread go onto its own deque instead of the injection queue.
+struct WorkerContext
+{
+    TaskGraph* graph = nullptr;
+    size_t slot = 0;
+};
+thread_local WorkerContext t_current;
+thread_local uint32_t t_stealSeed = 0;
+
+constexpr size_t kExternalSlot = TaskGraph::kMaxWorkers;
+constexpr int64_t kInitialDequeSize = 64; // power of two
+// Yields before parking: work often arrives right behind the last task.
+constexpr int kSpinRounds = 32;
+
+// Task nodes are recycled per thread. A thread that only frees (a worker
+// running tasks submitted from outside) hands batches to the shared pool; a
+// thread that only allocates takes them back, so steady state never hits
+// the heap.
+constexpr size_t kTaskCacheMax = 256;
+constexpr size_t kTaskCacheBatch = kTaskCacheMax / 2;
+
+std::mutex g_taskPoolMutex;
+std::vector<Task*> g_taskPool;
+
+struct TaskCache
+{
+    std::vector<Task*> free;
+    ~TaskCache()
+    {
+        for (Task* t : free)
+            delete t;
+    }
+};
+thread_local TaskCache t_taskCache;
+
+uint32_t NextStealSeed()
+{
+    if (t_stealSeed == 0)
+        t_stealSeed = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&t_stealSeed) >> 4) | 1u;
+    t_stealSeed ^= t_stealSeed << 13;
+    t_stealSeed ^= t_stealSeed >> 17;
+    t_stealSeed ^= t_stealSeed << 5;
+    return t_stealSeed;
+}
+
+void LockSuccessors(Task* t)
+{
+    while (t->successorLock.test_and_set(std::memory_order_acquire))
+        std::this_thread::yield();
+}
+
+void UnlockSuccessors(Task* t)
+{
+    t->successorLock.clear(std::memory_order_release);
+}
+} // namespace
+
+namespace detail
+{
+Task* AllocTask()
+{
+    auto& cache = t_taskCache.free;
+    if (cache.empty())
+    {
+        std::lock_guard lock(g_taskPoolMutex);
+        const size_t take = (std::min)(g_taskPool.size(), kTaskCacheBatch);
+        cache.insert(cache.end(), g_taskPool.end() - static_cast<ptrdiff_t>(take), g_taskPool.end());
+        g_taskPool.resize(g_taskPool.size() - take);
+    }
+    Task* t;
+    if (!cache.empty())
+    {
+        t = cache.back();
+        cache.pop_back();
+    }
+    else
+    {
+        t = new Task();
+    }
+    t->refs.store(2, std::memory_order_relaxed); // returned handle + scheduler
+    t->pending.store(1, std::memory_order_relaxed);
+    t->done.store(0, std::memory_order_relaxed);
+    t->waiters.store(0, std::memory_order_relaxed);
+    t->successorCount = 0;
+    t->moreSuccessors.clear();
+    return t;
+}
+
+void ReleaseTask(Task* t)
+{
+    if (t->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    auto& cache = t_taskCache.free;
+    cache.push_back(t);
+    if (cache.size() > kTaskCacheMax)
+    {
+        std::lock_guard lock(g_taskPoolMutex);
+        g_taskPool.insert(g_taskPool.end(), cache.end() - static_cast<ptrdiff_t>(kTaskCacheBatch), cache.end());
+        cache.resize(cache.size() - kTaskCacheBatch);
+    }
+}
+} // namespace detail
+
+// Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli 2013). Only the owner
+// pushes and pops at `bottom`; any thread may steal at `top`.
+struct TaskGraph::Deque
+{
+    struct Ring
+    {
+        explicit Ring(int64_t size) : mask(size - 1), items(new std::atomic<Task*>[static_cast<size_t>(size)]()) {}
+        Task* Get(int64_t i) const { return items[i & mask].load(std::memory_order_relaxed); }
+        void Put(int64_t i, Task* t) { items[i & mask].store(t, std::memory_order_relaxed); }
+
+        int64_t mask;
+        std::unique_ptr<std::atomic<Task*>[]> items;
+    };
+
+    Deque()
+    {
+        rings.push_back(std::make_unique<Ring>(kInitialDequeSize));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    void Push(Task* t)
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t tp = top.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - tp > r->mask)
+            r = Grow(r, tp, b);
+        r->Put(b, t);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    Task* Pop()
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t tp = top.load(std::memory_order_relaxed);
+        if (tp > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Task* t = r->Get(b);
+        if (tp == b)
+        {
+            // Last item: race the thieves for it.
+            if (!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                t = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    // Pops only items pushed after `bottom` was at `floor`.
+    Task* PopAbove(int64_t floor)
+    {
+        if (bottom.load(std::memory_order_relaxed) <= floor)
+            return nullptr;
+        return Pop();
+    }
+
+    Task* Steal()
+    {
+        int64_t tp = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (tp >= b)
+            return nullptr;
+        Task* t = ring.load(std::memory_order_acquire)->Get(tp);
+        if (!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return t;
+    }
+
+    bool Empty() const
+    {
+        return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+    }
+
+    Ring* Grow(Ring* old, int64_t tp, int64_t b)
+    {
+        // Thieves may still be reading the old ring, so it is kept until the
+        // deque goes away rather than freed here.
+        rings.push_back(std::make_unique<Ring>((old->mask + 1) * 2));
+        Ring* r = rings.back().get();
+        for (int64_t i = tp; i < b; ++i)
+            r->Put(i, old->Get(i));
+        ring.store(r, std::memory_order_release);
+        return r;
+    }
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Ring*> ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings; // owner only
+};
+
+struct TaskGraph::Slot
+{
+    Deque deque;
+    std::jthread thread;
+    std::atomic<bool> retire{false};
+};
+
+TaskHandle::TaskHandle(const TaskHandle& other) : m_task(other.m_task)
+{
+    if (m_task)
+        m_task->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+TaskHandle::TaskHandle(TaskHandle&& other) noexcept : m_task(std::exchange(other.m_task, nullptr)) {}
+
+TaskHandle& TaskHandle::operator=(TaskHandle other) noexcept
+{
+    std::swap(m_task, other.m_task);
+    return *this;
+}
+
+TaskHandle::~TaskHandle()
+{
+    if (m_task)
+        detail::ReleaseTask(m_task);
+}
+
+bool TaskHandle::IsDone() const
+{
+    return !m_task || m_task->done.load(std::memory_order_acquire) != 0;
+}
+
+TaskGraph::TaskGraph() : m_slots(std::make_unique<Slot[]>(kMaxWorkers + 1)) {}
+
 TaskGraph::~TaskGraph()
 {
     Stop();
+    // Whatever was submitted after Stop still owns a node.
+    Task* t;
+    while (m_injected.TryPop(t))
+    {
+        t->drop(t);
+        detail::ReleaseTask(t);
+    }
 }
 
-void TaskGraph::WorkerLoop()
+TaskHandle TaskGraph::Enqueue(Task* t, const TaskHandle* deps, size_t depCount)
 {
-    while (m_running)
+    TaskHandle handle(t);
+    t->pending.store(static_cast<int32_t>(depCount) + 1, std::memory_order_relaxed);
+    for (size_t i = 0; i < depCount; ++i)
     {
-        std::function<void()> task;
-        if (m_tasks.Pop(task))
+        Task* dep = deps[i].m_task;
+        bool finished = true;
+        if (dep)
         {
-            task();
+            LockSuccessors(dep);
+            finished = dep->done.load(std::memory_order_acquire) != 0;
+            if (!finished)
+            {
+                if (dep->successorCount < detail::kTaskInlineSuccessors)
+                    dep->successors[dep->successorCount++] = t;
+                else
+                    dep->moreSuccessors.push_back(t);
+            }
+            UnlockSuccessors(dep);
         }
-        else
+        if (finished)
+            t->pending.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (t->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        Schedule(t);
+    return handle;
+}
+
+void TaskGraph::Schedule(Task* t)
+{
+    if (t_current.graph == this)
+        m_slots[t_current.slot].deque.Push(t);
+    else
+        m_injected.Push(t);
+    WakeOne();
+}
+
+void TaskGraph::Execute(Task* t)
+{
+    t->invoke(t);
+    Finish(t);
+}
+
+void TaskGraph::Finish(Task* t)
+{
+    LockSuccessors(t);
+    t->done.store(1, std::memory_order_release);
+    const bool awaited = t->waiters.load(std::memory_order_relaxed) != 0;
+    UnlockSuccessors(t);
+    // No successor can be added once done is set, so the lists are stable.
+    for (uint32_t i = 0; i < t->successorCount; ++i)
+    {
+        if (t->successors[i]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Schedule(t->successors[i]);
+    }
+    for (Task* s : t->moreSuccessors)
+    {
+        if (s->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Schedule(s);
+    }
+    if (awaited)
+    {
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_all();
+    }
+    detail::ReleaseTask(t);
+}
+
+Task* TaskGraph::FindWork(size_t self)
+{
+    if (self <= kExternalSlot)
+    {
+        if (Task* t = m_slots[self].deque.Pop())
+            return t;
+    }
+    Task* t;
+    if (m_injected.TryPop(t))
+        return t;
+    return StealFrom(self);
+}
+
+Task* TaskGraph::StealFrom(size_t self)
+{
+    // Workers occupy [0, count); the borrowed external slot is visited last
+    // in the rotation as index `count`.
+    const size_t count = m_workerCount.load(std::memory_order_acquire);
+    const size_t start = NextStealSeed() % (count + 1);
+    for (size_t i = 0; i <= count; ++i)
+    {
+        size_t victim = (start + i) % (count + 1);
+        if (victim == count)
+            victim = kExternalSlot;
+        if (victim == self)
+            continue;
+        if (Task* t = m_slots[victim].deque.Steal())
+            return t;
+    }
+    return nullptr;
+}
+
+bool TaskGraph::HasWork() const
+{
+    if (!m_injected.Empty() || !m_slots[kExternalSlot].deque.Empty())
+        return true;
+    const size_t count = m_workerCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!m_slots[i].deque.Empty())
+            return true;
+    }
+    return false;
+}
+
+// Event count: a thread about to park registers in m_sleepers, re-checks for
+// work and then waits for m_epoch to move. Wakers publish their work before
+// reading m_sleepers, so one side always sees the other.
+void TaskGraph::WakeOne()
+{
+    // A worker still spinning will find the task (it re-checks before it
+    // parks), so a burst of submissions costs no wake-up syscalls.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) == 0 || m_searching.load(std::memory_order_relaxed) != 0)
+        return;
+    m_epoch.fetch_add(1, std::memory_order_release);
+    m_epoch.notify_one();
+}
+
+void TaskGraph::WakeAll()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) == 0)
+        return;
+    m_epoch.fetch_add(1, std::memory_order_release);
+    m_epoch.notify_all();
+}
+
+void TaskGraph::WorkerLoop(size_t slot)
+{
+    t_current = {this, slot};
+    TickProfiler_SetThreadName(("task worker " + std::to_string(slot)).c_str());
+    Slot& self = m_slots[slot];
+    int idleRounds = 0;
+    for (;;)
+    {
+        if (Task* t = FindWork(slot))
+        {
+            if (idleRounds != 0)
+                m_searching.fetch_sub(1, std::memory_order_seq_cst);
+            idleRounds = 0;
+            Execute(t);
+            continue;
+        }
+        // Own deque is empty here, so a retiring worker leaves nothing behind.
+        if (!m_running.load(std::memory_order_acquire) || self.retire.load(std::memory_order_acquire))
+            break;
+        if (idleRounds++ == 0)
+            m_searching.fetch_add(1, std::memory_order_seq_cst);
+        if (idleRounds < kSpinRounds)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        m_searching.fetch_sub(1, std::memory_order_seq_cst);
+        if (!HasWork() && m_running.load(std::memory_order_seq_cst) && !self.retire.load(std::memory_order_seq_cst))
+            m_epoch.wait(epoch, std::memory_order_acquire);
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        idleRounds = 0;
+    }
+    if (idleRounds != 0)
+        m_searching.fetch_sub(1, std::memory_order_relaxed);
+    t_current = {};
+}
+
+void TaskGraph::StartWorkersLocked(size_t from, size_t to)
+{
+    for (size_t i = from; i < to; ++i)
+    {
+        m_slots[i].retire.store(false, std::memory_order_relaxed);
+        m_slots[i].thread = std::jthread([this, i] { WorkerLoop(i); });
+    }
+    m_workerCount.store(to, std::memory_order_release);
+}
+
+void TaskGraph::RetireWorkersLocked(size_t from, size_t to)
+{
+    m_workerCount.store(from, std::memory_order_release);
+    for (size_t i = from; i < to; ++i)
+        m_slots[i].retire.store(true, std::memory_order_seq_cst);
+    m_epoch.fetch_add(1, std::memory_order_release);
+    m_epoch.notify_all();
+    for (size_t i = from; i < to; ++i)
+    {
+        if (m_slots[i].thread.joinable())
+            m_slots[i].thread.join();
+    }
+}
+
+void TaskGraph::DrainLocked()
+{
+    for (;;)
+    {
+        Task* t = nullptr;
+        if (!m_injected.TryPop(t))
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            for (size_t i = 0; i <= kExternalSlot && !t; ++i)
+                t = m_slots[i].deque.Steal();
         }
+        if (!t)
+            return;
+        Execute(t);
     }
 }
 
@@ -31,8 +479,7 @@ void TaskGraph::Start(size_t workers)
     if (m_running)
         return;
     m_running = true;
-    for (size_t i = 0; i < workers; ++i)
-        m_workers.emplace_back([this] { WorkerLoop(); });
+    StartWorkersLocked(0, (std::min)(workers, kMaxWorkers));
 }
 
 void TaskGraph::Stop()
@@ -40,39 +487,126 @@ void TaskGraph::Stop()
     std::lock_guard<std::mutex> lock(m_resizeMutex);
     if (!m_running)
         return;
-    m_running = false;
-    for (auto& t : m_workers)
-        if (t.joinable())
-            t.join();
-    m_workers.clear();
+    m_running.store(false, std::memory_order_seq_cst);
+    RetireWorkersLocked(0, m_workerCount.load(std::memory_order_relaxed));
+    DrainLocked();
 }
 
 void TaskGraph::Resize(size_t workers)
 {
     std::lock_guard<std::mutex> lock(m_resizeMutex);
-    // Inline stop
-    if (m_running)
+    workers = (std::min)(workers, kMaxWorkers);
+    m_running = true;
+    const size_t current = m_workerCount.load(std::memory_order_relaxed);
+    if (workers > current)
+        StartWorkersLocked(current, workers);
+    else if (workers < current)
+        RetireWorkersLocked(workers, current);
+}
+
+void TaskGraph::Wait(const TaskHandle& handle)
+{
+    Task* target = handle.m_task;
+    if (!target)
+        return;
+    const size_t self = t_current.graph == this ? t_current.slot : kExternalSlot + 1;
+    while (target->done.load(std::memory_order_acquire) == 0)
     {
-        m_running = false;
-        for (auto& t : m_workers)
-            if (t.joinable())
-                t.join();
-        m_workers.clear();
+        if (Task* t = FindWork(self))
+        {
+            Execute(t);
+            continue;
+        }
+        // Park like an idle worker. Registering under the successor lock
+        // means Finish either sees us and bumps the epoch, or finished first.
+        const uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        LockSuccessors(target);
+        const bool finished = target->done.load(std::memory_order_relaxed) != 0;
+        if (!finished)
+            target->waiters.fetch_add(1, std::memory_order_relaxed);
+        UnlockSuccessors(target);
+        if (!finished)
+        {
+            if (!HasWork())
+                m_epoch.wait(epoch, std::memory_order_acquire);
+            target->waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
     }
-    // Inline start
-    m_running = true;
-    for (size_t i = 0; i < workers; ++i)
-        m_workers.emplace_back([this] { WorkerLoop(); });
 }
 
-void TaskGraph::Submit(const std::function<void()>& task)
+void TaskGraph::RunParallelFor(detail::ForJob& job, size_t count)
 {
-    m_tasks.Push(task);
+    if (count == 0)
+        return;
+    job.grain = (std::max)(job.grain, size_t{1});
+    if (count <= job.grain || GetWorkerCount() == 0)
+    {
+        job.run(job.body, 0, count);
+        return;
+    }
+
+    // An outside thread borrows the external slot so its halves can be
+    // stolen; if another outside thread holds it, run serially.
+    const WorkerContext saved = t_current;
+    bool borrowed = false;
+    if (t_current.graph != this)
+    {
+        if (!m_externalSlot.try_lock())
+        {
+            job.run(job.body, 0, count);
+            return;
+        }
+        borrowed = true;
+        t_current = {this, kExternalSlot};
+    }
+
+    Deque& deque = m_slots[t_current.slot].deque;
+    const int64_t floor = deque.bottom.load(std::memory_order_relaxed);
+    job.remaining.store(count, std::memory_order_relaxed);
+    SplitRange(job, 0, count);
+    // Halves nobody stole are still above `floor`; the rest are running on
+    // other threads and finish without further help.
+    while (job.remaining.load(std::memory_order_acquire) != 0)
+    {
+        if (Task* t = deque.PopAbove(floor))
+            Execute(t);
+        else
+            std::this_thread::yield();
+    }
+
+    if (borrowed)
+    {
+        t_current = saved;
+        m_externalSlot.unlock();
+    }
+}
+
+void TaskGraph::SplitRange(detail::ForJob& job, size_t begin, size_t end)
+{
+    // Only threads with a deque split further; Stop() draining on some other
+    // thread just runs the piece.
+    if (t_current.graph == this)
+    {
+        while (end - begin > job.grain)
+        {
+            const size_t pieces = (end - begin + job.grain - 1) / job.grain;
+            const size_t mid = begin + (pieces / 2) * job.grain;
+            Task* t = detail::AllocTask();
+            detail::BindTask(t, [this, &job, mid, end] { SplitRange(job, mid, end); });
+            Enqueue(t, nullptr, 0);
+            end = mid;
+        }
+    }
+    job.run(job.body, begin, end);
+    // Last touch of `job`: the caller may return as soon as this hits zero.
+    job.remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
 }
 
 size_t TaskGraph::GetWorkerCount() const
 {
-    return m_workers.size();
+    return m_workerCount.load(std::memory_order_acquire);
 }
 
 } // namespace CoopNet
@@ -1,30 +1,209 @@
 #pragma once
+
+// Work-stealing task scheduler.
+// Each worker owns a Chase-Lev deque: it pushes and pops its own end, idle
+// workers steal the oldest task from the other end. Threads outside the graph
+// submit through a shared injection queue. Tasks live in pooled nodes with
+// inline storage for small callables, can depend on other tasks, and can be
+// awaited through a TaskHandle. Workers with nothing to do park on an event
+// count and are woken by the next submission instead of polling.
+
 #include "ThreadSafeQueue.hpp"
-#include <functional>
-#include <vector>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace CoopNet
 {
+class TaskGraph;
+
+namespace detail
+{
+constexpr size_t kTaskInlineBytes = 48;
+constexpr size_t kTaskInlineSuccessors = 4;
+
+struct Task
+{
+    // Runs the callable and destroys it; drop destroys it without running.
+    void (*invoke)(Task*);
+    void (*drop)(Task*);
+    alignas(std::max_align_t) unsigned char storage[kTaskInlineBytes];
+
+    std::atomic<uint32_t> refs;
+    std::atomic<int32_t> pending; // unfinished dependencies, +1 until submitted
+    std::atomic<uint32_t> done;
+    std::atomic<uint32_t> waiters;
+
+    std::atomic_flag successorLock;
+    uint32_t successorCount;
+    Task* successors[kTaskInlineSuccessors];
+    std::vector<Task*> moreSuccessors;
+};
+
+Task* AllocTask();
+void ReleaseTask(Task* t);
+
+template <typename F>
+void BindTask(Task* t, F&& f)
+{
+    using Fn = std::decay_t<F>;
+    if constexpr (sizeof(Fn) <= kTaskInlineBytes && alignof(Fn) <= alignof(std::max_align_t) &&
+                  std::is_nothrow_move_constructible_v<Fn>)
+    {
+        ::new (static_cast<void*>(t->storage)) Fn(std::forward<F>(f));
+        t->invoke = [](Task* self)
+        {
+            Fn* fn = std::launder(reinterpret_cast<Fn*>(self->storage));
+            (*fn)();
+            fn->~Fn();
+        };
+        t->drop = [](Task* self) { std::launder(reinterpret_cast<Fn*>(self->storage))->~Fn(); };
+    }
+    else
+    {
+        // Too big for the node: keep a pointer to a heap copy instead.
+        ::new (static_cast<void*>(t->storage)) Fn*(new Fn(std::forward<F>(f)));
+        t->invoke = [](Task* self)
+        {
+            std::unique_ptr<Fn> fn(*std::launder(reinterpret_cast<Fn**>(self->storage)));
+            (*fn)();
+        };
+        t->drop = [](Task* self) { delete *std::launder(reinterpret_cast<Fn**>(self->storage)); };
+    }
+}
+
+// State shared by the pieces of one ParallelFor; lives on the caller's stack.
+struct ForJob
+{
+    void* body;
+    void (*run)(void* body, size_t begin, size_t end);
+    size_t grain;
+    std::atomic<size_t> remaining;
+};
+} // namespace detail
+
+// Reference to a submitted task. Copyable; the task itself is recycled once
+// it has run and the last handle is gone.
+class TaskHandle
+{
+public:
+    TaskHandle() = default;
+    TaskHandle(const TaskHandle& other);
+    TaskHandle(TaskHandle&& other) noexcept;
+    TaskHandle& operator=(TaskHandle other) noexcept;
+    ~TaskHandle();
+
+    bool IsDone() const;
+    explicit operator bool() const { return m_task != nullptr; }
+
+private:
+    friend class TaskGraph;
+    explicit TaskHandle(detail::Task* task) : m_task(task) {}
+    detail::Task* m_task = nullptr;
+};
+
 class TaskGraph
 {
 public:
+    static constexpr size_t kMaxWorkers = 63;
+
     TaskGraph();
     ~TaskGraph();
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
 
     void Start(size_t workers);
+    // Joins the workers; tasks still queued are run on the calling thread.
     void Stop();
+    // Adds or retires workers without disturbing the others.
     void Resize(size_t workers);
-    void Submit(const std::function<void()>& task);
+
+    template <typename F>
+    TaskHandle Submit(F&& task)
+    {
+        return Submit(std::forward<F>(task), {});
+    }
+    // Runs `task` once every task in `deps` has finished.
+    template <typename F>
+    TaskHandle Submit(F&& task, std::initializer_list<TaskHandle> deps)
+    {
+        detail::Task* t = detail::AllocTask();
+        detail::BindTask(t, std::forward<F>(task));
+        return Enqueue(t, deps.begin(), deps.size());
+    }
+    // For dependency lists built at run time.
+    template <typename F>
+    TaskHandle Submit(F&& task, const std::vector<TaskHandle>& deps)
+    {
+        detail::Task* t = detail::AllocTask();
+        detail::BindTask(t, std::forward<F>(task));
+        return Enqueue(t, deps.data(), deps.size());
+    }
+    template <typename F>
+    TaskHandle Then(const TaskHandle& before, F&& task)
+    {
+        return Submit(std::forward<F>(task), {before});
+    }
+    // Blocks until `handle` has run, running other queued tasks meanwhile; do
+    // not call it while holding a lock those tasks may take.
+    void Wait(const TaskHandle& handle);
+
+    // Runs body(begin, end) over [0, count) in pieces of at most `grain`
+    // and returns once every piece has run. The range is split in halves on
+    // demand: the caller keeps the left half and leaves the right one on its
+    // deque for idle workers to steal. While waiting the caller only runs
+    // pieces of this range, never unrelated tasks, so it is safe to call while
+    // holding a lock; without workers it degrades to a serial loop.
+    template <typename Body>
+    void ParallelFor(size_t count, size_t grain, Body&& body)
+    {
+        using B = std::remove_reference_t<Body>;
+        detail::ForJob job;
+        job.body = const_cast<void*>(static_cast<const void*>(std::addressof(body)));
+        job.run = [](void* b, size_t begin, size_t end) { (*static_cast<B*>(b))(begin, end); };
+        job.grain = grain;
+        RunParallelFor(job, count);
+    }
+
     size_t GetWorkerCount() const;
 
 private:
-    void WorkerLoop();
+    struct Deque;
+    struct Slot;
+
+    TaskHandle Enqueue(detail::Task* t, const TaskHandle* deps, size_t depCount);
+    void Schedule(detail::Task* t);
+    void Execute(detail::Task* t);
+    void Finish(detail::Task* t);
+    detail::Task* FindWork(size_t self);
+    detail::Task* StealFrom(size_t self);
+    bool HasWork() const;
+    void WakeOne();
+    void WakeAll();
+    void WorkerLoop(size_t slot);
+    void StartWorkersLocked(size_t from, size_t to);
+    void RetireWorkersLocked(size_t from, size_t to);
+    void DrainLocked();
+    void RunParallelFor(detail::ForJob& job, size_t count);
+    void SplitRange(detail::ForJob& job, size_t begin, size_t end);
 
-    ThreadSafeQueue<std::function<void()>> m_tasks;
-    std::vector<std::jthread> m_workers;
+    // kMaxWorkers worker slots plus one borrowed by an outside thread while it
+    // runs a ParallelFor.
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<size_t> m_workerCount{0};
+    ThreadSafeQueue<detail::Task*> m_injected; // submissions from outside the graph
+    std::mutex m_externalSlot;
+    std::atomic<uint32_t> m_epoch{0};
+    std::atomic<uint32_t> m_sleepers{0};
+    std::atomic<uint32_t> m_searching{0}; // workers spinning for work, not yet parked
     std::atomic<bool> m_running{false};
     mutable std::mutex m_resizeMutex;
 };
@@ -2,6 +2,8 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <utility>
+#include <vector>
 
 namespace CoopNet
 {
@@ -13,6 +15,7 @@ private:
     std::queue<T> m_queue;
     mutable std::mutex m_mutex;
     std::condition_variable m_condition;
+    size_t m_waiters = 0; // threads inside WaitAndPop; pushes skip the notify otherwise
 
 public:
     ThreadSafeQueue() = default;
@@ -25,14 +28,16 @@ public:
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_queue.push(item);
-        m_condition.notify_one();
+        if (m_waiters != 0)
+            m_condition.notify_one();
     }
     
     void Push(T&& item)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_queue.push(std::move(item));
-        m_condition.notify_one();
+        if (m_waiters != 0)
+            m_condition.notify_one();
     }
     
     bool TryPop(T& item)
@@ -41,7 +46,7 @@ public:
         if (m_queue.empty())
             return false;
         
-        item = m_queue.front();
+        item = std::move(m_queue.front());
         m_queue.pop();
         return true;
     }
@@ -49,12 +54,14 @@ public:
     void WaitAndPop(T& item)
     {
         std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_waiters;
         while (m_queue.empty())
         {
             m_condition.wait(lock);
         }
+        --m_waiters;
         
-        item = m_queue.front();
+        item = std::move(m_queue.front());
         m_queue.pop();
     }
     
@@ -64,6 +71,24 @@ public:
         return TryPop(item);
     }
     
+    // Moves everything queued onto the end of `out` under a single lock.
+    size_t DrainTo(std::vector<T>& out)
+    {
+        std::queue<T> taken;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.swap(taken);
+        }
+        const size_t count = taken.size();
+        out.reserve(out.size() + count);
+        while (!taken.empty())
+        {
+            out.push_back(std::move(taken.front()));
+            taken.pop();
+        }
+        return count;
+    }
+
     bool Empty() const
     {
         std::lock_guard<std::mutex> lock(m_mutex);
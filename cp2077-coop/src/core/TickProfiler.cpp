@@ -0,0 +1,275 @@
+#include "TickProfiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace CoopNet
+{
+namespace detail
+{
+std::atomic<bool> g_profilerEnabled{true};
+} // namespace detail
+
+namespace
+{
+using detail::ProfileRing;
+
+struct RingSlot
+{
+    std::unique_ptr<ProfileRing> ring;
+    std::string threadName;
+    uint64_t firstEvent = 0; // head when the current owner took the ring
+};
+
+std::mutex g_ringMutex;
+std::vector<RingSlot> g_rings;
+
+// Gives the ring back when its thread exits so worker churn (TaskGraph
+// resizes) does not grow the set.
+struct RingOwner
+{
+    ProfileRing* ring = nullptr;
+    ~RingOwner()
+    {
+        if (ring)
+            ring->owned.store(false, std::memory_order_release);
+    }
+};
+thread_local RingOwner t_owner;
+
+uint64_t SteadyNs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// Clock readings taken together at start-up; a second pair at dump time
+// gives the tick rate of ProfileClock.
+const uint64_t g_baseTicks = detail::ProfileClock();
+const uint64_t g_baseNs = SteadyNs();
+
+double TicksPerNs()
+{
+#ifdef COOP_PROFILER_TSC
+    uint64_t ns = SteadyNs();
+    if (ns - g_baseNs < 20000000ull)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ns = SteadyNs();
+    }
+    const uint64_t ticks = detail::ProfileClock();
+    return static_cast<double>(ticks - g_baseTicks) / static_cast<double>(ns - g_baseNs);
+#else
+    return std::chrono::steady_clock::period::den / 1e9 / std::chrono::steady_clock::period::num;
+#endif
+}
+
+struct Collected
+{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+    uint32_t tid;
+};
+
+struct Window
+{
+    std::vector<Collected> events;
+    std::vector<std::pair<uint32_t, std::string>> threads;
+    double ticksPerNs = 1.0;
+    uint64_t startTicks = 0;
+};
+
+// Copies the events that ended after `seconds` ago out of every ring. A
+// ring's owner keeps writing meanwhile, so after the copy anything the
+// writer may have lapped (including the slot it is filling now) is dropped.
+Window Collect(float seconds)
+{
+    Window w;
+    w.ticksPerNs = TicksPerNs();
+    const uint64_t now = detail::ProfileClock();
+    const uint64_t span = static_cast<uint64_t>(static_cast<double>((std::max)(seconds, 0.f)) * 1e9 * w.ticksPerNs);
+    w.startTicks = now > span ? now - span : 0;
+
+    std::lock_guard lock(g_ringMutex);
+    for (const RingSlot& slot : g_rings)
+    {
+        ProfileRing& ring = *slot.ring;
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t from = head > detail::kProfileRingEvents ? head - detail::kProfileRingEvents : 0;
+        from = (std::max)(from, slot.firstEvent);
+        std::vector<std::pair<uint64_t, Collected>> copied;
+        copied.reserve(static_cast<size_t>(head - from));
+        for (uint64_t i = from; i < head; ++i)
+        {
+            const detail::ProfileEvent& e = ring.events[i & (detail::kProfileRingEvents - 1)];
+            copied.push_back({i,
+                              {e.name.load(std::memory_order_relaxed), e.begin.load(std::memory_order_relaxed),
+                               e.end.load(std::memory_order_relaxed), ring.tid}});
+        }
+        const uint64_t after = ring.head.load(std::memory_order_acquire);
+        const uint64_t safeFrom = after >= detail::kProfileRingEvents ? after - detail::kProfileRingEvents + 1 : 0;
+        for (const auto& [index, c] : copied)
+        {
+            if (index >= safeFrom && c.name && c.end >= w.startTicks && c.end >= c.begin)
+                w.events.push_back(c);
+        }
+        w.threads.emplace_back(ring.tid, slot.threadName);
+    }
+    return w;
+}
+
+std::string JsonEscape(const char* s)
+{
+    std::string out;
+    for (; *s; ++s)
+    {
+        if (*s == '"' || *s == '\\')
+            out.push_back('\\');
+        if (static_cast<unsigned char>(*s) >= 0x20)
+            out.push_back(*s);
+    }
+    return out;
+}
+} // namespace
+
+namespace detail
+{
+ProfileRing* AcquireProfileRing()
+{
+    std::lock_guard lock(g_ringMutex);
+    ProfileRing* ring = nullptr;
+    for (RingSlot& slot : g_rings)
+    {
+        bool expected = false;
+        if (slot.ring->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        {
+            ring = slot.ring.get();
+            slot.firstEvent = ring->head.load(std::memory_order_relaxed);
+            slot.threadName = "thread " + std::to_string(ring->tid);
+            break;
+        }
+    }
+    if (!ring)
+    {
+        RingSlot slot;
+        slot.ring = std::make_unique<ProfileRing>();
+        slot.ring->tid = static_cast<uint32_t>(g_rings.size() + 1);
+        slot.threadName = "thread " + std::to_string(slot.ring->tid);
+        ring = slot.ring.get();
+        g_rings.push_back(std::move(slot));
+    }
+    t_owner.ring = ring;
+    return ring;
+}
+} // namespace detail
+
+void TickProfiler_SetEnabled(bool enabled)
+{
+    detail::g_profilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool TickProfiler_IsEnabled()
+{
+    return detail::g_profilerEnabled.load(std::memory_order_relaxed);
+}
+
+void TickProfiler_SetThreadName(const char* name)
+{
+#if COOP_TICK_PROFILER
+    ProfileRing* ring = detail::ThisProfileRing();
+    std::lock_guard lock(g_ringMutex);
+    g_rings[ring->tid - 1].threadName = name;
+#else
+    (void)name;
+#endif
+}
+
+bool TickProfiler_WriteChromeTrace(const std::string& path, float seconds)
+{
+    const Window w = Collect(seconds);
+    std::error_code ec;
+    const auto dir = std::filesystem::path(path).parent_path();
+    if (!dir.empty())
+        std::filesystem::create_directories(dir, ec);
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    const double usPerTick = 1.0 / (w.ticksPerNs * 1000.0);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& [tid, name] : w.threads)
+    {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"" << JsonEscape(name.c_str()) << "\"}}";
+        first = false;
+    }
+    char nums[128];
+    for (const Collected& e : w.events)
+    {
+        const uint64_t begin = (std::max)(e.begin, w.startTicks);
+        std::snprintf(nums, sizeof(nums), "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+                      static_cast<double>(begin - w.startTicks) * usPerTick,
+                      static_cast<double>(e.end - begin) * usPerTick, e.tid);
+        out << (first ? "" : ",") << "\n{\"name\":\"" << JsonEscape(e.name) << "\",\"cat\":\"tick\",\"ph\":\"X\","
+            << nums << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+
+std::string TickProfiler_Summary(float seconds, size_t maxRows)
+{
+    const Window w = Collect(seconds);
+    struct Row
+    {
+        std::string name;
+        uint64_t count = 0;
+        uint64_t total = 0;
+        uint64_t worst = 0;
+    };
+    std::unordered_map<std::string, Row> byName;
+    for (const Collected& e : w.events)
+    {
+        Row& r = byName[e.name];
+        const uint64_t d = e.end - e.begin;
+        ++r.count;
+        r.total += d;
+        r.worst = (std::max)(r.worst, d);
+    }
+    std::vector<Row> rows;
+    rows.reserve(byName.size());
+    for (auto& [name, r] : byName)
+    {
+        r.name = name;
+        rows.push_back(std::move(r));
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.total > b.total; });
+
+    const double msPerTick = 1.0 / (w.ticksPerNs * 1e6);
+    char line[256];
+    std::snprintf(line, sizeof(line), "Tick profile, last %.1f s: %zu scopes on %zu thread(s)\n", seconds,
+                  w.events.size(), w.threads.size());
+    std::string out = line;
+    std::snprintf(line, sizeof(line), "  %-40s %8s %10s %9s %9s\n", "scope", "calls", "total ms", "avg us", "max us");
+    out += line;
+    for (size_t i = 0; i < rows.size() && i < maxRows; ++i)
+    {
+        const Row& r = rows[i];
+        std::snprintf(line, sizeof(line), "  %-40.40s %8llu %10.2f %9.1f %9.1f\n", r.name.c_str(),
+                      static_cast<unsigned long long>(r.count), r.total * msPerTick,
+                      r.total * msPerTick * 1000.0 / static_cast<double>(r.count), r.worst * msPerTick * 1000.0);
+        out += line;
+    }
+    return out;
+}
+} // namespace CoopNet
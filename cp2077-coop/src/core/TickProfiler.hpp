@@ -0,0 +1,135 @@
+#pragma once
+
+// Scoped tick profiler.
+// COOP_PROFILE_SCOPE("name") times the enclosing block and, when the block
+// exits, writes one event into a ring owned by the current thread: two clock
+// reads, three relaxed stores and one release store, with no locks and no
+// allocation. A scope inside another shows up nested under it in the trace.
+// Rings keep the most recent kProfileRingEvents events per thread and
+// overwrite the oldest.
+//
+// TickProfiler_WriteChromeTrace copies the last N seconds out of every ring
+// into Chrome trace JSON (chrome://tracing, Perfetto); TickProfiler_Summary
+// totals the same window per scope name. Both may run on any thread while
+// the others keep recording.
+//
+// Build with COOP_TICK_PROFILER=0 to compile every scope out;
+// TickProfiler_SetEnabled(false) turns recording off at run time.
+//
+// Names must be string literals or otherwise outlive the process: only the
+// pointer is stored.
+
+#ifndef COOP_TICK_PROFILER
+#define COOP_TICK_PROFILER 1
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define COOP_PROFILER_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COOP_PROFILER_TSC 1
+#endif
+
+namespace CoopNet
+{
+namespace detail
+{
+constexpr size_t kProfileRingEvents = 1u << 15;
+
+struct ProfileEvent
+{
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> begin{0};
+    std::atomic<uint64_t> end{0};
+};
+
+struct ProfileRing
+{
+    ProfileEvent events[kProfileRingEvents];
+    std::atomic<uint64_t> head{0}; // events ever written; slot = index % size
+    uint32_t tid = 0;
+    std::atomic<bool> owned{true};
+};
+
+extern std::atomic<bool> g_profilerEnabled;
+
+// Hands the calling thread a ring, reusing one left by an exited thread.
+ProfileRing* AcquireProfileRing();
+
+inline ProfileRing* ThisProfileRing()
+{
+    thread_local ProfileRing* ring = AcquireProfileRing();
+    return ring;
+}
+
+// Raw ticks: the TSC where there is one, steady_clock nanoseconds elsewhere.
+// Converted to time only when a trace is written.
+inline uint64_t ProfileClock()
+{
+#ifdef COOP_PROFILER_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+} // namespace detail
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name)
+    {
+        if (!detail::g_profilerEnabled.load(std::memory_order_relaxed))
+            return;
+        m_ring = detail::ThisProfileRing();
+        m_name = name;
+        m_begin = detail::ProfileClock();
+    }
+
+    ~ProfileScope()
+    {
+        if (!m_ring)
+            return;
+        const uint64_t end = detail::ProfileClock();
+        const uint64_t index = m_ring->head.load(std::memory_order_relaxed);
+        detail::ProfileEvent& e = m_ring->events[index & (detail::kProfileRingEvents - 1)];
+        e.name.store(m_name, std::memory_order_relaxed);
+        e.begin.store(m_begin, std::memory_order_relaxed);
+        e.end.store(end, std::memory_order_relaxed);
+        m_ring->head.store(index + 1, std::memory_order_release);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    detail::ProfileRing* m_ring = nullptr;
+    const char* m_name = nullptr;
+    uint64_t m_begin = 0;
+};
+
+void TickProfiler_SetEnabled(bool enabled);
+bool TickProfiler_IsEnabled();
+// Labels the calling thread in traces and summaries.
+void TickProfiler_SetThreadName(const char* name);
+// Writes every event that ended in the last `seconds`.
+bool TickProfiler_WriteChromeTrace(const std::string& path, float seconds);
+// Count, total, average and worst time per scope name over the last
+// `seconds`, busiest first.
+std::string TickProfiler_Summary(float seconds, size_t maxRows = 15);
+} // namespace CoopNet
+
+#define COOP_PROFILE_CONCAT_INNER(a, b) a##b
+#define COOP_PROFILE_CONCAT(a, b) COOP_PROFILE_CONCAT_INNER(a, b)
+#if COOP_TICK_PROFILER
+#define COOP_PROFILE_SCOPE(name) ::CoopNet::ProfileScope COOP_PROFILE_CONCAT(coopProfileScope_, __LINE__)(name)
+#else
+#define COOP_PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,208 @@
+#include "TickScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace CoopNet
+{
+namespace
+{
+#ifdef __linux__
+// Marks the timerfd in epoll_event.data; watched entries carry their fd.
+constexpr uint64_t kTimerTag = ~0ull;
+#endif
+} // namespace
+
+TickScheduler::TickScheduler(uint64_t periodNs, uint32_t maxCatchUp)
+    : m_periodNs(periodNs ? periodNs : 1), m_maxCatchUp(maxCatchUp)
+{
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC here, so its readings arm the timer as-is.
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (m_epollFd >= 0 && m_timerFd >= 0)
+    {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = kTimerTag;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_timerFd, &ev) == 0)
+            return;
+    }
+    if (m_timerFd >= 0)
+        close(m_timerFd);
+    if (m_epollFd >= 0)
+        close(m_epollFd);
+    m_timerFd = -1;
+    m_epollFd = -1;
+#endif
+}
+
+TickScheduler::~TickScheduler()
+{
+#ifdef __linux__
+    if (m_timerFd >= 0)
+        close(m_timerFd);
+    if (m_epollFd >= 0)
+        close(m_epollFd);
+#endif
+}
+
+uint64_t TickScheduler::NowNs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+bool TickScheduler::Watch(intptr_t fd, std::function<void()> onReadable)
+{
+#ifdef __linux__
+    if (m_epollFd < 0 || fd < 0)
+        return false;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = static_cast<uint64_t>(fd);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, static_cast<int>(fd), &ev) != 0)
+        return false;
+    m_watched.push_back({fd, std::move(onReadable)});
+    return true;
+#else
+    (void)fd;
+    (void)onReadable;
+    return false;
+#endif
+}
+
+void TickScheduler::Unwatch(intptr_t fd)
+{
+    auto it = std::find_if(m_watched.begin(), m_watched.end(), [fd](const Watched& w) { return w.fd == fd; });
+    if (it == m_watched.end())
+        return;
+#ifdef __linux__
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, static_cast<int>(fd), nullptr);
+#endif
+    m_watched.erase(it);
+}
+
+void TickScheduler::Reset()
+{
+    m_started = true;
+    m_baseNs = NowNs();
+    m_baseTick = 0;
+    m_nextTick = 0;
+    m_stats = {};
+    m_lateness.Reset();
+}
+
+void TickScheduler::SetPeriod(uint64_t periodNs)
+{
+    if (periodNs == 0 || periodNs == m_periodNs)
+        return;
+    if (m_started)
+    {
+        m_baseNs = Deadline(m_nextTick);
+        m_baseTick = m_nextTick;
+    }
+    m_periodNs = periodNs;
+}
+
+uint64_t TickScheduler::WaitNext()
+{
+    if (!m_started)
+        Reset();
+    uint64_t deadline = Deadline(m_nextTick);
+    uint64_t now = NowNs();
+    if (now < deadline)
+    {
+        SleepUntil(deadline);
+        now = NowNs();
+    }
+    else
+    {
+        // Already due: these run back to back. Keep the newest maxCatchUp
+        // behind this one and skip whatever is older.
+        const uint64_t backlog = (now - deadline) / m_periodNs;
+        m_stats.worstBacklog = (std::max)(m_stats.worstBacklog, static_cast<uint32_t>((std::min)(backlog, uint64_t{UINT32_MAX})));
+        if (backlog > m_maxCatchUp)
+        {
+            const uint64_t skip = backlog - m_maxCatchUp;
+            m_nextTick += skip;
+            m_stats.droppedTicks += skip;
+            deadline = Deadline(m_nextTick);
+        }
+        if (m_stats.ticks != 0)
+            ++m_stats.catchUpTicks;
+    }
+
+    const uint64_t lateNs = now > deadline ? now - deadline : 0;
+    m_lateness.Record(static_cast<float>(lateNs) / 1e6f);
+    if (lateNs >= m_periodNs)
+        ++m_stats.overrunTicks;
+    ++m_stats.ticks;
+    return m_nextTick++;
+}
+
+void TickScheduler::SleepUntil(uint64_t deadlineNs)
+{
+#ifdef __linux__
+    if (m_epollFd >= 0)
+    {
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(deadlineNs / 1000000000ull);
+        spec.it_value.tv_nsec = static_cast<long>(deadlineNs % 1000000000ull);
+        if (timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0)
+        {
+            epoll_event events[8];
+            for (;;)
+            {
+                const int n = epoll_wait(m_epollFd, events, 8, -1);
+                if (n < 0 && errno != EINTR)
+                    break;
+                bool due = false;
+                for (int i = 0; i < n; ++i)
+                {
+                    if (events[i].data.u64 == kTimerTag)
+                    {
+                        uint64_t expirations;
+                        (void)!read(m_timerFd, &expirations, sizeof(expirations));
+                        due = true;
+                        continue;
+                    }
+                    const intptr_t fd = static_cast<intptr_t>(events[i].data.u64);
+                    for (const Watched& w : m_watched)
+                    {
+                        if (w.fd == fd)
+                        {
+                            w.onReadable();
+                            break;
+                        }
+                    }
+                }
+                if (due || NowNs() >= deadlineNs)
+                    return;
+            }
+        }
+    }
+#endif
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadlineNs)));
+}
+
+std::string TickScheduler::Summary() const
+{
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "ticks=%llu overruns=%llu catch-up=%llu dropped=%llu worst-backlog=%u",
+                  static_cast<unsigned long long>(m_stats.ticks),
+                  static_cast<unsigned long long>(m_stats.overrunTicks),
+                  static_cast<unsigned long long>(m_stats.catchUpTicks),
+                  static_cast<unsigned long long>(m_stats.droppedTicks), m_stats.worstBacklog);
+    return std::string(buf) + " | lateness " + m_lateness.Summary();
+}
+} // namespace CoopNet
@@ -0,0 +1,86 @@
+#pragma once
+
+// Fixed-timestep tick scheduler.
+// Tick n is due at base + n * period, computed in integer nanoseconds, so a
+// late tick never shifts the ones after it. On Linux the wait is a one-shot
+// absolute timerfd in an epoll set that can also hold sockets: input on a
+// watched socket runs its callback and the wait resumes, and the thread is
+// idle otherwise. Elsewhere it falls back to sleep_until.
+//
+// A tick that wakes late is still handed out on its own; the ones already
+// due behind it follow back to back without waiting, so a stall is made up
+// with the same number of fixed steps. Once more than maxCatchUp deadlines
+// are overdue the oldest are dropped instead of burst.
+//
+// Not synchronized: use from the thread that ticks.
+
+#include "LatencyHistogram.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace CoopNet
+{
+struct TickSchedulerStats
+{
+    uint64_t ticks = 0;        // ticks handed out
+    uint64_t overrunTicks = 0; // started a full period or more after their deadline
+    uint64_t catchUpTicks = 0; // returned without waiting because they were already due
+    uint64_t droppedTicks = 0; // deadlines skipped after a stall longer than maxCatchUp
+    uint32_t worstBacklog = 0; // most deadlines overdue at a single wake-up
+};
+
+class TickScheduler
+{
+public:
+    explicit TickScheduler(uint64_t periodNs, uint32_t maxCatchUp = 4);
+    ~TickScheduler();
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    // Runs onReadable on the waiting thread whenever `fd` has input before
+    // the next deadline. Returns false where fds cannot be watched (non-Linux
+    // or epoll unavailable); callers then service the socket themselves.
+    bool Watch(intptr_t fd, std::function<void()> onReadable);
+    void Unwatch(intptr_t fd);
+
+    // Makes the next tick due now and clears the statistics.
+    void Reset();
+    // Applies from the next deadline on; ticks already due keep their slots.
+    void SetPeriod(uint64_t periodNs);
+
+    // Blocks until the next tick is due and returns its index.
+    uint64_t WaitNext();
+
+    uint64_t GetPeriodNs() const { return m_periodNs; }
+    const TickSchedulerStats& GetStats() const { return m_stats; }
+    // Start of each tick minus its deadline.
+    const LatencyHistogram& GetLateness() const { return m_lateness; }
+    std::string Summary() const;
+
+    static uint64_t NowNs();
+
+private:
+    uint64_t Deadline(uint64_t tick) const { return m_baseNs + (tick - m_baseTick) * m_periodNs; }
+    void SleepUntil(uint64_t deadlineNs);
+
+    struct Watched
+    {
+        intptr_t fd;
+        std::function<void()> onReadable;
+    };
+
+    uint64_t m_periodNs;
+    uint32_t m_maxCatchUp;
+    bool m_started = false;
+    uint64_t m_baseNs = 0; // deadline of m_baseTick
+    uint64_t m_baseTick = 0;
+    uint64_t m_nextTick = 0;
+    TickSchedulerStats m_stats;
+    LatencyHistogram m_lateness;
+    std::vector<Watched> m_watched;
+    int m_epollFd = -1;
+    int m_timerFd = -1;
+};
+} // namespace CoopNet
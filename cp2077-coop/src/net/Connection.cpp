@@ -7,6 +7,8 @@
 #include "../core/Hash.hpp"
 #include "../core/SessionState.hpp"
 #include "../core/Logger.hpp"
+#include "../core/Metrics.hpp"
+#include "../core/TickProfiler.hpp"
 #include "../plugin/PluginManager.hpp"
 #include <string>
 #include <algorithm>
@@ -15,6 +17,7 @@
 #include "../server/AdminCommandHandler.hpp"
 #include "../server/BreachController.hpp"
 #include "../server/ChatFilter.hpp"
+#include "../server/GrenadeController.hpp"
 #include "../server/NpcController.hpp"
 #include "../server/VehicleController.hpp"
 #include "../server/QuestWatchdog.hpp"
@@ -29,6 +32,7 @@
 #include "StatBatch.hpp"
 #include <Python.h>
 #include <RED4ext/RED4ext.hpp>
+#include <enet/enet.h>
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
@@ -39,6 +43,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <cstddef>
 #include <shared_mutex>
 #include <mutex>
 #include "../core/Red4extUtils.hpp"
@@ -1489,6 +1494,56 @@ Connection::Connection()
     crypto_kx_keypair(pubKey.data(), privKey.data());
 }
 
+Connection::RawPacket::RawPacket(RawPacket&& other) noexcept
+    : hdr(other.hdr)
+    , packet(other.packet)
+    , offset(other.offset)
+    , size(other.size)
+{
+    other.packet = nullptr;
+}
+
+Connection::RawPacket& Connection::RawPacket::operator=(RawPacket&& other) noexcept
+{
+    if (this != &other)
+    {
+        Reset();
+        hdr = other.hdr;
+        packet = other.packet;
+        offset = other.offset;
+        size = other.size;
+        other.packet = nullptr;
+    }
+    return *this;
+}
+
+Connection::RawPacket::~RawPacket()
+{
+    Reset();
+}
+
+const uint8_t* Connection::RawPacket::Payload() const
+{
+    return packet ? packet->data + offset : nullptr;
+}
+
+void Connection::RawPacket::Reset()
+{
+    if (packet)
+        enet_packet_destroy(packet);
+    packet = nullptr;
+    offset = 0;
+    size = 0;
+}
+
+Connection::~Connection()
+{
+    // Packets still queued for a peer that has gone away were never handed to ENet.
+    OutboundPacket out;
+    while (m_outgoing.TryPop(out))
+        enet_packet_destroy(out.packet);
+}
+
 void Connection::SendSectorChange(uint64_t hash)
 {
     SectorChangePacket pkt{0u, hash};
@@ -1523,6 +1578,14 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
     (void)size;
     switch (static_cast<EMsg>(hdr.type))
     {
+    case EMsg::Bundle:
+        if (!MessageBundle_ForEach(static_cast<const uint8_t*>(payload), size,
+                                   [this](const PacketHeader& inner, const uint8_t* data, uint16_t len)
+                                   { HandlePacket(inner, data, len); }))
+        {
+            std::cout << "WARN: malformed bundle peer=" << peerId << std::endl;
+        }
+        break;
     case EMsg::Hello:
         if (size >= sizeof(HelloPacket))
         {
@@ -1561,6 +1624,10 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
             const PongPacket* pkt = reinterpret_cast<const PongPacket*>(payload);
             uint64_t now = GameClock::GetTimeMs();
             rttMs = static_cast<float>(now - pkt->timeMs);
+            static auto& rttSeconds = GetMetrics().Histogram(
+                "coop_net_rtt_seconds", "Round trip time measured by ping/pong",
+                {0.01, 0.025, 0.05, 0.075, 0.1, 0.15, 0.2, 0.25, 0.35, 0.5, 1.0});
+            rttSeconds.Observe(rttMs / 1000.0);
             rttHist[rttIndex % 16] = rttMs;
             rttIndex = (rttIndex + 1) % 16;
         }
@@ -1648,31 +1715,31 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
         Killfeed_Broadcast("0 disconnected");
         break;
     case EMsg::Snapshot:
-        if (size >= sizeof(uint32_t) + sizeof(SnapshotHeader) + sizeof(SnapshotFieldFlags))
         {
-            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(payload);
-            uint32_t entId = *reinterpret_cast<const uint32_t*>(ptr);
-            SnapshotReader reader;
-            reader.Attach(ptr + sizeof(uint32_t), size - sizeof(uint32_t));
+            uint32_t entId = 0;
             TransformSnap snap{};
-            if (reader.Has(0))
-                snap.pos = reader.Read<RED4ext::Vector3>();
-            if (reader.Has(1))
-                snap.vel = reader.Read<RED4ext::Vector3>();
-            if (reader.Has(2))
-                snap.rot = reader.Read<RED4ext::Quaternion>();
-            if (reader.Has(3))
-                snap.health = reader.Read<uint16_t>();
-            if (reader.Has(4))
-                snap.armor = reader.Read<uint16_t>();
-            if (reader.Has(5))
-                snap.ownerId = reader.Read<uint32_t>();
-            if (reader.Has(6))
-                snap.seq = reader.Read<uint16_t>();
+            if (snapshotIn.Decode(reinterpret_cast<const uint8_t*>(payload), size, entId, snap) !=
+                SnapshotDecodeResult::Applied)
+                break;
             avatarPos = snap.pos;
             std::cout << "Snapshot entity=" << entId << " seq=" << snap.seq << std::endl;
         }
         break;
+    case EMsg::SnapshotDeltaAck:
+        if (size >= offsetof(SnapshotDeltaAckPacket, entries))
+        {
+            const SnapshotDeltaAckPacket* pkt = reinterpret_cast<const SnapshotDeltaAckPacket*>(payload);
+            const size_t count = std::min<size_t>({pkt->count, kMaxSnapshotAcks,
+                (size - offsetof(SnapshotDeltaAckPacket, entries)) / sizeof(SnapshotAckEntry)});
+            for (size_t i = 0; i < count; ++i)
+            {
+                const SnapshotAckEntry& e = pkt->entries[i];
+                if (snapshotOut.OnAck(e.entityId, e.snapshotId) &&
+                    (lastSnapshotId == 0 || SnapshotId_Newer(e.snapshotId, lastSnapshotId)))
+                    lastSnapshotId = e.snapshotId;
+            }
+        }
+        break;
     case EMsg::Chat:
         if (Net_IsAuthoritative())
         {
@@ -1746,7 +1813,7 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
         if (size >= sizeof(NpcSnapshotPacket))
         {
             const NpcSnapshotPacket* pkt = reinterpret_cast<const NpcSnapshotPacket*>(payload);
-            NpcProxy_ApplySnap(pkt->snap);
+            NpcProxy_ApplySnap(NpcSnapshotPacket_Unpack(*pkt));
         }
         break;
     case EMsg::NpcDespawn:
@@ -2341,8 +2408,8 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
                 break;
             LargeBlob lb{0u, 0u, {}};
             lb.data.assign(pkt->zstdBlob, pkt->zstdBlob + pkt->blobBytes);
-            m_largeBlobs.Push(lb);
             pendingLarge += 1;
+            QueueLargeBlob(std::move(lb));
             RED4EXT_EXECUTE("SyncProgress", "Show", nullptr);
         }
         break;
@@ -2668,8 +2735,8 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
                 break;
             LargeBlob lb{1u, pkt->phaseId, {}};
             lb.data.assign(pkt->zstdBlob, pkt->zstdBlob + pkt->blobBytes);
-            m_largeBlobs.Push(lb);
             pendingLarge += 1;
+            QueueLargeBlob(std::move(lb));
             RED4EXT_EXECUTE("SyncProgress", "Show", nullptr);
         }
         break;
@@ -2897,14 +2964,22 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
                 RED4EXT_EXECUTE("GrenadeSync", "OnPrime", nullptr, pkt);
         }
         break;
-    case EMsg::GrenadeSnap:
-        if (size >= sizeof(GrenadeSnapPacket))
+    case EMsg::ProjectileSpawn:
+        if (size >= sizeof(ProjectileSpawnPacket))
         {
-            const GrenadeSnapPacket* pkt = reinterpret_cast<const GrenadeSnapPacket*>(payload);
-            if (Net_IsAuthoritative())
-                Net_BroadcastGrenadeSnap(pkt->entityId, pkt->pos, pkt->vel);
-            else
-                RED4EXT_EXECUTE("GrenadeSync", "OnSnap", nullptr, pkt);
+            const ProjectileSpawnPacket* pkt = reinterpret_cast<const ProjectileSpawnPacket*>(payload);
+            CoopNet::GrenadeController_Spawn(*pkt);
+            if (!Net_IsServer())
+                RED4EXT_EXECUTE("GrenadeSync", "OnSpawn", nullptr, pkt);
+        }
+        break;
+    case EMsg::ProjectileEvent:
+        if (size >= sizeof(ProjectileEventPacket))
+        {
+            const ProjectileEventPacket* pkt = reinterpret_cast<const ProjectileEventPacket*>(payload);
+            CoopNet::GrenadeController_ApplyEvent(*pkt);
+            if (!Net_IsServer())
+                RED4EXT_EXECUTE("GrenadeSync", "OnEvent", nullptr, pkt);
         }
         break;
     case EMsg::SmartCamStart:
@@ -3039,6 +3114,20 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
             std::cout << "InterestRemove " << pkt->id << std::endl;
         }
         break;
+    case EMsg::InterestBatch:
+        if (size >= offsetof(InterestBatchPacket, ids))
+        {
+            const InterestBatchPacket* pkt = reinterpret_cast<const InterestBatchPacket*>(payload);
+            const size_t avail = (size - offsetof(InterestBatchPacket, ids)) / sizeof(uint32_t);
+            if (static_cast<size_t>(pkt->addCount) + pkt->removeCount > avail)
+                break;
+            // Client side: mirror the server's view of which NPCs we hear about.
+            for (uint16_t i = 0; i < pkt->addCount; ++i)
+                subscribedNpcs.insert(pkt->ids[i]);
+            for (uint16_t i = 0; i < pkt->removeCount; ++i)
+                subscribedNpcs.erase(pkt->ids[pkt->addCount + i]);
+        }
+        break;
     case EMsg::JoinDeny:
         std::cout << "Join denied" << std::endl;
         Transition(ConnectionState::Disconnected);
@@ -3128,7 +3217,8 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
         if (size >= sizeof(VehicleSnapshotPacket))
         {
             const VehicleSnapshotPacket* pkt = reinterpret_cast<const VehicleSnapshotPacket*>(payload);
-            RED4EXT_EXECUTE("VehicleProxy", "VehicleProxy_UpdateSnap", nullptr, 1u, &pkt->snap);
+            VehicleSnap snap = VehicleSnapshotPacket_Unpack(*pkt);
+            RED4EXT_EXECUTE("VehicleProxy", "VehicleProxy_UpdateSnap", nullptr, 1u, &snap);
         }
         break;
     case EMsg::Version:
@@ -3154,6 +3244,7 @@ void Connection::HandlePacket(const PacketHeader& hdr, const void* payload, uint
 
 void Connection::Update(uint64_t nowMs)
 {
+    COOP_PROFILE_SCOPE("Connection::Update");
     if (voiceMuted && voiceMuteEndMs > 0 && nowMs >= voiceMuteEndMs)
     {
         voiceMuted = false;
@@ -3167,10 +3258,37 @@ void Connection::Update(uint64_t nowMs)
         lastPingSent = nowMs;
     }
 
-    RawPacket pkt;
-    while (m_incoming.Pop(pkt))
     {
-        HandlePacket(pkt.hdr, pkt.data.data(), static_cast<uint16_t>(pkt.data.size()));
+        COOP_PROFILE_SCOPE("Connection::HandlePackets");
+        RawPacket pkt;
+        while (m_incoming.TryPop(pkt))
+        {
+            HandlePacket(pkt.hdr, pkt.Payload(), pkt.size);
+            pkt.Reset();
+        }
+        // Everything spilled arrived after what was in the ring. Once the
+        // spill queue is taken the network thread may use the ring again.
+        if (m_spilling.load(std::memory_order_acquire))
+        {
+            std::deque<RawPacket> spilled;
+            {
+                std::lock_guard<std::mutex> lock(m_spillMutex);
+                spilled.swap(m_spill);
+                m_spilling.store(false, std::memory_order_release);
+            }
+            for (RawPacket& p : spilled)
+                HandlePacket(p.hdr, p.Payload(), p.size);
+        }
+    }
+
+    // One ack message per tick covers every snapshot stream resolved above.
+    SnapshotDeltaAckPacket ack{};
+    ack.count = static_cast<uint8_t>(snapshotIn.TakeAcks(ack.entries, kMaxSnapshotAcks));
+    if (ack.count > 0)
+    {
+        Net_Send(this, EMsg::SnapshotDeltaAck, &ack,
+                 static_cast<uint16_t>(offsetof(SnapshotDeltaAckPacket, entries) +
+                                       ack.count * sizeof(SnapshotAckEntry)));
     }
 
     int16_t pcm[960];
@@ -3181,22 +3299,8 @@ void Connection::Update(uint64_t nowMs)
     }
 
     LargeBlob blob;
-    if (m_largeBlobs.Pop(blob))
-    {
-        if (blob.type == 0)
-            ApplyMarkerBlob(this, blob.data);
-        else if (blob.type == 1)
-            ApplyPhaseBundle(this, blob.arg, blob.data);
-        processedLarge += 1;
-        int32_t pct = 0;
-        uint8_t total = pendingLarge + pendingAssets;
-        uint8_t done = processedLarge + processedAssets;
-        if (total > 0)
-            pct = static_cast<int32_t>(done * 100 / total);
-        RED4EXT_EXECUTE("SyncProgress", "Update", nullptr, pct);
-        if (done >= total)
-            RED4EXT_EXECUTE("SyncProgress", "Hide", nullptr);
-    }
+    if (m_largeBlobs.TryPop(blob))
+        ApplyLargeBlob(blob);
 
     CoopNet::AssetStreamer::Result ar;
     if (CoopNet::GetAssetStreamer().Poll(ar))
@@ -3243,6 +3347,12 @@ void Connection::Update(uint64_t nowMs)
         s.vKbps = static_cast<uint16_t>((voiceBytes * 1000 / dt) / 1024);
         s.sKbps = static_cast<uint16_t>((snapBytes * 1000 / dt) / 1024);
         s.dropPkts = CoopVoice::ConsumeDropPct();
+        static auto& voiceTotal =
+            GetMetrics().Counter("coop_net_payload_bytes", "Payload bytes sent by kind", "kind=\"voice\"");
+        static auto& snapTotal =
+            GetMetrics().Counter("coop_net_payload_bytes", "Payload bytes sent by kind", "kind=\"snapshot\"");
+        voiceTotal.Add(voiceBytes);
+        snapTotal.Add(snapBytes);
         voiceBytes = 0;
         snapBytes = 0;
         lastStatTime = nowMs;
@@ -3253,28 +3363,67 @@ void Connection::Update(uint64_t nowMs)
     CoopNet::StatBatch_Tick(static_cast<float>(CoopNet::GameClock::GetTickMs()) / 1000.f);
 }
 
-void Connection::EnqueuePacket(const RawPacket& pkt)
+void Connection::EnqueuePacket(RawPacket&& pkt)
 {
     uint64_t now = GameClock::GetTimeMs();
     if (pkt.hdr.type != static_cast<uint16_t>(EMsg::Voice))
     {
+        // The server charges a client's bundle per message inside it, or
+        // packing hundreds into one datagram would slip past the limit.
+        float cost = 1.f;
+        if (pkt.hdr.type == static_cast<uint16_t>(EMsg::Bundle) && Net_IsServer())
+        {
+            cost = 0.f;
+            MessageBundle_ForEach(pkt.Payload(), pkt.size,
+                                  [&cost](const PacketHeader& inner, const uint8_t*, uint16_t)
+                                  {
+                                      if (inner.type != static_cast<uint16_t>(EMsg::Voice))
+                                          cost += 1.f;
+                                  });
+        }
         float dt = static_cast<float>(now - rateLastMs) / 1000.f;
         rateTokens = (std::min)(30.f, rateTokens + dt * 20.f);
         rateLastMs = now;
-        if (rateTokens < 1.f)
+        if (rateTokens < cost)
         {
             std::cout << "WARN: rate limit drop peer=" << peerId << std::endl;
             return;
         }
-        rateTokens -= 1.f;
+        rateTokens -= cost;
+    }
+    if (m_spilling.load(std::memory_order_acquire) || !m_incoming.TryPush(std::move(pkt)))
+    {
+        // The tick thread is behind by a full ring. ENet has already acked
+        // reliable packets and will not resend them, so those wait in the
+        // spill queue; only unreliable traffic may be dropped.
+        if (!pkt.packet || !(pkt.packet->flags & ENET_PACKET_FLAG_RELIABLE))
+        {
+            if (inboundDropped.fetch_add(1, std::memory_order_relaxed) % 256 == 0)
+                std::cout << "WARN: inbound ring full, dropping unreliable packets peer=" << peerId << std::endl;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_spillMutex);
+        if (m_spill.empty())
+            std::cout << "WARN: inbound ring full, spilling reliable packets peer=" << peerId << std::endl;
+        m_spill.push_back(std::move(pkt));
+        m_spilling.store(true, std::memory_order_release);
     }
-    m_incoming.Push(pkt);
     lastRecvTime = 0;
 }
 
 bool Connection::PopPacket(RawPacket& out)
 {
-    return m_incoming.Pop(out);
+    return m_incoming.TryPop(out);
+}
+
+bool Connection::QueueOutbound(ENetPacket* packet, uint8_t channel)
+{
+    return m_outgoing.TryPush(OutboundPacket{packet, channel});
+}
+
+bool Connection::PopOutbound(OutboundPacket& out)
+{
+    return m_outgoing.TryPop(out);
 }
 
 float Connection::GetAverageRtt() const
@@ -3293,32 +3442,76 @@ float Connection::GetAverageRtt() const
 }
 void Connection::RefreshNpcInterest()
 {
-    std::vector<uint32_t> ids;
-    g_interestGrid.Query(avatarPos, 80.f, ids);
-    std::unordered_set<uint32_t> newSet(ids.begin(), ids.end());
-    for (uint32_t id : newSet)
-    {
-        if (subscribedNpcs.insert(id).second)
-        {
-            InterestPacket pkt{id};
-            Net_Send(this, EMsg::InterestAdd, &pkt, sizeof(pkt));
-        }
-    }
-    for (auto it = subscribedNpcs.begin(); it != subscribedNpcs.end();)
+    std::vector<uint32_t> enter, enterOffsets, keep, keepOffsets;
+    g_interestGrid.QueryHysteresis(&avatarPos, 1, kNpcInterestEnterRadius, kNpcInterestLeaveRadius, enter,
+                                   enterOffsets, keep, keepOffsets);
+    RefreshNpcInterest(enter.data(), enter.size(), keep.data(), keep.size());
+}
+
+void Connection::RefreshNpcInterest(const uint32_t* enterIds, size_t enterCount, const uint32_t* keepIds,
+                                    size_t keepCount)
+{
+    std::vector<uint32_t> added, removed;
+    Interest_Diff(subscribedNpcs, enterIds, enterCount, keepIds, keepCount, added, removed);
+    for (uint32_t id : removed)
+        replication.Forget(ReplicationClass::Npc, id);
+    SendInterestBatch(added, removed);
+    // A stationary or dead NPC is never dirty, so newly subscribed ones are
+    // queued here or the client would never see their state.
+    NpcController_MarkForReplication(this, added.data(), added.size());
+}
+
+// Adds then removes, packed kMaxInterestBatchIds to a packet; normally one
+// packet per client per tick.
+void Connection::SendInterestBatch(const std::vector<uint32_t>& added, const std::vector<uint32_t>& removed)
+{
+    InterestBatchPacket pkt{};
+    size_t a = 0, r = 0;
+    while (a < added.size() || r < removed.size())
     {
-        if (newSet.count(*it) == 0)
+        uint16_t n = 0;
+        pkt.addCount = 0;
+        pkt.removeCount = 0;
+        while (a < added.size() && n < kMaxInterestBatchIds)
         {
-            InterestPacket pkt{*it};
-            Net_Send(this, EMsg::InterestRemove, &pkt, sizeof(pkt));
-            it = subscribedNpcs.erase(it);
+            pkt.ids[n++] = added[a++];
+            ++pkt.addCount;
         }
-        else
+        while (r < removed.size() && n < kMaxInterestBatchIds)
         {
-            ++it;
+            pkt.ids[n++] = removed[r++];
+            ++pkt.removeCount;
         }
+        Net_Send(this, EMsg::InterestBatch, &pkt,
+                 static_cast<uint16_t>(offsetof(InterestBatchPacket, ids) + n * sizeof(uint32_t)));
     }
 }
 
+void Connection::QueueLargeBlob(LargeBlob&& blob)
+{
+    // A full ring means the server sent more than Update can spread out;
+    // apply this one now rather than drop it.
+    if (!m_largeBlobs.TryPush(std::move(blob)))
+        ApplyLargeBlob(blob);
+}
+
+void Connection::ApplyLargeBlob(LargeBlob& blob)
+{
+    if (blob.type == 0)
+        ApplyMarkerBlob(this, blob.data);
+    else if (blob.type == 1)
+        ApplyPhaseBundle(this, blob.arg, blob.data);
+    processedLarge += 1;
+    int32_t pct = 0;
+    uint8_t total = pendingLarge + pendingAssets;
+    uint8_t done = processedLarge + processedAssets;
+    if (total > 0)
+        pct = static_cast<int32_t>(done * 100 / total);
+    RED4EXT_EXECUTE("SyncProgress", "Update", nullptr, pct);
+    if (done >= total)
+        RED4EXT_EXECUTE("SyncProgress", "Hide", nullptr);
+}
+
 void Connection::Transition(ConnectionState next)
 {
     std::lock_guard<std::mutex> lock(m_stateMutex);
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "MessageBundle.hpp"
 #include "Packets.hpp"
-#include "../core/ThreadSafeQueue.hpp"
+#include "ReplicationScheduler.hpp"
+#include "../core/SpscRing.hpp"
 #include "../voice/VoiceEncoder.hpp"
 #include <RED4ext/Scripting/Natives/Generated/Vector3.hpp>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <mutex>
@@ -15,6 +18,8 @@
 // Forward declaration for ENet
 struct _ENetPeer;
 typedef struct _ENetPeer ENetPeer;
+struct _ENetPacket;
+typedef struct _ENetPacket ENetPacket;
 
 namespace CoopNet
 {
@@ -30,28 +35,69 @@ enum class ConnectionState
 };
 
 // Threading:
-// - HandlePacket/EnqueuePacket are invoked from network threads.
-// - Update and other gameplay interactions run on the game thread.
+// - EnqueuePacket is invoked from the network thread (the I/O thread when
+//   Net_StartIoThread is active) and feeds the SPSC inbound ring. Reliable
+//   packets that find the ring full go to a mutex-guarded spill queue
+//   instead, and keep going there until the tick thread has caught up, so
+//   their order is kept; unreliable ones are dropped.
+// - Update drains the ring, then the spill queue, and runs HandlePacket on
+//   the game/tick thread.
+// - QueueOutbound is only called by the tick thread; the network thread
+//   drains it with PopOutbound while holding the Net mutex.
 // - State transitions are guarded by m_stateMutex.
 class Connection
 {
 public:
+    static constexpr size_t kInboundRing = 1024;
+    static constexpr size_t kOutboundRing = 1024;
+
     Connection();
+    ~Connection();
 
+    // A received message. Owns the ENetPacket it arrived in; the payload is
+    // read in place (decrypted in place when sealed) and the packet is
+    // released when the RawPacket is reset or destroyed after dispatch.
     struct RawPacket
     {
-        PacketHeader hdr;
-        std::vector<uint8_t> data;
+        PacketHeader hdr{};
+        ENetPacket* packet = nullptr;
+        uint32_t offset = 0; // payload start within packet->data
+        uint16_t size = 0;
+
+        RawPacket() = default;
+        RawPacket(const RawPacket&) = delete;
+        RawPacket& operator=(const RawPacket&) = delete;
+        RawPacket(RawPacket&& other) noexcept;
+        RawPacket& operator=(RawPacket&& other) noexcept;
+        ~RawPacket();
+
+        const uint8_t* Payload() const;
+        void Reset();
     };
 
     void StartHandshake();
     void HandlePacket(const PacketHeader& hdr, const void* payload, uint16_t size);
-    void EnqueuePacket(const RawPacket& pkt);
+    void EnqueuePacket(RawPacket&& pkt);
     void Update(uint64_t nowMs);
     void RefreshNpcInterest();
+    // Same, with the NPCs inside the enter and leave radii already queried
+    // (see InterestGrid::QueryHysteresis).
+    void RefreshNpcInterest(const uint32_t* enterIds, size_t enterCount, const uint32_t* keepIds,
+                            size_t keepCount);
+    void SendInterestBatch(const std::vector<uint32_t>& added, const std::vector<uint32_t>& removed);
 
     bool PopPacket(RawPacket& out);
 
+    struct OutboundPacket
+    {
+        ENetPacket* packet = nullptr;
+        uint8_t channel = 0;
+    };
+
+    // False when the ring is full; the caller keeps ownership of `packet`.
+    bool QueueOutbound(ENetPacket* packet, uint8_t channel);
+    bool PopOutbound(OutboundPacket& out);
+
     void SendSectorChange(uint64_t hash);
     void SendSectorReady(uint64_t hash);
 
@@ -71,17 +117,26 @@ public:
 
 private:
     void Transition(ConnectionState next);
+    struct LargeBlob;
+    void QueueLargeBlob(LargeBlob&& blob);
+    void ApplyLargeBlob(LargeBlob& blob);
 
     ConnectionState state;
     mutable std::mutex m_stateMutex;
-    ThreadSafeQueue<RawPacket> m_incoming; // avoids cross-thread deadlocks
+    SpscRing<RawPacket, kInboundRing> m_incoming;    // network thread -> tick
+    SpscRing<OutboundPacket, kOutboundRing> m_outgoing; // tick -> network thread
+    std::mutex m_spillMutex;
+    std::deque<RawPacket> m_spill;      // reliable packets that found m_incoming full
+    std::atomic<bool> m_spilling{false}; // set while m_spill must be used to keep order
     struct LargeBlob
     {
         uint8_t type; // 0 = markers, 1 = phase bundle
         uint32_t arg;
         std::vector<uint8_t> data;
     };
-    ThreadSafeQueue<LargeBlob> m_largeBlobs;
+    // Filled and drained on the tick thread, one blob per Update so a big
+    // session join does not hitch a single frame.
+    SpscRing<LargeBlob, 32> m_largeBlobs;
     uint8_t pendingLarge = 0;
     uint8_t processedLarge = 0;
     uint8_t pendingAssets = 0;
@@ -100,7 +155,16 @@ public:
     uint64_t currentSector = 0;
     bool sectorReady = true;
     uint64_t lastSectorChangeTick = 0;
+    // NPCs in this peer's interest set; on a client, the set the server
+    // last announced through InterestBatch.
     std::unordered_set<uint32_t> subscribedNpcs;
+    // Grid cell the interest set was last evaluated from.
+    int32_t interestCellX = 0;
+    int32_t interestCellY = 0;
+    bool interestCellValid = false;
+    // Another player's phase this connection is visiting (apartment guest);
+    // 0 while it is only in the shared world and its own phase.
+    uint32_t visitPhaseId = 0;
     uint64_t relayBytes = 0;
     bool usingRelay = false;
     float rttMs = 0.f;
@@ -113,13 +177,13 @@ public:
     uint32_t voiceRecv = 0;
     uint32_t voiceDropped = 0;
     uint64_t lastStatTime = 0;
-    uint32_t lastSnapshotId = 0;
+    uint32_t lastSnapshotId = 0; // newest player snapshot id this peer acknowledged
     uint64_t balance = 10000;
-    uint64_t lastNonce = 0;
+    std::atomic<uint64_t> lastNonce{0};
     uint64_t invulEndTick = 0;
 
     // NS-1: symmetric encryption key derived from DH handshake
-    bool hasKey = false;
+    std::atomic<bool> hasKey{false}; // published after `key` is written
     std::array<uint8_t, crypto_secretbox_KEYBYTES> key{};
     std::array<uint8_t, crypto_kx_PUBLICKEYBYTES> pubKey{};
     std::array<uint8_t, crypto_kx_SECRETKEYBYTES> privKey{};
@@ -131,6 +195,20 @@ public:
     // NS-3: rate limiting
     float rateTokens = 30.f;
     uint64_t rateLastMs = 0;
+    std::atomic<uint32_t> inboundDropped{0}; // unreliable packets dropped on inbound ring overflow
+
+    // NB-1: small messages waiting for the end-of-tick flush (Net_FlushBundles)
+    MessageBundler bundler;
+
+    // Per-entity TransformSnap delta streams (EMsg::Snapshot). The encoder
+    // diffs against what this peer acknowledged; the decoder resolves what it
+    // sends us and queues SnapshotDeltaAck for the next Update().
+    SnapshotDeltaEncoder snapshotOut;
+    SnapshotDeltaDecoder snapshotIn;
+
+    // Entity updates waiting for this peer's share of the replication
+    // budget (Net_FlushReplication).
+    ReplicationScheduler replication;
 };
 
 } // namespace CoopNet
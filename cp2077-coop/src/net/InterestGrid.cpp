@@ -1,34 +1,46 @@
 #include "InterestGrid.hpp"
+#include <algorithm>
 
 namespace CoopNet {
 
 void InterestGrid::Insert(uint32_t id, const RED4ext::Vector3& pos)
 {
-    std::lock_guard lock(m_mutex);
-    m_posMap[id] = pos;
-    m_grid.Insert(id, pos);
+    Move(id, pos);
 }
 
 void InterestGrid::Move(uint32_t id, const RED4ext::Vector3& pos)
 {
     std::lock_guard lock(m_mutex);
-    auto it = m_posMap.find(id);
-    if (it != m_posMap.end()) {
-        m_grid.Move(id, it->second, pos);
-        it->second = pos;
-    } else {
-        m_posMap[id] = pos;
-        m_grid.Insert(id, pos);
+    MoveLocked(id, pos);
+}
+
+void InterestGrid::MoveMany(const uint32_t* ids, const RED4ext::Vector3* pos, size_t count)
+{
+    std::lock_guard lock(m_mutex);
+    for (size_t i = 0; i < count; ++i)
+        MoveLocked(ids[i], pos[i]);
+}
+
+void InterestGrid::MoveLocked(uint32_t id, const RED4ext::Vector3& pos)
+{
+    const CellId to = m_grid.CellOf(pos);
+    CellId from;
+    if (!m_grid.Locate(id, from)) {
+        MarkDirty(to);
+    } else if (from != to) {
+        MarkDirty(from);
+        MarkDirty(to);
     }
+    m_grid.Move(id, pos);
 }
 
 void InterestGrid::Remove(uint32_t id)
 {
     std::lock_guard lock(m_mutex);
-    auto it = m_posMap.find(id);
-    if (it != m_posMap.end()) {
-        m_grid.Remove(id, it->second);
-        m_posMap.erase(it);
+    CellId from;
+    if (m_grid.Locate(id, from)) {
+        MarkDirty(from);
+        m_grid.Remove(id);
     }
 }
 
@@ -38,10 +50,66 @@ void InterestGrid::Query(const RED4ext::Vector3& center, float radius, std::vect
     m_grid.QueryCircle(center, radius, out);
 }
 
+void InterestGrid::QueryBatch(const RED4ext::Vector3* centers, size_t count, float radius,
+                              std::vector<uint32_t>& out, std::vector<uint32_t>& offsets) const
+{
+    std::lock_guard lock(m_mutex);
+    m_grid.QueryCircles(centers, count, radius, out, offsets);
+}
+
+void InterestGrid::QueryHysteresis(const RED4ext::Vector3* centers, size_t count, float enterRadius,
+                                   float leaveRadius, std::vector<uint32_t>& enterIds,
+                                   std::vector<uint32_t>& enterOffsets, std::vector<uint32_t>& keepIds,
+                                   std::vector<uint32_t>& keepOffsets) const
+{
+    std::lock_guard lock(m_mutex);
+    m_grid.QueryCircles(centers, count, enterRadius, enterIds, enterOffsets);
+    m_grid.QueryCircles(centers, count, leaveRadius, keepIds, keepOffsets);
+}
+
 size_t InterestGrid::GetSize() const
 {
     std::lock_guard lock(m_mutex);
-    return m_posMap.size();
+    return m_grid.GetSize();
+}
+
+bool InterestGrid::GetPosition(uint32_t id, RED4ext::Vector3& out) const
+{
+    std::lock_guard lock(m_mutex);
+    return m_grid.GetPosition(id, out);
+}
+
+void InterestGrid::TakeDirtyCells(std::vector<CellId>& out)
+{
+    out.clear();
+    {
+        std::lock_guard lock(m_mutex);
+        out.swap(m_dirtyCells);
+    }
+    std::sort(out.begin(), out.end(), [](const CellId& a, const CellId& b) {
+        return a.x != b.x ? a.x < b.x : a.y < b.y;
+    });
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void Interest_Diff(std::unordered_set<uint32_t>& subscribed, const uint32_t* enterIds, size_t enterCount,
+                   const uint32_t* keepIds, size_t keepCount, std::vector<uint32_t>& added,
+                   std::vector<uint32_t>& removed)
+{
+    for (size_t i = 0; i < enterCount; ++i) {
+        if (subscribed.insert(enterIds[i]).second)
+            added.push_back(enterIds[i]);
+    }
+    std::vector<uint32_t> keep(keepIds, keepIds + keepCount);
+    std::sort(keep.begin(), keep.end());
+    for (auto it = subscribed.begin(); it != subscribed.end();) {
+        if (!std::binary_search(keep.begin(), keep.end(), *it)) {
+            removed.push_back(*it);
+            it = subscribed.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 InterestGrid g_interestGrid;
@@ -1,23 +1,60 @@
 #pragma once
 #include "../core/SpatialGrid.hpp"
-#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <mutex>
 
 namespace CoopNet {
+// NPCs enter a player's interest set inside the enter radius and only leave
+// it beyond the leave radius, so entities on the boundary do not flap.
+constexpr float kNpcInterestEnterRadius = 80.f; // metres around a player's avatar
+constexpr float kNpcInterestLeaveRadius = 96.f;
+// Cell crossings drive re-evaluation; movement inside a cell is picked up by
+// a full pass this often (NPC ticks), which also resends every subscribed
+// NPC's state so a lost unreliable NpcSnapshot is repaired.
+constexpr uint32_t kNpcInterestRefreshTicks = 32;
+
 class InterestGrid {
 public:
+    using CellId = SpatialGrid::CellId;
+
     void Insert(uint32_t id, const RED4ext::Vector3& pos);
     void Move(uint32_t id, const RED4ext::Vector3& pos);
+    void MoveMany(const uint32_t* ids, const RED4ext::Vector3* pos, size_t count); // one lock for all
     void Remove(uint32_t id);
     void Query(const RED4ext::Vector3& center, float radius, std::vector<uint32_t>& out) const;
+    // One query per centre under a single lock; results for centre i are
+    // out[offsets[i] .. offsets[i + 1]).
+    void QueryBatch(const RED4ext::Vector3* centers, size_t count, float radius, std::vector<uint32_t>& out,
+                    std::vector<uint32_t>& offsets) const;
+    // Enter- and leave-radius results for the same centres from one snapshot
+    // of the grid.
+    void QueryHysteresis(const RED4ext::Vector3* centers, size_t count, float enterRadius, float leaveRadius,
+                         std::vector<uint32_t>& enterIds, std::vector<uint32_t>& enterOffsets,
+                         std::vector<uint32_t>& keepIds, std::vector<uint32_t>& keepOffsets) const;
     size_t GetSize() const;
+    bool GetPosition(uint32_t id, RED4ext::Vector3& out) const; // X/Y only
+
+    // Cells an entity entered or left since the last call (deduplicated).
+    void TakeDirtyCells(std::vector<CellId>& out);
+    CellId CellOf(const RED4ext::Vector3& pos) const { return m_grid.CellOf(pos); }
+    int32_t CellReach(float radius) const { return m_grid.CellReach(radius); }
 
 private:
+    void MoveLocked(uint32_t id, const RED4ext::Vector3& pos);
+    void MarkDirty(const CellId& cell) { m_dirtyCells.push_back(cell); } // caller holds m_mutex
+
     SpatialGrid m_grid;
-    std::unordered_map<uint32_t, RED4ext::Vector3> m_posMap;
+    std::vector<CellId> m_dirtyCells;
     mutable std::mutex m_mutex;
 };
 
+// Applies one evaluation to `subscribed`: ids inside the enter radius are
+// added, subscribed ids missing from the leave-radius set are removed. The
+// changes are appended to `added`/`removed`.
+void Interest_Diff(std::unordered_set<uint32_t>& subscribed, const uint32_t* enterIds, size_t enterCount,
+                   const uint32_t* keepIds, size_t keepCount, std::vector<uint32_t>& added,
+                   std::vector<uint32_t>& removed);
+
 extern InterestGrid g_interestGrid;
 } // namespace CoopNet
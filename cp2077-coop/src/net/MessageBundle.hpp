@@ -0,0 +1,103 @@
+#pragma once
+
+// Outbound message coalescing (NB-1).
+// Small messages queued for a peer during a tick are framed back to back as
+// [PacketHeader][payload]... and sent as one EMsg::Bundle packet per channel,
+// so the ENet header, nonce and MAC are paid once per datagram instead of once
+// per message. Lanes are keyed by ENet channel; a lane only holds messages
+// with identical ENet flags so delivery semantics are unchanged.
+//
+// Threading: owned by the tick thread (see Net_StartIoThread); not locked.
+
+#include "NetChannels.hpp"
+#include "Packets.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace CoopNet
+{
+class MessageBundler
+{
+public:
+    // Messages above this size gain little from sharing a datagram.
+    static constexpr uint16_t kMaxBundledMessage = 256;
+
+    struct Lane
+    {
+        std::vector<uint8_t> bytes;
+        uint32_t flags = 0;
+        uint16_t count = 0;
+    };
+
+    static bool IsCoalescable(EMsg type, uint16_t size)
+    {
+        return size <= kMaxBundledMessage && type != EMsg::Hello && type != EMsg::Welcome && type != EMsg::Bundle;
+    }
+
+    // True when the lane can take the message without exceeding `budget`
+    // framed bytes and without mixing delivery flags.
+    bool Fits(const NetRoute& route, uint16_t size, size_t budget) const
+    {
+        const Lane& lane = m_lanes[LaneIndex(route)];
+        if (lane.count != 0 && lane.flags != route.flags)
+            return false;
+        return lane.bytes.size() + sizeof(PacketHeader) + size <= budget;
+    }
+
+    void Append(const NetRoute& route, EMsg type, const void* data, uint16_t size)
+    {
+        Lane& lane = m_lanes[LaneIndex(route)];
+        if (lane.count == 0)
+            lane.flags = route.flags;
+        const size_t at = lane.bytes.size();
+        lane.bytes.resize(at + sizeof(PacketHeader) + size);
+        PacketHeader hdr{static_cast<uint16_t>(type), size};
+        std::memcpy(lane.bytes.data() + at, &hdr, sizeof(hdr));
+        if (size > 0 && data)
+            std::memcpy(lane.bytes.data() + at + sizeof(hdr), data, size);
+        ++lane.count;
+    }
+
+    Lane& GetLane(uint8_t channel) { return m_lanes[channel < kNetChannelCount ? channel : 0]; }
+    bool HasPending(uint8_t channel) const { return m_lanes[channel < kNetChannelCount ? channel : 0].count != 0; }
+
+    // Keeps the lane's capacity for the next tick.
+    static void Reset(Lane& lane)
+    {
+        lane.bytes.clear();
+        lane.count = 0;
+    }
+
+private:
+    static size_t LaneIndex(const NetRoute& route)
+    {
+        return route.channel < kNetChannelCount ? route.channel : 0;
+    }
+
+    std::array<Lane, kNetChannelCount> m_lanes{};
+};
+
+// Walks a received bundle. Returns false on a malformed frame; frames before
+// it have already been delivered to `fn(hdr, payload, size)`.
+template<typename Fn>
+bool MessageBundle_ForEach(const uint8_t* data, size_t size, Fn&& fn)
+{
+    size_t off = 0;
+    while (off < size)
+    {
+        if (size - off < sizeof(PacketHeader))
+            return false;
+        PacketHeader hdr;
+        std::memcpy(&hdr, data + off, sizeof(hdr));
+        off += sizeof(hdr);
+        if (hdr.size > size - off || hdr.type == static_cast<uint16_t>(EMsg::Bundle))
+            return false;
+        fn(hdr, data + off, hdr.size);
+        off += hdr.size;
+    }
+    return true;
+}
+} // namespace CoopNet
@@ -3,27 +3,47 @@
 #include "../core/GameClock.hpp"
 #include "../core/Hash.hpp"
 #include "../core/SessionState.hpp"
+#include "../physics/LagComp.hpp"
 #include <memory>
 // #include "../runtime/QuestSync.reds" // REMOVED: Cannot include .reds in C++
 #include "../server/AdminController.hpp"
 #include "../server/Journal.hpp"
+#include "../server/NpcController.hpp"
 #include "../server/PoliceDispatch.hpp"
 #include "../server/QuestWatchdog.hpp"
+#include "../server/VehicleController.hpp"
 #include "Connection.hpp"
+#include "InterestGrid.hpp"
+#include "MessageBundle.hpp"
 #include "NatClient.hpp"
+#include "NetAllocator.hpp"
 #include "../voice/VoiceEncoder.hpp"
+#include "NetChannels.hpp"
 #include "NetConfig.hpp"
+#include "NetworkOptimizer.hpp"
+#include "PeerRegistry.hpp"
+#include "PacketCrypto.hpp"
 #include "Packets.hpp"
 #include "../core/AssetStreamer.hpp"
+#include "../core/Metrics.hpp"
+#include "../core/SpscRing.hpp"
+#include "../core/TickProfiler.hpp"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <deque>
 #include <enet/enet.h>
 #include <iostream>
 #include <new>
+#include <optional>
 #include <sodium.h>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 #include <mutex>
+#include <system_error>
+#include <thread>
 
 using CoopNet::Connection;
 using CoopNet::EMsg;
@@ -167,7 +187,6 @@ using CoopNet::CarryBeginPacket;
 using CoopNet::CarrySnapPacket;
 using CoopNet::CarryEndPacket;
 using CoopNet::GrenadePrimePacket;
-using CoopNet::GrenadeSnapPacket;
 using CoopNet::SmartCamStartPacket;
 using CoopNet::SmartCamEndPacket;
 using CoopNet::ArcadeStartPacket;
@@ -207,36 +226,303 @@ namespace QuestSync {
 
 namespace
 {
-struct PeerEntry
-{
-    ENetPeer* peer;
-    CoopNet::Connection* conn;
-    uint32_t peerId;
-};
+using CoopNet::PeerEntry;
 
 ENetHost* g_Host = nullptr;
-std::vector<PeerEntry> g_Peers;
+std::atomic<bool> g_isServer{false}; // g_Host was created by Net_StartServer
+CoopNet::PeerRegistry g_Peers;
 static uint32_t g_nextPeerId = 1;
-static uint32_t g_nextSnapshotId = 1;
 static uint32_t g_MaxPlayers = 0;
 static std::string g_ServerPassword;
 
-// Thread safety protection for networking globals
-std::mutex g_NetMutex;
+// Guards g_Host, g_Peers and g_nextPeerId. Recursive because broadcast
+// helpers hold it while calling Net_Send.
+std::recursive_mutex g_NetMutex;
+using NetLock = std::lock_guard<std::recursive_mutex>;
+
+// Network I/O thread (Net_StartIoThread). While it runs it owns
+// enet_host_service, inbound decrypt and enet_peer_send; joins and leaves are
+// handed to the tick thread through g_ioEvents so Connection lifetime and
+// gameplay callbacks stay on the tick thread.
+struct NetIoEvent
+{
+    enum class Kind : uint8_t
+    {
+        Join,
+        Leave
+    };
+    Kind kind;
+    Connection* conn;
+};
+
+std::thread g_ioThread;
+std::atomic<bool> g_ioRunning{false};
+uint32_t g_ioWaitMs = 1;
+CoopNet::SpscRing<NetIoEvent, 256> g_ioEvents;
+std::deque<NetIoEvent> g_ioBacklog; // I/O thread overflow for g_ioEvents
+thread_local bool t_isTickThread = false;
+
+bool UseOutboundRing()
+{
+    return t_isTickThread && g_ioRunning.load(std::memory_order_acquire);
+}
+
+// Traffic counters reported through Net_GetTrafficStats and /metrics. They
+// are bumped from the tick and I/O threads, so each lives in the sharded
+// metrics registry rather than in one shared atomic.
+struct TrafficCounters
+{
+    CoopNet::MetricCounter& packetsOut =
+        CoopNet::GetMetrics().Counter("coop_net_sent_packets", "ENet packets handed to peers");
+    CoopNet::MetricCounter& bytesOut = CoopNet::GetMetrics().Counter("coop_net_sent_bytes", "Bytes handed to peers");
+    CoopNet::MetricCounter& packetsIn =
+        CoopNet::GetMetrics().Counter("coop_net_received_packets", "ENet packets received from peers");
+    CoopNet::MetricCounter& bytesIn =
+        CoopNet::GetMetrics().Counter("coop_net_received_bytes", "Bytes received from peers");
+    CoopNet::MetricCounter& messagesOut =
+        CoopNet::GetMetrics().Counter("coop_net_sent_messages", "Logical messages sent, before coalescing");
+    CoopNet::MetricCounter& bundledMessages =
+        CoopNet::GetMetrics().Counter("coop_net_bundled_messages", "Messages that travelled inside a bundle");
+    CoopNet::MetricCounter& bundlesOut = CoopNet::GetMetrics().Counter("coop_net_sent_bundles", "Bundles sent");
+    CoopNet::MetricCounter& sealsOut =
+        CoopNet::GetMetrics().Counter("coop_net_seals", "secretbox operations on the send path");
+};
+TrafficCounters g_traffic;
+
+inline void CountTraffic(CoopNet::MetricCounter& counter, uint64_t n = 1)
+{
+    counter.Add(n);
+}
+
+inline void CountTraffic(std::atomic<uint64_t>& counter, uint64_t n = 1)
+{
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+// Relevance-filter counters reported through Net_GetBroadcastFilterStats,
+// indexed by EMsg value.
+struct BroadcastFilterCounters
+{
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> avoided{0};
+};
+constexpr size_t kBroadcastFilterSlots = 512;
+BroadcastFilterCounters g_broadcastFilter[kBroadcastFilterSlots];
+
+// enet_peer_send leaves the packet with the caller when it fails.
+void PeerSend(ENetPeer* peer, uint8_t channel, ENetPacket* pkt)
+{
+    if (channel >= peer->channelCount)
+        channel = 0; // peer negotiated fewer channels
+    const size_t bytes = pkt->dataLength;
+    if (enet_peer_send(peer, channel, pkt) < 0)
+    {
+        if (pkt->referenceCount == 0)
+            enet_packet_destroy(pkt);
+        return;
+    }
+    CountTraffic(g_traffic.packetsOut);
+    CountTraffic(g_traffic.bytesOut, bytes);
+}
+
+// Hands everything the tick thread queued for this peer to ENet. Callers hold
+// g_NetMutex, which also serializes the ring's consumer side.
+void FlushOutbound(PeerEntry& e)
+{
+    Connection::OutboundPacket out;
+    while (e.conn->PopOutbound(out))
+        PeerSend(e.peer, out.channel, out.packet);
+}
+
+// Per-thread serialization buffer reused by variable-length broadcast helpers.
+std::vector<uint8_t>& NetScratch(size_t bytes)
+{
+    thread_local std::vector<uint8_t> scratch;
+    if (scratch.size() < bytes)
+        scratch.resize(bytes);
+    return scratch;
+}
+
+// Frames and (when keyed) seals the payload directly into the ENet packet
+// buffer, then queues it on the peer. No intermediate buffers are used.
+// On the tick thread with the I/O thread running the packet goes through the
+// connection's outbound ring instead and `peer` is not touched.
+void SendToPeer(ENetPeer* peer, CoopNet::Connection* conn, CoopNet::EMsg type, const void* data, uint16_t size,
+                const CoopNet::NetRoute& route)
+{
+    const bool ring = UseOutboundRing();
+    if (!conn || (!peer && !ring))
+        return;
+    const bool encrypt = conn->hasKey && type != CoopNet::EMsg::Hello && type != CoopNet::EMsg::Welcome;
+    const size_t wireSize = encrypt ? CoopNet::PacketCrypto_SealedSize(size) : size;
+    if (wireSize > UINT16_MAX)
+    {
+        std::cerr << "[Net] payload too large for type " << static_cast<uint16_t>(type) << std::endl;
+        return;
+    }
+    ENetPacket* pkt = enet_packet_create(nullptr, sizeof(CoopNet::PacketHeader) + wireSize, route.flags);
+    if (!pkt)
+        return;
+    CoopNet::PacketHeader hdr{static_cast<uint16_t>(type), static_cast<uint16_t>(wireSize)};
+    std::memcpy(pkt->data, &hdr, sizeof(hdr));
+    uint8_t* body = pkt->data + sizeof(hdr);
+    if (encrypt)
+    {
+        uint32_t nonce = static_cast<uint32_t>(conn->lastNonce.fetch_add(1, std::memory_order_relaxed));
+        CoopNet::PacketCrypto_SealInto(body, nonce, data, size, conn->key.data());
+        CountTraffic(g_traffic.sealsOut);
+    }
+    else if (size > 0 && data)
+    {
+        std::memcpy(body, data, size);
+    }
+    if (!ring)
+    {
+        PeerSend(peer, route.channel, pkt);
+        return;
+    }
+    if (conn->QueueOutbound(pkt, route.channel))
+        return;
+    // Ring full: drain it ourselves under the lock so per-channel order holds.
+    NetLock lock(g_NetMutex);
+    PeerEntry* e = g_Peers.FindByConn(conn);
+    if (!e)
+    {
+        enet_packet_destroy(pkt); // peer already left
+        return;
+    }
+    FlushOutbound(*e);
+    PeerSend(e->peer, route.channel, pkt);
+}
+
+// ENet protocol header plus a reliable send command, with some slack.
+constexpr size_t kEnetDatagramOverhead = 48;
+
+// Largest framed bundle that still fits one datagram at the peer's MTU.
+size_t BundleBudget(const Connection* conn)
+{
+    const size_t mtu = (conn->peer && conn->peer->mtu) ? conn->peer->mtu : static_cast<size_t>(ENET_HOST_DEFAULT_MTU);
+    const size_t overhead =
+        kEnetDatagramOverhead + sizeof(CoopNet::PacketHeader) + (conn->hasKey ? CoopNet::kSealOverhead : 0);
+    return mtu > overhead ? mtu - overhead : 0;
+}
+
+// Sends whatever one lane of conn's bundler holds. A lone message goes out
+// as itself; two or more become one sealed EMsg::Bundle. `peer` may be null,
+// in which case it is resolved here unless the outbound ring is in use.
+void FlushLane(Connection* conn, ENetPeer* peer, uint8_t channel)
+{
+    CoopNet::MessageBundler::Lane& lane = conn->bundler.GetLane(channel);
+    if (lane.count == 0)
+        return;
+    const CoopNet::NetRoute route{channel, lane.flags};
+    std::optional<NetLock> held;
+    if (!peer && !UseOutboundRing())
+    {
+        held.emplace(g_NetMutex);
+        PeerEntry* e = g_Peers.FindByConn(conn);
+        peer = e ? e->peer : nullptr;
+    }
+    if (peer || UseOutboundRing())
+    {
+        if (lane.count == 1)
+        {
+            PacketHeader hdr;
+            std::memcpy(&hdr, lane.bytes.data(), sizeof(hdr));
+            SendToPeer(peer, conn, static_cast<EMsg>(hdr.type), lane.bytes.data() + sizeof(hdr), hdr.size, route);
+        }
+        else
+        {
+            SendToPeer(peer, conn, EMsg::Bundle, lane.bytes.data(), static_cast<uint16_t>(lane.bytes.size()), route);
+            CountTraffic(g_traffic.bundlesOut);
+            CountTraffic(g_traffic.bundledMessages, lane.count);
+        }
+    }
+    CoopNet::MessageBundler::Reset(lane);
+}
+
+// Entry point for every logical outbound message. On the tick thread small
+// messages are held in the connection's bundler until Net_FlushBundles;
+// anything else flushes its channel's lane first so per-channel order holds.
+void Deliver(ENetPeer* peer, Connection* conn, EMsg type, const void* data, uint16_t size,
+             const CoopNet::NetRoute& route)
+{
+    CountTraffic(g_traffic.messagesOut);
+    if (!t_isTickThread)
+    {
+        SendToPeer(peer, conn, type, data, size, route);
+        return;
+    }
+    CoopNet::MessageBundler& bundler = conn->bundler;
+    if (CoopNet::MessageBundler::IsCoalescable(type, size))
+    {
+        const size_t budget = BundleBudget(conn);
+        if (!bundler.Fits(route, size, budget))
+            FlushLane(conn, peer, route.channel);
+        if (bundler.Fits(route, size, budget))
+        {
+            bundler.Append(route, type, data, size);
+            return;
+        }
+    }
+    else if (bundler.HasPending(route.channel))
+    {
+        FlushLane(conn, peer, route.channel);
+    }
+    SendToPeer(peer, conn, type, data, size, route);
+}
+
+// Latest player transforms awaiting their replication slot; written by
+// Net_BroadcastPlayerUpdate, read by ReplicatePlayer. Never held together
+// with g_NetMutex.
+std::mutex g_replMutex;
+std::unordered_map<uint32_t, CoopNet::TransformSnap> g_replPlayers;
+std::chrono::steady_clock::time_point g_replLastFlush{};
+constexpr float kReplicationDefaultDt = 1.f / 30.f;
+constexpr float kReplicationMaxDt = 0.25f;  // after a stall, don't grant a burst
+constexpr uint16_t kPlayerReplicationHint = 32; // typical delta incl. entity prefix
+
+// Sends `peerId`'s latest transform to `conn`, delta-encoded against the
+// baseline that peer last acknowledged. Returns bytes sent, 0 if the player
+// is gone.
+size_t ReplicatePlayer(Connection* conn, uint32_t peerId)
+{
+    CoopNet::TransformSnap snap;
+    {
+        std::lock_guard<std::mutex> lock(g_replMutex);
+        auto it = g_replPlayers.find(peerId);
+        if (it == g_replPlayers.end())
+            return 0;
+        snap = it->second;
+    }
+    const CoopNet::NetRoute route = CoopNet::NetChannel_Route(EMsg::Snapshot);
+    uint8_t buf[CoopNet::SnapshotDeltaEncoder::kMaxMessage];
+    NetLock lock(g_NetMutex);
+    PeerEntry* e = g_Peers.FindByConn(conn);
+    if (!g_Host || !e)
+        return 0;
+    const size_t bytes = conn->snapshotOut.Encode(peerId, snap, buf, sizeof(buf));
+    if (bytes == 0)
+        return 0;
+    conn->snapBytes += bytes;
+    Deliver(e->peer, conn, EMsg::Snapshot, buf, static_cast<uint16_t>(bytes), route);
+    return bytes;
+}
 
 // Helper used by world streaming to match sector hashing in the game.
 } // namespace
 
 void Net_Init()
 {
-    if (enet_initialize() != 0)
+    // Route ENet's packet and bookkeeping allocations through the slab pools.
+    if (enet_initialize_with_callbacks(ENET_VERSION, &CoopNet::NetAlloc_EnetCallbacks()) != 0)
     {
         std::cout << "enet_initialize failed" << std::endl;
         return;
     }
 
-    std::lock_guard<std::mutex> lock(g_NetMutex);
-    g_Host = enet_host_create(nullptr, 8, 2, 0, 0);
+    NetLock lock(g_NetMutex);
+    g_Host = enet_host_create(nullptr, 8, CoopNet::kNetChannelCount, 0, 0);
     Nat_SetCandidateCallback(
         [](const char* cand)
         {
@@ -245,23 +531,27 @@ void Net_Init()
         });
     CoopNet::Nat_Start();
     CoopNet::GetAssetStreamer().Start();
+    CoopNet::GetMetrics().GaugeFn("coop_players_connected", "Connected peers",
+                                  [] { return static_cast<double>(Net_GetConnections().size()); });
     std::cout << "Net_Init complete" << std::endl;
 }
 
 void Net_Shutdown()
 {
-    std::lock_guard<std::mutex> lock(g_NetMutex);
-    for (auto& e : g_Peers)
+    Net_StopIoThread();
+    NetLock lock(g_NetMutex);
+    for (auto& e : g_Peers.Entries())
     {
         delete e.conn;
     }
-    g_Peers.clear();
+    g_Peers.Clear();
 
     if (g_Host)
     {
         enet_host_destroy(g_Host);
         g_Host = nullptr;
     }
+    g_isServer.store(false, std::memory_order_release);
 
     CoopNet::GetAssetStreamer().Stop();
 
@@ -269,179 +559,392 @@ void Net_Shutdown()
     std::cout << "Net_Shutdown complete" << std::endl;
 }
 
-void Net_Poll(uint32_t maxMs)
+namespace
 {
-    if (!g_Host)
+// Network-side half of a connect: allocate and register the Connection so
+// inbound packets can be routed to it. Runs wherever ENet is serviced.
+Connection* AcceptPeer(ENetPeer* peer)
+{
+    if (!peer) {
+        std::cerr << "[Net] Connect event with null peer" << std::endl;
+        return nullptr;
+    }
+
+    Connection* conn = new(std::nothrow) Connection();
+    if (!conn) {
+        std::cerr << "[Net] Failed to allocate Connection object" << std::endl;
+        enet_peer_disconnect(peer, 0);
+        return nullptr;
+    }
+    conn->peerId = g_nextPeerId++;
+    conn->peer = peer;  // Link connection to ENet peer
+    conn->SetState(CoopNet::ConnectionState::Handshaking);
+
+    g_Peers.Add(peer, conn, conn->peerId);
+    std::cout << "[Net] Peer connected ID=" << conn->peerId << std::endl;
+
+    // Set connection to connected state
+    conn->SetState(CoopNet::ConnectionState::Connected);
+    return conn;
+}
+
+// Gameplay-side half of a connect; runs on the tick thread.
+void OnPeerJoined(Connection* conn)
+{
+    // Check if player is banned; the pending disconnect event releases conn.
+    if (Net_IsPlayerBanned(conn->peerId))
+    {
+        std::cout << "[Net] Rejected banned player ID " << conn->peerId << std::endl;
+        Net_Disconnect(conn);
         return;
+    }
+
+    // Initialize player synchronization
+    Net_HandlePlayerJoin(conn->peerId, "Player_" + std::to_string(conn->peerId));
+}
+
+// Unregisters the peer so no further packets are routed to its Connection.
+Connection* DetachPeer(ENetPeer* peer)
+{
+    if (!peer) {
+        std::cerr << "[Net] Disconnect event with null peer" << std::endl;
+        return nullptr;
+    }
 
-    ENetEvent evt;
-    int wait = static_cast<int>(maxMs);
-    while (enet_host_service(g_Host, &evt, wait) > 0)
+    PeerEntry* e = g_Peers.FromPeer(peer);
+    if (!e)
     {
-        wait = 0; // subsequent polls are non-blocking
-        switch (evt.type)
-        {
-        case ENET_EVENT_TYPE_CONNECT:
-        {
-            if (!evt.peer) {
-                std::cerr << "[Net] Connect event with null peer" << std::endl;
-                break;
-            }
-            
-            PeerEntry e;
-            e.peer = evt.peer;
-            e.conn = new(std::nothrow) Connection();
-            if (!e.conn) {
-                std::cerr << "[Net] Failed to allocate Connection object" << std::endl;
-                enet_peer_disconnect(evt.peer, 0);
-                break;
-            }
-            {
-                std::lock_guard<std::mutex> lock(g_NetMutex);
-                e.conn->peerId = g_nextPeerId++;
-            }
-            e.conn->peer = evt.peer;  // Link connection to ENet peer
-            e.conn->SetState(CoopNet::ConnectionState::Handshaking);
+        std::cout << "[Net] Unknown peer disconnected" << std::endl;
+        return nullptr;
+    }
+    const CoopNet::PeerRegistry::Handle h = CoopNet::PeerRegistry::DecodeHandle(peer->data);
+    Connection* conn = e->conn;
+    g_Peers.Remove(h);
+    return conn;
+}
 
-            // Check if player is banned
-            if (Net_IsPlayerBanned(e.conn->peerId))
-            {
-                std::cout << "[Net] Rejected banned player ID " << e.conn->peerId << std::endl;
-                enet_peer_disconnect(evt.peer, 0);
-                delete e.conn;
-            }
-            else
-            {
-                {
-                    std::lock_guard<std::mutex> lock(g_NetMutex);
-                    g_Peers.push_back(e);
-                }
-                std::cout << "[Net] Peer connected ID=" << e.conn->peerId << std::endl;
+// Tick-thread half of a disconnect; owns the final delete.
+void OnPeerLeft(Connection* conn)
+{
+    uint32_t peerId = conn->peerId;
+    std::cout << "[Net] Peer disconnected ID=" << peerId << std::endl;
 
-                // Set connection to connected state
-                e.conn->SetState(CoopNet::ConnectionState::Connected);
+    // Handle player leave with synchronization
+    Net_HandlePlayerLeave(peerId, "Connection lost");
 
-                // Initialize player synchronization
-                Net_HandlePlayerJoin(e.conn->peerId, "Player_" + std::to_string(e.conn->peerId));
+    // Drop the departed player's snapshot streams on everyone else.
+    {
+        std::lock_guard<std::mutex> lock(g_replMutex);
+        g_replPlayers.erase(peerId);
+    }
+    CoopNet::g_lagComp.Remove(peerId);
+    {
+        NetLock lock(g_NetMutex);
+        for (auto& e : g_Peers.Entries())
+        {
+            if (e.conn && e.conn != conn)
+            {
+                e.conn->snapshotOut.Forget(peerId);
+                e.conn->snapshotIn.Forget(peerId);
             }
-            break;
         }
-        case ENET_EVENT_TYPE_DISCONNECT:
+    }
+
+    delete conn;
+}
+
+// Takes ownership of `packet`. The packet itself travels to the tick thread
+// inside the RawPacket; sealed payloads are decrypted in place, so nothing is
+// allocated or copied per message.
+void HandleReceive(ENetPeer* peer, ENetPacket* packet)
+{
+    Connection::RawPacket pkt;
+    pkt.packet = packet; // released on every early return below
+    if (!packet->data) {
+        std::cerr << "[Net] Receive event with null packet data" << std::endl;
+        return;
+    }
+    CountTraffic(g_traffic.packetsIn);
+    CountTraffic(g_traffic.bytesIn, packet->dataLength);
+    if (packet->dataLength < sizeof(CoopNet::PacketHeader)) {
+        std::cerr << "[Net] Packet too small: " << packet->dataLength
+                  << " < " << sizeof(CoopNet::PacketHeader) << std::endl;
+        return;
+    }
+    const size_t psize = packet->dataLength - sizeof(CoopNet::PacketHeader);
+    if (psize > UINT16_MAX)
+        return;
+    PeerEntry* e = g_Peers.FromPeer(peer);
+    if (!e || !e->conn)
+        return;
+    Connection* conn = e->conn;
+
+    std::memcpy(&pkt.hdr, packet->data, sizeof(pkt.hdr));
+    uint8_t* payload = packet->data + sizeof(CoopNet::PacketHeader);
+    pkt.offset = sizeof(CoopNet::PacketHeader);
+    pkt.size = static_cast<uint16_t>(psize);
+    if (conn->hasKey && pkt.hdr.type != static_cast<uint16_t>(CoopNet::EMsg::Hello) &&
+        pkt.hdr.type != static_cast<uint16_t>(CoopNet::EMsg::Welcome))
+    {
+        if (psize < CoopNet::kSealOverhead)
+            return;
+        uint32_t nonce;
+        memcpy(&nonce, payload, 4);
+        if (conn->nonceSet.count(nonce))
+            return;
+        conn->nonceWindow.push_back(nonce);
+        conn->nonceSet.insert(nonce);
+        if (conn->nonceWindow.size() > 1024)
         {
-            if (!evt.peer) {
-                std::cerr << "[Net] Disconnect event with null peer" << std::endl;
-                break;
-            }
-            
-            auto it =
-                std::find_if(g_Peers.begin(), g_Peers.end(), [&](const PeerEntry& p) { return p.peer == evt.peer; });
-            if (it != g_Peers.end())
-            {
-                if (it->conn) {
-                    uint32_t peerId = it->conn->peerId;
-                    std::cout << "[Net] Peer disconnected ID=" << peerId << std::endl;
+            uint32_t old = conn->nonceWindow.front();
+            conn->nonceWindow.pop_front();
+            conn->nonceSet.erase(old);
+        }
+        if (!CoopNet::PacketCrypto_OpenInPlace(payload, psize, conn->key.data()))
+            return;
+        pkt.offset += static_cast<uint32_t>(CoopNet::kSealOverhead);
+        pkt.size = static_cast<uint16_t>(psize - CoopNet::kSealOverhead);
+    }
+    conn->EnqueuePacket(std::move(pkt));
+}
+
+void DispatchIoEvents()
+{
+    NetIoEvent ev;
+    while (g_ioEvents.TryPop(ev))
+    {
+        if (ev.kind == NetIoEvent::Kind::Join)
+            OnPeerJoined(ev.conn);
+        else
+            OnPeerLeft(ev.conn);
+    }
+}
 
-                    // Handle player leave with synchronization
-                    Net_HandlePlayerLeave(peerId, "Connection lost");
+void PostIoEvent(NetIoEvent::Kind kind, Connection* conn)
+{
+    if (!conn)
+        return;
+    g_ioBacklog.push_back({kind, conn});
+}
 
-                    delete it->conn;
-                }
+void IoThreadMain()
+{
+    CoopNet::TickProfiler_SetThreadName("net io");
+    while (g_ioRunning.load(std::memory_order_acquire))
+    {
+        ENetSocket socket = ENET_SOCKET_NULL;
+        {
+            COOP_PROFILE_SCOPE("Net_IoService");
+            NetLock lock(g_NetMutex);
+            if (g_Host)
+            {
+                for (auto& e : g_Peers.Entries())
+                    FlushOutbound(e);
+                ENetEvent evt;
+                while (enet_host_service(g_Host, &evt, 0) > 0)
                 {
-                    std::lock_guard<std::mutex> lock(g_NetMutex);
-                    g_Peers.erase(it);
+                    switch (evt.type)
+                    {
+                    case ENET_EVENT_TYPE_CONNECT:
+                        PostIoEvent(NetIoEvent::Kind::Join, AcceptPeer(evt.peer));
+                        break;
+                    case ENET_EVENT_TYPE_DISCONNECT:
+                        PostIoEvent(NetIoEvent::Kind::Leave, DetachPeer(evt.peer));
+                        break;
+                    case ENET_EVENT_TYPE_RECEIVE:
+                        if (evt.packet)
+                            HandleReceive(evt.peer, evt.packet); // takes ownership
+                        break;
+                    default:
+                        break;
+                    }
                 }
+                enet_host_flush(g_Host);
+                socket = g_Host->socket;
             }
-            else
-            {
-                std::cout << "[Net] Unknown peer disconnected" << std::endl;
-            }
-            break;
         }
-        case ENET_EVENT_TYPE_RECEIVE:
+        while (!g_ioBacklog.empty() && g_ioEvents.TryPush(g_ioBacklog.front()))
+            g_ioBacklog.pop_front();
+
+        if (socket == ENET_SOCKET_NULL)
         {
-            if (!evt.packet) {
-                std::cerr << "[Net] Receive event with null packet" << std::endl;
-                break;
-            }
-            if (!evt.packet->data) {
-                std::cerr << "[Net] Receive event with null packet data" << std::endl;
-                enet_packet_destroy(evt.packet);
-                break;
-            }
-            if (evt.packet->dataLength < sizeof(CoopNet::PacketHeader)) {
-                std::cerr << "[Net] Packet too small: " << evt.packet->dataLength 
-                          << " < " << sizeof(CoopNet::PacketHeader) << std::endl;
-                enet_packet_destroy(evt.packet);
-                break;
-            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(g_ioWaitMs));
+            continue;
+        }
+        // Wake on inbound datagrams; the timeout bounds outbound latency.
+        enet_uint32 cond = ENET_SOCKET_WAIT_RECEIVE;
+        enet_socket_wait(socket, &cond, g_ioWaitMs);
+    }
+}
+} // namespace
+
+bool Net_StartIoThread(uint32_t waitMs)
+{
+    if (g_ioRunning.load())
+        return true;
+    g_ioWaitMs = waitMs ? waitMs : 1;
+    t_isTickThread = true;
+    g_ioRunning.store(true, std::memory_order_release);
+    try
+    {
+        g_ioThread = std::thread(IoThreadMain);
+    }
+    catch (const std::system_error& ex)
+    {
+        g_ioRunning.store(false, std::memory_order_release);
+        t_isTickThread = false;
+        std::cerr << "[Net] I/O thread failed to start: " << ex.what() << std::endl;
+        return false;
+    }
+    std::cout << "[Net] I/O thread started" << std::endl;
+    return true;
+}
+
+void Net_StopIoThread()
+{
+    if (!g_ioRunning.exchange(false))
+        return;
+    if (g_ioThread.joinable())
+        g_ioThread.join();
+
+    // Settle joins and leaves that were handed over but not yet dispatched,
+    // then send any bundles still held for registered peers.
+    DispatchIoEvents();
+    Net_FlushBundles();
+    t_isTickThread = false;
+    for (auto& ev : g_ioBacklog)
+    {
+        if (ev.kind == NetIoEvent::Kind::Leave)
+            OnPeerLeft(ev.conn);
+    }
+    g_ioBacklog.clear();
+    NetLock lock(g_NetMutex);
+    for (auto& e : g_Peers.Entries())
+        FlushOutbound(e);
+    std::cout << "[Net] I/O thread stopped" << std::endl;
+}
+
+bool Net_IsIoThreadRunning()
+{
+    return g_ioRunning.load(std::memory_order_acquire);
+}
+
+void Net_FlushBundles()
+{
+    if (!t_isTickThread)
+        return; // bundling only happens on the tick thread
+    COOP_PROFILE_SCOPE("Net_FlushBundles");
+    for (Connection* conn : Net_GetConnections())
+    {
+        for (uint8_t ch = 0; ch < CoopNet::kNetChannelCount; ++ch)
+            FlushLane(conn, nullptr, ch);
+    }
+}
+
+CoopNet::NetTrafficStats Net_GetTrafficStats()
+{
+    CoopNet::NetTrafficStats s{};
+    s.packetsOut = g_traffic.packetsOut.Value();
+    s.bytesOut = g_traffic.bytesOut.Value();
+    s.packetsIn = g_traffic.packetsIn.Value();
+    s.bytesIn = g_traffic.bytesIn.Value();
+    s.messagesOut = g_traffic.messagesOut.Value();
+    s.bundledMessages = g_traffic.bundledMessages.Value();
+    s.bundlesOut = g_traffic.bundlesOut.Value();
+    s.sealsOut = g_traffic.sealsOut.Value();
+    return s;
+}
+
+void Net_Poll(uint32_t maxMs)
+{
+    COOP_PROFILE_SCOPE("Net_Poll");
+    if (g_ioRunning.load(std::memory_order_acquire))
+    {
+        // The I/O thread services ENet; the tick thread only picks up joins
+        // and leaves. Packets wait in each Connection's ring for Update.
+        DispatchIoEvents();
+        return;
+    }
+
+    // Service the host under g_NetMutex without blocking; the optional wait
+    // happens on the socket with the lock released so senders are not stalled.
+    uint32_t wait = maxMs;
+    for (;;)
+    {
+        ENetSocket socket;
+        {
+            NetLock lock(g_NetMutex);
+            if (!g_Host)
+                return;
+            ENetEvent evt;
+            int r = enet_host_service(g_Host, &evt, 0);
+            if (r < 0)
+                return;
+            if (r > 0)
             {
-                auto it = std::find_if(g_Peers.begin(), g_Peers.end(),
-                                       [&](const PeerEntry& p) { return p.peer == evt.peer; });
-                if (it != g_Peers.end() && it->conn)
+                switch (evt.type)
                 {
-                    Connection::RawPacket pkt;
-                    pkt.hdr = *reinterpret_cast<CoopNet::PacketHeader*>(evt.packet->data);
-                    const uint8_t* payload = evt.packet->data + sizeof(CoopNet::PacketHeader);
-                    uint16_t psize = evt.packet->dataLength - sizeof(CoopNet::PacketHeader);
-                    if (it->conn->hasKey && pkt.hdr.type != static_cast<uint16_t>(CoopNet::EMsg::Hello) &&
-                        pkt.hdr.type != static_cast<uint16_t>(CoopNet::EMsg::Welcome))
-                    {
-                        if (psize < 4 + crypto_secretbox_MACBYTES)
-                            break;
-                        uint32_t nonce;
-                        memcpy(&nonce, payload, 4);
-                        if (it->conn->nonceSet.count(nonce))
-                            break;
-                        it->conn->nonceWindow.push_back(nonce);
-                        it->conn->nonceSet.insert(nonce);
-                        if (it->conn->nonceWindow.size() > 1024)
-                        {
-                            uint32_t old = it->conn->nonceWindow.front();
-                            it->conn->nonceWindow.pop_front();
-                            it->conn->nonceSet.erase(old);
-                        }
-                        unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
-                        memcpy(nbuf, &nonce, 4);
-                        std::vector<uint8_t> plain(psize - 4 - crypto_secretbox_MACBYTES);
-                        if (crypto_secretbox_open_easy(plain.data(), payload + 4, psize - 4, nbuf,
-                                                       it->conn->key.data()) != 0)
-                            break;
-                        pkt.data = std::move(plain);
+                case ENET_EVENT_TYPE_CONNECT:
+                    if (Connection* conn = AcceptPeer(evt.peer))
+                        OnPeerJoined(conn);
+                    break;
+                case ENET_EVENT_TYPE_DISCONNECT:
+                    if (Connection* conn = DetachPeer(evt.peer))
+                        OnPeerLeft(conn);
+                    break;
+                case ENET_EVENT_TYPE_RECEIVE:
+                    if (!evt.packet) {
+                        std::cerr << "[Net] Receive event with null packet" << std::endl;
+                        break;
                     }
-                    else
-                    {
-                        pkt.data.resize(psize);
-                        memcpy(pkt.data.data(), payload, psize);
-                    }
-                    it->conn->EnqueuePacket(pkt);
+                    HandleReceive(evt.peer, evt.packet); // takes ownership
+                    break;
+                default:
+                    break;
                 }
+                continue;
             }
-            break;
-        }
-        default:
-            break;
+            socket = g_Host->socket;
         }
+        if (wait == 0)
+            return;
+        enet_uint32 cond = ENET_SOCKET_WAIT_RECEIVE;
+        enet_socket_wait(socket, &cond, wait);
+        wait = 0; // subsequent polls are non-blocking
     }
 }
 
+intptr_t Net_GetHostSocket()
+{
+    NetLock lock(g_NetMutex);
+    if (!g_Host || g_Host->socket == ENET_SOCKET_NULL)
+        return -1;
+    return static_cast<intptr_t>(g_Host->socket);
+}
+
 bool Net_IsAuthoritative()
 {
     return CoopNet::kDedicatedAuthority;
 }
 
+bool Net_IsServer()
+{
+    return g_isServer.load(std::memory_order_acquire);
+}
+
 bool Net_IsConnected()
 {
-    std::lock_guard<std::mutex> lock(g_NetMutex);
-    return !g_Peers.empty();
+    NetLock lock(g_NetMutex);
+    return !g_Peers.Empty();
 }
 
 std::vector<CoopNet::Connection*> Net_GetConnections()
 {
     std::vector<CoopNet::Connection*> out;
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        out.reserve(g_Peers.size());
-        for (auto& e : g_Peers)
+        NetLock lock(g_NetMutex);
+        out.reserve(g_Peers.Size());
+        for (auto& e : g_Peers.Entries())
             if (e.conn) out.push_back(e.conn);
     }
     return out;
@@ -451,9 +954,9 @@ std::vector<uint32_t> Net_GetConnectionPeerIds()
 {
     std::vector<uint32_t> ret;
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        ret.reserve(g_Peers.size());
-        for (const auto& p : g_Peers)
+        NetLock lock(g_NetMutex);
+        ret.reserve(g_Peers.Size());
+        for (const auto& p : g_Peers.Entries())
             if (p.conn)
                 ret.push_back(p.peerId);
     }
@@ -462,61 +965,160 @@ std::vector<uint32_t> Net_GetConnectionPeerIds()
 
 void Net_Send(CoopNet::Connection* conn, CoopNet::EMsg type, const void* data, uint16_t size)
 {
-    if (!g_Host || !conn)
+    if (!conn)
         return;
-    
-    auto it = std::find_if(g_Peers.begin(), g_Peers.end(), [&](const PeerEntry& p) { return p.conn == conn; });
-    if (it == g_Peers.end())
+    if (UseOutboundRing())
+    {
+        // Lock-free handoff; the tick thread owns conn's lifetime.
+        Deliver(nullptr, conn, type, data, size, CoopNet::NetChannel_Route(type));
+        return;
+    }
+    NetLock lock(g_NetMutex);
+    if (!g_Host)
+        return;
+    PeerEntry* e = g_Peers.FindByConn(conn);
+    if (!e)
         return;
 
-    std::vector<uint8_t> outBuf;
-    uint16_t finalSize = size;
-    if (conn->hasKey && type != CoopNet::EMsg::Hello && type != CoopNet::EMsg::Welcome)
-    {
-        uint32_t nonce = static_cast<uint32_t>(conn->lastNonce++);
-        unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
-        memcpy(nbuf, &nonce, 4);
-        outBuf.resize(4 + size + crypto_secretbox_MACBYTES);
-        memcpy(outBuf.data(), &nonce, 4);
-        crypto_secretbox_easy(outBuf.data() + 4, static_cast<const unsigned char*>(data), size, nbuf, conn->key.data());
-        finalSize = static_cast<uint16_t>(outBuf.size());
-        data = outBuf.data();
-    }
-    ENetPacket* pkt = enet_packet_create(nullptr, sizeof(CoopNet::PacketHeader) + finalSize, ENET_PACKET_FLAG_RELIABLE);
-    CoopNet::PacketHeader hdr{static_cast<uint16_t>(type), finalSize};
-    std::memcpy(pkt->data, &hdr, sizeof(hdr));
-    if (finalSize > 0 && data)
-        std::memcpy(pkt->data + sizeof(hdr), data, finalSize);
-    enet_peer_send(it->peer, 0, pkt);
+    Deliver(e->peer, conn, type, data, size, CoopNet::NetChannel_Route(type));
 }
 
 void Net_Broadcast(CoopNet::EMsg type, const void* data, uint16_t size)
 {
-    if (!g_Host)
-        return;
+    // Route once; every peer then gets a single packet allocation with the
+    // payload sealed in place under its own key.
+    const CoopNet::NetRoute route = CoopNet::NetChannel_Route(type);
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        for (auto& e : g_Peers)
+        NetLock lock(g_NetMutex);
+        if (!g_Host)
+            return;
+        for (auto& e : g_Peers.Entries())
         {
-            Net_Send(e.conn, type, data, size);
+            Deliver(e.peer, e.conn, type, data, size, route);
         }
     }
 }
 
-void Net_SendUnreliableToAll(CoopNet::EMsg type, const void* data, uint16_t size)
+namespace
 {
-    if (!g_Host)
+// Net_Broadcast restricted to connections `relevant` accepts. Runs under
+// g_NetMutex, so the predicate may read Connection state the tick thread owns.
+template <typename Relevant>
+void BroadcastFiltered(CoopNet::EMsg type, const void* data, uint16_t size, Relevant&& relevant)
+{
+    const CoopNet::NetRoute route = CoopNet::NetChannel_Route(type);
+    uint64_t sent = 0, avoided = 0;
+    {
+        NetLock lock(g_NetMutex);
+        if (!g_Host)
+            return;
+        for (auto& e : g_Peers.Entries())
+        {
+            if (!e.conn || !relevant(*e.conn))
+            {
+                ++avoided;
+                continue;
+            }
+            Deliver(e.peer, e.conn, type, data, size, route);
+            ++sent;
+        }
+    }
+    const size_t slot = static_cast<size_t>(type);
+    if (slot < kBroadcastFilterSlots)
+    {
+        CountTraffic(g_broadcastFilter[slot].sent, sent);
+        CountTraffic(g_broadcastFilter[slot].avoided, avoided);
+    }
+}
+
+// Full 3D distance: a player on a megabuilding roof or in an underground
+// car park is out of reach of an event straight above or below them.
+bool Within(const RED4ext::Vector3& a, const RED4ext::Vector3& b, float radius)
+{
+    const float dx = a.X - b.X;
+    const float dy = a.Y - b.Y;
+    const float dz = a.Z - b.Z;
+    return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+// The interest grid keeps no height, so NPC-centred sends compare X/Y only.
+bool WithinXY(const RED4ext::Vector3& a, const RED4ext::Vector3& b, float radius)
+{
+    const float dx = a.X - b.X;
+    const float dy = a.Y - b.Y;
+    return dx * dx + dy * dy <= radius * radius;
+}
+} // namespace
+
+void Net_BroadcastNear(CoopNet::EMsg type, const void* data, uint16_t size, const RED4ext::Vector3& pos,
+                       float radius)
+{
+    BroadcastFiltered(type, data, size,
+                      [&](const Connection& c) { return Within(c.avatarPos, pos, radius); });
+}
+
+void Net_BroadcastNearPeer(CoopNet::EMsg type, const void* data, uint16_t size, uint32_t peerId, float radius)
+{
+    std::optional<RED4ext::Vector3> center;
+    {
+        NetLock lock(g_NetMutex);
+        if (PeerEntry* e = g_Peers.FindByPeerId(peerId); e && e->conn)
+            center = e->conn->avatarPos;
+    }
+    BroadcastFiltered(type, data, size, [&](const Connection& c) {
+        return !center || c.peerId == peerId || Within(c.avatarPos, *center, radius);
+    });
+}
+
+void Net_BroadcastNearNpc(CoopNet::EMsg type, const void* data, uint16_t size, uint32_t npcId, float radius)
+{
+    RED4ext::Vector3 pos;
+    if (!CoopNet::g_interestGrid.GetPosition(npcId, pos))
+    {
+        BroadcastFiltered(type, data, size, [](const Connection&) { return true; });
         return;
+    }
+    BroadcastFiltered(type, data, size,
+                      [&](const Connection& c) { return WithinXY(c.avatarPos, pos, radius); });
+}
+
+void Net_BroadcastPhase(CoopNet::EMsg type, const void* data, uint16_t size, uint32_t phaseId)
+{
+    // Phase 0 is the shared world; a player's own phase id is its peer id.
+    BroadcastFiltered(type, data, size, [&](const Connection& c) {
+        return phaseId == 0 || c.peerId == phaseId || c.visitPhaseId == phaseId;
+    });
+}
+
+std::vector<CoopNet::BroadcastFilterStats> Net_GetBroadcastFilterStats()
+{
+    std::vector<CoopNet::BroadcastFilterStats> out;
+    for (size_t i = 0; i < kBroadcastFilterSlots; ++i)
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        for (auto& e : g_Peers)
+        const uint64_t sent = g_broadcastFilter[i].sent.load(std::memory_order_relaxed);
+        const uint64_t avoided = g_broadcastFilter[i].avoided.load(std::memory_order_relaxed);
+        if (sent || avoided)
+            out.push_back({static_cast<EMsg>(i), sent, avoided});
+    }
+    return out;
+}
+
+void Net_SendUnreliableToAll(CoopNet::EMsg type, const void* data, uint16_t size)
+{
+    {
+        NetLock lock(g_NetMutex);
+        if (!g_Host)
+            return;
+        const uint8_t channel = CoopNet::NetChannel_Route(type).channel;
+        for (auto& e : g_Peers.Entries())
         {
             ENetPacket* pkt = enet_packet_create(nullptr, sizeof(CoopNet::PacketHeader) + size, 0);
             CoopNet::PacketHeader hdr{static_cast<uint16_t>(type), size};
             std::memcpy(pkt->data, &hdr, sizeof(hdr));
             if (size > 0 && data)
                 std::memcpy(pkt->data + sizeof(hdr), data, size);
-            enet_peer_send(e.peer, 0, pkt);
+            CountTraffic(g_traffic.messagesOut);
+            PeerSend(e.peer, channel, pkt);
         }
     }
 }
@@ -590,29 +1192,42 @@ void Net_SendElevatorCall(uint32_t elevatorId, uint8_t floorIdx)
     }
 }
 
+// A wreck and a lost part are lasting vehicle state, so they reach the
+// vehicle's phase like VehicleSpawn did; a vehicle the server does not
+// track falls back to everyone.
 void Net_BroadcastVehicleExplode(uint32_t vehicleId, uint32_t vfxId, uint32_t seed)
 {
     VehicleExplodePacket pkt{vehicleId, vfxId, seed};
-    Net_Broadcast(CoopNet::EMsg::VehicleExplode, &pkt, sizeof(pkt));
+    RED4ext::Vector3 pos;
+    uint32_t phaseId = 0;
+    if (CoopNet::VehicleController_GetPlacement(vehicleId, pos, phaseId))
+        Net_BroadcastPhase(CoopNet::EMsg::VehicleExplode, &pkt, sizeof(pkt), phaseId);
+    else
+        Net_Broadcast(CoopNet::EMsg::VehicleExplode, &pkt, sizeof(pkt));
 }
 
 void Net_BroadcastPartDetach(uint32_t vehicleId, uint8_t partId)
 {
     VehiclePartDetachPacket pkt{vehicleId, partId, {0, 0, 0}};
-    Net_Broadcast(CoopNet::EMsg::VehiclePartDetach, &pkt, sizeof(pkt));
+    RED4ext::Vector3 pos;
+    uint32_t phaseId = 0;
+    if (CoopNet::VehicleController_GetPlacement(vehicleId, pos, phaseId))
+        Net_BroadcastPhase(CoopNet::EMsg::VehiclePartDetach, &pkt, sizeof(pkt), phaseId);
+    else
+        Net_Broadcast(CoopNet::EMsg::VehiclePartDetach, &pkt, sizeof(pkt));
 }
 
 void Net_BroadcastEject(uint32_t peerId, const RED4ext::Vector3& vel)
 {
     EjectOccupantPacket pkt{peerId, vel};
-    Net_Broadcast(CoopNet::EMsg::EjectOccupant, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(CoopNet::EMsg::EjectOccupant, &pkt, sizeof(pkt), peerId);
 }
 
 void Net_BroadcastVehicleSpawn(uint32_t vehicleId, uint32_t archetypeId, uint32_t paintId, uint32_t phaseId,
                                const TransformSnap& t)
 {
     VehicleSpawnPacket pkt{vehicleId, archetypeId, paintId, phaseId, t};
-    Net_Broadcast(CoopNet::EMsg::VehicleSpawn, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(CoopNet::EMsg::VehicleSpawn, &pkt, sizeof(pkt), phaseId);
 }
 
 void Net_SendSeatRequest(uint32_t vehicleId, uint8_t seatIdx)
@@ -645,25 +1260,30 @@ void Net_SendVehicleHit(uint32_t vehicleId, uint16_t dmg, bool side)
 void Net_BroadcastVehicleHit(uint32_t vehicleId, uint16_t dmg)
 {
     VehicleHitPacket pkt{vehicleId, dmg};
-    Net_Broadcast(EMsg::VehicleHit, &pkt, sizeof(pkt));
+    RED4ext::Vector3 pos;
+    uint32_t phaseId = 0;
+    if (CoopNet::VehicleController_GetPlacement(vehicleId, pos, phaseId))
+        Net_BroadcastNear(EMsg::VehicleHit, &pkt, sizeof(pkt), pos);
+    else
+        Net_Broadcast(EMsg::VehicleHit, &pkt, sizeof(pkt));
 }
 
 void Net_BroadcastBreachStart(uint32_t peerId, uint32_t seed, uint8_t w, uint8_t h)
 {
     BreachStartPacket pkt{peerId, seed, w, h, {0, 0}};
-    Net_Broadcast(EMsg::BreachStart, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::BreachStart, &pkt, sizeof(pkt), peerId);
 }
 
 void Net_BroadcastBreachInput(uint32_t peerId, uint8_t index)
 {
     BreachInputPacket pkt{peerId, index, {0, 0, 0}};
-    Net_Broadcast(EMsg::BreachInput, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::BreachInput, &pkt, sizeof(pkt), peerId);
 }
 
 void Net_BroadcastBreachResult(uint32_t peerId, uint8_t mask)
 {
     BreachResultPacket pkt{peerId, mask, {0, 0, 0}};
-    Net_Broadcast(EMsg::BreachResult, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::BreachResult, &pkt, sizeof(pkt), peerId);
 }
 
 void Net_BroadcastHeat(uint8_t level)
@@ -676,7 +1296,7 @@ void Net_BroadcastHeat(uint8_t level)
 void Net_BroadcastElevatorCall(uint32_t peerId, uint32_t elevatorId, uint8_t floorIdx)
 {
     ElevatorCallPacket pkt{peerId, elevatorId, floorIdx, {0, 0, 0}};
-    Net_Broadcast(EMsg::ElevatorCall, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::ElevatorCall, &pkt, sizeof(pkt), peerId);
 }
 
 void Net_BroadcastElevatorArrive(uint32_t elevatorId, uint64_t sectorHash, const RED4ext::Vector3& pos)
@@ -709,8 +1329,8 @@ void Net_BroadcastQuestStage(uint32_t nameHash, uint16_t stage)
 {
     QuestStagePacket pkt{nameHash, stage, 0};
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        for (auto& e : g_Peers)
+        NetLock lock(g_NetMutex);
+        for (auto& e : g_Peers.Entries())
             CoopNet::QuestWatchdog_Record(e.conn->peerId, nameHash, stage);
     }
     Journal_Log(GameClock::GetCurrentTick(), 0, "questStage", nameHash, stage);
@@ -721,8 +1341,8 @@ void Net_BroadcastQuestStageP2P(uint32_t phaseId, uint32_t questHash, uint16_t s
 {
     QuestStageP2PPacket pkt{phaseId, questHash, stage, 0};
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        for (auto& e : g_Peers)
+        NetLock lock(g_NetMutex);
+        for (auto& e : g_Peers.Entries())
             CoopNet::QuestWatchdog_Record(phaseId, questHash, stage);
     }
     Net_Broadcast(EMsg::QuestStageP2P, &pkt, sizeof(pkt));
@@ -875,25 +1495,61 @@ void Net_BroadcastPlayerUpdate(uint32_t peerId,
                                uint16_t health,
                                uint16_t armor)
 {
-    // Build a minimal transform snapshot using SnapshotWriter
-    CoopNet::SnapshotWriter writer;
-    CoopNet::SnapshotHeader hdr{g_nextSnapshotId++, (g_nextSnapshotId > 1) ? (g_nextSnapshotId - 1) : 0u};
-    writer.Begin(hdr);
-    writer.Write(0, pos);
-    writer.Write(1, vel);
-    writer.Write(2, rot);
-    writer.Write(3, health);
-    writer.Write(4, armor);
-    uint32_t owner = peerId;
-    writer.Write(5, owner);
-    uint16_t seq = static_cast<uint16_t>(hdr.id);
-    writer.Write(6, seq);
-
-    std::vector<uint8_t> buf(sizeof(CoopNet::SnapshotHeader) + sizeof(CoopNet::SnapshotFieldFlags) + sizeof(TransformSnap));
-    size_t bytes = writer.End(buf.data(), buf.size());
-    if (bytes == 0)
+    // Only the latest transform is kept; each peer gets it at its next
+    // replication slot (ReplicatePlayer).
+    CoopNet::TransformSnap snap{};
+    snap.pos = pos;
+    snap.vel = vel;
+    snap.rot = rot;
+    snap.health = health;
+    snap.armor = armor;
+    snap.ownerId = peerId;
+    {
+        std::lock_guard<std::mutex> lock(g_replMutex);
+        g_replPlayers[peerId] = snap;
+    }
+    Net_QueueReplication(CoopNet::ReplicationClass::Player, peerId, pos, 0, kPlayerReplicationHint);
+}
+
+void Net_QueueReplication(CoopNet::ReplicationClass cls, uint32_t entityId, const RED4ext::Vector3& pos,
+                          uint32_t phaseId, uint16_t sizeHint)
+{
+    for (Connection* conn : Net_GetConnections())
+        conn->replication.Mark(cls, entityId, pos, phaseId, sizeHint);
+}
+
+void Net_FlushReplication()
+{
+    COOP_PROFILE_SCOPE("Net_FlushReplication");
+    const auto now = std::chrono::steady_clock::now();
+    float dtSec = kReplicationDefaultDt;
+    if (g_replLastFlush.time_since_epoch().count() != 0)
+        dtSec = std::min(std::chrono::duration<float>(now - g_replLastFlush).count(), kReplicationMaxDt);
+    g_replLastFlush = now;
+
+    const std::vector<Connection*> conns = Net_GetConnections();
+    if (conns.empty())
         return;
-    Net_Broadcast(EMsg::Snapshot, buf.data(), static_cast<uint16_t>(bytes));
+    const uint64_t perSec =
+        CoopNet::NetworkOptimizer::Instance().GetClientReplicationBudget(static_cast<uint32_t>(conns.size()));
+    for (Connection* conn : conns)
+    {
+        const uint64_t rate = conn->lowBWMode ? perSec / 2 : perSec;
+        const size_t budget = static_cast<size_t>(static_cast<float>(rate) * dtSec);
+        conn->replication.Flush(conn->avatarPos, conn->peerId, dtSec, budget,
+                                [conn](CoopNet::ReplicationClass cls, uint32_t id) -> size_t
+                                {
+                                    switch (cls)
+                                    {
+                                    case CoopNet::ReplicationClass::Player:
+                                        return ReplicatePlayer(conn, id);
+                                    case CoopNet::ReplicationClass::Npc:
+                                        return CoopNet::NpcController_Replicate(conn, id);
+                                    default:
+                                        return 0;
+                                    }
+                                });
+    }
 }
 
 void Net_SendAdminCmd(CoopNet::Connection* conn, uint8_t cmdType, uint64_t param)
@@ -906,12 +1562,14 @@ void Net_SendAdminCmd(CoopNet::Connection* conn, uint8_t cmdType, uint64_t param
 
 void Net_Disconnect(Connection* conn)
 {
-    if (!g_Host || !conn)
+    if (!conn)
+        return;
+    NetLock lock(g_NetMutex);
+    if (!g_Host)
         return;
-    auto it = std::find_if(g_Peers.begin(), g_Peers.end(), [&](const PeerEntry& p) { return p.conn == conn; });
-    if (it != g_Peers.end())
+    if (PeerEntry* e = g_Peers.FindByConn(conn))
     {
-        enet_peer_disconnect(it->peer, 0);
+        enet_peer_disconnect(e->peer, 0);
     }
 }
 
@@ -925,13 +1583,17 @@ void Net_BroadcastNatCandidate(const char* sdp)
 void Net_BroadcastCineStart(uint32_t sceneId, uint32_t startTimeMs, uint32_t phaseId, bool solo)
 {
     CineStartPacket pkt{sceneId, startTimeMs, phaseId, static_cast<uint8_t>(solo), {0, 0, 0}};
-    Net_Broadcast(EMsg::CineStart, &pkt, sizeof(pkt));
+    // Solo scenes play inside the requester's phase; shared ones for everyone.
+    if (solo)
+        Net_BroadcastPhase(EMsg::CineStart, &pkt, sizeof(pkt), phaseId);
+    else
+        Net_Broadcast(EMsg::CineStart, &pkt, sizeof(pkt));
 }
 
 void Net_BroadcastViseme(uint32_t npcId, uint8_t visemeId, uint32_t timeMs)
 {
     VisemePacket pkt{npcId, visemeId, {0, 0, 0}, timeMs};
-    Net_Broadcast(EMsg::Viseme, &pkt, sizeof(pkt));
+    Net_BroadcastNearNpc(EMsg::Viseme, &pkt, sizeof(pkt), npcId);
 }
 
 void Net_SendDialogChoice(uint8_t choiceIdx)
@@ -953,7 +1615,7 @@ void Net_BroadcastDialogChoice(uint32_t peerId, uint8_t choiceIdx)
 void Net_BroadcastSceneTrigger(uint32_t phaseId, uint32_t nameHash, bool start)
 {
     SceneTriggerPacket pkt{phaseId, nameHash, static_cast<uint8_t>(start), {0, 0, 0}};
-    Net_Broadcast(EMsg::SceneTrigger, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(EMsg::SceneTrigger, &pkt, sizeof(pkt), phaseId);
 }
 
 void Net_SendVoiceCaps(CoopNet::Connection* conn, uint16_t maxBytes)
@@ -1088,7 +1750,7 @@ void Net_BroadcastNpcSpawnCruiser(uint8_t waveIdx, const uint32_t seeds[4])
 void Net_BroadcastNpcState(uint32_t npcId, uint8_t aiState)
 {
     NpcStatePacket pkt{npcId, aiState, {0, 0, 0}};
-    Net_Broadcast(EMsg::NpcState, &pkt, sizeof(pkt));
+    Net_BroadcastNearNpc(EMsg::NpcState, &pkt, sizeof(pkt), npcId);
 }
 
 void Net_BroadcastCrimeEvent(const CrimeEventSpawnPacket& pkt)
@@ -1272,7 +1934,7 @@ void Net_BroadcastAptInteriorState(uint32_t phaseId, const char* json, uint16_t
     pkt->phaseId = phaseId;
     pkt->blobBytes = len;
     std::memcpy(pkt->json, json, len);
-    Net_Broadcast(EMsg::AptInteriorState, pkt, static_cast<uint16_t>(buf.size()));
+    Net_BroadcastPhase(EMsg::AptInteriorState, pkt, static_cast<uint16_t>(buf.size()), phaseId);
 }
 
 void Net_SendVehicleTowRequest(const RED4ext::Vector3& pos)
@@ -1334,19 +1996,19 @@ void Net_SendTileSelect(uint8_t row, uint8_t col)
 void Net_BroadcastTileGameStart(uint32_t phaseId, uint32_t seed)
 {
     TileGameStartPacket pkt{phaseId, seed};
-    Net_Broadcast(EMsg::TileGameStart, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(EMsg::TileGameStart, &pkt, sizeof(pkt), phaseId);
 }
 
 void Net_BroadcastTileSelect(uint32_t peerId, uint32_t phaseId, uint8_t row, uint8_t col)
 {
     TileSelectPacket pkt{peerId, phaseId, row, col, {0, 0}};
-    Net_Broadcast(EMsg::TileSelect, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(EMsg::TileSelect, &pkt, sizeof(pkt), phaseId);
 }
 
 void Net_BroadcastShardProgress(uint32_t phaseId, uint8_t percent)
 {
     ShardProgressPacket pkt{0u, phaseId, 0, 0, percent, {0}};
-    Net_Broadcast(EMsg::ShardProgress, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(EMsg::ShardProgress, &pkt, sizeof(pkt), phaseId);
 }
 
 void Net_SendTradeInit(uint32_t targetPeerId)
@@ -1480,15 +2142,16 @@ void Net_BroadcastVehicleUnlock(uint32_t peerId, uint32_t vehicleTpl)
     Net_Broadcast(EMsg::VehicleUnlock, &pkt, sizeof(pkt));
 }
 
-void Net_BroadcastVehicleHitHighSpeed(uint32_t vehA, uint32_t vehB, const RED4ext::Vector3& delta)
+void Net_BroadcastVehicleHitHighSpeed(uint32_t vehA, uint32_t vehB, const RED4ext::Vector3& delta,
+                                     const RED4ext::Vector3& pos)
 {
     VehicleHitHighSpeedPacket pkt{vehA, vehB, delta};
-    Net_Broadcast(EMsg::VehicleHitHighSpeed, &pkt, sizeof(pkt));
+    Net_BroadcastNear(EMsg::VehicleHitHighSpeed, &pkt, sizeof(pkt), pos);
 }
 
 void Net_BroadcastVehicleSnap(const VehicleSnap& snap)
 {
-    VehicleSnapshotPacket pkt{snap};
+    VehicleSnapshotPacket pkt = VehicleSnapshotPacket_Pack(snap);
     Net_Broadcast(EMsg::VehicleSnapshot, &pkt, sizeof(pkt));
 }
 
@@ -1528,7 +2191,7 @@ void Net_BroadcastVehiclePaintChange(uint32_t vehId, uint32_t colorId, const cha
 void Net_BroadcastPanicEvent(const RED4ext::Vector3& pos, uint32_t seed)
 {
     PanicEventPacket pkt{pos, seed};
-    Net_Broadcast(EMsg::PanicEvent, &pkt, sizeof(pkt));
+    Net_BroadcastNear(EMsg::PanicEvent, &pkt, sizeof(pkt), pos);
 }
 
 void Net_BroadcastAIHack(uint32_t targetId, uint8_t effectId)
@@ -1540,13 +2203,13 @@ void Net_BroadcastAIHack(uint32_t targetId, uint8_t effectId)
 void Net_BroadcastBossPhase(uint32_t npcId, uint8_t phaseIdx)
 {
     BossPhasePacket pkt{npcId, phaseIdx, {0, 0, 0}};
-    Net_Broadcast(EMsg::BossPhase, &pkt, sizeof(pkt));
+    Net_BroadcastNearNpc(EMsg::BossPhase, &pkt, sizeof(pkt), npcId);
 }
 
 void Net_BroadcastWeaponInspect(uint32_t peerId, uint16_t animId)
 {
     WeaponInspectPacket pkt{peerId, animId, 0};
-    Net_Broadcast(EMsg::WeaponInspectStart, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::WeaponInspectStart, &pkt, sizeof(pkt), peerId);
 }
 
 void Net_BroadcastFinisherStart(uint32_t actorId, uint32_t victimId, uint8_t finisherType)
@@ -1598,13 +2261,13 @@ void Net_SendCrowdCfg(CoopNet::Connection* conn, uint8_t density)
 void Net_BroadcastEmote(uint32_t peerId, uint8_t emoteId)
 {
     EmotePacket pkt{peerId, emoteId, {0, 0, 0}};
-    Net_Broadcast(EMsg::Emote, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::Emote, &pkt, sizeof(pkt), peerId);
 }
 
 void Net_BroadcastCrowdChatterStart(uint32_t npcA, uint32_t npcB, uint32_t lineId, uint32_t seed)
 {
     CrowdChatterStartPacket pkt{npcA, npcB, lineId, seed};
-    Net_Broadcast(EMsg::CrowdChatterStart, &pkt, sizeof(pkt));
+    Net_BroadcastNearNpc(EMsg::CrowdChatterStart, &pkt, sizeof(pkt), npcA);
 }
 
 void Net_BroadcastCrowdChatterEnd(uint32_t convId)
@@ -1628,7 +2291,7 @@ void Net_BroadcastHoloNextAd(uint64_t sectorHash, uint32_t adId)
 void Net_BroadcastDoorBreachStart(uint32_t doorId, uint32_t phaseId, uint32_t seed)
 {
     DoorBreachStartPacket pkt{doorId, phaseId, seed};
-    Net_Broadcast(EMsg::DoorBreachStart, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(EMsg::DoorBreachStart, &pkt, sizeof(pkt), phaseId);
 }
 
 void Net_BroadcastDoorBreachTick(uint32_t doorId, uint8_t percent)
@@ -1675,6 +2338,7 @@ void Net_BroadcastItemGrab(uint32_t peerId, uint32_t itemId)
 
 void Net_BroadcastItemDrop(uint32_t peerId, uint32_t itemId, const RED4ext::Vector3& pos)
 {
+    // The item stays on the ground, so players who walk up later need it too.
     ItemDropPacket pkt{peerId, itemId, pos};
     Net_Broadcast(EMsg::ItemDrop, &pkt, sizeof(pkt));
 }
@@ -1718,19 +2382,19 @@ void Net_BroadcastCamFrameStart(uint32_t camId)
 void Net_BroadcastCarryBegin(uint32_t carrierId, uint32_t entityId)
 {
     CarryBeginPacket pkt{carrierId, entityId};
-    Net_Broadcast(EMsg::CarryBegin, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::CarryBegin, &pkt, sizeof(pkt), carrierId);
 }
 
 void Net_BroadcastCarrySnap(uint32_t entityId, const RED4ext::Vector3& pos, const RED4ext::Vector3& vel)
 {
     CarrySnapPacket pkt{entityId, pos, vel};
-    Net_Broadcast(EMsg::CarrySnap, &pkt, sizeof(pkt));
+    Net_BroadcastNear(EMsg::CarrySnap, &pkt, sizeof(pkt), pos);
 }
 
 void Net_BroadcastCarryEnd(uint32_t entityId, const RED4ext::Vector3& pos, const RED4ext::Vector3& vel)
 {
     CarryEndPacket pkt{entityId, pos, vel};
-    Net_Broadcast(EMsg::CarryEnd, &pkt, sizeof(pkt));
+    Net_BroadcastNear(EMsg::CarryEnd, &pkt, sizeof(pkt), pos);
 }
 
 void Net_BroadcastGrenadePrime(uint32_t entityId, uint32_t startTick)
@@ -1739,18 +2403,22 @@ void Net_BroadcastGrenadePrime(uint32_t entityId, uint32_t startTick)
     Net_Broadcast(EMsg::GrenadePrime, &pkt, sizeof(pkt));
 }
 
-void Net_BroadcastGrenadeSnap(uint32_t entityId, const RED4ext::Vector3& pos, const RED4ext::Vector3& vel)
+void Net_BroadcastProjectileSpawn(const CoopNet::ProjectileSpawnPacket& pkt)
 {
-    GrenadeSnapPacket pkt{entityId, pos, vel};
-    Net_Broadcast(EMsg::GrenadeSnap, &pkt, sizeof(pkt));
+    Net_BroadcastNear(EMsg::ProjectileSpawn, &pkt, sizeof(pkt), pkt.origin);
+}
+
+void Net_BroadcastProjectileEvent(const CoopNet::ProjectileEventPacket& pkt)
+{
+    Net_BroadcastNear(EMsg::ProjectileEvent, &pkt, sizeof(pkt), pkt.pos);
 }
 
 void Net_BroadcastSmartCamStart(uint32_t projId)
 {
     SmartCamStartPacket pkt{projId};
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        for (auto& e : g_Peers)
+        NetLock lock(g_NetMutex);
+        for (auto& e : g_Peers.Entries())
         {
             if (!e.conn->lowBWMode)
                 Net_Send(e.conn, EMsg::SmartCamStart, &pkt, sizeof(pkt));
@@ -1762,8 +2430,8 @@ void Net_BroadcastSmartCamEnd(uint32_t projId)
 {
     SmartCamEndPacket pkt{projId};
     {
-        std::lock_guard<std::mutex> lock(g_NetMutex);
-        for (auto& e : g_Peers)
+        NetLock lock(g_NetMutex);
+        for (auto& e : g_Peers.Entries())
         {
             if (!e.conn->lowBWMode)
                 Net_Send(e.conn, EMsg::SmartCamEnd, &pkt, sizeof(pkt));
@@ -1780,8 +2448,9 @@ void Net_BroadcastArcadeStart(uint32_t cabId, uint32_t peerId, uint32_t seed)
 void Net_SendArcadeInput(uint32_t frame, uint8_t buttonMask)
 {
     ArcadeInputPacket pkt{0u, frame, buttonMask, {0, 0, 0}};
-    if (g_Peers.size() > 0)
-        Net_Send(g_Peers[0].conn, EMsg::ArcadeInput, &pkt, sizeof(pkt));
+    NetLock lock(g_NetMutex);
+    if (!g_Peers.Empty())
+        Net_Send(g_Peers.Entries()[0].conn, EMsg::ArcadeInput, &pkt, sizeof(pkt));
 }
 
 void Net_BroadcastArcadeScore(uint32_t peerId, uint32_t score)
@@ -1811,13 +2480,14 @@ void Net_SendPluginRPC(CoopNet::Connection* conn, uint16_t pluginId, uint32_t fn
 void Net_BroadcastPluginRPC(uint16_t pluginId, uint32_t fnHash, const char* json,
                             uint16_t len)
 {
-    std::vector<uint8_t> buf(sizeof(PluginRPCPacket) - 1 + len);
+    const size_t bytes = sizeof(PluginRPCPacket) - 1 + len;
+    std::vector<uint8_t>& buf = NetScratch(bytes);
     auto* pkt = reinterpret_cast<PluginRPCPacket*>(buf.data());
     pkt->pluginId = pluginId;
     pkt->fnHash = fnHash;
     pkt->jsonBytes = len;
     memcpy(pkt->json, json, len);
-    Net_Broadcast(EMsg::PluginRPC, buf.data(), static_cast<uint16_t>(buf.size()));
+    Net_Broadcast(EMsg::PluginRPC, buf.data(), static_cast<uint16_t>(bytes));
 }
 
 void Net_BroadcastAssetBundle(uint16_t pluginId, const std::vector<uint8_t>& data)
@@ -1828,14 +2498,15 @@ void Net_BroadcastAssetBundle(uint16_t pluginId, const std::vector<uint8_t>& dat
     while (offset < data.size())
     {
         uint16_t len = static_cast<uint16_t>(std::min<size_t>(32 * 1024, data.size() - offset));
-        std::vector<uint8_t> buf(sizeof(AssetBundlePacket) - 1 + len);
+        const size_t bytes = sizeof(AssetBundlePacket) - 1 + len;
+        std::vector<uint8_t>& buf = NetScratch(bytes);
         auto* pkt = reinterpret_cast<AssetBundlePacket*>(buf.data());
         pkt->pluginId = pluginId;
         pkt->totalBytes = total;
         pkt->chunkId = chunk++;
         pkt->dataBytes = len;
         memcpy(pkt->data, data.data() + offset, len);
-        Net_Broadcast(EMsg::AssetBundle, buf.data(), static_cast<uint16_t>(buf.size()));
+        Net_Broadcast(EMsg::AssetBundle, buf.data(), static_cast<uint16_t>(bytes));
         offset += len;
     }
 }
@@ -1961,16 +2632,19 @@ bool Net_StartServer(uint32_t port, uint32_t maxPlayers)
     address.host = ENET_HOST_ANY;
     address.port = port;
     
+    NetLock lock(g_NetMutex);
     if (g_Host) {
         enet_host_destroy(g_Host);
     }
     
-    g_Host = enet_host_create(&address, maxPlayers, 2, 0, 0);
+    g_Host = enet_host_create(&address, maxPlayers, CoopNet::kNetChannelCount, 0, 0);
     g_MaxPlayers = maxPlayers;
     if (!g_Host) {
         std::cerr << "[Net_StartServer] Failed to create server host on port " << port << std::endl;
+        g_isServer.store(false, std::memory_order_release);
         return false;
     }
+    g_isServer.store(true, std::memory_order_release);
     
     std::cout << "[Net_StartServer] Server successfully started on port " << port << std::endl;
     return true;
@@ -1978,33 +2652,35 @@ bool Net_StartServer(uint32_t port, uint32_t maxPlayers)
 
 void Net_StopServer()
 {
-    std::lock_guard<std::mutex> lock(g_NetMutex);
+    Net_StopIoThread();
+    NetLock lock(g_NetMutex);
     if (!g_Host)
         return;
-    for (auto& e : g_Peers)
+    for (auto& e : g_Peers.Entries())
     {
         if (e.peer)
             enet_peer_disconnect(e.peer, 0);
         if (e.conn)
             delete e.conn;
     }
-    g_Peers.clear();
+    g_Peers.Clear();
     enet_host_destroy(g_Host);
     g_Host = nullptr;
+    g_isServer.store(false, std::memory_order_release);
 }
 
 void Net_SetServerPassword(const std::string& password)
 {
-    std::lock_guard<std::mutex> lock(g_NetMutex);
+    NetLock lock(g_NetMutex);
     g_ServerPassword = password;
 }
 
 ServerInfo Net_GetServerInfo()
 {
-    std::lock_guard<std::mutex> lock(g_NetMutex);
+    NetLock lock(g_NetMutex);
     ServerInfo info{};
     info.name = "cp2077-coop";
-    info.playerCount = static_cast<uint32_t>(g_Peers.size());
+    info.playerCount = static_cast<uint32_t>(g_Peers.Size());
     info.maxPlayers = g_MaxPlayers;
     info.hasPassword = !g_ServerPassword.empty();
     info.mode = "Coop";
@@ -2035,6 +2711,7 @@ bool Net_ConnectToServer(const char* host, uint32_t port)
 {
     std::cout << "[Net_ConnectToServer] Connecting to " << host << ":" << port << std::endl;
     
+    NetLock lock(g_NetMutex);
     if (!g_Host) {
         std::cerr << "[Net_ConnectToServer] Network not initialized, call Net_Init() first" << std::endl;
         return false;
@@ -2044,7 +2721,7 @@ bool Net_ConnectToServer(const char* host, uint32_t port)
     enet_address_set_host(&address, host);
     address.port = port;
     
-    ENetPeer* peer = enet_host_connect(g_Host, &address, 2, 0);
+    ENetPeer* peer = enet_host_connect(g_Host, &address, CoopNet::kNetChannelCount, 0);
     if (!peer) {
         std::cerr << "[Net_ConnectToServer] Failed to create connection peer" << std::endl;
         return false;
@@ -2075,11 +2752,7 @@ void Net_HandlePlayerLeave(uint32_t peerId, const std::string& reason) {
 }
 
 CoopNet::Connection* Net_FindConnection(uint32_t peerId) {
-    auto it = std::find_if(g_Peers.begin(), g_Peers.end(),
-        [peerId](const PeerEntry& p) { return p.conn && p.conn->peerId == peerId; });
-
-    if (it != g_Peers.end() && it->conn) {
-        return it->conn;
-    }
-    return nullptr;
+    NetLock lock(g_NetMutex);
+    PeerEntry* e = g_Peers.FindByPeerId(peerId);
+    return e ? e->conn : nullptr;
 }
@@ -23,6 +23,8 @@ struct VendorStockPacket;
 struct VendorStockUpdatePacket;
 struct VendorRefreshPacket;
 struct CrimeEventSpawnPacket;
+struct ProjectileSpawnPacket;
+struct ProjectileEventPacket;
 enum class EMsg : uint16_t;
 struct NetStats
 {
@@ -32,11 +34,59 @@ struct NetStats
     uint16_t sKbps;
     uint16_t dropPkts;
 };
+// Cumulative counters since Net_Init; sample twice to derive rates.
+struct NetTrafficStats
+{
+    uint64_t packetsOut;      // ENet packets handed to peers
+    uint64_t bytesOut;
+    uint64_t packetsIn;
+    uint64_t bytesIn;
+    uint64_t messagesOut;     // logical messages before coalescing
+    uint64_t bundledMessages; // messages that travelled inside a Bundle
+    uint64_t bundlesOut;
+    uint64_t sealsOut;        // secretbox operations on the send path
+};
+// Default reach of Net_BroadcastNear: past this an event is neither visible
+// nor audible to a player (NPC interest ends at ~100 m).
+constexpr float kNetRelevanceRadius = 150.f;
+// Per-message totals for the relevance-filtered broadcasts since Net_Init.
+struct BroadcastFilterStats
+{
+    EMsg type;
+    uint64_t sent;    // connections the message went to
+    uint64_t avoided; // connections it was filtered away from
+};
 } // namespace CoopNet
 void Net_Init();
 void Net_Shutdown();
 void Net_Poll(uint32_t maxMs);
+// The host's UDP socket, or -1 before Net_StartServer/Net_Connect. A
+// single-threaded server waits on it (TickScheduler::Watch) and calls
+// Net_Poll(0) when it turns readable.
+intptr_t Net_GetHostSocket();
+// Moves ENet servicing, inbound decrypt/validation and socket sends onto a
+// dedicated I/O thread. The calling thread becomes the tick thread: Net_Poll
+// then only dispatches queued joins/leaves, and Net_Send from it hands packets
+// to the I/O thread through each Connection's outbound ring. False if the
+// thread could not be created; ENet is then still serviced by Net_Poll.
+bool Net_StartIoThread(uint32_t waitMs = 1);
+void Net_StopIoThread();
+bool Net_IsIoThreadRunning();
+// Sends the small messages the tick thread coalesced this tick (NB-1).
+void Net_FlushBundles();
+// Queues an entity update on every connection's ReplicationScheduler; it goes
+// out with the next Net_FlushReplication once it wins a share of the budget.
+void Net_QueueReplication(CoopNet::ReplicationClass cls, uint32_t entityId, const RED4ext::Vector3& pos,
+                          uint32_t phaseId, uint16_t sizeHint);
+// Sends each connection's highest-priority pending updates within its
+// per-client budget (NetworkOptimizer::GetClientReplicationBudget). Call once
+// per tick, before Net_FlushBundles.
+void Net_FlushReplication();
+CoopNet::NetTrafficStats Net_GetTrafficStats();
 bool Net_IsAuthoritative();
+// True in the process that called Net_StartServer (until Net_StopServer);
+// false in a client that only connects to one.
+bool Net_IsServer();
 bool Net_IsConnected();
 
 // === MISSING SERVER FUNCTION DECLARATIONS ===
@@ -76,6 +126,21 @@ std::vector<CoopNet::Connection*> Net_GetConnections();
 std::vector<uint32_t> Net_GetConnectionPeerIds();
 void Net_Send(CoopNet::Connection* conn, CoopNet::EMsg type, const void* data, uint16_t size);
 void Net_Broadcast(CoopNet::EMsg type, const void* data, uint16_t size);
+// Relevance-filtered broadcasts. Near sends to connections whose avatar is
+// within `radius` of `pos` in 3D; the Peer and Npc forms centre on that
+// peer's avatar or the NPC's interest-grid position (X/Y only, the grid has
+// no height) and fall back to every connection when it is unknown. Phase sends to the connections in `phaseId`
+// (the owner and its apartment guests); phase 0 is the shared world and
+// reaches everyone.
+void Net_BroadcastNear(CoopNet::EMsg type, const void* data, uint16_t size, const RED4ext::Vector3& pos,
+                       float radius = CoopNet::kNetRelevanceRadius);
+void Net_BroadcastNearPeer(CoopNet::EMsg type, const void* data, uint16_t size, uint32_t peerId,
+                           float radius = CoopNet::kNetRelevanceRadius);
+void Net_BroadcastNearNpc(CoopNet::EMsg type, const void* data, uint16_t size, uint32_t npcId,
+                          float radius = CoopNet::kNetRelevanceRadius);
+void Net_BroadcastPhase(CoopNet::EMsg type, const void* data, uint16_t size, uint32_t phaseId);
+// Message types that have gone through a filtered broadcast, in EMsg order.
+std::vector<CoopNet::BroadcastFilterStats> Net_GetBroadcastFilterStats();
 void Net_SendUnreliableToAll(CoopNet::EMsg type, const void* data, uint16_t size);
 void Net_SendSectorReady(uint64_t hash);
 void Net_SendCraftRequest(uint32_t recipeId);
@@ -174,7 +239,8 @@ void Net_BroadcastPingOutline(uint32_t peerId, uint16_t durationMs, const std::v
 void Net_BroadcastLootRoll(uint32_t containerId, uint32_t seed, const std::vector<uint64_t>& items);
 void Net_SendDealerBuy(uint32_t vehicleTpl, uint32_t price);
 void Net_BroadcastVehicleUnlock(uint32_t peerId, uint32_t vehicleTpl);
-void Net_BroadcastVehicleHitHighSpeed(uint32_t vehA, uint32_t vehB, const RED4ext::Vector3& delta);
+void Net_BroadcastVehicleHitHighSpeed(uint32_t vehA, uint32_t vehB, const RED4ext::Vector3& delta,
+                                     const RED4ext::Vector3& pos);
 void Net_BroadcastWeaponInspect(uint32_t peerId, uint16_t animId);
 void Net_BroadcastFinisherStart(uint32_t actorId, uint32_t victimId, uint8_t finisherType);
 void Net_BroadcastFinisherEnd(uint32_t actorId);
@@ -261,7 +327,8 @@ void Net_BroadcastCarryBegin(uint32_t carrierId, uint32_t entityId);
 void Net_BroadcastCarrySnap(uint32_t entityId, const RED4ext::Vector3& pos, const RED4ext::Vector3& vel);     // PC-1
 void Net_BroadcastCarryEnd(uint32_t entityId, const RED4ext::Vector3& pos, const RED4ext::Vector3& vel);      // PC-1
 void Net_BroadcastGrenadePrime(uint32_t entityId, uint32_t startTick);                                        // GR-1
-void Net_BroadcastGrenadeSnap(uint32_t entityId, const RED4ext::Vector3& pos, const RED4ext::Vector3& vel);   // GR-1
+void Net_BroadcastProjectileSpawn(const CoopNet::ProjectileSpawnPacket& pkt);                                  // GR-2
+void Net_BroadcastProjectileEvent(const CoopNet::ProjectileEventPacket& pkt);                                  // GR-2
 void Net_BroadcastSmartCamStart(uint32_t projId);                                                             // RC-1
 void Net_BroadcastSmartCamEnd(uint32_t projId);                                                               // RC-1
 void Net_BroadcastArcadeStart(uint32_t cabId, uint32_t peerId, uint32_t seed);
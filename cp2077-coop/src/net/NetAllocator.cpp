@@ -0,0 +1,300 @@
+#include "NetAllocator.hpp"
+#include <enet/enet.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+namespace CoopNet
+{
+namespace
+{
+constexpr size_t kClassSizes[] = {32, 64, 128, 256, 512, 1024, 2048, 4096};
+constexpr uint32_t kClassCount = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+constexpr uint32_t kLargeClass = 0xFF;
+constexpr uint32_t kMagic = 0x4E414C43; // "NALC"
+constexpr size_t kSlabBytes = 64 * 1024;
+constexpr uint32_t kCacheBatch = 32;          // blocks moved per refill/release
+constexpr uint32_t kCacheMax = 2 * kCacheBatch; // per thread and class
+
+// Precedes every block; keeps the user pointer 16-byte aligned.
+struct BlockHeader
+{
+    uint32_t magic;
+    uint32_t sizeClass;
+    uint64_t requested;
+};
+constexpr size_t kHeader = sizeof(BlockHeader);
+static_assert(kHeader == 16, "block header must preserve 16-byte alignment");
+
+// Overlays a free block (header included).
+struct FreeNode
+{
+    FreeNode* next;
+};
+
+// Shared per-class free list. `checkedOut` counts blocks held by threads
+// (live or cached) and only changes under the mutex, so its high-water mark
+// is cheap to keep.
+struct ClassPool
+{
+    std::mutex mutex;
+    FreeNode* freeList = nullptr;
+    uint64_t checkedOut = 0;
+    std::atomic<uint64_t> peakCheckedOut{0};
+    std::atomic<uint64_t> slabBytes{0};
+};
+
+// Counters are written only by their owning thread (plain load + store, no
+// locked RMW on the hot path) and summed by NetAlloc_GetStats.
+struct ThreadCounters
+{
+    std::atomic<uint64_t> allocs[kClassCount + 1]{};
+    std::atomic<uint64_t> frees[kClassCount + 1]{};
+};
+
+struct ThreadCache;
+
+struct Pools
+{
+    ClassPool classes[kClassCount];
+    std::atomic<uint64_t> largeLive{0};
+    std::atomic<uint64_t> largePeak{0};
+
+    std::mutex registryMutex;
+    std::vector<ThreadCache*> threads;
+    uint64_t retiredAllocs[kClassCount + 1]{};
+    uint64_t retiredFrees[kClassCount + 1]{};
+};
+
+// Never destroyed: thread caches may flush into it during process teardown.
+Pools& GetPools()
+{
+    static Pools* pools = new Pools();
+    return *pools;
+}
+
+inline void Bump(std::atomic<uint64_t>& counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void RaisePeak(std::atomic<uint64_t>& peak, uint64_t now)
+{
+    uint64_t seen = peak.load(std::memory_order_relaxed);
+    while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed))
+    {
+    }
+}
+
+uint32_t ClassFor(size_t size)
+{
+    for (uint32_t c = 0; c < kClassCount; ++c)
+    {
+        if (size <= kClassSizes[c])
+            return c;
+    }
+    return kLargeClass;
+}
+
+// Carves a fresh slab into blocks; caller holds pool.mutex.
+bool GrowLocked(ClassPool& pool, uint32_t c)
+{
+    uint8_t* slab = static_cast<uint8_t*>(std::malloc(kSlabBytes));
+    if (!slab)
+        return false;
+    const size_t stride = kHeader + kClassSizes[c];
+    const size_t blocks = kSlabBytes / stride;
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        FreeNode* node = reinterpret_cast<FreeNode*>(slab + i * stride);
+        node->next = pool.freeList;
+        pool.freeList = node;
+    }
+    pool.slabBytes.fetch_add(kSlabBytes, std::memory_order_relaxed);
+    return true;
+}
+
+struct ThreadCache
+{
+    FreeNode* head[kClassCount]{};
+    uint32_t count[kClassCount]{};
+    ThreadCounters counters;
+
+    ThreadCache()
+    {
+        Pools& pools = GetPools();
+        std::lock_guard<std::mutex> lock(pools.registryMutex);
+        pools.threads.push_back(this);
+    }
+
+    ~ThreadCache()
+    {
+        for (uint32_t c = 0; c < kClassCount; ++c)
+            Release(c, count[c]);
+        Pools& pools = GetPools();
+        std::lock_guard<std::mutex> lock(pools.registryMutex);
+        for (uint32_t c = 0; c <= kClassCount; ++c)
+        {
+            pools.retiredAllocs[c] += counters.allocs[c].load(std::memory_order_relaxed);
+            pools.retiredFrees[c] += counters.frees[c].load(std::memory_order_relaxed);
+        }
+        pools.threads.erase(std::find(pools.threads.begin(), pools.threads.end(), this));
+    }
+
+    // Moves up to `n` cached blocks of class c back to the shared pool.
+    void Release(uint32_t c, uint32_t n)
+    {
+        if (n == 0 || !head[c])
+            return;
+        FreeNode* first = head[c];
+        FreeNode* last = first;
+        uint32_t moved = 1;
+        while (moved < n && last->next)
+        {
+            last = last->next;
+            ++moved;
+        }
+        head[c] = last->next;
+        count[c] -= moved;
+        ClassPool& pool = GetPools().classes[c];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        last->next = pool.freeList;
+        pool.freeList = first;
+        pool.checkedOut -= moved;
+    }
+
+    bool Refill(uint32_t c)
+    {
+        ClassPool& pool = GetPools().classes[c];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (!pool.freeList && !GrowLocked(pool, c))
+            return false;
+        for (uint32_t i = 0; i < kCacheBatch && pool.freeList; ++i)
+        {
+            FreeNode* node = pool.freeList;
+            pool.freeList = node->next;
+            node->next = head[c];
+            head[c] = node;
+            ++count[c];
+            ++pool.checkedOut;
+        }
+        RaisePeak(pool.peakCheckedOut, pool.checkedOut);
+        return true;
+    }
+};
+
+thread_local ThreadCache t_cache;
+
+void* ENET_CALLBACK EnetMalloc(size_t size)
+{
+    return NetAlloc_Malloc(size);
+}
+
+void ENET_CALLBACK EnetFree(void* ptr)
+{
+    NetAlloc_Free(ptr);
+}
+} // namespace
+
+void* NetAlloc_Malloc(size_t size)
+{
+    const uint32_t c = ClassFor(size);
+    ThreadCache& cache = t_cache;
+    BlockHeader* hdr = nullptr;
+    if (c == kLargeClass)
+    {
+        hdr = static_cast<BlockHeader*>(std::malloc(kHeader + size));
+        if (!hdr)
+            return nullptr;
+        Bump(cache.counters.allocs[kClassCount]);
+        Pools& pools = GetPools();
+        RaisePeak(pools.largePeak, pools.largeLive.fetch_add(1, std::memory_order_relaxed) + 1);
+    }
+    else
+    {
+        if (!cache.head[c] && !cache.Refill(c))
+            return nullptr;
+        FreeNode* node = cache.head[c];
+        cache.head[c] = node->next;
+        --cache.count[c];
+        hdr = reinterpret_cast<BlockHeader*>(node);
+        Bump(cache.counters.allocs[c]);
+    }
+    hdr->magic = kMagic;
+    hdr->sizeClass = c;
+    hdr->requested = size;
+    return reinterpret_cast<uint8_t*>(hdr) + kHeader;
+}
+
+void NetAlloc_Free(void* ptr)
+{
+    if (!ptr)
+        return;
+    BlockHeader* hdr = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(ptr) - kHeader);
+    if (hdr->magic != kMagic)
+    {
+        // Double free or a pointer this allocator never handed out; leaking
+        // is safer than threading it onto a free list.
+        std::cerr << "[NetAlloc] invalid free " << ptr << std::endl;
+        return;
+    }
+    const uint32_t c = hdr->sizeClass;
+    hdr->magic = 0;
+    ThreadCache& cache = t_cache;
+    if (c == kLargeClass)
+    {
+        Bump(cache.counters.frees[kClassCount]);
+        GetPools().largeLive.fetch_sub(1, std::memory_order_relaxed);
+        std::free(hdr);
+        return;
+    }
+    FreeNode* node = reinterpret_cast<FreeNode*>(hdr);
+    node->next = cache.head[c];
+    cache.head[c] = node;
+    ++cache.count[c];
+    Bump(cache.counters.frees[c]);
+    if (cache.count[c] > kCacheMax)
+        cache.Release(c, kCacheBatch);
+}
+
+const ENetCallbacks& NetAlloc_EnetCallbacks()
+{
+    static const ENetCallbacks callbacks{EnetMalloc, EnetFree, nullptr};
+    return callbacks;
+}
+
+std::vector<NetAllocClassStats> NetAlloc_GetStats()
+{
+    Pools& pools = GetPools();
+    std::vector<NetAllocClassStats> out(kClassCount + 1);
+    {
+        std::lock_guard<std::mutex> lock(pools.registryMutex);
+        for (uint32_t c = 0; c <= kClassCount; ++c)
+        {
+            uint64_t allocs = pools.retiredAllocs[c];
+            uint64_t frees = pools.retiredFrees[c];
+            for (const ThreadCache* t : pools.threads)
+            {
+                allocs += t->counters.allocs[c].load(std::memory_order_relaxed);
+                frees += t->counters.frees[c].load(std::memory_order_relaxed);
+            }
+            out[c].allocs = allocs;
+            out[c].frees = frees;
+            // Counters are sampled one thread at a time; clamp transient skew.
+            out[c].inUse = allocs > frees ? allocs - frees : 0;
+        }
+    }
+    for (uint32_t c = 0; c < kClassCount; ++c)
+    {
+        out[c].blockSize = kClassSizes[c];
+        out[c].peakInUse = pools.classes[c].peakCheckedOut.load(std::memory_order_relaxed);
+        out[c].slabBytes = pools.classes[c].slabBytes.load(std::memory_order_relaxed);
+    }
+    out[kClassCount].blockSize = 0;
+    out[kClassCount].peakInUse = pools.largePeak.load(std::memory_order_relaxed);
+    out[kClassCount].slabBytes = 0;
+    return out;
+}
+} // namespace CoopNet
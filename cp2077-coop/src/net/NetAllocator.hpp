@@ -0,0 +1,39 @@
+#pragma once
+
+// Size-class slab allocator backing ENet (enet_initialize_with_callbacks).
+// Packets and ENet's small internal structures are served from fixed-size
+// blocks carved out of 64 KiB slabs, so a long-running server does not
+// fragment the global heap with short-lived allocations. Each thread keeps a
+// small per-class cache; blocks freed on another thread (e.g. packets
+// received on the I/O thread and released on the tick thread) migrate back
+// to the shared pool in batches. Requests above the largest class fall
+// through to malloc.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct _ENetCallbacks;
+typedef struct _ENetCallbacks ENetCallbacks;
+
+namespace CoopNet
+{
+struct NetAllocClassStats
+{
+    size_t blockSize;   // usable bytes; 0 for the malloc fallback row
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t inUse;
+    uint64_t peakInUse; // high-water of blocks held by threads, caches included
+    uint64_t slabBytes; // reserved from the system for this class
+};
+
+void* NetAlloc_Malloc(size_t size);
+void NetAlloc_Free(void* ptr);
+
+// Callbacks for enet_initialize_with_callbacks.
+const ENetCallbacks& NetAlloc_EnetCallbacks();
+
+// One row per size class followed by the malloc fallback.
+std::vector<NetAllocClassStats> NetAlloc_GetStats();
+} // namespace CoopNet
@@ -0,0 +1,177 @@
+#include "NetChannels.hpp"
+#include "Packets.hpp"
+#include <algorithm>
+#include <atomic>
+#include <enet/enet.h>
+
+namespace CoopNet
+{
+
+static std::atomic<uint8_t> g_delivery[kNetChannelCount] = {
+    static_cast<uint8_t>(NetDelivery::Reliable),            // Control
+    static_cast<uint8_t>(NetDelivery::UnreliableSequenced), // Snapshot
+    static_cast<uint8_t>(NetDelivery::Unreliable),          // Voice
+    static_cast<uint8_t>(NetDelivery::Reliable),            // Quest
+    static_cast<uint8_t>(NetDelivery::Reliable),            // Inventory
+    static_cast<uint8_t>(NetDelivery::Reliable)};           // Chat
+static std::atomic<bool> g_singleChannel{false};
+
+static const char* const kChannelNames[kNetChannelCount] = {"control", "snapshot", "voice",
+                                                             "quest",   "inventory", "chat"};
+
+NetChannel NetChannel_ForMsg(EMsg type)
+{
+    switch (type)
+    {
+    case EMsg::Snapshot:
+    case EMsg::SnapshotDeltaAck:
+    case EMsg::NpcSnapshot:
+    case EMsg::GrenadeSnap:
+    case EMsg::VehicleSnapshot:
+    case EMsg::AirVehUpdate:
+    case EMsg::CarrySnap:
+    case EMsg::TurretAim:
+        return NetChannel::Snapshot;
+    case EMsg::Voice:
+        return NetChannel::Voice;
+    case EMsg::QuestStage:
+    case EMsg::QuestStageP2P:
+    case EMsg::QuestFullSync:
+    case EMsg::QuestResyncRequest:
+    case EMsg::SceneTrigger:
+    case EMsg::CineStart:
+    case EMsg::Viseme:
+    case EMsg::DialogChoice:
+    case EMsg::HoloCallStart:
+    case EMsg::HoloCallEnd:
+    case EMsg::CriticalVoteStart:
+    case EMsg::CriticalVoteCast:
+    case EMsg::BranchVoteStart:
+    case EMsg::BranchVoteCast:
+    case EMsg::EndingVoteStart:
+    case EMsg::EndingVoteCast:
+    case EMsg::PhaseBundle:
+        return NetChannel::Quest;
+    case EMsg::ItemSnap:
+    case EMsg::CraftRequest:
+    case EMsg::CraftResult:
+    case EMsg::AttachModRequest:
+    case EMsg::AttachModResult:
+    case EMsg::PurchaseRequest:
+    case EMsg::PurchaseResult:
+    case EMsg::VendorStock:
+    case EMsg::VendorStockUpdate:
+    case EMsg::VendorRefresh:
+    case EMsg::VendorPurchase:
+    case EMsg::ReRollRequest:
+    case EMsg::ReRollResult:
+    case EMsg::RipperInstallRequest:
+    case EMsg::TradeInit:
+    case EMsg::TradeOffer:
+    case EMsg::TradeAccept:
+    case EMsg::TradeFinalize:
+    case EMsg::ItemGrab:
+    case EMsg::ItemDrop:
+    case EMsg::ItemStore:
+    case EMsg::LootRoll:
+    case EMsg::CyberEquip:
+    case EMsg::DealerBuy:
+        return NetChannel::Inventory;
+    case EMsg::Chat:
+    case EMsg::Killfeed:
+        return NetChannel::Chat;
+    default:
+        return NetChannel::Control;
+    }
+}
+
+NetRoute NetChannel_Route(EMsg type)
+{
+    if (g_singleChannel.load(std::memory_order_relaxed))
+        return {0u, ENET_PACKET_FLAG_RELIABLE};
+    // Handshake packets always travel reliably on the control channel.
+    if (type == EMsg::Hello || type == EMsg::Welcome)
+        return {static_cast<uint8_t>(NetChannel::Control), ENET_PACKET_FLAG_RELIABLE};
+
+    NetChannel ch = NetChannel_ForMsg(type);
+    NetRoute route{static_cast<uint8_t>(ch), 0u};
+    switch (NetChannel_GetDelivery(ch))
+    {
+    case NetDelivery::Reliable:
+        route.flags = ENET_PACKET_FLAG_RELIABLE;
+        break;
+    case NetDelivery::UnreliableSequenced:
+        route.flags = ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+        break;
+    case NetDelivery::Unreliable:
+        route.flags = ENET_PACKET_FLAG_UNSEQUENCED | ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+        break;
+    }
+    return route;
+}
+
+void NetChannel_SetDelivery(NetChannel ch, NetDelivery delivery)
+{
+    if (ch >= NetChannel::Count)
+        return;
+    // Control carries handshake and session state and must stay reliable.
+    if (ch == NetChannel::Control)
+        delivery = NetDelivery::Reliable;
+    g_delivery[static_cast<uint8_t>(ch)].store(static_cast<uint8_t>(delivery), std::memory_order_relaxed);
+}
+
+NetDelivery NetChannel_GetDelivery(NetChannel ch)
+{
+    if (ch >= NetChannel::Count)
+        return NetDelivery::Reliable;
+    return static_cast<NetDelivery>(g_delivery[static_cast<uint8_t>(ch)].load(std::memory_order_relaxed));
+}
+
+void NetChannel_SetSingleChannel(bool enable)
+{
+    g_singleChannel.store(enable, std::memory_order_relaxed);
+}
+
+bool NetChannel_IsSingleChannel()
+{
+    return g_singleChannel.load(std::memory_order_relaxed);
+}
+
+const char* NetChannel_Name(NetChannel ch)
+{
+    if (ch >= NetChannel::Count)
+        return "unknown";
+    return kChannelNames[static_cast<uint8_t>(ch)];
+}
+
+bool NetChannel_Parse(const std::string& name, NetChannel& out)
+{
+    std::string v = name;
+    std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+    for (uint8_t i = 0; i < kNetChannelCount; ++i)
+    {
+        if (v == kChannelNames[i])
+        {
+            out = static_cast<NetChannel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NetDelivery_Parse(const std::string& name, NetDelivery& out)
+{
+    std::string v = name;
+    std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+    if (v == "reliable")
+        out = NetDelivery::Reliable;
+    else if (v == "unreliable_sequenced" || v == "sequenced")
+        out = NetDelivery::UnreliableSequenced;
+    else if (v == "unreliable" || v == "unsequenced")
+        out = NetDelivery::Unreliable;
+    else
+        return false;
+    return true;
+}
+
+} // namespace CoopNet
@@ -0,0 +1,54 @@
+#pragma once
+
+// ENet channel layout and per-message delivery policy.
+// Every EMsg is routed to a channel; each channel keeps its own reliable
+// sequence so a lost quest packet no longer stalls snapshots or voice
+// (head-of-line blocking). Delivery per channel can be overridden from
+// ServerConfig (see server.cfg.template, NETWORK SETTINGS).
+
+#include <cstdint>
+#include <string>
+
+namespace CoopNet
+{
+enum class EMsg : uint16_t;
+
+enum class NetChannel : uint8_t
+{
+    Control = 0, // handshake, session, admin and anything unclassified
+    Snapshot,    // Snapshot, NpcSnapshot, GrenadeSnap and other streamed state
+    Voice,
+    Quest,
+    Inventory,
+    Chat,
+    Count
+};
+
+constexpr uint8_t kNetChannelCount = static_cast<uint8_t>(NetChannel::Count);
+
+enum class NetDelivery : uint8_t
+{
+    Reliable,            // ordered per channel, retransmitted on loss
+    UnreliableSequenced, // newest wins, stale packets are dropped
+    Unreliable           // unsequenced, may arrive out of order
+};
+
+struct NetRoute
+{
+    uint8_t channel;
+    uint32_t flags; // ENet packet flags
+};
+
+NetChannel NetChannel_ForMsg(EMsg type);
+NetRoute NetChannel_Route(EMsg type);
+
+void NetChannel_SetDelivery(NetChannel ch, NetDelivery delivery);
+NetDelivery NetChannel_GetDelivery(NetChannel ch);
+// Legacy mode: everything reliable on channel 0.
+void NetChannel_SetSingleChannel(bool enable);
+bool NetChannel_IsSingleChannel();
+
+const char* NetChannel_Name(NetChannel ch);
+bool NetChannel_Parse(const std::string& name, NetChannel& out);
+bool NetDelivery_Parse(const std::string& name, NetDelivery& out);
+} // namespace CoopNet
@@ -1,5 +1,6 @@
 #include "NetworkOptimizer.hpp"
 #include "../core/Logger.hpp"
+#include "../core/Metrics.hpp"
 #include <lz4.h>
 #include <zstd.h>
 #include <algorithm>
@@ -10,6 +11,32 @@
 
 namespace CoopNet {
 
+namespace {
+// Per-packet counts live in the metrics registry so the send and receive
+// paths never take m_metricsMutex; NetworkMetrics reads them back.
+struct PacketCounters {
+    MetricCounter& packetsSent;
+    MetricCounter& bytesSent;
+    MetricCounter& packetsExpired;
+    MetricCounter& compressedIn;
+    MetricCounter& compressedOut;
+    MetricCounter& bytesDecompressed;
+};
+
+PacketCounters& Counters() {
+    auto& metrics = GetMetrics();
+    static PacketCounters counters{
+        metrics.Counter("coop_netopt_packets_sent", "Packets prepared by NetworkOptimizer"),
+        metrics.Counter("coop_netopt_bytes_sent", "Payload bytes prepared by NetworkOptimizer"),
+        metrics.Counter("coop_netopt_packets_expired", "Queued packets dropped after their deadline"),
+        metrics.Counter("coop_netopt_compression_input_bytes", "Bytes fed to packet compression"),
+        metrics.Counter("coop_netopt_compression_output_bytes", "Bytes produced by packet compression"),
+        metrics.Counter("coop_netopt_decompressed_bytes", "Bytes produced by packet decompression"),
+    };
+    return counters;
+}
+} // namespace
+
 NetworkOptimizer& NetworkOptimizer::Instance() {
     static NetworkOptimizer instance;
     return instance;
@@ -148,11 +175,8 @@ bool NetworkOptimizer::OptimizePacket(NetworkPacket& packet) {
     packet.deadline = packet.timestamp + timeout;
 
     // Update packet metrics
-    {
-        std::lock_guard<std::mutex> lock(m_metricsMutex);
-        m_metrics.packetsSent++;
-        m_metrics.bytesSent += packet.data.size();
-    }
+    Counters().packetsSent.Add();
+    Counters().bytesSent.Add(packet.data.size());
 
     return true;
 }
@@ -186,15 +210,8 @@ bool NetworkOptimizer::CompressPacket(NetworkPacket& packet, CompressionType com
     packet.compression = compression;
 
     // Update compression metrics
-    {
-        std::lock_guard<std::mutex> lock(m_metricsMutex);
-        m_metrics.bytesCompressed += packet.originalSize;
-
-        if (packet.originalSize > 0) {
-            float ratio = static_cast<float>(packet.compressedSize) / packet.originalSize;
-            m_metrics.compressionRatio = (m_metrics.compressionRatio * 0.9f) + (ratio * 0.1f);
-        }
-    }
+    Counters().compressedIn.Add(packet.originalSize);
+    Counters().compressedOut.Add(packet.compressedSize);
 
     spdlog::debug("[NetworkOptimizer] Compressed packet {} from {} to {} bytes (ratio: {:.2f})",
                   packet.packetId, packet.originalSize, packet.compressedSize,
@@ -275,10 +292,7 @@ bool NetworkOptimizer::DecompressPacket(NetworkPacket& packet) {
     packet.compression = CompressionType::None;
 
     // Update decompression metrics
-    {
-        std::lock_guard<std::mutex> lock(m_metricsMutex);
-        m_metrics.bytesDecompressed += packet.data.size();
-    }
+    Counters().bytesDecompressed.Add(packet.data.size());
 
     return true;
 }
@@ -530,12 +544,28 @@ void NetworkOptimizer::AdaptToBandwidth(uint64_t bandwidth) {
 
 NetworkMetrics NetworkOptimizer::GetMetrics() const {
     std::lock_guard<std::mutex> lock(m_metricsMutex);
-    return m_metrics;
+    NetworkMetrics metrics = m_metrics;
+    ReadPacketCounters(metrics);
+    return metrics;
+}
+
+void NetworkOptimizer::ReadPacketCounters(NetworkMetrics& metrics) const {
+    auto& counters = Counters();
+    metrics.packetsSent = counters.packetsSent.Value() - m_counterBase.packetsSent;
+    metrics.bytesSent = counters.bytesSent.Value() - m_counterBase.bytesSent;
+    metrics.packetsLost = counters.packetsExpired.Value() - m_counterBase.packetsLost;
+    metrics.bytesCompressed = counters.compressedIn.Value() - m_counterBase.bytesCompressed;
+    metrics.bytesDecompressed = counters.bytesDecompressed.Value() - m_counterBase.bytesDecompressed;
+
+    const uint64_t compressedOut = counters.compressedOut.Value() - m_compressedOutBase;
+    metrics.compressionRatio =
+        metrics.bytesCompressed > 0 ? static_cast<float>(compressedOut) / metrics.bytesCompressed : 0.0f;
 }
 
 void NetworkOptimizer::UpdateMetrics() {
     std::lock_guard<std::mutex> lock(m_metricsMutex);
     m_metrics.lastUpdate = std::chrono::steady_clock::now();
+    ReadPacketCounters(m_metrics);
 
     // Calculate packet loss rate
     if (m_metrics.packetsSent > 0) {
@@ -708,8 +738,8 @@ namespace NetworkUtils {
                 if (now < packet.deadline) {
                     tempQueue.push(packet);
                 } else {
-                    // Packet expired - using existing metrics field
-                    m_metrics.packetsLost++;
+                    // Packet expired - counted as lost
+                    Counters().packetsExpired.Add();
                     spdlog::debug("[NetworkOptimizer] Packet {} expired", packet.packetId);
                 }
             }
@@ -897,6 +927,15 @@ namespace NetworkUtils {
 
         m_metrics = NetworkMetrics{};
         m_metrics.lastUpdate = std::chrono::steady_clock::now();
+
+        // The registry counters only grow; report from here on
+        auto& counters = Counters();
+        m_counterBase.packetsSent = counters.packetsSent.Value();
+        m_counterBase.bytesSent = counters.bytesSent.Value();
+        m_counterBase.packetsLost = counters.packetsExpired.Value();
+        m_counterBase.bytesCompressed = counters.compressedIn.Value();
+        m_counterBase.bytesDecompressed = counters.bytesDecompressed.Value();
+        m_compressedOutBase = counters.compressedOut.Value();
         m_metrics.minLatency = std::numeric_limits<float>::max();
         m_metrics.maxLatency = 0.0f;
         m_metrics.connectionQuality = 1.0f;
@@ -985,13 +1024,22 @@ namespace NetworkUtils {
         }
     }
 
+    uint64_t NetworkOptimizer::GetClientReplicationBudget(uint32_t clientCount) const {
+        std::lock_guard<std::mutex> lock(m_bandwidthMutex);
+
+        uint64_t budget = m_bandwidthManager.clientReplicationBudget;
+        if (m_bandwidthManager.allocatedBandwidthUp > 0 && clientCount > 0) {
+            budget = std::min(budget, m_bandwidthManager.allocatedBandwidthUp / clientCount);
+        }
+        return budget;
+    }
+
     bool NetworkOptimizer::IsAdaptationEnabled() const {
         return m_adaptationEnabled;
     }
 
     float NetworkOptimizer::GetCompressionRatio() const {
-        std::lock_guard<std::mutex> lock(m_metricsMutex);
-        return m_metrics.compressionRatio;
+        return GetMetrics().compressionRatio;
     }
 
     bool NetworkOptimizer::IsOptimizationActive() const {
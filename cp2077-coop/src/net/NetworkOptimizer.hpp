@@ -154,6 +154,7 @@ struct BandwidthManager {
     uint64_t allocatedBandwidthDown = 0;
     uint64_t usedBandwidthUp = 0;
     uint64_t usedBandwidthDown = 0;
+    uint64_t clientReplicationBudget = 256 * 1000 / 8; // bytes per second per client (256 kbps)
     std::chrono::steady_clock::time_point lastReset;
 
     // Token bucket for rate limiting
@@ -218,6 +219,10 @@ public:
     void UpdateBandwidthUsage(uint64_t bytesSent, uint64_t bytesReceived);
     uint64_t GetAvailableBandwidth(bool upstream = true) const;
     float GetBandwidthUtilization(bool upstream = true) const;
+    // Replication budget for one of `clientCount` clients, bytes per second:
+    // the per-client target, lowered when the upstream allocation is shared
+    // by more clients than it can give that much.
+    uint64_t GetClientReplicationBudget(uint32_t clientCount) const;
 
     // Packet scheduling
     bool SchedulePacket(const NetworkPacket& packet);
@@ -326,10 +331,15 @@ private:
     void TriggerEvent(const std::string& eventType, const std::string& data);
     std::string SerializeProfile(const OptimizationProfile& profile) const;
     OptimizationProfile DeserializeProfile(const std::string& data) const;
+    // Fills the packet and byte counts from the registry counters, relative
+    // to the last ResetMetrics. Call with m_metricsMutex held.
+    void ReadPacketCounters(NetworkMetrics& metrics) const;
 
     // Data storage
     OptimizationProfile m_currentProfile;
     NetworkMetrics m_metrics;
+    NetworkMetrics m_counterBase; // registry counter values at the last ResetMetrics
+    uint64_t m_compressedOutBase = 0;
     BandwidthManager m_bandwidthManager;
     PacketScheduler m_scheduler;
 
@@ -0,0 +1,44 @@
+#pragma once
+
+// Wire framing for encrypted payloads: [nonce:4][mac:16][ciphertext].
+// This matches crypto_secretbox_easy output prefixed by the 4-byte nonce.
+// Sealing writes the MAC and ciphertext straight into the caller's buffer
+// (typically ENetPacket::data) via crypto_secretbox_detached, and opening
+// decrypts in place so received payloads are never copied.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sodium.h>
+
+namespace CoopNet
+{
+constexpr size_t kSealOverhead = 4 + crypto_secretbox_MACBYTES;
+
+inline constexpr size_t PacketCrypto_SealedSize(size_t plainBytes)
+{
+    return kSealOverhead + plainBytes;
+}
+
+// `out` must hold PacketCrypto_SealedSize(size) bytes and may not overlap `plain`.
+inline void PacketCrypto_SealInto(uint8_t* out, uint32_t nonce, const void* plain, size_t size, const uint8_t* key)
+{
+    unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
+    std::memcpy(nbuf, &nonce, 4);
+    std::memcpy(out, &nonce, 4);
+    const unsigned char* m = plain ? static_cast<const unsigned char*>(plain) : out + kSealOverhead;
+    crypto_secretbox_detached(out + kSealOverhead, out + 4, m, plain ? size : 0, nbuf, key);
+}
+
+// Verifies and decrypts `frame` in place. On success the plaintext occupies
+// frame[kSealOverhead, frameSize).
+inline bool PacketCrypto_OpenInPlace(uint8_t* frame, size_t frameSize, const uint8_t* key)
+{
+    if (frameSize < kSealOverhead)
+        return false;
+    unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
+    std::memcpy(nbuf, frame, 4);
+    uint8_t* c = frame + kSealOverhead;
+    return crypto_secretbox_open_detached(c, c, frame + 4, frameSize - kSealOverhead, nbuf, key) == 0;
+}
+} // namespace CoopNet
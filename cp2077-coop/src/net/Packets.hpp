@@ -206,7 +206,12 @@ enum class EMsg : uint16_t
     ApartmentEnter,
     ApartmentPermChange,
     ApartmentShareChange,
-    ApartmentCustomization
+    ApartmentCustomization,
+    Bundle, // NB-1: several small messages framed into one packet
+    SnapshotDeltaAck,
+    InterestBatch,
+    ProjectileSpawn, // GR-2: replaces streamed GrenadeSnap
+    ProjectileEvent
 };
 
 struct PacketHeader
@@ -344,10 +349,55 @@ struct KillfeedPacket
     char msg[64];
 };
 
+// Quantised NpcSnap (see Quantize.hpp): 40 bytes instead of 64.
 struct NpcSnapshotPacket
 {
-    NpcSnap snap;
+    uint32_t npcId;
+    uint16_t templateId;
+    NpcState state;
+    uint8_t aiState;
+    uint64_t sectorHash;
+    QuantCell cell;
+    QuantLocal pos;
+    uint32_t rot;
+    uint16_t health;
+    uint8_t appearanceSeed;
+    uint8_t _pad;
+    uint32_t phaseId;
 };
+static_assert(sizeof(NpcSnapshotPacket) == 40, "NpcSnapshotPacket layout changed");
+
+inline NpcSnapshotPacket NpcSnapshotPacket_Pack(const NpcSnap& snap)
+{
+    NpcSnapshotPacket pkt{};
+    pkt.npcId = snap.npcId;
+    pkt.templateId = snap.templateId;
+    pkt.state = snap.state;
+    pkt.aiState = snap.aiState;
+    pkt.sectorHash = snap.sectorHash;
+    Quant_PackPos(snap.pos, pkt.cell, pkt.pos);
+    pkt.rot = Quant_PackRot(snap.rot);
+    pkt.health = snap.health;
+    pkt.appearanceSeed = snap.appearanceSeed;
+    pkt.phaseId = snap.phaseId;
+    return pkt;
+}
+
+inline NpcSnap NpcSnapshotPacket_Unpack(const NpcSnapshotPacket& pkt)
+{
+    NpcSnap snap{};
+    snap.npcId = pkt.npcId;
+    snap.templateId = pkt.templateId;
+    snap.sectorHash = pkt.sectorHash;
+    snap.pos = Quant_UnpackPos(pkt.cell, pkt.pos);
+    snap.rot = Quant_UnpackRot(pkt.rot);
+    snap.state = pkt.state;
+    snap.health = pkt.health;
+    snap.aiState = pkt.aiState;
+    snap.appearanceSeed = pkt.appearanceSeed;
+    snap.phaseId = pkt.phaseId;
+    return snap;
+}
 
 struct NpcSpawnPacket
 {
@@ -488,6 +538,16 @@ struct InterestPacket
     uint32_t id;
 };
 
+// One client's interest changes for a tick: `addCount` entering ids followed
+// by `removeCount` leaving ids; only the used ids go on the wire.
+constexpr uint16_t kMaxInterestBatchIds = 256;
+struct InterestBatchPacket
+{
+    uint16_t addCount;
+    uint16_t removeCount;
+    uint32_t ids[kMaxInterestBatchIds];
+};
+
 struct TickRateChangePacket
 {
     uint16_t tickMs;
@@ -1111,10 +1171,30 @@ struct PartyKickPacket
     uint32_t peerId;
 };
 
+// Quantised VehicleSnap (see Quantize.hpp): 36 bytes instead of 60.
 struct VehicleSnapshotPacket
 {
-    VehicleSnap snap;
+    TransformQuant transform;
+    int16_t leanCentiDeg;
+    uint8_t _pad[2];
 };
+static_assert(sizeof(VehicleSnapshotPacket) == 36, "VehicleSnapshotPacket layout changed");
+
+inline VehicleSnapshotPacket VehicleSnapshotPacket_Pack(const VehicleSnap& snap)
+{
+    VehicleSnapshotPacket pkt{};
+    pkt.transform = TransformSnap_Quantize(snap.transform);
+    pkt.leanCentiDeg = static_cast<int16_t>(std::lround(std::clamp(snap.leanAngle, -180.f, 180.f) * 100.f));
+    return pkt;
+}
+
+inline VehicleSnap VehicleSnapshotPacket_Unpack(const VehicleSnapshotPacket& pkt)
+{
+    VehicleSnap snap{};
+    snap.transform = TransformSnap_Dequantize(pkt.transform);
+    snap.leanAngle = pkt.leanCentiDeg / 100.f;
+    return snap;
+}
 
 struct TurretAimPacket
 {
@@ -1190,6 +1270,16 @@ struct CrowdCfgPacket
     uint8_t _pad[3];
 };
 
+// Baselines the receiver resolved since its last ack; sent at most once per
+// tick with only `count` entries on the wire.
+constexpr uint8_t kMaxSnapshotAcks = 64;
+struct SnapshotDeltaAckPacket
+{
+    uint8_t count;
+    uint8_t _pad[3];
+    SnapshotAckEntry entries[kMaxSnapshotAcks];
+};
+
 struct AvatarSpawnPacket
 {
     uint32_t peerId;
@@ -1203,18 +1293,9 @@ struct AvatarDespawnPacket
     uint32_t phaseId; // PX-1
 };
 
-// Delta-compressed TransformSnap serialized via SnapshotWriter.
-// `dataBytes` is the number of bytes following `flags` that make up the
-// compressed payload. The payload layout is determined by the dirty bits
-// set in `flags`.
-struct SnapshotPacket
-{
-    uint32_t entityId;
-    SnapshotHeader header;
-    SnapshotFieldFlags flags;
-    uint16_t dataBytes;
-    uint8_t data[1];
-};
+// EMsg::Snapshot payload: uint32 entityId followed by a snapshot in the
+// SnapshotWriter wire layout (header, packed field mask, changed fields only).
+// Built per peer by SnapshotDeltaEncoder and resolved by SnapshotDeltaDecoder.
 
 struct ChatPacket
 {
@@ -1356,6 +1437,7 @@ struct GrenadePrimePacket
     uint32_t startTick;
 };
 
+// Legacy 20 Hz grenade state; superseded by ProjectileSpawn/ProjectileEvent.
 struct GrenadeSnapPacket
 {
     uint32_t entityId;
@@ -1363,6 +1445,35 @@ struct GrenadeSnapPacket
     RED4ext::Vector3 vel;
 };
 
+// Sent once per throw; every peer then integrates the grenade itself
+// (see physics/Projectile.hpp).
+struct ProjectileSpawnPacket
+{
+    uint32_t entityId;
+    uint32_t spawnTick; // GameClock tick of the launch
+    uint32_t seed;      // picks the fuse length
+    RED4ext::Vector3 origin;
+    RED4ext::Vector3 velocity;
+};
+
+enum class ProjectileEventKind : uint8_t
+{
+    Bounce,  // replace the state at `step`
+    Detonate // remove; `pos` is the blast point
+};
+
+// Correction for something the integrator cannot predict. `step` counts
+// fixed projectile steps since launch, so it is exact regardless of latency.
+struct ProjectileEventPacket
+{
+    uint32_t entityId;
+    uint32_t step;
+    uint8_t kind; // ProjectileEventKind
+    uint8_t _pad[3];
+    RED4ext::Vector3 pos;
+    RED4ext::Vector3 vel;
+};
+
 struct SmartCamStartPacket
 {
     uint32_t projId;
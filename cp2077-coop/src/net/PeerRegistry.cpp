@@ -0,0 +1,137 @@
+#include "PeerRegistry.hpp"
+#include <enet/enet.h>
+
+namespace CoopNet
+{
+static_assert(sizeof(void*) == 8, "peer handle packing assumes 64-bit pointers");
+
+PeerRegistry::Handle PeerRegistry::Add(ENetPeer* peer, Connection* conn, uint32_t peerId)
+{
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    Slot& s = m_slots[slot];
+    s.used = true;
+    s.dense = static_cast<uint32_t>(m_dense.size());
+    m_dense.push_back({peer, conn, peerId});
+    m_denseToSlot.push_back(slot);
+    m_byPeerId[peerId] = slot;
+    if (conn)
+        m_byConn[conn] = slot;
+
+    Handle h{slot, s.generation};
+    if (peer)
+        peer->data = EncodeHandle(h);
+    return h;
+}
+
+bool PeerRegistry::Remove(Handle h)
+{
+    if (h.slot >= m_slots.size())
+        return false;
+    Slot& s = m_slots[h.slot];
+    if (!s.used || s.generation != h.generation)
+        return false;
+
+    PeerEntry& e = m_dense[s.dense];
+    if (e.peer && e.peer->data == EncodeHandle(h))
+        e.peer->data = nullptr;
+    m_byPeerId.erase(e.peerId);
+    if (e.conn)
+        m_byConn.erase(e.conn);
+
+    // Swap-remove from the dense array and patch the moved entry's slot.
+    const uint32_t last = static_cast<uint32_t>(m_dense.size() - 1);
+    if (s.dense != last)
+    {
+        m_dense[s.dense] = m_dense[last];
+        m_denseToSlot[s.dense] = m_denseToSlot[last];
+        m_slots[m_denseToSlot[s.dense]].dense = s.dense;
+    }
+    m_dense.pop_back();
+    m_denseToSlot.pop_back();
+
+    s.used = false;
+    ++s.generation;
+    m_freeSlots.push_back(h.slot);
+    return true;
+}
+
+void PeerRegistry::Clear()
+{
+    for (auto& e : m_dense)
+    {
+        if (e.peer)
+            e.peer->data = nullptr;
+    }
+    for (uint32_t i = 0; i < m_slots.size(); ++i)
+    {
+        if (m_slots[i].used)
+        {
+            m_slots[i].used = false;
+            ++m_slots[i].generation;
+            m_freeSlots.push_back(i);
+        }
+    }
+    m_dense.clear();
+    m_denseToSlot.clear();
+    m_byPeerId.clear();
+    m_byConn.clear();
+}
+
+PeerEntry* PeerRegistry::Get(Handle h)
+{
+    if (h.slot >= m_slots.size())
+        return nullptr;
+    const Slot& s = m_slots[h.slot];
+    if (!s.used || s.generation != h.generation)
+        return nullptr;
+    return &m_dense[s.dense];
+}
+
+PeerEntry* PeerRegistry::FromPeer(const ENetPeer* peer)
+{
+    if (!peer || !peer->data)
+        return nullptr;
+    PeerEntry* e = Get(DecodeHandle(peer->data));
+    return (e && e->peer == peer) ? e : nullptr;
+}
+
+PeerEntry* PeerRegistry::FindByPeerId(uint32_t peerId)
+{
+    auto it = m_byPeerId.find(peerId);
+    if (it == m_byPeerId.end())
+        return nullptr;
+    return &m_dense[m_slots[it->second].dense];
+}
+
+PeerEntry* PeerRegistry::FindByConn(const Connection* conn)
+{
+    auto it = m_byConn.find(conn);
+    if (it == m_byConn.end())
+        return nullptr;
+    return &m_dense[m_slots[it->second].dense];
+}
+
+void* PeerRegistry::EncodeHandle(Handle h)
+{
+    // slot + 1 keeps a valid handle distinct from a null ENetPeer::data.
+    const uint64_t v = (static_cast<uint64_t>(h.generation) << 32) | (static_cast<uint64_t>(h.slot) + 1u);
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(v));
+}
+
+PeerRegistry::Handle PeerRegistry::DecodeHandle(const void* data)
+{
+    const uint64_t v = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(data));
+    return {static_cast<uint32_t>(v & 0xFFFFFFFFu) - 1u, static_cast<uint32_t>(v >> 32)};
+}
+
+} // namespace CoopNet
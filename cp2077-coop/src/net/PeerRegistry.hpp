@@ -0,0 +1,73 @@
+#pragma once
+
+// Slot-map registry of connected peers.
+// Entries live in a dense array for iteration; a stable slot index plus a
+// generation counter is stored in ENetPeer::data so per-packet routing is O(1)
+// and a recycled slot can never be mistaken for the peer that used it before.
+// peerId and Connection* lookups go through hash maps onto the same slots.
+//
+// Threading: not internally synchronized. Net.cpp guards every access with
+// g_NetMutex.
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct _ENetPeer;
+typedef struct _ENetPeer ENetPeer;
+
+namespace CoopNet
+{
+class Connection;
+
+struct PeerEntry
+{
+    ENetPeer* peer;
+    Connection* conn;
+    uint32_t peerId;
+};
+
+class PeerRegistry
+{
+public:
+    struct Handle
+    {
+        uint32_t slot;
+        uint32_t generation;
+    };
+
+    Handle Add(ENetPeer* peer, Connection* conn, uint32_t peerId);
+    bool Remove(Handle h);
+    void Clear();
+
+    PeerEntry* Get(Handle h);
+    PeerEntry* FromPeer(const ENetPeer* peer); // resolves ENetPeer::data
+    PeerEntry* FindByPeerId(uint32_t peerId);
+    PeerEntry* FindByConn(const Connection* conn);
+
+    // Dense view for iteration; invalidated by Add/Remove.
+    std::vector<PeerEntry>& Entries() { return m_dense; }
+    const std::vector<PeerEntry>& Entries() const { return m_dense; }
+    size_t Size() const { return m_dense.size(); }
+    bool Empty() const { return m_dense.empty(); }
+
+    static void* EncodeHandle(Handle h);
+    static Handle DecodeHandle(const void* data);
+
+private:
+    struct Slot
+    {
+        uint32_t dense = 0;
+        uint32_t generation = 1;
+        bool used = false;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<PeerEntry> m_dense;
+    std::vector<uint32_t> m_denseToSlot;
+    std::unordered_map<uint32_t, uint32_t> m_byPeerId;
+    std::unordered_map<const Connection*, uint32_t> m_byConn;
+};
+} // namespace CoopNet
@@ -0,0 +1,161 @@
+#pragma once
+
+// Fixed-point encodings for replicated transforms.
+//
+// Positions are split into a sector cell (kQuantSectorSize metre cubes) and a
+// 1 mm offset from the cell origin, so the cell only goes on the wire when an
+// entity crosses a sector edge and the offset fits in 16 bits per axis.
+// Velocities are clamped to +/-kQuantVelRange per axis and stored as int16.
+// Rotations use smallest-three: the largest quaternion component is dropped
+// (its sign folded away since q and -q are the same rotation) and the other
+// three are stored as 10-bit fixed point alongside its 2-bit index.
+//
+// Error budget, per axis unless noted (checked by QuantizeTest):
+//   position  <= kQuantPosMaxError for |coord| <= kQuantPosMaxCoord
+//   velocity  <= kQuantVelMaxError inside the clamp range
+//   rotation  <= kQuantRotMaxErrorDeg angle between input and decoded rotation
+
+#include <RED4ext/Scripting/Natives/Generated/Quaternion.hpp>
+#include <RED4ext/Scripting/Natives/Generated/Vector3.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace CoopNet
+{
+constexpr double kQuantSectorSize = 64.0;  // metres per cell edge
+constexpr double kQuantPosStep = 0.001;    // 1 mm
+constexpr float kQuantVelRange = 128.f;    // m/s per axis
+constexpr float kQuantVelStep = kQuantVelRange / 32767.f;
+constexpr uint32_t kQuantRotBits = 10;     // per smallest-three component
+constexpr float kQuantRotComponentMax = 0.70710678f;
+
+// Half a step of quantisation plus float rounding of the decoded coordinate.
+constexpr float kQuantPosMaxCoord = 8192.f;
+constexpr float kQuantPosMaxError = 0.001f;
+constexpr float kQuantVelMaxError = 0.002f; // half a step (1.95 mm/s) plus float rounding
+constexpr float kQuantRotMaxErrorDeg = 0.25f;
+
+struct QuantCell
+{
+    int16_t x, y, z;
+};
+
+struct QuantLocal
+{
+    uint16_t x, y, z;
+};
+
+struct QuantVel
+{
+    int16_t x, y, z;
+};
+static_assert(sizeof(QuantCell) == 6 && sizeof(QuantLocal) == 6 && sizeof(QuantVel) == 6,
+              "quantised vectors must pack to 48 bits");
+
+namespace QuantDetail
+{
+inline void PackAxis(float coord, int16_t& cell, uint16_t& local)
+{
+    const double c = std::floor(static_cast<double>(coord) / kQuantSectorSize);
+    const double offset = static_cast<double>(coord) - c * kQuantSectorSize;
+    cell = static_cast<int16_t>(std::clamp(c, -32768.0, 32767.0));
+    local = static_cast<uint16_t>(std::clamp(std::lround(offset / kQuantPosStep), 0l, 65535l));
+}
+
+inline float UnpackAxis(int16_t cell, uint16_t local)
+{
+    return static_cast<float>(cell * kQuantSectorSize + local * kQuantPosStep);
+}
+
+inline int16_t PackVelAxis(float v)
+{
+    const float clamped = std::clamp(v, -kQuantVelRange, kQuantVelRange);
+    return static_cast<int16_t>(std::lround(clamped / kQuantVelStep));
+}
+} // namespace QuantDetail
+
+inline void Quant_PackPos(const RED4ext::Vector3& pos, QuantCell& cell, QuantLocal& local)
+{
+    QuantDetail::PackAxis(pos.X, cell.x, local.x);
+    QuantDetail::PackAxis(pos.Y, cell.y, local.y);
+    QuantDetail::PackAxis(pos.Z, cell.z, local.z);
+}
+
+// Both unpackers build the result in the return statement: RED4ext::Vector3
+// declares operator= itself, so copying a named local out is deprecated.
+inline RED4ext::Vector3 Quant_UnpackPos(const QuantCell& cell, const QuantLocal& local)
+{
+    return RED4ext::Vector3(QuantDetail::UnpackAxis(cell.x, local.x), QuantDetail::UnpackAxis(cell.y, local.y),
+                            QuantDetail::UnpackAxis(cell.z, local.z));
+}
+
+inline QuantVel Quant_PackVel(const RED4ext::Vector3& vel)
+{
+    return {QuantDetail::PackVelAxis(vel.X), QuantDetail::PackVelAxis(vel.Y), QuantDetail::PackVelAxis(vel.Z)};
+}
+
+inline RED4ext::Vector3 Quant_UnpackVel(const QuantVel& q)
+{
+    return RED4ext::Vector3(q.x * kQuantVelStep, q.y * kQuantVelStep, q.z * kQuantVelStep);
+}
+
+// Bits 30..31: index of the dropped component (i, j, k, r); bits 0..29: the
+// remaining three in order, 10 bits each. A zero quaternion packs as identity.
+inline uint32_t Quant_PackRot(const RED4ext::Quaternion& rot)
+{
+    float q[4] = {rot.i, rot.j, rot.k, rot.r};
+    float len = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    if (!(len > 1e-6f))
+    {
+        q[0] = q[1] = q[2] = 0.f;
+        q[3] = len = 1.f;
+    }
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i)
+    {
+        if (std::fabs(q[i]) > std::fabs(q[largest]))
+            largest = i;
+    }
+    const float sign = q[largest] < 0.f ? -1.f : 1.f;
+    constexpr float kMaxCode = static_cast<float>((1u << kQuantRotBits) - 1);
+    uint32_t packed = largest << 30;
+    uint32_t shift = 2 * kQuantRotBits;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        const float c = std::clamp(q[i] * sign / len, -kQuantRotComponentMax, kQuantRotComponentMax);
+        const float unit = (c + kQuantRotComponentMax) / (2.f * kQuantRotComponentMax);
+        packed |= static_cast<uint32_t>(std::lround(unit * kMaxCode)) << shift;
+        shift -= kQuantRotBits;
+    }
+    return packed;
+}
+
+inline RED4ext::Quaternion Quant_UnpackRot(uint32_t packed)
+{
+    constexpr uint32_t kMask = (1u << kQuantRotBits) - 1;
+    constexpr float kMaxCode = static_cast<float>(kMask);
+    const uint32_t largest = packed >> 30;
+    float q[4];
+    float sumSq = 0.f;
+    uint32_t shift = 2 * kQuantRotBits;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        const float unit = static_cast<float>((packed >> shift) & kMask) / kMaxCode;
+        q[i] = unit * 2.f * kQuantRotComponentMax - kQuantRotComponentMax;
+        sumSq += q[i] * q[i];
+        shift -= kQuantRotBits;
+    }
+    q[largest] = std::sqrt(std::max(0.f, 1.f - sumSq));
+    RED4ext::Quaternion rot;
+    rot.i = q[0];
+    rot.j = q[1];
+    rot.k = q[2];
+    rot.r = q[3];
+    return rot;
+}
+} // namespace CoopNet
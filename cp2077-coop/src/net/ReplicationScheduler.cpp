@@ -0,0 +1,124 @@
+#include "ReplicationScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace CoopNet
+{
+float Replication_TypeWeight(ReplicationClass cls)
+{
+    switch (cls)
+    {
+    case ReplicationClass::Player:
+        return 2.f; // other players are what everyone looks at
+    case ReplicationClass::Projectile:
+        return 2.f; // fast movers extrapolate worst
+    case ReplicationClass::Npc:
+    default:
+        return 1.f;
+    }
+}
+
+float Replication_Weight(ReplicationClass cls, float distance, bool samePhase)
+{
+    const float near = kReplicationNearDistance;
+    const float dist = distance > near ? std::max(near / distance, kReplicationMinDistanceWeight) : 1.f;
+    return Replication_TypeWeight(cls) * dist * (samePhase ? 1.f : kReplicationOtherPhaseWeight);
+}
+
+void ReplicationScheduler::Mark(ReplicationClass cls, uint32_t entityId, const RED4ext::Vector3& pos,
+                                uint32_t phaseId, uint16_t sizeHint)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_entries.try_emplace(Key(cls, entityId));
+    Entry& e = it->second;
+    if (inserted)
+    {
+        e.priority = 0.f;
+        e.waitTicks = 0;
+        e.generation = 0;
+    }
+    e.pos = pos;
+    e.phaseId = phaseId;
+    e.sizeHint = sizeHint;
+    ++e.generation;
+}
+
+void ReplicationScheduler::Forget(ReplicationClass cls, uint32_t entityId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(Key(cls, entityId));
+}
+
+void ReplicationScheduler::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+void ReplicationScheduler::Prioritise(const RED4ext::Vector3& viewerPos, uint32_t viewerPhase, float dtSec,
+                                      std::vector<Candidate>& out)
+{
+    out.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out.reserve(m_entries.size());
+    for (auto& [key, e] : m_entries)
+    {
+        const float dx = e.pos.X - viewerPos.X;
+        const float dy = e.pos.Y - viewerPos.Y;
+        const float dz = e.pos.Z - viewerPos.Z;
+        const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        // Phase 0 is the shared world; a player's own phase id is its peer id.
+        const bool samePhase = e.phaseId == 0 || e.phaseId == viewerPhase;
+        const ReplicationClass cls = static_cast<ReplicationClass>(key >> 32);
+        e.priority += Replication_Weight(cls, dist, samePhase) * dtSec;
+        if (e.waitTicks < UINT16_MAX)
+            ++e.waitTicks;
+        out.push_back({cls, static_cast<uint32_t>(key), e.generation, e.priority, e.sizeHint, e.waitTicks});
+    }
+    m_lastCandidates = out.size();
+    std::sort(out.begin(), out.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.priority != b.priority)
+            return a.priority > b.priority;
+        if (a.cls != b.cls)
+            return a.cls < b.cls;
+        return a.entityId < b.entityId;
+    });
+}
+
+void ReplicationScheduler::Complete(const std::vector<Candidate>& sent, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Candidate& c : sent)
+    {
+        m_stats.maxWaitTicks = std::max<uint32_t>(m_stats.maxWaitTicks, c.waitTicks);
+        auto it = m_entries.find(Key(c.cls, c.entityId));
+        if (it == m_entries.end())
+            continue;
+        if (it->second.generation == c.generation)
+        {
+            m_entries.erase(it);
+        }
+        else
+        {
+            // Marked again while we were sending; queue the newer state afresh.
+            it->second.priority = 0.f;
+            it->second.waitTicks = 0;
+        }
+    }
+    m_stats.sent += sent.size();
+    m_stats.deferred += m_lastCandidates - sent.size();
+    m_stats.bytes += bytes;
+}
+
+size_t ReplicationScheduler::GetPending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+ReplicationStats ReplicationScheduler::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+} // namespace CoopNet
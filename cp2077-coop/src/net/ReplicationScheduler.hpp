@@ -0,0 +1,130 @@
+#pragma once
+
+// Per-client priority accumulator for state replication.
+//
+// Controllers Mark() an entity when its replicated state changes instead of
+// sending it straight away. Every tick Flush() adds each pending entity's
+// weight (type x distance to the viewer x phase) to its accumulated priority,
+// then sends in priority order until the client's byte budget for the tick is
+// spent. Entities that did not fit keep their priority, so anything that
+// stays pending eventually outranks fresher, closer traffic instead of
+// starving. A sent entity leaves the queue until it is marked again.
+//
+// The scheduler never holds its lock while calling the send callback, so
+// callbacks may take controller or network locks freely.
+
+#include <RED4ext/Scripting/Natives/Generated/Vector3.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace CoopNet
+{
+enum class ReplicationClass : uint8_t
+{
+    Player,
+    Projectile,
+    Npc,
+    Count
+};
+
+constexpr float kReplicationNearDistance = 10.f;  // full distance weight inside this radius (m)
+// Floors keep the weight spread (and so the longest wait under load) bounded:
+// the heaviest entity outranks the lightest by at most 2 / (0.25 * 0.25) = 32x.
+constexpr float kReplicationMinDistanceWeight = 0.25f;
+constexpr float kReplicationOtherPhaseWeight = 0.25f;
+
+// Priority gained per second of staleness for an entity of this class, at
+// full distance weight in the viewer's phase.
+float Replication_TypeWeight(ReplicationClass cls);
+float Replication_Weight(ReplicationClass cls, float distance, bool samePhase);
+
+struct ReplicationStats
+{
+    uint64_t sent = 0;        // entity updates sent
+    uint64_t deferred = 0;    // pending entity-ticks left over for a later flush
+    uint64_t bytes = 0;       // bytes reported by the send callback
+    uint32_t maxWaitTicks = 0; // longest any update waited before it went out
+};
+
+class ReplicationScheduler
+{
+public:
+    struct Candidate
+    {
+        ReplicationClass cls;
+        uint32_t entityId;
+        uint32_t generation;
+        float priority;
+        uint16_t sizeHint;
+        uint16_t waitTicks;
+    };
+
+    // Queues (or refreshes) an entity whose state changed. `sizeHint` is the
+    // expected wire size and decides whether the entity fits the budget.
+    void Mark(ReplicationClass cls, uint32_t entityId, const RED4ext::Vector3& pos, uint32_t phaseId,
+              uint16_t sizeHint);
+    void Forget(ReplicationClass cls, uint32_t entityId);
+    void Clear();
+
+    // Spends up to `budget` bytes on the highest-priority entities.
+    // send(cls, entityId) transmits the entity's current state and returns
+    // the bytes written, or 0 when it no longer exists. The top candidate is
+    // always sent even if it alone exceeds the budget, so oversized updates
+    // cannot wedge the queue. Returns the bytes sent.
+    template <typename SendFn>
+    size_t Flush(const RED4ext::Vector3& viewerPos, uint32_t viewerPhase, float dtSec, size_t budget, SendFn&& send)
+    {
+        std::vector<Candidate>& order = m_flushScratch;
+        Prioritise(viewerPos, viewerPhase, dtSec, order);
+        std::vector<Candidate>& done = m_doneScratch;
+        done.clear();
+        size_t used = 0;
+        for (const Candidate& c : order)
+        {
+            if (used + c.sizeHint > budget && !done.empty())
+                continue; // smaller entities further down may still fit
+            used += send(c.cls, c.entityId);
+            done.push_back(c);
+            if (used >= budget)
+                break;
+        }
+        Complete(done, used);
+        return used;
+    }
+
+    size_t GetPending() const;
+    ReplicationStats GetStats() const;
+
+private:
+    struct Entry
+    {
+        RED4ext::Vector3 pos;
+        uint32_t phaseId;
+        uint32_t generation;
+        float priority;
+        uint16_t sizeHint;
+        uint16_t waitTicks;
+    };
+
+    static uint64_t Key(ReplicationClass cls, uint32_t entityId)
+    {
+        return (static_cast<uint64_t>(cls) << 32) | entityId;
+    }
+
+    // Accumulates priority and writes the pending set in send order.
+    void Prioritise(const RED4ext::Vector3& viewerPos, uint32_t viewerPhase, float dtSec,
+                    std::vector<Candidate>& out);
+    // Drops the sent entities unless they were marked again meanwhile.
+    void Complete(const std::vector<Candidate>& sent, size_t bytes);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    ReplicationStats m_stats;
+    size_t m_lastCandidates = 0;
+    std::vector<Candidate> m_flushScratch; // Flush() runs on one thread
+    std::vector<Candidate> m_doneScratch;
+};
+} // namespace CoopNet
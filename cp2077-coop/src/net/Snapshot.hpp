@@ -1,10 +1,14 @@
 #pragma once
 
+#include "Quantize.hpp"
 #include <RED4ext/Scripting/Natives/Generated/Quaternion.hpp>
 #include <RED4ext/Scripting/Natives/Generated/Vector3.hpp>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace CoopNet
@@ -23,6 +27,7 @@ using SnapshotId = uint32_t;
 //   4 - armor
 //   5 - ownerId
 //   6 - ackSeq
+//   7 - position sector cell (TransformQuant only; see Quantize.hpp)
 struct SnapshotFieldFlags
 {
     uint32_t bits[4]; // 4 * 32 = 128 flags
@@ -33,7 +38,8 @@ constexpr uint32_t kMaxSnapshotFields = 128;
 
 // Basic header stored before each snapshot payload.
 // `id` is the absolute snapshot index.
-// `baseId` points to the previous snapshot used as a baseline when delta-compressing.
+// `baseId` points to the previous snapshot used as a baseline when delta-compressing;
+// 0 means the snapshot is full and carries every field it describes.
 struct SnapshotHeader
 {
     SnapshotId id;
@@ -50,7 +56,7 @@ struct TransformSnap
     uint16_t health;  // field flag index 3
     uint16_t armor;   // field flag index 4
     uint32_t ownerId; // field flag index 5
-    uint16_t seq;     // field flag index 6
+    uint16_t seq;     // field flag index 6; defaults to the low bits of the snapshot id
 };
 // static_assert(std::is_trivially_copyable_v<TransformSnap>, "TransformSnap must be trivial");
 
@@ -118,9 +124,16 @@ struct VehicleSnap
 static_assert(sizeof(VehicleSnap) % 4 == 0, "VehicleSnap must align to 4 bytes");
 // static_assert(std::is_trivially_copyable_v<VehicleSnap>, "VehicleSnap must be trivial");
 
+// Wire layout shared by SnapshotWriter and SnapshotReader:
+//   SnapshotHeader | uint8 maskBytes | mask[maskBytes] | payload
+// The mask is SnapshotFieldFlags packed little-endian with trailing zero bytes
+// trimmed, so a transform with seven fields costs two bytes instead of 16.
+constexpr size_t kSnapshotMaxOverhead = sizeof(SnapshotHeader) + 1 + sizeof(SnapshotFieldFlags);
+
 // Writes snapshot data into a buffer with dirty-bit tracking.
 // Begin() resets internal state with the target header.
 // Write<T>() serializes a field and marks the bit in SnapshotFieldFlags.
+// WriteDelta<T>() does the same only when the value differs from the baseline.
 // End() finalizes the buffer as a delta against `baseId` so multiple
 // snapshots may form a chain of baselines for compression.
 class SnapshotWriter
@@ -151,24 +164,55 @@ public:
         m_payload.insert(m_payload.end(), ptr, ptr + sizeof(T));
     }
 
+    // Write the field only if it differs bitwise from `baseline` (nullptr = always write)
+    template<typename T>
+    void WriteDelta(uint32_t fieldIndex, const T& value, const T* baseline)
+    {
+        if (baseline && std::memcmp(&value, baseline, sizeof(T)) == 0)
+            return;
+        Write(fieldIndex, value);
+    }
+
     // Finalize the snapshot into the output buffer; returns bytes written or 0 if insufficient space
     size_t End(uint8_t* outBuf, size_t max) const
     {
-        const size_t total = sizeof(SnapshotHeader) + sizeof(SnapshotFieldFlags) + m_payload.size();
+        const uint8_t maskBytes = PackedMaskBytes();
+        const size_t total = sizeof(SnapshotHeader) + 1 + maskBytes + m_payload.size();
         if (max < total)
             return 0;
 
-        std::memcpy(outBuf, &m_header, sizeof(SnapshotHeader));
-        std::memcpy(outBuf + sizeof(SnapshotHeader), &m_flags, sizeof(SnapshotFieldFlags));
+        uint8_t* out = outBuf;
+        std::memcpy(out, &m_header, sizeof(SnapshotHeader));
+        out += sizeof(SnapshotHeader);
+        *out++ = maskBytes;
+        for (uint8_t i = 0; i < maskBytes; ++i)
+            *out++ = static_cast<uint8_t>(m_flags.bits[i / 4] >> ((i % 4) * 8));
         if (!m_payload.empty())
-        {
-            std::memcpy(outBuf + sizeof(SnapshotHeader) + sizeof(SnapshotFieldFlags), m_payload.data(),
-                        m_payload.size());
-        }
+            std::memcpy(out, m_payload.data(), m_payload.size());
         return total;
     }
 
+    const SnapshotFieldFlags& GetFlags() const
+    {
+        return m_flags;
+    }
+
 private:
+    uint8_t PackedMaskBytes() const
+    {
+        for (int word = 3; word >= 0; --word)
+        {
+            const uint32_t v = m_flags.bits[word];
+            if (v == 0)
+                continue;
+            uint8_t top = 3;
+            while ((v >> (top * 8)) == 0)
+                --top;
+            return static_cast<uint8_t>(word * 4 + top + 1);
+        }
+        return 0;
+    }
+
     SnapshotHeader m_header{};
     SnapshotFieldFlags m_flags{};
     std::vector<uint8_t> m_payload;
@@ -182,20 +226,32 @@ private:
 class SnapshotReader
 {
 public:
-    void Attach(const uint8_t* buffer, size_t size)
+    // Returns false if the buffer is too short for the header and mask.
+    bool Attach(const uint8_t* buffer, size_t size)
     {
         m_buffer = buffer;
         m_size = size;
-        if (size >= sizeof(SnapshotHeader) + sizeof(SnapshotFieldFlags))
-        {
-            std::memcpy(&m_header, buffer, sizeof(SnapshotHeader));
-            std::memcpy(&m_flags, buffer + sizeof(SnapshotHeader), sizeof(SnapshotFieldFlags));
-            m_cursor = buffer + sizeof(SnapshotHeader) + sizeof(SnapshotFieldFlags);
-        }
+        m_cursor = buffer + size;
+        m_ok = false;
+        std::memset(&m_flags, 0, sizeof(m_flags));
+        if (size < sizeof(SnapshotHeader) + 1)
+            return false;
+        std::memcpy(&m_header, buffer, sizeof(SnapshotHeader));
+        const uint8_t maskBytes = buffer[sizeof(SnapshotHeader)];
+        if (maskBytes > sizeof(SnapshotFieldFlags) || size < sizeof(SnapshotHeader) + 1 + maskBytes)
+            return false;
+        const uint8_t* mask = buffer + sizeof(SnapshotHeader) + 1;
+        for (uint8_t i = 0; i < maskBytes; ++i)
+            m_flags.bits[i / 4] |= static_cast<uint32_t>(mask[i]) << ((i % 4) * 8);
+        m_cursor = mask + maskBytes;
+        m_ok = true;
+        return true;
     }
 
     bool Has(uint32_t fieldIndex) const
     {
+        if (fieldIndex >= kMaxSnapshotFields)
+            return false;
         const uint32_t word = fieldIndex / 32;
         const uint32_t bit = fieldIndex % 32;
         return (m_flags.bits[word] & (1u << bit)) != 0;
@@ -207,25 +263,441 @@ public:
         T out{};
         if (m_cursor + sizeof(T) <= m_buffer + m_size)
         {
-            std::memcpy(&out, m_cursor, sizeof(T));
+            out = FromBytes<T>(m_cursor);
             m_cursor += sizeof(T);
         }
+        else
+        {
+            m_ok = false;
+        }
         return out;
     }
 
+    // Value from the payload when the field is flagged, otherwise the baseline's.
+    template<typename T>
+    T ReadOr(uint32_t fieldIndex, const T& baseline)
+    {
+        return Has(fieldIndex) ? Read<T>() : baseline;
+    }
+
+    // False once the header was malformed or a Read ran past the buffer.
+    bool Ok() const
+    {
+        return m_ok;
+    }
+
+    SnapshotId GetId() const
+    {
+        return m_header.id;
+    }
+
     SnapshotId GetBaseId() const
     {
         return m_header.baseId;
     }
 
+    const SnapshotFieldFlags& GetFlags() const
+    {
+        return m_flags;
+    }
+
 private:
+    // RED4ext's Vector3 and Quaternion declare their own copy assignment, so
+    // they are not trivially copyable and are rebuilt from their floats.
+    template<typename T>
+    static T FromBytes(const uint8_t* bytes)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            T out;
+            std::memcpy(&out, bytes, sizeof(T));
+            return out;
+        }
+        else if constexpr (std::is_same_v<T, RED4ext::Vector3>)
+        {
+            float f[3];
+            std::memcpy(f, bytes, sizeof(f));
+            return RED4ext::Vector3(f[0], f[1], f[2]);
+        }
+        else if constexpr (std::is_same_v<T, RED4ext::Quaternion>)
+        {
+            float f[4];
+            std::memcpy(f, bytes, sizeof(f));
+            return RED4ext::Quaternion(f[0], f[1], f[2], f[3]);
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+            return T{};
+        }
+    }
+
     const uint8_t* m_buffer = nullptr;
     const uint8_t* m_cursor = nullptr;
     size_t m_size = 0;
+    bool m_ok = false;
     SnapshotHeader m_header{};
     SnapshotFieldFlags m_flags{};
 };
 
+// Serial-number comparison so ids keep ordering across uint32 wrap.
+inline bool SnapshotId_Newer(SnapshotId a, SnapshotId b)
+{
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+// Wire form of TransformSnap: 32 bytes when full instead of 56. Deltas are
+// taken between quantised values, so sub-millimetre jitter never sends a field
+// and both ends keep bit-identical baselines.
+struct TransformQuant
+{
+    QuantLocal pos;  // field flag index 0
+    QuantVel vel;    // field flag index 1
+    uint32_t rot;    // field flag index 2, smallest-three
+    uint16_t health; // field flag index 3
+    uint16_t armor;  // field flag index 4
+    uint32_t ownerId; // field flag index 5
+    uint16_t seq;    // field flag index 6
+    QuantCell cell;  // field flag index 7
+};
+
+inline TransformQuant TransformSnap_Quantize(const TransformSnap& snap)
+{
+    TransformQuant q{};
+    Quant_PackPos(snap.pos, q.cell, q.pos);
+    q.vel = Quant_PackVel(snap.vel);
+    q.rot = Quant_PackRot(snap.rot);
+    q.health = snap.health;
+    q.armor = snap.armor;
+    q.ownerId = snap.ownerId;
+    q.seq = snap.seq;
+    return q;
+}
+
+inline TransformSnap TransformSnap_Dequantize(const TransformQuant& q)
+{
+    TransformSnap snap{};
+    snap.pos = Quant_UnpackPos(q.cell, q.pos);
+    snap.vel = Quant_UnpackVel(q.vel);
+    snap.rot = Quant_UnpackRot(q.rot);
+    snap.health = q.health;
+    snap.armor = q.armor;
+    snap.ownerId = q.ownerId;
+    snap.seq = q.seq;
+    return snap;
+}
+
+// Field-by-field delta of a transform against `base` (nullptr = full snapshot).
+inline void TransformSnap_Write(SnapshotWriter& writer, const TransformQuant& snap, const TransformQuant* base)
+{
+    writer.WriteDelta(0, snap.pos, base ? &base->pos : nullptr);
+    writer.WriteDelta(1, snap.vel, base ? &base->vel : nullptr);
+    writer.WriteDelta(2, snap.rot, base ? &base->rot : nullptr);
+    writer.WriteDelta(3, snap.health, base ? &base->health : nullptr);
+    writer.WriteDelta(4, snap.armor, base ? &base->armor : nullptr);
+    writer.WriteDelta(5, snap.ownerId, base ? &base->ownerId : nullptr);
+    writer.WriteDelta(6, snap.seq, base ? &base->seq : nullptr);
+    writer.WriteDelta(7, snap.cell, base ? &base->cell : nullptr);
+}
+
+// Rebuilds a full transform from the reader, taking unflagged fields from `base`.
+inline TransformQuant TransformSnap_Read(SnapshotReader& reader, const TransformQuant& base)
+{
+    TransformQuant snap{};
+    snap.pos = reader.ReadOr(0, base.pos);
+    snap.vel = reader.ReadOr(1, base.vel);
+    snap.rot = reader.ReadOr(2, base.rot);
+    snap.health = reader.ReadOr(3, base.health);
+    snap.armor = reader.ReadOr(4, base.armor);
+    snap.ownerId = reader.ReadOr(5, base.ownerId);
+    snap.seq = reader.ReadOr(6, base.seq);
+    snap.cell = reader.ReadOr(7, base.cell);
+    return snap;
+}
+
+// Default slots per arena. Snapshot ids are per peer, so at 32 entities
+// updated at 30 Hz this keeps about a second of unacknowledged baselines.
+constexpr size_t kSnapshotArenaCapacity = 1024;
+
+// Fixed-capacity baseline store for one direction of one peer's delta streams
+// (every entity shares it). All slots are allocated up front in one block;
+// slot = id % capacity, so lookup by SnapshotId is O(1) and storing a new id
+// evicts the oldest baseline in that slot. The memory figure is constant for
+// the arena's lifetime and tracked process-wide in TotalBytes().
+class SnapshotBaselineArena
+{
+public:
+    explicit SnapshotBaselineArena(size_t capacity = kSnapshotArenaCapacity)
+        : m_slots(new Slot[capacity]())
+        , m_capacity(capacity)
+    {
+        s_totalBytes.fetch_add(Bytes(), std::memory_order_relaxed);
+    }
+
+    ~SnapshotBaselineArena()
+    {
+        s_totalBytes.fetch_sub(Bytes(), std::memory_order_relaxed);
+    }
+
+    SnapshotBaselineArena(const SnapshotBaselineArena&) = delete;
+    SnapshotBaselineArena& operator=(const SnapshotBaselineArena&) = delete;
+
+    void Store(SnapshotId id, uint32_t entityId, const TransformQuant& value)
+    {
+        Slot& slot = m_slots[id % m_capacity];
+        if (slot.id == 0)
+            ++m_occupied;
+        else if (slot.id != id)
+            ++m_evictions;
+        slot.id = id;
+        slot.entityId = entityId;
+        slot.value = value;
+    }
+
+    // nullptr when `id` was evicted, never stored, or belongs to another entity.
+    const TransformQuant* Find(SnapshotId id, uint32_t entityId) const
+    {
+        if (id == 0)
+            return nullptr;
+        const Slot& slot = m_slots[id % m_capacity];
+        return slot.id == id && slot.entityId == entityId ? &slot.value : nullptr;
+    }
+
+    void Clear()
+    {
+        for (size_t i = 0; i < m_capacity; ++i)
+            m_slots[i].id = 0;
+        m_occupied = 0;
+    }
+
+    size_t Capacity() const
+    {
+        return m_capacity;
+    }
+
+    size_t Occupied() const
+    {
+        return m_occupied;
+    }
+
+    uint64_t Evictions() const
+    {
+        return m_evictions;
+    }
+
+    size_t Bytes() const
+    {
+        return m_capacity * sizeof(Slot);
+    }
+
+    // Sum of Bytes() over all live arenas.
+    static size_t TotalBytes()
+    {
+        return s_totalBytes.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        SnapshotId id;
+        uint32_t entityId;
+        TransformQuant value;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_capacity;
+    size_t m_occupied = 0;
+    uint64_t m_evictions = 0;
+    static inline std::atomic<size_t> s_totalBytes{0};
+};
+
+struct SnapshotAckEntry
+{
+    uint32_t entityId;
+    SnapshotId snapshotId; // newest snapshot of this entity the peer resolved
+};
+
+// Sender half of TransformSnap delta streams to one peer. Ids come from one
+// per-peer sequence; each entity is encoded against the newest id the peer
+// acknowledged for it, or sent full when that baseline has been evicted from
+// the arena (or none was ever acknowledged).
+// Message layout: uint32 entityId | snapshot (see kSnapshotMaxOverhead).
+class SnapshotDeltaEncoder
+{
+public:
+    static constexpr size_t kMaxMessage = sizeof(uint32_t) + kSnapshotMaxOverhead + sizeof(TransformQuant);
+
+    explicit SnapshotDeltaEncoder(size_t capacity = kSnapshotArenaCapacity)
+        : m_sent(capacity)
+    {
+    }
+
+    size_t Encode(uint32_t entityId, const TransformSnap& snap, uint8_t* out, size_t max)
+    {
+        if (max < sizeof(uint32_t))
+            return 0;
+        SnapshotId id = m_lastId + 1;
+        if (id == 0)
+            id = 1;
+        const SnapshotId acked = m_acked[entityId];
+        const TransformQuant* base = m_sent.Find(acked, entityId);
+        const TransformQuant q = TransformSnap_Quantize(snap);
+        m_writer.Begin({id, base ? acked : 0u});
+        TransformSnap_Write(m_writer, q, base);
+        const size_t bytes = m_writer.End(out + sizeof(uint32_t), max - sizeof(uint32_t));
+        if (bytes == 0)
+            return 0;
+        std::memcpy(out, &entityId, sizeof(uint32_t));
+        m_sent.Store(id, entityId, q);
+        m_lastId = id;
+        ++(base ? m_deltaCount : m_fullCount);
+        return sizeof(uint32_t) + bytes;
+    }
+
+    // Returns true if the ack advanced the entity's baseline.
+    bool OnAck(uint32_t entityId, SnapshotId id)
+    {
+        auto it = m_acked.find(entityId);
+        if (it == m_acked.end() || !m_sent.Find(id, entityId))
+            return false;
+        if (it->second != 0 && !SnapshotId_Newer(id, it->second))
+            return false;
+        it->second = id;
+        return true;
+    }
+
+    // Baselines stay in the arena until overwritten but become unreachable.
+    void Forget(uint32_t entityId)
+    {
+        m_acked.erase(entityId);
+    }
+
+    const SnapshotBaselineArena& GetArena() const
+    {
+        return m_sent;
+    }
+
+    uint64_t GetFullCount() const
+    {
+        return m_fullCount;
+    }
+
+    uint64_t GetDeltaCount() const
+    {
+        return m_deltaCount;
+    }
+
+private:
+    SnapshotBaselineArena m_sent;
+    std::unordered_map<uint32_t, SnapshotId> m_acked; // entity -> newest acked id
+    SnapshotId m_lastId = 0;
+    SnapshotWriter m_writer;
+    uint64_t m_fullCount = 0;
+    uint64_t m_deltaCount = 0;
+};
+
+enum class SnapshotDecodeResult : uint8_t
+{
+    Applied,        // newest state for the entity; `out` is valid
+    Stale,          // resolved but older than what was already applied
+    MissingBaseline, // baseline evicted or never received; dropped
+    Malformed
+};
+
+// Receiver half: resolves deltas against the baseline arena and collects
+// acknowledgements, which TakeAcks() hands out once per tick.
+class SnapshotDeltaDecoder
+{
+public:
+    explicit SnapshotDeltaDecoder(size_t capacity = kSnapshotArenaCapacity)
+        : m_received(capacity)
+    {
+    }
+
+    SnapshotDecodeResult Decode(const uint8_t* data, size_t size, uint32_t& entityId, TransformSnap& out)
+    {
+        if (size < sizeof(uint32_t))
+            return SnapshotDecodeResult::Malformed;
+        std::memcpy(&entityId, data, sizeof(uint32_t));
+        SnapshotReader reader;
+        if (!reader.Attach(data + sizeof(uint32_t), size - sizeof(uint32_t)) || reader.GetId() == 0)
+            return SnapshotDecodeResult::Malformed;
+
+        Stream& stream = m_streams[entityId];
+        const TransformQuant* base = nullptr;
+        if (reader.GetBaseId() != 0)
+        {
+            base = m_received.Find(reader.GetBaseId(), entityId);
+            if (!base)
+            {
+                // Re-ack what we do hold so the sender moves its baseline forward.
+                if (stream.latestId != 0)
+                    QueueAck(entityId, stream);
+                return SnapshotDecodeResult::MissingBaseline;
+            }
+        }
+        const TransformQuant q = TransformSnap_Read(reader, base ? *base : TransformQuant{});
+        if (!reader.Ok())
+            return SnapshotDecodeResult::Malformed;
+
+        m_received.Store(reader.GetId(), entityId, q);
+        if (stream.latestId != 0 && !SnapshotId_Newer(reader.GetId(), stream.latestId))
+            return SnapshotDecodeResult::Stale;
+        stream.latestId = reader.GetId();
+        QueueAck(entityId, stream);
+        out = TransformSnap_Dequantize(q);
+        if (!reader.Has(6))
+            out.seq = static_cast<uint16_t>(reader.GetId());
+        return SnapshotDecodeResult::Applied;
+    }
+
+    // Moves up to `max` pending acks into `out`; the rest stay queued.
+    size_t TakeAcks(SnapshotAckEntry* out, size_t max)
+    {
+        size_t n = 0;
+        while (n < max && !m_pending.empty())
+        {
+            const uint32_t entityId = m_pending.back();
+            m_pending.pop_back();
+            auto it = m_streams.find(entityId);
+            if (it == m_streams.end() || !it->second.ackPending)
+                continue;
+            it->second.ackPending = false;
+            out[n++] = {entityId, it->second.latestId};
+        }
+        return n;
+    }
+
+    void Forget(uint32_t entityId)
+    {
+        m_streams.erase(entityId);
+    }
+
+    const SnapshotBaselineArena& GetArena() const
+    {
+        return m_received;
+    }
+
+private:
+    struct Stream
+    {
+        SnapshotId latestId = 0;
+        bool ackPending = false;
+    };
+
+    void QueueAck(uint32_t entityId, Stream& stream)
+    {
+        if (stream.ackPending)
+            return;
+        stream.ackPending = true;
+        m_pending.push_back(entityId);
+    }
+
+    SnapshotBaselineArena m_received;
+    std::unordered_map<uint32_t, Stream> m_streams;
+    std::vector<uint32_t> m_pending;
+};
+
 // Entity snapshot for server-side entity tracking
 struct EntitySnap
 {
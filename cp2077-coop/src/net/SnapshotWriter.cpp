@@ -1,8 +1,7 @@
 // #include "../runtime/QuestSync.reds" // REMOVED: Cannot include .reds in C++
 // #include "../runtime/SpectatorCam.reds" // REMOVED: Cannot include .reds in C++
-#include "Snapshot.hpp"
-#include <vector>
-#include <mutex>
+#include "SnapshotWriter.hpp"
+#include <thread>
 
 // Temporary namespaces for missing .reds includes
 namespace QuestSync {
@@ -16,32 +15,160 @@ namespace SpectatorCam {
 namespace CoopNet
 {
 
-std::vector<EntitySnap> g_entitySnaps;
-std::mutex g_entitySnapsMutex;
+void EntitySnapStore::Write(uint32_t id, uint32_t phaseId, const TransformSnap& snap)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    Frame& back = Back();
+    auto it = m_slots.find(id);
+    if (it != m_slots.end())
+    {
+        Partition& p = back.partitions[it->second.partition];
+        if (p.phaseId == phaseId)
+        {
+            p.snaps[it->second.row] = snap;
+            m_dirty.push_back(it->second);
+            return;
+        }
+        RemoveLocked(back, it); // changed phase
+    }
+    const uint32_t partition = PartitionFor(back, phaseId);
+    Partition& p = back.partitions[partition];
+    m_slots[id] = {partition, static_cast<uint32_t>(p.ids.size())};
+    p.ids.push_back(id);
+    p.snaps.push_back(snap);
+    m_layoutChanged = true;
+}
+
+void EntitySnapStore::Remove(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto it = m_slots.find(id);
+    if (it != m_slots.end())
+        RemoveLocked(Back(), it);
+}
+
+void EntitySnapStore::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    for (Partition& p : Back().partitions)
+    {
+        p.ids.clear();
+        p.snaps.clear();
+    }
+    m_slots.clear();
+    m_layoutChanged = true;
+}
+
+void EntitySnapStore::Publish()
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    const uint32_t live = m_front.load() ^ 1u;
+    m_frames[live].generation = m_frames[live ^ 1u].generation + 1;
+    m_front.store(live);
+
+    // The old front becomes the next back copy once its readers are gone.
+    const uint32_t stale = live ^ 1u;
+    while (m_readers[stale].load() != 0)
+        std::this_thread::yield();
+    Frame& dst = m_frames[stale];
+    const Frame& src = m_frames[live];
+    if (m_layoutChanged)
+    {
+        // Element-wise assignment keeps the destination vectors' capacity.
+        dst.partitions = src.partitions;
+    }
+    else
+    {
+        for (const Slot& s : m_dirty)
+            dst.partitions[s.partition].snaps[s.row] = src.partitions[s.partition].snaps[s.row];
+    }
+    dst.generation = src.generation;
+    m_dirty.clear();
+    m_layoutChanged = false;
+}
+
+void EntitySnapStore::Frame::AppendPhase(uint32_t phaseId, std::vector<EntitySnap>& out) const
+{
+    const Partition* p = Find(phaseId);
+    if (!p)
+        return;
+    const size_t base = out.size();
+    out.resize(base + p->ids.size());
+    for (size_t i = 0; i < p->ids.size(); ++i)
+        out[base + i] = {p->ids[i], phaseId, p->snaps[i]};
+}
+
+size_t EntitySnapStore::GetSize() const
+{
+    size_t n = 0;
+    Read([&](const Frame& frame) {
+        for (const Partition& p : frame.partitions)
+            n += p.ids.size();
+    });
+    return n;
+}
+
+uint32_t EntitySnapStore::PartitionFor(Frame& frame, uint32_t phaseId)
+{
+    for (uint32_t i = 0; i < frame.partitions.size(); ++i)
+    {
+        if (frame.partitions[i].phaseId == phaseId)
+            return i;
+    }
+    frame.partitions.push_back({phaseId, {}, {}});
+    return static_cast<uint32_t>(frame.partitions.size() - 1);
+}
+
+// Swap-remove keeps the partition contiguous; the moved entity's slot is
+// patched so the id -> slot map stays valid.
+void EntitySnapStore::RemoveLocked(Frame& frame, std::unordered_map<uint32_t, Slot>::iterator it)
+{
+    const Slot slot = it->second;
+    Partition& p = frame.partitions[slot.partition];
+    const uint32_t last = static_cast<uint32_t>(p.ids.size() - 1);
+    if (slot.row != last)
+    {
+        p.ids[slot.row] = p.ids[last];
+        p.snaps[slot.row] = p.snaps[last];
+        m_slots[p.ids[slot.row]].row = slot.row;
+    }
+    p.ids.pop_back();
+    p.snaps.pop_back();
+    m_slots.erase(it);
+    m_layoutChanged = true;
+}
+
+static EntitySnapStore g_entitySnaps;
 
 void AddEntitySnap(uint32_t id, uint32_t phaseId, const TransformSnap& snap)
 {
-    std::lock_guard<std::mutex> lock(g_entitySnapsMutex);
-    g_entitySnaps.push_back({id, phaseId, snap});
+    g_entitySnaps.Write(id, phaseId, snap);
+}
+
+void RemoveEntitySnap(uint32_t id)
+{
+    g_entitySnaps.Remove(id);
 }
 
 void ClearEntitySnaps()
 {
-    std::lock_guard<std::mutex> lock(g_entitySnapsMutex);
-    g_entitySnaps.clear();
+    g_entitySnaps.Clear();
+}
+
+void PublishEntitySnaps()
+{
+    g_entitySnaps.Publish();
 }
 
 void BuildSnapshot(std::vector<EntitySnap>& out)
 {
     uint32_t local = QuestSync::localPhase;
     uint32_t spectate = SpectatorCam::spectatePhase;
-    std::lock_guard<std::mutex> lock(g_entitySnapsMutex);
-    for (auto& e : g_entitySnaps)
-    {
-        if (e.phaseId != local && e.phaseId != spectate)
-            continue; // PX-3
-        out.push_back(e);
-    }
+    g_entitySnaps.Read([&](const EntitySnapStore::Frame& frame) {
+        frame.AppendPhase(local, out); // PX-3
+        if (spectate != local)
+            frame.AppendPhase(spectate, out);
+    });
 }
 
 } // namespace CoopNet
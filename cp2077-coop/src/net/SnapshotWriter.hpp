@@ -0,0 +1,106 @@
+#pragma once
+
+// Server-side entity snapshot store (PX-3 phase filtering).
+//
+// Entities live in per-phase partitions laid out as parallel arrays (ids and
+// transforms), with a stable id -> slot map so an update is a single indexed
+// write. There are two copies of the store: writers update the back copy
+// during the tick and PublishEntitySnaps() swaps it to the front atomically.
+// Readers pin the front copy with a reader count and scan one phase's
+// partition contiguously without taking a lock; Publish waits for readers of
+// the old front to leave before bringing it up to date as the next back copy.
+
+#include "Snapshot.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace CoopNet
+{
+class EntitySnapStore
+{
+public:
+    struct Partition
+    {
+        uint32_t phaseId;
+        std::vector<uint32_t> ids;
+        std::vector<TransformSnap> snaps;
+    };
+
+    struct Frame
+    {
+        std::vector<Partition> partitions;
+        uint64_t generation = 0; // Publish() count when this frame went live
+
+        const Partition* Find(uint32_t phaseId) const
+        {
+            for (const Partition& p : partitions)
+            {
+                if (p.phaseId == phaseId)
+                    return &p;
+            }
+            return nullptr;
+        }
+
+        // Appends the entities of `phaseId` to `out`.
+        void AppendPhase(uint32_t phaseId, std::vector<EntitySnap>& out) const;
+    };
+
+    // Writer side; visible to readers after the next Publish().
+    void Write(uint32_t id, uint32_t phaseId, const TransformSnap& snap);
+    void Remove(uint32_t id);
+    void Clear();
+    void Publish();
+
+    // Calls fn(const Frame&) on the published frame. Lock-free; the frame
+    // stays valid and unchanged until fn returns.
+    template <typename Fn>
+    void Read(Fn&& fn) const
+    {
+        uint32_t f;
+        for (;;)
+        {
+            f = m_front.load();
+            m_readers[f].fetch_add(1);
+            if (m_front.load() == f)
+                break;
+            m_readers[f].fetch_sub(1); // swapped under us; pin the new front
+        }
+        fn(m_frames[f]);
+        m_readers[f].fetch_sub(1);
+    }
+
+    size_t GetSize() const;
+
+private:
+    struct Slot
+    {
+        uint32_t partition;
+        uint32_t row;
+    };
+
+    Frame& Back() { return m_frames[m_front.load() ^ 1u]; }
+    uint32_t PartitionFor(Frame& frame, uint32_t phaseId);
+    void RemoveLocked(Frame& frame, std::unordered_map<uint32_t, Slot>::iterator it);
+
+    Frame m_frames[2];
+    std::atomic<uint32_t> m_front{0};
+    mutable std::atomic<uint32_t> m_readers[2]{};
+
+    std::mutex m_writeMutex; // serialises writers; readers never take it
+    std::unordered_map<uint32_t, Slot> m_slots;
+    std::vector<Slot> m_dirty; // rows written since Publish, for the back-copy sync
+    bool m_layoutChanged = false; // rows added, removed or moved since Publish
+};
+
+void AddEntitySnap(uint32_t id, uint32_t phaseId, const TransformSnap& snap);
+void RemoveEntitySnap(uint32_t id);
+void ClearEntitySnaps();
+// Makes this tick's AddEntitySnap/RemoveEntitySnap calls visible to
+// BuildSnapshot. Call once per tick from the tick thread.
+void PublishEntitySnaps();
+// Published entities in the local and spectated phases.
+void BuildSnapshot(std::vector<EntitySnap>& out);
+} // namespace CoopNet
@@ -1,5 +1,6 @@
 #include "StatBatch.hpp"
 #include "Net.hpp"
+#include "../core/TickProfiler.hpp"
 #include "../../third_party/httplib.h"
 #include <iostream>
 #include <sstream>
@@ -37,6 +38,7 @@ static void FlushStats()
 
 void StatBatch_Tick(float dt)
 {
+    COOP_PROFILE_SCOPE("StatBatch_Tick");
     g_timer += dt;
     if (g_timer >= 30.f)
     {
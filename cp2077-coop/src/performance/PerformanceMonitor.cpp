@@ -1,10 +1,12 @@
 #include "PerformanceMonitor.hpp"
 #include "../core/Logger.hpp"
+#include "../core/Metrics.hpp"
 #include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <iterator>
 #include <spdlog/spdlog.h>
 
 // Platform-specific includes
@@ -16,6 +18,58 @@
 
 namespace CoopNet {
 
+namespace {
+MetricHistogram& FrameTimeHistogram() {
+    static MetricHistogram& hist =
+        GetMetrics().Histogram("coop_frame_time_seconds", "Frame time reported to PerformanceMonitor", MetricTimeBuckets());
+    return hist;
+}
+
+MetricHistogram& ProfileScopeHistogram(const std::string& scopeName) {
+    return GetMetrics().Histogram("coop_profile_scope_seconds", "Time spent in profiled scopes", MetricTimeBuckets(),
+                                  "scope=\"" + scopeName + "\"");
+}
+
+// Registry gauge for each built-in metric, converted to base units. Frame
+// time has its own histogram and custom metrics are not exported.
+MetricGauge* MetricGaugeFor(MetricType type, float& scale) {
+    struct Entry {
+        const char* name;
+        const char* help;
+        float scale;
+    };
+    static const Entry entries[] = {
+        {"coop_fps", "Frames per second", 1.0f},
+        {nullptr, nullptr, 0.0f},
+        {"coop_cpu_usage_ratio", "CPU usage", 0.01f},
+        {"coop_memory_usage_ratio", "Physical memory in use", 0.01f},
+        {"coop_net_latency_seconds", "Network latency", 0.001f},
+        {"coop_net_bandwidth_bytes_per_second", "Network bandwidth", 1024.0f},
+        {nullptr, nullptr, 0.0f},
+        {"coop_gpu_usage_ratio", "GPU usage", 0.01f},
+        {"coop_audio_latency_seconds", "Audio latency", 0.001f},
+        {"coop_voice_latency_seconds", "Voice latency", 0.001f},
+    };
+    static MetricGauge* gauges[std::size(entries)] = {};
+    static std::once_flag once;
+    std::call_once(once, [] {
+        for (size_t i = 0; i < std::size(entries); ++i) {
+            if (entries[i].name)
+                gauges[i] = &GetMetrics().Gauge(entries[i].name, entries[i].help);
+        }
+    });
+
+    const size_t index = static_cast<size_t>(type);
+    if (index >= std::size(entries))
+        return nullptr;
+    scale = entries[index].scale;
+    return gauges[index];
+}
+
+thread_local std::unordered_map<std::string, std::chrono::steady_clock::time_point> t_openScopes;
+thread_local std::unordered_map<std::string, MetricHistogram*> t_scopeHistograms;
+} // namespace
+
 PerformanceMonitor& PerformanceMonitor::Instance() {
     static PerformanceMonitor instance;
     return instance;
@@ -108,29 +162,33 @@ void PerformanceMonitor::Update(float deltaTime) {
 
     auto currentTime = std::chrono::steady_clock::now();
 
-    // Calculate FPS from deltaTime
+    // Record the frame; FPS is derived when the metrics are sampled
     if (deltaTime > 0.0f) {
-        float fps = 1.0f / deltaTime;
-        UpdateMetric(MetricType::FPS, fps);
-        UpdateMetric(MetricType::FrameTime, deltaTime * 1000.0f); // Convert to milliseconds
+        RecordFrameTime(deltaTime * 1000.0f); // Convert to milliseconds
     }
 
-    // Update system metrics periodically (every 100ms)
+    // Sample metrics periodically (every 100ms) so a frame never takes the
+    // metric or alert locks
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
         currentTime - m_lastUpdate).count();
 
-    if (elapsed >= 100) {
-        // Update CPU usage
-        UpdateMetric(MetricType::CPUUsage, GetCurrentCPUUsage());
+    if (elapsed < 100) {
+        return;
+    }
 
-        // Update memory usage
-        UpdateMetric(MetricType::MemoryUsage, GetCurrentMemoryUsage());
+    // Fold the recorded frames into FPS and frame time
+    ProcessMetricUpdates();
 
-        // Update GPU usage
-        UpdateMetric(MetricType::GPUUsage, GetCurrentGPUUsage());
+    // Update CPU usage
+    UpdateMetric(MetricType::CPUUsage, GetCurrentCPUUsage());
 
-        m_lastUpdate = currentTime;
-    }
+    // Update memory usage
+    UpdateMetric(MetricType::MemoryUsage, GetCurrentMemoryUsage());
+
+    // Update GPU usage
+    UpdateMetric(MetricType::GPUUsage, GetCurrentGPUUsage());
+
+    m_lastUpdate = currentTime;
 
     // Update statistics
     UpdateStatistics();
@@ -233,6 +291,11 @@ bool PerformanceMonitor::RegisterMetric(MetricType type, const std::string& name
 }
 
 bool PerformanceMonitor::UpdateMetric(MetricType type, float value) {
+    float scale = 1.0f;
+    if (MetricGauge* gauge = MetricGaugeFor(type, scale)) {
+        gauge->Set(static_cast<double>(value) * scale);
+    }
+
     std::lock_guard<std::mutex> lock(m_metricsMutex);
 
     auto it = m_metrics.find(type);
@@ -293,26 +356,38 @@ float PerformanceMonitor::CalculateMovingAverage(const std::queue<float>& histor
 }
 
 void PerformanceMonitor::RecordFrameTime(float frameTimeMs) {
-    UpdateMetric(MetricType::FrameTime, frameTimeMs);
+    // One sharded add per frame; ProcessMetricUpdates turns the frames since
+    // the last sample into the FrameTime and FPS metrics
+    FrameTimeHistogram().Observe(frameTimeMs / 1000.0);
+}
 
-    // Calculate FPS
-    float fps = (frameTimeMs > 0.0f) ? (1000.0f / frameTimeMs) : 0.0f;
-    UpdateMetric(MetricType::FPS, fps);
+void PerformanceMonitor::ProcessMetricUpdates() {
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
 
-    // Update FPS history for more accurate calculations
-    {
-        std::lock_guard<std::mutex> lock(m_metricsMutex);
-        m_frameTimeHistory.push(frameTimeMs);
+    const auto frames = FrameTimeHistogram().Read();
+    if (frames.count <= m_lastFrameCount) {
+        return;
+    }
 
-        while (m_frameTimeHistory.size() > 60) { // Keep last 60 frames
-            m_frameTimeHistory.pop();
-        }
+    const uint64_t count = frames.count - m_lastFrameCount;
+    const float avgFrameTime = static_cast<float>((frames.sum - m_lastFrameSum) * 1000.0 / count);
+    m_lastFrameCount = frames.count;
+    m_lastFrameSum = frames.sum;
+    m_currentFPS = (avgFrameTime > 0.0f) ? (1000.0f / avgFrameTime) : 0.0f;
 
-        // Calculate smoothed FPS
-        if (!m_frameTimeHistory.empty()) {
-            float avgFrameTime = CalculateMovingAverage(m_frameTimeHistory, 30);
-            m_currentFPS = (avgFrameTime > 0.0f) ? (1000.0f / avgFrameTime) : 0.0f;
-        }
+    float scale = 1.0f;
+    if (MetricGauge* gauge = MetricGaugeFor(MetricType::FPS, scale)) {
+        gauge->Set(m_currentFPS);
+    }
+
+    auto frameTimeIt = m_metrics.find(MetricType::FrameTime);
+    if (frameTimeIt != m_metrics.end()) {
+        ProcessMetric(frameTimeIt->second, avgFrameTime);
+    }
+
+    auto fpsIt = m_metrics.find(MetricType::FPS);
+    if (fpsIt != m_metrics.end()) {
+        ProcessMetric(fpsIt->second, m_currentFPS);
     }
 }
 
@@ -554,29 +629,54 @@ uint64_t PerformanceMonitor::GenerateAlertId() {
 // Performance profiler implementation
 PerformanceProfiler::PerformanceProfiler(const std::string& scopeName)
     : m_scopeName(scopeName), m_startTime(std::chrono::steady_clock::now()) {
-    PerformanceMonitor::Instance().BeginProfileScope(m_scopeName);
 }
 
 PerformanceProfiler::~PerformanceProfiler() {
-    PerformanceMonitor::Instance().EndProfileScope(m_scopeName);
+    PerformanceMonitor::Instance().RecordProfileScope(m_scopeName, std::chrono::steady_clock::now() - m_startTime);
 }
 
 void PerformanceMonitor::BeginProfileScope(const std::string& scopeName) {
-    std::lock_guard<std::mutex> lock(m_profileMutex);
-    m_profileScopes[scopeName] = std::chrono::steady_clock::now();
+    t_openScopes[scopeName] = std::chrono::steady_clock::now();
 }
 
 void PerformanceMonitor::EndProfileScope(const std::string& scopeName) {
     auto endTime = std::chrono::steady_clock::now();
 
-    std::lock_guard<std::mutex> lock(m_profileMutex);
+    auto it = t_openScopes.find(scopeName);
+    if (it != t_openScopes.end()) {
+        RecordProfileScope(scopeName, endTime - it->second);
+        t_openScopes.erase(it);
+    }
+}
 
-    auto it = m_profileScopes.find(scopeName);
-    if (it != m_profileScopes.end()) {
-        auto duration = std::chrono::duration<float, std::milli>(endTime - it->second);
-        m_profileStats[scopeName] = duration.count();
-        m_profileScopes.erase(it);
+void PerformanceMonitor::RecordProfileScope(const std::string& scopeName, std::chrono::steady_clock::duration duration) {
+    // Each thread caches the histogram, so only a scope's first use on a
+    // thread takes a lock
+    MetricHistogram*& hist = t_scopeHistograms[scopeName];
+    if (!hist) {
+        hist = &ProfileScopeHistogram(scopeName);
+
+        std::lock_guard<std::mutex> lock(m_profileMutex);
+        if (std::find(m_profileScopeNames.begin(), m_profileScopeNames.end(), scopeName) == m_profileScopeNames.end()) {
+            m_profileScopeNames.push_back(scopeName);
+        }
     }
+    hist->Observe(std::chrono::duration<double>(duration).count());
+}
+
+std::unordered_map<std::string, float> PerformanceMonitor::GetProfileScopeStats() const {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(m_profileMutex);
+        names = m_profileScopeNames;
+    }
+
+    std::unordered_map<std::string, float> stats;
+    for (const auto& name : names) {
+        const auto snap = ProfileScopeHistogram(name).Read();
+        stats[name] = snap.count ? static_cast<float>(snap.sum * 1000.0 / snap.count) : 0.0f;
+    }
+    return stats;
 }
 
 // Performance presets implementation
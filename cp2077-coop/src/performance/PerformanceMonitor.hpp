@@ -150,7 +150,9 @@ public:
     PerformanceMetric GetMetric(const std::string& name) const;
     std::vector<PerformanceMetric> GetAllMetrics() const;
 
-    // FPS and frame time monitoring
+    // FPS and frame time monitoring. RecordFrameTime only feeds the
+    // coop_frame_time_seconds histogram in the metrics registry; the FPS and
+    // FrameTime metrics are folded in from it when the monitor samples.
     void RecordFrameTime(float frameTimeMs);
     float GetCurrentFPS() const;
     float GetAverageFrameTime() const;
@@ -231,9 +233,13 @@ public:
     bool RegisterCustomMetric(const std::string& name, const std::string& unit = "");
     bool UpdateCustomMetric(const std::string& name, float value);
 
-    // Profiling integration
+    // Profiling integration. Scope durations go to the
+    // coop_profile_scope_seconds{scope="..."} histograms in the metrics
+    // registry; open scopes are tracked per thread. The stats are the mean
+    // duration of each scope in milliseconds.
     void BeginProfileScope(const std::string& scopeName);
     void EndProfileScope(const std::string& scopeName);
+    void RecordProfileScope(const std::string& scopeName, std::chrono::steady_clock::duration duration);
     std::unordered_map<std::string, float> GetProfileScopeStats() const;
 
 private:
@@ -299,9 +305,8 @@ private:
     std::unordered_map<MetricType, float> m_thresholds;
     std::unordered_map<std::string, float> m_customThresholds;
 
-    // Profiling scopes
-    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_profileScopes;
-    std::unordered_map<std::string, float> m_profileStats;
+    // Profiling scopes seen so far; the durations live in the registry
+    std::vector<std::string> m_profileScopeNames;
 
     // Configuration
     PerformanceProfile m_currentProfile;
@@ -333,8 +338,9 @@ private:
     std::chrono::steady_clock::time_point m_lastUpdate;
     std::chrono::steady_clock::time_point m_sessionStart;
 
-    // FPS calculation
-    std::queue<float> m_frameTimeHistory;
+    // FPS calculation, from the frame time histogram since the last sample
+    uint64_t m_lastFrameCount = 0;
+    double m_lastFrameSum = 0.0;
     float m_currentFPS = 0.0f;
     std::chrono::steady_clock::time_point m_lastFPSUpdate;
 
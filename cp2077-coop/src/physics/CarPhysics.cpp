@@ -78,6 +78,6 @@ void HandleHighSpeedCollision(uint32_t idA, TransformSnap& a, float latencyAms,
     RED4ext::Vector3 delta = (b.vel - a.vel) * 0.5f;
     a.vel = a.vel + delta;
     b.vel = b.vel - delta;
-    Net_BroadcastVehicleHitHighSpeed(idA, idB, delta);
+    Net_BroadcastVehicleHitHighSpeed(idA, idB, delta, a.pos);
 }
 } // namespace CoopNet
@@ -1,14 +1,186 @@
 #include "LagComp.hpp"
-
-// rewind = pos - vel * (clientRTTms / 1000.f)
+#include <algorithm>
+#include <cmath>
 
 namespace CoopNet
 {
-RED4ext::Vector3 RewindPosition(const RED4ext::Vector3& pos,
-                                const RED4ext::Vector3& vel,
-                                float clientRTTms)
+LagCompHistory g_lagComp;
+
+LagCompHistory::LagCompHistory(uint32_t capacityTicks)
+    : m_capacity(std::max<uint32_t>(capacityTicks, 2))
+{
+}
+
+uint32_t LagCompHistory::RowFor(uint32_t entityId)
+{
+    auto it = m_rows.find(entityId);
+    if (it != m_rows.end())
+        return it->second;
+    uint32_t row;
+    if (!m_freeRows.empty())
+    {
+        row = m_freeRows.back();
+        m_freeRows.pop_back();
+    }
+    else
+    {
+        row = static_cast<uint32_t>(m_newest.size());
+        const size_t cells = static_cast<size_t>(row + 1) * m_capacity;
+        m_tick.resize(cells, kNoTick);
+        m_x.resize(cells);
+        m_y.resize(cells);
+        m_z.resize(cells);
+        m_newest.push_back(kNoTick);
+        m_rowEntity.push_back(0);
+    }
+    m_rowEntity[row] = entityId;
+    m_rows.emplace(entityId, row);
+    return row;
+}
+
+void LagCompHistory::Record(uint32_t entityId, uint64_t tick, const RED4ext::Vector3& pos)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint32_t row = RowFor(entityId);
+    const size_t idx = static_cast<size_t>(row) * m_capacity + tick % m_capacity;
+    m_tick[idx] = tick;
+    m_x[idx] = pos.X;
+    m_y[idx] = pos.Y;
+    m_z[idx] = pos.Z;
+    if (m_newest[row] == kNoTick || tick > m_newest[row])
+        m_newest[row] = tick;
+    m_latestTick = std::max(m_latestTick, tick);
+}
+
+void LagCompHistory::Remove(uint32_t entityId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rows.find(entityId);
+    if (it == m_rows.end())
+        return;
+    const uint32_t row = it->second;
+    std::fill_n(m_tick.begin() + static_cast<size_t>(row) * m_capacity, m_capacity, kNoTick);
+    m_newest[row] = kNoTick;
+    m_freeRows.push_back(row);
+    m_rows.erase(it);
+}
+
+void LagCompHistory::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tick.clear();
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_newest.clear();
+    m_rowEntity.clear();
+    m_freeRows.clear();
+    m_rows.clear();
+    m_latestTick = 0;
+}
+
+// Samples older than newest - capacity + 1 have been overwritten (or belong
+// to a previous lap of the ring), so only ticks inside that window count.
+RED4ext::Vector3 LagCompHistory::SampleRow(uint32_t row, double tick) const
+{
+    const size_t base = static_cast<size_t>(row) * m_capacity;
+    const uint64_t newest = m_newest[row];
+    const uint64_t oldest = newest >= m_capacity - 1 ? newest - (m_capacity - 1) : 0;
+    auto at = [&](uint64_t t) { return base + t % m_capacity; };
+    auto has = [&](uint64_t t) { return m_tick[at(t)] == t; };
+    auto pos = [&](uint64_t t) {
+        const size_t i = at(t);
+        return RED4ext::Vector3(m_x[i], m_y[i], m_z[i]);
+    };
+
+    if (!(tick < static_cast<double>(newest)))
+        return pos(newest);
+    const uint64_t floorTick =
+        std::clamp(static_cast<uint64_t>(std::max(0.0, std::floor(tick))), oldest, newest);
+
+    // Bracket `tick` with the nearest recorded samples; normally these are
+    // floorTick and floorTick + 1.
+    uint64_t a = floorTick;
+    while (a > oldest && !has(a))
+        --a;
+    uint64_t b = floorTick + 1;
+    while (b < newest && !has(b))
+        ++b;
+    if (!has(a))
+        return pos(b); // before the first sample we still hold
+    const double span = static_cast<double>(b - a);
+    const float alpha = static_cast<float>(std::clamp((tick - static_cast<double>(a)) / span, 0.0, 1.0));
+    const size_t ia = at(a), ib = at(b);
+    return RED4ext::Vector3(m_x[ia] + (m_x[ib] - m_x[ia]) * alpha, m_y[ia] + (m_y[ib] - m_y[ia]) * alpha,
+                            m_z[ia] + (m_z[ib] - m_z[ia]) * alpha);
+}
+
+bool LagCompHistory::Rewind(uint32_t entityId, double tick, RED4ext::Vector3& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rows.find(entityId);
+    if (it == m_rows.end() || m_newest[it->second] == kNoTick)
+        return false;
+    out = SampleRow(it->second, tick);
+    return true;
+}
+
+size_t LagCompHistory::RewindBatch(const uint32_t* ids, size_t count, double tick, RED4ext::Vector3* out,
+                                   bool* found) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t hits = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto it = m_rows.find(ids[i]);
+        found[i] = it != m_rows.end() && m_newest[it->second] != kNoTick;
+        if (!found[i])
+            continue;
+        out[i] = SampleRow(it->second, tick);
+        ++hits;
+    }
+    return hits;
+}
+
+size_t LagCompHistory::RewindNear(const RED4ext::Vector3& origin, float radius, double tick,
+                                  std::vector<LagCompSample>& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const float r2 = radius * radius;
+    const size_t before = out.size();
+    for (uint32_t row = 0; row < m_newest.size(); ++row)
+    {
+        if (m_newest[row] == kNoTick)
+            continue; // free row
+        const RED4ext::Vector3 p = SampleRow(row, tick);
+        const float dx = p.X - origin.X, dy = p.Y - origin.Y, dz = p.Z - origin.Z;
+        if (dx * dx + dy * dy + dz * dz <= r2)
+        {
+            LagCompSample& sample = out.emplace_back();
+            sample.entityId = m_rowEntity[row];
+            sample.pos = p;
+        }
+    }
+    return out.size() - before;
+}
+
+size_t LagCompHistory::GetEntityCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rows.size();
+}
+
+double LagCompHistory::ViewTick(float rttMs, float interpMs) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const double back = (static_cast<double>(rttMs) + interpMs) / m_tickMs;
+    return std::max(0.0, static_cast<double>(m_latestTick) - back);
+}
+
+void LagCompHistory::SetTickMs(float tickMs)
 {
-    float t = clientRTTms / 1000.f;
-    return pos - vel * t;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (tickMs > 0.f)
+        m_tickMs = tickMs;
 }
 } // namespace CoopNet
@@ -1,13 +1,85 @@
 #pragma once
 
-// Helper for lag compensation on the server.
-// Rewinds a target position based on client RTT.
+// Server-side lag compensation.
+// Keeps a short per-entity history of positions, one sample per server tick,
+// so a hit claimed by a client can be checked against where the target was
+// on that client's screen rather than extrapolated from its current velocity.
+// Samples live in structure-of-arrays rings (one row of kLagCompHistoryTicks
+// per entity, ring index = tick % capacity) and Rewind interpolates between
+// the two samples around a fractional tick.
 
 #include <RED4ext/Scripting/Natives/Vector3.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace CoopNet
 {
-RED4ext::Vector3 RewindPosition(const RED4ext::Vector3& pos,
-                                const RED4ext::Vector3& vel,
-                                float clientRTTms);
+// Samples kept per entity. The window in time depends on the loop recording
+// them: 1 s at DedicatedServer's default 64 Hz, 1.6-2.6 s at DedicatedMain's
+// adaptive 25-40 ms ticks. Either covers RTT + kLagCompInterpMs for any
+// playable connection.
+constexpr uint32_t kLagCompHistoryTicks = 64;
+constexpr float kLagCompHitTolerance = 1.0f;  // metres between claimed hit and rewound target
+constexpr float kLagCompInterpMs = 100.f;     // SnapshotInterpolator.defaultInterpMs
+
+struct LagCompSample
+{
+    uint32_t entityId;
+    RED4ext::Vector3 pos;
+};
+
+class LagCompHistory
+{
+public:
+    explicit LagCompHistory(uint32_t capacityTicks = kLagCompHistoryTicks);
+
+    void Record(uint32_t entityId, uint64_t tick, const RED4ext::Vector3& pos);
+    void Remove(uint32_t entityId);
+    void Clear();
+
+    // Position of `entityId` at `tick` (fractional ticks interpolate). Ticks
+    // outside the recorded window clamp to the oldest/newest sample. Returns
+    // false if the entity has no history.
+    bool Rewind(uint32_t entityId, double tick, RED4ext::Vector3& out) const;
+
+    // Rewinds `count` entities to the same tick; `found[i]` is false for ids
+    // without history. Returns the number found.
+    size_t RewindBatch(const uint32_t* ids, size_t count, double tick, RED4ext::Vector3* out, bool* found) const;
+
+    // Every tracked entity whose rewound position lies within `radius` of
+    // `origin`, e.g. all candidates near a shot. Appends to `out`.
+    size_t RewindNear(const RED4ext::Vector3& origin, float radius, double tick,
+                      std::vector<LagCompSample>& out) const;
+
+    // Tick the attacker was looking at when it fired: the hit arrives one
+    // RTT after the state it saw left the server, and the client renders
+    // `interpMs` behind the newest state it has.
+    double ViewTick(float rttMs, float interpMs = kLagCompInterpMs) const;
+    void SetTickMs(float tickMs);
+
+    uint32_t GetCapacity() const { return m_capacity; }
+    size_t GetEntityCount() const;
+
+private:
+    static constexpr uint64_t kNoTick = ~0ull;
+
+    uint32_t RowFor(uint32_t entityId); // caller holds m_mutex
+    RED4ext::Vector3 SampleRow(uint32_t row, double tick) const;
+
+    uint32_t m_capacity;
+    float m_tickMs = 1000.f / 64.f; // until the server loop calls SetTickMs
+    uint64_t m_latestTick = 0; // newest tick recorded for any entity
+    // Row r occupies [r * m_capacity, (r + 1) * m_capacity) in each column.
+    std::vector<uint64_t> m_tick;
+    std::vector<float> m_x, m_y, m_z;
+    std::vector<uint64_t> m_newest; // per row
+    std::vector<uint32_t> m_rowEntity;
+    std::vector<uint32_t> m_freeRows;
+    std::unordered_map<uint32_t, uint32_t> m_rows;
+    mutable std::mutex m_mutex;
+};
+
+extern LagCompHistory g_lagComp;
 } // namespace CoopNet
@@ -0,0 +1,82 @@
+#include "Projectile.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace CoopNet
+{
+namespace
+{
+// 9.81 m/s^2 applied for 1/64 s, in fixed-point velocity units.
+constexpr int32_t kGravityPerStep = 10045;
+// Linear drag: each step loses vel / 2^kDragShift (~6% per second).
+constexpr int kDragShift = 10;
+// log2(kProjectileStepsPerSec): position advances by vel >> kStepShift.
+constexpr int kStepShift = 6;
+static_assert((1u << kStepShift) == kProjectileStepsPerSec, "step shift out of sync with the step rate");
+
+int64_t ToFixed(float v)
+{
+    // float -> double and the power-of-two scale are exact; llround is
+    // correctly rounded, so the result does not depend on the compiler.
+    return std::llround(static_cast<double>(v) * kProjectileFixedOne);
+}
+
+int32_t ToFixedVel(float v)
+{
+    constexpr int64_t kMax = INT32_MAX;
+    return static_cast<int32_t>(std::clamp<int64_t>(ToFixed(v), -kMax, kMax));
+}
+
+float FromFixed(int64_t v)
+{
+    return static_cast<float>(static_cast<double>(v) / kProjectileFixedOne);
+}
+} // namespace
+
+ProjectileState Projectile_Make(const RED4ext::Vector3& pos, const RED4ext::Vector3& vel, uint32_t step)
+{
+    ProjectileState s{};
+    s.pos[0] = ToFixed(pos.X);
+    s.pos[1] = ToFixed(pos.Y);
+    s.pos[2] = ToFixed(pos.Z);
+    s.vel[0] = ToFixedVel(vel.X);
+    s.vel[1] = ToFixedVel(vel.Y);
+    s.vel[2] = ToFixedVel(vel.Z);
+    s.step = step;
+    return s;
+}
+
+void Projectile_Step(ProjectileState& s)
+{
+    // Right shifts of negative values are arithmetic (C++20), so drag and
+    // movement round the same way on every platform.
+    for (int axis = 0; axis < 3; ++axis)
+        s.vel[axis] -= s.vel[axis] >> kDragShift;
+    s.vel[2] = static_cast<int32_t>((std::max)(static_cast<int64_t>(s.vel[2]) - kGravityPerStep,
+                                               static_cast<int64_t>(INT32_MIN + 1)));
+    for (int axis = 0; axis < 3; ++axis)
+        s.pos[axis] += s.vel[axis] >> kStepShift;
+    ++s.step;
+}
+
+void Projectile_AdvanceTo(ProjectileState& s, uint32_t toStep)
+{
+    while (s.step < toStep)
+        Projectile_Step(s);
+}
+
+RED4ext::Vector3 Projectile_Position(const ProjectileState& s)
+{
+    return RED4ext::Vector3(FromFixed(s.pos[0]), FromFixed(s.pos[1]), FromFixed(s.pos[2]));
+}
+
+RED4ext::Vector3 Projectile_Velocity(const ProjectileState& s)
+{
+    return RED4ext::Vector3(FromFixed(s.vel[0]), FromFixed(s.vel[1]), FromFixed(s.vel[2]));
+}
+
+uint32_t Projectile_FuseSteps(uint32_t seed)
+{
+    return kProjectileFuseSteps + (seed & 31u);
+}
+} // namespace CoopNet
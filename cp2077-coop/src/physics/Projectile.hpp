@@ -0,0 +1,40 @@
+#pragma once
+
+// Deterministic ballistic projectiles (grenades).
+// A projectile is replicated once at launch (origin, velocity, seed) and
+// every peer then runs the same fixed-step integrator, so its position at
+// step N is identical everywhere without streaming snapshots. The state is
+// fixed-point and updated with integer arithmetic only: float rounding,
+// FMA contraction and x87/SSE differences between compilers cannot make the
+// server and a client drift apart. Only events the integrator cannot predict
+// (bounces off world geometry, detonation) are sent, as corrections that
+// replace the state at a given step.
+
+#include <RED4ext/Scripting/Natives/Vector3.hpp>
+#include <cstdint>
+
+namespace CoopNet
+{
+constexpr uint32_t kProjectileStepsPerSec = 64; // power of two: dt is a shift
+constexpr float kProjectileStepMs = 1000.f / kProjectileStepsPerSec;
+constexpr uint32_t kProjectileFuseSteps = 3 * kProjectileStepsPerSec; // plus up to 31 steps from the seed
+constexpr int32_t kProjectileFixedOne = 1 << 16;                      // fixed-point units per metre
+
+struct ProjectileState
+{
+    int64_t pos[3]; // metres * kProjectileFixedOne
+    int32_t vel[3]; // metres per second * kProjectileFixedOne
+    uint32_t step;  // fixed steps since launch
+};
+
+// Quantises a launch or correction; identical inputs give identical bits.
+ProjectileState Projectile_Make(const RED4ext::Vector3& pos, const RED4ext::Vector3& vel, uint32_t step);
+// One fixed step: drag and gravity on the velocity, then the position.
+void Projectile_Step(ProjectileState& s);
+// Steps forward until s.step == toStep (no-op if already there or past).
+void Projectile_AdvanceTo(ProjectileState& s, uint32_t toStep);
+RED4ext::Vector3 Projectile_Position(const ProjectileState& s);
+RED4ext::Vector3 Projectile_Velocity(const ProjectileState& s);
+// Step at which an unprompted projectile detonates.
+uint32_t Projectile_FuseSteps(uint32_t seed);
+} // namespace CoopNet
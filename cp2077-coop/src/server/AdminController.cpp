@@ -1,6 +1,7 @@
 #include "AdminController.hpp"
 #include "../core/GameClock.hpp"
-#include "../core/ThreadSafeQueue.hpp"
+#include "../core/SpscRing.hpp"
+#include "../core/TickProfiler.hpp"
 #include "../net/Net.hpp"
 #include "../net/Packets.hpp"
 #include "WorldStateIO.hpp"
@@ -14,10 +15,12 @@
 #include <unistd.h>
 #endif
 #include <openssl/sha.h>
+#include <cstdlib>
 #include <iomanip>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <mutex>
 #include <unordered_set>
 
 namespace CoopNet
@@ -25,7 +28,7 @@ namespace CoopNet
 
 static std::unordered_set<uint32_t> g_banList;
 static std::mutex g_banMutex;
-static ThreadSafeQueue<std::string> g_cmdQueue;
+static SpscRing<std::string, 64> g_cmdQueue; // console thread -> tick
 static std::thread g_consoleThread;
 static std::atomic<bool> g_consoleRunning{false};
 struct VoteKickData
@@ -339,6 +342,27 @@ void AdminController_PollCommands()
             std::cout << "[Admin] world reset" << std::endl;
         }
     }
+    else if (cmd == "profile")
+    {
+        // profile [seconds] | profile on | profile off
+        std::string arg;
+        ss >> arg;
+        if (arg == "on" || arg == "off")
+        {
+            TickProfiler_SetEnabled(arg == "on");
+            std::cout << "[Admin] tick profiler " << arg << std::endl;
+            return;
+        }
+        float seconds = arg.empty() ? 5.f : std::strtof(arg.c_str(), nullptr);
+        if (seconds <= 0.f)
+            seconds = 5.f;
+        std::cout << TickProfiler_Summary(seconds);
+        const std::string path = "logs/tick_profile_" + std::to_string(GameClock::GetTimeMs()) + ".json";
+        if (TickProfiler_WriteChromeTrace(path, seconds))
+            std::cout << "[Admin] trace written to " << path << std::endl;
+        else
+            std::cout << "[Admin] could not write " << path << std::endl;
+    }
     else if (cmd == "sv_dm")
     {
         int flag = 0;
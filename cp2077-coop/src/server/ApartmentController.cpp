@@ -168,6 +168,8 @@ void ApartmentController_HandleEnter(Connection* conn, uint32_t aptId, uint32_t
     }
 
     uint32_t seed = static_cast<uint32_t>(std::hash<std::string>{}(infoIt->second.interiorScene) ^ ownerPhaseId);
+    // Guests join the owner's phase so its phase broadcasts reach them.
+    conn->visitPhaseId = conn->peerId == ownerPhaseId ? 0u : ownerPhaseId;
     Net_SendAptEnterAck(conn, true, ownerPhaseId, seed);
     if (auto* js = ApartmentController_GetCustomization(ownerPhaseId))
     {
@@ -25,7 +25,7 @@ void BreachController_Start(uint32_t peerId, uint8_t w, uint8_t h)
     g_timer = 45.f;
     g_peer = peerId;
     BreachStartPacket pkt{peerId, g_seed, w, h, {0,0}};
-    Net_Broadcast(EMsg::BreachStart, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::BreachStart, &pkt, sizeof(pkt), peerId);
     std::cout << "Breach start seed=" << g_seed << std::endl;
 }
 
@@ -35,7 +35,7 @@ void BreachController_HandleInput(uint32_t peerId, uint8_t idx)
     if (!g_active)
         return;
     BreachInputPacket pkt{peerId, idx, {0,0,0}};
-    Net_Broadcast(EMsg::BreachInput, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::BreachInput, &pkt, sizeof(pkt), peerId);
 }
 
 void BreachController_ServerTick(float dt)
@@ -48,7 +48,7 @@ void BreachController_ServerTick(float dt)
     {
         g_active = false;
         BreachResultPacket pkt{g_peer, 7u, {0,0,0}}; // all daemons active
-        Net_Broadcast(EMsg::BreachResult, &pkt, sizeof(pkt));
+        Net_BroadcastNearPeer(EMsg::BreachResult, &pkt, sizeof(pkt), g_peer);
         std::cout << "Breach result sent" << std::endl;
     }
 }
@@ -18,13 +18,13 @@ void CarryController_Begin(uint32_t carrierId, uint32_t entityId)
     std::lock_guard lock(g_mapMutex);
     g_map[entityId] = {carrierId, 0.f};
     CarryBeginPacket pkt{carrierId, entityId};
-    Net_Broadcast(EMsg::CarryBegin, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::CarryBegin, &pkt, sizeof(pkt), carrierId);
 }
 
 void CarryController_End(uint32_t entityId, const RED4ext::Vector3& pos, const RED4ext::Vector3& vel)
 {
     CarryEndPacket pkt{entityId, pos, vel};
-    Net_Broadcast(EMsg::CarryEnd, &pkt, sizeof(pkt));
+    Net_BroadcastNear(EMsg::CarryEnd, &pkt, sizeof(pkt), pos);
     std::lock_guard lock(g_mapMutex);
     g_map.erase(entityId);
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include "CombatStateManager.hpp"
+#include <RED4ext/Scripting/Natives/Vector3.hpp>
 
 namespace CoopNet
 {
@@ -33,38 +33,23 @@
 #include "VendorController.hpp"
 #include "WebDash.hpp"
 #include "../plugin/PluginManager.hpp"
+#include "../core/Metrics.hpp"
+#include "../core/StartupGraph.hpp"
 #include "../core/TaskGraph.hpp"
-#include "../net/Snapshot.hpp"
+#include "../core/TickProfiler.hpp"
+#include "../core/TickScheduler.hpp"
+#include "../net/SnapshotWriter.hpp"
+#include "../physics/LagComp.hpp"
 #include "../core/Red4extUtils.hpp"
 #include <RED4ext/RED4ext.hpp>
 
-namespace CoopNet
-{
-void BuildSnapshot(std::vector<EntitySnap>& out);
-}
 #include <cmath>
 #include <cstring>
 #include <iostream>
 #include <thread>
 
-int main(int argc, char** argv)
+static void SpawnParkedVehicle()
 {
-    for (int i = 1; i < argc; ++i)
-    {
-        if (std::strcmp(argv[i], "--help") == 0)
-        {
-            return 0;
-        }
-    }
-
-    CoopNet::ServerConfig_Load();
-    CoopNet::ApartmentController_Load();
-    CoopNet::QuestWatchdog_LoadCritical();
-    CoopNet::QuestWatchdog_LoadRomance();
-    CoopNet::QuestWatchdog_LoadMain();
-    CoopNet::QuestWatchdog_LoadSide();
-    Net_Init();
-    CoopNet::MigrateSinglePlayerSave();
     CoopNet::CarParking park{};
     CoopNet::TransformSnap vs{};
     vs.pos = {0.f, 0.f, 0.f};
@@ -81,10 +66,59 @@ int main(int argc, char** argv)
     {
         CoopNet::VehicleController_SpawnPhaseVehicle(CoopNet::Fnv1a32("vehicle_caliburn"), 0u, vs, 0u);
     }
-    CoopNet::WebDash_Start();
-    CoopNet::AdminController_Start();
-    CoopNet::InfoServer_Start();
-    CoopNet::PluginManager_Init();
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--help") == 0)
+        {
+            return 0;
+        }
+    }
+
+    CoopNet::TaskGraph taskGraph;
+    size_t maxWorkers = std::max<size_t>(1, std::thread::hardware_concurrency() - 1);
+    taskGraph.Start(maxWorkers);
+
+    // Start-up runs as a dependency graph on its own workers. The tick loop
+    // only waits for what connecting players need; quest tables, the web
+    // services and plugins keep loading in the background and are picked up
+    // as they finish. They stay off `taskGraph` because TaskGraph::Wait runs
+    // whatever is queued, and the tick thread must not pick up a slow load
+    // while it waits for its NPC and physics tasks.
+    CoopNet::TaskGraph bootGraph;
+    bootGraph.Start(maxWorkers);
+    CoopNet::StartupGraph startup;
+    const auto config = startup.Add("ServerConfig", [] { CoopNet::ServerConfig_Load(); });
+    const auto apartments = startup.Add("Apartments", [] { CoopNet::ApartmentController_Load(); }, {config});
+    startup.Add("QuestCritical", [] { CoopNet::QuestWatchdog_LoadCritical(); });
+    startup.Add("QuestRomance", [] { CoopNet::QuestWatchdog_LoadRomance(); });
+    startup.Add("QuestMain", [] { CoopNet::QuestWatchdog_LoadMain(); });
+    startup.Add("QuestSide", [] { CoopNet::QuestWatchdog_LoadSide(); });
+    const auto net = startup.Add("Net", [] { Net_Init(); }, {config});
+    const auto migration = startup.Add("SaveMigration", [] { CoopNet::MigrateSinglePlayerSave(); });
+    const auto vehicle = startup.Add("ParkedVehicle", SpawnParkedVehicle, {net, migration});
+    startup.Add("WebDash", [] { CoopNet::WebDash_Start(); }, {config});
+    const auto admin = startup.Add("AdminConsole", [] { CoopNet::AdminController_Start(); }, {config});
+    startup.Add("InfoServer", [] { CoopNet::InfoServer_Start(); }, {net});
+    // The Python VM belongs to the thread that dispatches to it: the tick loop.
+    const auto plugins = startup.Add("Plugins", [] { CoopNet::PluginManager_Init(); }, {net},
+                                     CoopNet::StartupGraph::Affinity::Caller);
+    const auto bootStart = std::chrono::steady_clock::now();
+    startup.Launch(&bootGraph);
+    // Ticking needs the host socket, the vehicle and apartment tables it
+    // mutates and the ban list checked on connect; everything else may land
+    // after the port is open.
+    startup.Wait(net);
+    startup.Wait(apartments);
+    startup.Wait(vehicle);
+    startup.Wait(admin);
+    std::cout << "Port open after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootStart)
+                     .count()
+              << " ms, content still loading" << std::endl;
     // Declare time/weather/session vars before first use
     uint32_t sessionId = 0;
     uint64_t worldClock = 0;
@@ -106,9 +140,7 @@ int main(int argc, char** argv)
         CoopNet::SessionState_UpdateWeather(saved.sunAngleDeg, saved.weatherId, saved.particleSeed);
     }
     std::cout << "Dedicated up" << std::endl;
-    CoopNet::TaskGraph taskGraph;
-    size_t maxWorkers = std::max<size_t>(1, std::thread::hardware_concurrency() - 1);
-    taskGraph.Start(maxWorkers);
+    CoopNet::NpcController_SetTaskGraph(&taskGraph);
 
     // Main server loop
     bool running = true;
@@ -126,11 +158,36 @@ int main(int argc, char** argv)
     float tickMs = CoopNet::GameClock::GetTickMs();
     bool validated = false;
     bool hbSent = false;
+    bool startupReported = false;
     auto last = std::chrono::steady_clock::now();
+    // Ticks land on absolute deadlines. ENet servicing and inbound decrypt
+    // run on the network I/O thread, which makes this the tick thread: its
+    // small messages are coalesced until Net_FlushBundles. Should the I/O
+    // thread not start, this thread also sleeps in epoll on the ENet socket
+    // and handles packets as they come.
+    CoopNet::TickScheduler ticker(static_cast<uint64_t>(tickMs * 1e6f));
+    if (!Net_StartIoThread())
+        ticker.Watch(Net_GetHostSocket(), [] { Net_Poll(0); });
+    CoopNet::TickProfiler_SetThreadName("tick");
+    auto& tickSeconds = CoopNet::GetMetrics().Histogram("coop_tick_duration_seconds", "Time spent in one server tick",
+                                                        CoopNet::MetricTimeBuckets());
+    auto& tickInterval =
+        CoopNet::GetMetrics().Gauge("coop_tick_interval_seconds", "Target time between server ticks");
 
     while (running)
     {
+        ticker.SetPeriod(static_cast<uint64_t>(tickMs * 1e6f));
+        ticker.WaitNext();
+        COOP_PROFILE_SCOPE("Tick");
         auto begin = std::chrono::steady_clock::now();
+        if (!startupReported && startup.RunCallerSteps() && startup.AllDone())
+        {
+            startupReported = true;
+            std::cout << startup.Timeline();
+            if (startup.WriteChromeTrace("logs/startup_trace.json"))
+                std::cout << "Startup trace written to logs/startup_trace.json" << std::endl;
+            bootGraph.Stop();
+        }
         if (sessionId == 0)
             sessionId = CoopNet::SessionState_GetId();
         if (sessionId && !validated)
@@ -163,12 +220,14 @@ int main(int argc, char** argv)
             CoopNet::SessionState_UpdateWeather(deg, weatherId, particleSeed);
         }
         CoopNet::ElevatorController_ServerTick(tickMs);
+        CoopNet::TaskHandle npcTick;
+        CoopNet::TaskHandle physicsTick;
         if (!CoopNet::ElevatorController_IsPaused())
         {
-            taskGraph.Submit([tickMs]
-                            { CoopNet::NpcController_ServerTick(tickMs); });
-            taskGraph.Submit([tickMs]
-                            { CoopNet::VehicleController_PhysicsStep(tickMs); });
+            npcTick = taskGraph.Submit([tickMs]
+                                       { CoopNet::NpcController_ServerTick(tickMs); });
+            physicsTick = taskGraph.Submit([tickMs]
+                                           { CoopNet::VehicleController_PhysicsStep(tickMs); });
             CoopNet::VehicleController_ServerTick(tickMs);
             CoopNet::BreachController_ServerTick(tickMs);
             CoopNet::ShardController_ServerTick(tickMs);
@@ -183,7 +242,12 @@ int main(int argc, char** argv)
             CoopNet::TrafficController_Tick(tickMs);
             RED4EXT_EXECUTE("GameModeManager", "TickDM", nullptr, static_cast<uint32_t>(tickMs));
         }
-        Net_Poll(static_cast<uint32_t>(tickMs));
+        // Replication reads NPC and vehicle state, so both ticks must land first.
+        taskGraph.Wait(npcTick);
+        taskGraph.Wait(physicsTick);
+        Net_FlushReplication();
+        Net_Poll(0);
+        CoopNet::PublishEntitySnaps();
         taskGraph.Submit([]
                         {
                             std::vector<CoopNet::EntitySnap> tmp;
@@ -192,14 +256,18 @@ int main(int argc, char** argv)
         CoopNet::QuestWatchdog_Tick(tickMs);
         CoopNet::PhaseGC_Tick(CoopNet::GameClock::GetCurrentTick());
         CoopNet::AdminController_Tick(tickMs);
-        CoopNet::PluginManager_Tick(tickMs / 1000.f);
+        if (startup.IsDone(plugins))
+            CoopNet::PluginManager_Tick(tickMs / 1000.f);
         hbTimer += tickMs / 1000.f;
         memTimer += tickMs / 1000.f;
         CoopNet::TextureGuard_Tick(tickMs / 1000.f);
         CoopNet::SectorLODController_Tick(tickMs / 1000.f);
         latencyTimer += tickMs / 1000.f;
+        CoopNet::g_lagComp.SetTickMs(tickMs); // adaptive: may change below
+        const uint64_t lagCompTick = CoopNet::GameClock::GetCurrentTick();
         for (auto* c : Net_GetConnections())
         {
+            CoopNet::g_lagComp.Record(c->peerId, lagCompTick, c->avatarPos);
             uint64_t now = CoopNet::GameClock::GetTimeMs();
             if (now - c->lastBWCheckMs >= 30000)
             {
@@ -257,11 +325,17 @@ int main(int argc, char** argv)
         {
             memTimer = 0.f;
             CoopNet::SnapshotMemCheck();
+            std::cout << "Tick schedule " << ticker.Summary() << std::endl;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(tickMs)));
+
+        // One coalesced datagram per peer and channel for everything sent
+        // this tick.
+        Net_FlushBundles();
 
         auto end = std::chrono::steady_clock::now();
         float frameMs = std::chrono::duration<float, std::milli>(end - begin).count();
+        tickSeconds.Observe(frameMs / 1000.0);
+        tickInterval.Set(tickMs / 1000.0);
         frameAccum += frameMs;
         frameCount++;
         scaleTimer += frameMs / 1000.f;
@@ -332,6 +406,12 @@ int main(int argc, char** argv)
         }
     }
 
+    // Sends the last bundles from this thread before the services go away.
+    Net_StopIoThread();
+    // Nothing may still be loading while the services it starts are torn down.
+    startup.WaitAll();
+    bootGraph.Stop();
+    CoopNet::NpcController_SetTaskGraph(nullptr);
     taskGraph.Stop();
     CoopNet::PluginManager_Shutdown();
     CoopNet::SaveSessionState(sessionId);
@@ -1,8 +1,17 @@
 #include "DedicatedServer.hpp"
 #include "../net/Net.hpp"
 #include "../net/Connection.hpp"
+#include "../net/NetAllocator.hpp"
+#include "../physics/LagComp.hpp"
+#include "ServerConfig.hpp"
+#include "SnapshotHeap.hpp"
+#include "../core/GameClock.hpp"
 #include "../core/Logger.hpp"
+#include "../core/Metrics.hpp"
+#include "../core/TickProfiler.hpp"
 #include "../core/Version.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <thread>
@@ -33,8 +42,9 @@ DedicatedServer::DedicatedServer()
     , m_port(7777)
     , m_maxPlayers(32)
     , m_tickRate(64)
-    , m_lastTick(0)
-    , m_tickInterval(1000 / m_tickRate)
+    , m_tickCount(0)
+    , m_tickIntervalNs(1000000000ull / m_tickRate)
+    , m_ticker(m_tickIntervalNs)
 {
     LoadDefaultConfig();
 }
@@ -83,7 +93,6 @@ void DedicatedServer::Start() {
     LogInfo("Starting dedicated server...");
     
     m_isRunning = true;
-    m_lastTick = GetCurrentTimeMs();
     
     // Start main server loop
     ServerLoop();
@@ -116,27 +125,56 @@ void DedicatedServer::Stop() {
 void DedicatedServer::ServerLoop() {
     LogInfoF("Server main loop started (tick rate: %d Hz)", m_tickRate);
     
+    // ENet servicing and packet decryption run on the network I/O thread;
+    // this thread only drains its handoff rings and ticks.
+    Net_StartIoThread();
+    TickProfiler_SetThreadName("server tick");
+    
+    // The I/O thread owns the ENet socket, so this thread only waits on the
+    // tick timer and is idle between ticks.
+    using Clock = std::chrono::steady_clock;
+    const float intervalMs = static_cast<float>(m_tickIntervalNs) / 1e6f;
+    Clock::time_point lastStart{};
+    m_tickJitter.Reset();
+    m_ticker.SetPeriod(m_tickIntervalNs);
+    m_ticker.Reset();
+    g_lagComp.SetTickMs(intervalMs);
+    auto& tickSeconds =
+        GetMetrics().Histogram("coop_tick_duration_seconds", "Time spent in one server tick", MetricTimeBuckets());
+    GetMetrics().Gauge("coop_tick_interval_seconds", "Target time between server ticks").Set(intervalMs / 1000.0);
+    
     while (m_isRunning && !g_shutdownRequested.load()) {
-        uint64_t currentTime = GetCurrentTimeMs();
-        
-        // Check if it's time for next tick
-        if (currentTime - m_lastTick >= m_tickInterval) {
-            ProcessServerTick();
-            m_lastTick = currentTime;
+        // Returns at once for ticks that are already overdue, so a slow tick
+        // is followed by fixed-step catch-up rather than a longer timestep.
+        m_ticker.WaitNext();
+        COOP_PROFILE_SCOPE("ServerTick");
+        auto start = Clock::now();
+        if (lastStart != Clock::time_point{}) {
+            float dtMs = std::chrono::duration<float, std::milli>(start - lastStart).count();
+            m_tickJitter.Record(dtMs - intervalMs);
         }
+        lastStart = start;
         
         // Process network events
         ProcessNetworkEvents();
         
+        ProcessServerTick();
+        
         // Handle console commands
         ProcessConsoleInput();
         
-        // Small sleep to prevent 100% CPU usage
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        // Spend this tick's replication budget, then send one coalesced
+        // datagram per peer and channel
+        Net_FlushReplication();
+        Net_FlushBundles();
+        tickSeconds.Observe(std::chrono::duration<double>(Clock::now() - start).count());
     }
+    
+    Net_StopIoThread();
 }
 
 void DedicatedServer::ProcessServerTick() {
+    COOP_PROFILE_SCOPE("DedicatedServer::ProcessServerTick");
     // Update player states
     UpdatePlayerStates();
     
@@ -160,8 +198,9 @@ void DedicatedServer::ProcessServerTick() {
 }
 
 void DedicatedServer::ProcessNetworkEvents() {
-    // Poll for network events with timeout
-    Net_Poll(5); // 5ms timeout
+    COOP_PROFILE_SCOPE("DedicatedServer::ProcessNetworkEvents");
+    // Dispatch joins/leaves handed over by the I/O thread; never blocks
+    Net_Poll(0);
     
     // Process incoming connections
     ProcessNewConnections();
@@ -223,6 +262,34 @@ void DedicatedServer::ProcessConsoleCommand(const std::string& command) {
         LogInfo("Shutdown requested via console");
         RequestShutdown();
     }
+    else if (cmd == "profile") {
+        std::string arg;
+        iss >> arg;
+        if (arg == "on" || arg == "off") {
+            TickProfiler_SetEnabled(arg == "on");
+            LogInfoF("Tick profiler %s", arg.c_str());
+        }
+        else {
+            float seconds = 5.f;
+            if (!arg.empty()) {
+                seconds = std::strtof(arg.c_str(), nullptr);
+            }
+            if (seconds <= 0.f) {
+                seconds = 5.f;
+            }
+            std::istringstream summary(TickProfiler_Summary(seconds));
+            for (std::string line; std::getline(summary, line);) {
+                LogInfo(line);
+            }
+            const std::string path = "logs/tick_profile_" + std::to_string(GetCurrentTimeMs()) + ".json";
+            if (TickProfiler_WriteChromeTrace(path, seconds)) {
+                LogInfoF("Chrome trace of the last %.1f s written to %s", seconds, path.c_str());
+            }
+            else {
+                LogWarningF("Could not write %s", path.c_str());
+            }
+        }
+    }
     else if (cmd == "say") {
         std::string message;
         std::getline(iss, message);
@@ -248,6 +315,8 @@ void DedicatedServer::ShowConsoleHelp() {
     LogInfo("load            - Load world state");
     LogInfo("reload          - Reload server configuration");
     LogInfo("say <message>   - Broadcast message to all players");
+    LogInfo("profile [secs]  - Summarize the last secs of ticks and write a Chrome trace");
+    LogInfo("profile on|off  - Turn tick profiling on or off");
     LogInfo("stop, exit, quit - Stop the server");
 }
 
@@ -261,6 +330,46 @@ void DedicatedServer::ShowServerStatus() {
     LogInfoF("Players: %u/%u", connectedPlayers, m_config.maxPlayers);
     LogInfoF("Uptime: %lluh %llum %llus", uptime / 3600, (uptime % 3600) / 60, uptime % 60);
     LogInfoF("Tick Rate: %u Hz", m_tickRate);
+    LogInfoF("Tick Jitter: %s", m_tickJitter.Summary().c_str());
+    LogInfoF("Tick Schedule: %s", m_ticker.Summary().c_str());
+    LogInfoF("Traffic Out: %.0f pkt/s, %.1f KB/s", m_stats.packetsOutPerSec, m_stats.bytesOutPerSec / 1024.0);
+    LogInfoF("Traffic In: %.0f pkt/s, %.1f KB/s", m_stats.packetsInPerSec, m_stats.bytesInPerSec / 1024.0);
+    const NetTrafficStats traffic = Net_GetTrafficStats();
+    LogInfoF("Coalescing: %llu messages -> %llu packets (%llu bundles, %llu seals)",
+             static_cast<unsigned long long>(traffic.messagesOut),
+             static_cast<unsigned long long>(traffic.packetsOut),
+             static_cast<unsigned long long>(traffic.bundlesOut),
+             static_cast<unsigned long long>(traffic.sealsOut));
+    for (const NetAllocClassStats& s : NetAlloc_GetStats()) {
+        if (s.allocs == 0) {
+            continue;
+        }
+        const std::string label = s.blockSize ? std::to_string(s.blockSize) + " B" : std::string("large");
+        LogInfoF("ENet Pool %-7s: in use %llu (peak %llu), allocs %llu, frees %llu, slabs %llu KiB", label.c_str(),
+                 static_cast<unsigned long long>(s.inUse), static_cast<unsigned long long>(s.peakInUse),
+                 static_cast<unsigned long long>(s.allocs), static_cast<unsigned long long>(s.frees),
+                 static_cast<unsigned long long>(s.slabBytes / 1024));
+    }
+    LogInfoF("Snapshot Baselines: %zu held, %zu KiB reserved", SnapshotStore_GetOccupied(),
+             SnapshotStore_GetMemory() / 1024);
+    size_t replPending = 0;
+    ReplicationStats repl;
+    for (Connection* conn : Net_GetConnections()) {
+        const ReplicationStats s = conn->replication.GetStats();
+        replPending += conn->replication.GetPending();
+        repl.sent += s.sent;
+        repl.deferred += s.deferred;
+        repl.maxWaitTicks = std::max(repl.maxWaitTicks, s.maxWaitTicks);
+    }
+    LogInfoF("Replication: %zu pending, %llu sent, %llu deferred, longest wait %u ticks", replPending,
+             static_cast<unsigned long long>(repl.sent), static_cast<unsigned long long>(repl.deferred),
+             repl.maxWaitTicks);
+    for (const BroadcastFilterStats& f : Net_GetBroadcastFilterStats()) {
+        const uint64_t total = f.sent + f.avoided;
+        LogInfoF("Relevance Filter msg %-4u: %llu sent, %llu avoided (%.0f%%)", static_cast<unsigned>(f.type),
+                 static_cast<unsigned long long>(f.sent), static_cast<unsigned long long>(f.avoided),
+                 total ? 100.0 * static_cast<double>(f.avoided) / static_cast<double>(total) : 0.0);
+    }
     LogInfoF("Version: %s", Version::Current().ToString().c_str());
     LogInfoF("Port: %d", m_config.port);
 }
@@ -374,8 +483,8 @@ void DedicatedServer::ProcessConfigOption(const std::string& key, const std::str
         m_config.region = value;
     }
     else if (key == "tick_rate") {
-        m_tickRate = static_cast<uint32_t>(std::stoi(value));
-        m_tickInterval = 1000 / m_tickRate;
+        m_tickRate = static_cast<uint32_t>(std::max(1, std::stoi(value)));
+        m_tickIntervalNs = 1000000000ull / m_tickRate;
     }
     else if (key == "enable_anti_cheat") {
         m_config.enableAntiCheat = (value == "true" || value == "1");
@@ -386,6 +495,9 @@ void DedicatedServer::ProcessConfigOption(const std::string& key, const std::str
     else if (key == "log_level") {
         SetLogLevel(value);
     }
+    else if (ServerConfig_ApplyChannelOption(key, value)) {
+        // net_single_channel / channel_<name>: applied to the ENet channel map
+    }
     else {
         LogWarningF("Unknown config option: %s = %s", key.c_str(), value.c_str());
     }
@@ -439,7 +551,7 @@ void DedicatedServer::LoadDefaultConfig() {
     m_config.publicServer = false;
     
     m_tickRate = 64;
-    m_tickInterval = 1000 / m_tickRate;
+    m_tickIntervalNs = 1000000000ull / m_tickRate;
 }
 
 void DedicatedServer::SetLogLevel(const std::string& level) {
@@ -483,20 +595,30 @@ void DedicatedServer::CleanupGameSystems() {
 }
 
 void DedicatedServer::UpdatePlayerStates() {
+    COOP_PROFILE_SCOPE("DedicatedServer::UpdatePlayerStates");
     // Update player positions, health, etc.
     // This would integrate with the AvatarProxy system
+    
+    // One lag compensation sample per player per tick
+    const uint64_t tick = ++m_tickCount;
+    for (Connection* conn : Net_GetConnections()) {
+        g_lagComp.Record(conn->peerId, tick, conn->avatarPos);
+    }
 }
 
 void DedicatedServer::UpdateGameWorld() {
+    COOP_PROFILE_SCOPE("DedicatedServer::UpdateGameWorld");
     // Update world state, NPCs, events, etc.
 }
 
 void DedicatedServer::ProcessInventorySync() {
+    COOP_PROFILE_SCOPE("DedicatedServer::ProcessInventorySync");
     // Process inventory synchronization
     // This would use the InventoryController
 }
 
 void DedicatedServer::ProcessAntiCheat() {
+    COOP_PROFILE_SCOPE("DedicatedServer::ProcessAntiCheat");
     if (!m_config.enableAntiCheat) {
         return;
     }
@@ -506,15 +628,35 @@ void DedicatedServer::ProcessAntiCheat() {
 }
 
 void DedicatedServer::SendPeriodicUpdates() {
+    COOP_PROFILE_SCOPE("DedicatedServer::SendPeriodicUpdates");
     // Send regular updates to all connected clients
 }
 
 void DedicatedServer::CleanupExpiredData() {
+    COOP_PROFILE_SCOPE("DedicatedServer::CleanupExpiredData");
     // Clean up old data to prevent memory leaks
 }
 
 void DedicatedServer::UpdateStatistics() {
+    COOP_PROFILE_SCOPE("DedicatedServer::UpdateStatistics");
     // Update server performance statistics
+    const uint64_t now = GetCurrentTimeMs();
+    if (now - m_stats.rateSampleMs < 1000) {
+        return;
+    }
+    const NetTrafficStats traffic = Net_GetTrafficStats();
+    if (m_stats.rateSampleMs != 0) {
+        const double sec = (now - m_stats.rateSampleMs) / 1000.0;
+        m_stats.packetsOutPerSec = (traffic.packetsOut - m_stats.totalPacketsSent) / sec;
+        m_stats.packetsInPerSec = (traffic.packetsIn - m_stats.totalPacketsReceived) / sec;
+        m_stats.bytesOutPerSec = (traffic.bytesOut - m_stats.totalBytesOut) / sec;
+        m_stats.bytesInPerSec = (traffic.bytesIn - m_stats.totalBytesIn) / sec;
+    }
+    m_stats.totalPacketsSent = traffic.packetsOut;
+    m_stats.totalPacketsReceived = traffic.packetsIn;
+    m_stats.totalBytesOut = traffic.bytesOut;
+    m_stats.totalBytesIn = traffic.bytesIn;
+    m_stats.rateSampleMs = now;
 }
 
 void DedicatedServer::ProcessNewConnections() {
@@ -522,7 +664,12 @@ void DedicatedServer::ProcessNewConnections() {
 }
 
 void DedicatedServer::ProcessClientMessages() {
-    // Process incoming messages from clients
+    COOP_PROFILE_SCOPE("DedicatedServer::ProcessClientMessages");
+    // Drain each connection's inbound ring and handle its packets
+    const uint64_t now = GameClock::GetTimeMs();
+    for (auto* conn : Net_GetConnections()) {
+        conn->Update(now);
+    }
 }
 
 void DedicatedServer::ProcessDisconnections() {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../core/LatencyHistogram.hpp"
+#include "../core/TickScheduler.hpp"
 #include <string>
 #include <vector>
 #include <unordered_set>
@@ -124,9 +126,11 @@ private:
     
     // Timing
     uint32_t m_tickRate;
-    uint64_t m_lastTick;
-    uint64_t m_tickInterval;
+    uint64_t m_tickCount; // ticks run since Start, used as the lag compensation clock
+    uint64_t m_tickIntervalNs;
     uint64_t m_startTime;
+    TickScheduler m_ticker;
+    LatencyHistogram m_tickJitter; // |tick-to-tick interval - target|
     
     // Ban management
     std::unordered_set<std::string> m_bannedIPs;
@@ -140,6 +144,11 @@ private:
         uint64_t totalBytesOut = 0;
         uint32_t peakPlayers = 0;
         double averageTickTime = 0.0;
+        double packetsOutPerSec = 0.0;
+        double packetsInPerSec = 0.0;
+        double bytesOutPerSec = 0.0;
+        double bytesInPerSec = 0.0;
+        uint64_t rateSampleMs = 0;
     } m_stats;
 };
 
@@ -38,7 +38,7 @@ void DoorBreachController_Start(uint32_t doorId, uint32_t phaseId)
         dur = 300.f;
     g_map[doorId] = {phaseId, seed, 0.f, 0.f, dur};
     DoorBreachStartPacket pkt{doorId, phaseId, seed};
-    Net_Broadcast(EMsg::DoorBreachStart, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(EMsg::DoorBreachStart, &pkt, sizeof(pkt), phaseId);
 }
 
 void DoorBreachController_Tick(float dt)
@@ -51,7 +51,7 @@ void DoorBreachController_Tick(float dt)
         if (combat)
         {
             DoorBreachAbortPacket ab{it->first};
-            Net_Broadcast(EMsg::DoorBreachAbort, &ab, sizeof(ab));
+            Net_BroadcastPhase(EMsg::DoorBreachAbort, &ab, sizeof(ab), it->second.phase);
             it = g_map.erase(it);
             continue;
         }
@@ -65,11 +65,11 @@ void DoorBreachController_Tick(float dt)
             if (pct > 100)
                 pct = 100;
             DoorBreachTickPacket pkt{it->first, pct, {0, 0, 0}};
-            Net_Broadcast(EMsg::DoorBreachTick, &pkt, sizeof(pkt));
+            Net_BroadcastPhase(EMsg::DoorBreachTick, &pkt, sizeof(pkt), it->second.phase);
             if (pct >= 100)
             {
                 DoorBreachSuccessPacket s{it->first};
-                Net_Broadcast(EMsg::DoorBreachSuccess, &s, sizeof(s));
+                Net_BroadcastPhase(EMsg::DoorBreachSuccess, &s, sizeof(s), it->second.phase);
                 it = g_map.erase(it);
                 continue;
             }
@@ -21,7 +21,7 @@ static std::mutex g_elevMutex;
 void ElevatorController_OnCall(uint32_t peerId, uint32_t elevatorId, uint8_t floor)
 {
     ElevatorCallPacket pkt{peerId, elevatorId, floor, {0,0,0}};
-    Net_Broadcast(EMsg::ElevatorCall, &pkt, sizeof(pkt));
+    Net_BroadcastNearPeer(EMsg::ElevatorCall, &pkt, sizeof(pkt), peerId);
 }
 
 void ElevatorController_OnArrive(uint32_t elevatorId, uint64_t sectorHash, const RED4ext::Vector3& pos)
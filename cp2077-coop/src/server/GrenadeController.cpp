@@ -1,27 +1,74 @@
 #include "GrenadeController.hpp"
 #include "../core/GameClock.hpp"
 #include "../net/Net.hpp"
-#include <unordered_map>
+#include "../net/Packets.hpp"
+#include "../physics/Projectile.hpp"
+#include <algorithm>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace CoopNet
 {
+namespace
+{
+// A peer that misses the server's Detonate drops the grenade this long
+// after its own fuse ran out.
+constexpr uint32_t kClientGraceSteps = kProjectileStepsPerSec;
+// Spawns older than this are started late rather than fast-forwarded.
+constexpr float kMaxCatchUpMs = 500.f;
+
 struct GrenadeState
 {
-    uint32_t start;
-    RED4ext::Vector3 pos;
-    RED4ext::Vector3 vel;
-    float timer;
+    ProjectileState sim;
+    uint32_t fuse;
+    float accumMs;
 };
-static std::unordered_map<uint32_t, GrenadeState> g_map;
-static std::mutex g_grenadeMutex;
+std::unordered_map<uint32_t, GrenadeState> g_map;
+std::mutex g_grenadeMutex;
+} // namespace
 
-void GrenadeController_Prime(uint32_t entityId, uint32_t startTick)
+void GrenadeController_Spawn(const ProjectileSpawnPacket& pkt)
 {
-    std::lock_guard lock(g_grenadeMutex);
-    g_map[entityId] = {startTick, {}, {}, 0.f};
-    GrenadePrimePacket pkt{entityId, startTick};
-    Net_Broadcast(EMsg::GrenadePrime, &pkt, sizeof(pkt));
+    // Catch up on the time the spawn spent in flight so the local step count
+    // tracks the thrower's; corrections are step-stamped, so any residue is
+    // fixed by the next event.
+    const uint64_t now = GameClock::GetCurrentTick();
+    float lateMs = 0.f;
+    if (now > pkt.spawnTick)
+        lateMs = (std::min)(static_cast<float>(now - pkt.spawnTick) * GameClock::GetTickMs(), kMaxCatchUpMs);
+    {
+        std::lock_guard lock(g_grenadeMutex);
+        g_map[pkt.entityId] = {Projectile_Make(pkt.origin, pkt.velocity, 0), Projectile_FuseSteps(pkt.seed), lateMs};
+    }
+    // Net_IsAuthoritative is a build-wide constant; only the process that
+    // runs the server relays, or clients would echo every spawn back.
+    if (Net_IsServer())
+        Net_BroadcastProjectileSpawn(pkt);
+}
+
+void GrenadeController_ApplyEvent(const ProjectileEventPacket& pkt)
+{
+    {
+        std::lock_guard lock(g_grenadeMutex);
+        auto it = g_map.find(pkt.entityId);
+        if (it == g_map.end())
+            return;
+        if (pkt.kind == static_cast<uint8_t>(ProjectileEventKind::Detonate))
+        {
+            g_map.erase(it);
+        }
+        else
+        {
+            // Rewind to the bounce and replay up to where we were, so a
+            // late correction lands on the same state as a timely one.
+            const uint32_t current = it->second.sim.step;
+            it->second.sim = Projectile_Make(pkt.pos, pkt.vel, pkt.step);
+            Projectile_AdvanceTo(it->second.sim, current);
+        }
+    }
+    if (Net_IsServer())
+        Net_BroadcastProjectileEvent(pkt);
 }
 
 void GrenadeController_Remove(uint32_t entityId)
@@ -30,19 +77,60 @@ void GrenadeController_Remove(uint32_t entityId)
     g_map.erase(entityId);
 }
 
-void GrenadeController_Tick(float dt)
+void GrenadeController_Tick(float dtMs)
 {
-    std::lock_guard lock(g_grenadeMutex);
-    for (auto it = g_map.begin(); it != g_map.end();)
+    const bool authoritative = Net_IsServer();
+    std::vector<ProjectileEventPacket> detonated;
     {
-        it->second.timer += dt;
-        if (it->second.timer >= 50.f)
+        std::lock_guard lock(g_grenadeMutex);
+        for (auto it = g_map.begin(); it != g_map.end();)
         {
-            it->second.timer = 0.f;
-            GrenadeSnapPacket pkt{it->first, it->second.pos, it->second.vel};
-            Net_Broadcast(EMsg::GrenadeSnap, &pkt, sizeof(pkt));
+            GrenadeState& g = it->second;
+            g.accumMs += dtMs;
+            while (g.accumMs >= kProjectileStepMs)
+            {
+                Projectile_Step(g.sim);
+                g.accumMs -= kProjectileStepMs;
+            }
+            if (authoritative && g.sim.step >= g.fuse)
+            {
+                ProjectileEventPacket pkt{};
+                pkt.entityId = it->first;
+                pkt.step = g.sim.step;
+                pkt.kind = static_cast<uint8_t>(ProjectileEventKind::Detonate);
+                pkt.pos = Projectile_Position(g.sim);
+                pkt.vel = Projectile_Velocity(g.sim);
+                detonated.push_back(pkt);
+                it = g_map.erase(it);
+            }
+            else if (!authoritative && g.sim.step >= g.fuse + kClientGraceSteps)
+            {
+                it = g_map.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
         }
-        ++it;
     }
+    for (const auto& pkt : detonated)
+        Net_BroadcastProjectileEvent(pkt);
+}
+
+bool GrenadeController_GetState(uint32_t entityId, RED4ext::Vector3& pos, RED4ext::Vector3& vel)
+{
+    std::lock_guard lock(g_grenadeMutex);
+    auto it = g_map.find(entityId);
+    if (it == g_map.end())
+        return false;
+    pos = Projectile_Position(it->second.sim);
+    vel = Projectile_Velocity(it->second.sim);
+    return true;
+}
+
+size_t GrenadeController_GetCount()
+{
+    std::lock_guard lock(g_grenadeMutex);
+    return g_map.size();
 }
 } // namespace CoopNet
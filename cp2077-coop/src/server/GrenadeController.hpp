@@ -1,10 +1,21 @@
 #pragma once
 #include <RED4ext/Scripting/Natives/Vector3.hpp>
+#include <cstddef>
 #include <cstdint>
 
 namespace CoopNet
 {
-void GrenadeController_Prime(uint32_t entityId, uint32_t startTick); // GR-1
-void GrenadeController_Remove(uint32_t entityId);                    // GR-1
-void GrenadeController_Tick(float dt);                               // GR-1
+struct ProjectileSpawnPacket;
+struct ProjectileEventPacket;
+
+// Starts simulating a thrown grenade. On the server this also broadcasts the
+// spawn once to nearby peers; there is no per-tick state stream.
+void GrenadeController_Spawn(const ProjectileSpawnPacket& pkt);           // GR-2
+// Applies a bounce correction or detonation. The server rebroadcasts it.
+void GrenadeController_ApplyEvent(const ProjectileEventPacket& pkt);      // GR-2
+void GrenadeController_Remove(uint32_t entityId);                         // GR-1
+// Runs the fixed-step integrator; the server detonates expired fuses.
+void GrenadeController_Tick(float dtMs);                                  // GR-1
+bool GrenadeController_GetState(uint32_t entityId, RED4ext::Vector3& pos, RED4ext::Vector3& vel);
+size_t GrenadeController_GetCount();
 } // namespace CoopNet
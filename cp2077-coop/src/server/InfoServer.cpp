@@ -1,5 +1,9 @@
 #include "InfoServer.hpp"
 #include "../net/Net.hpp"
+#include "../core/Metrics.hpp"
+#include <algorithm>
+#include <cctype>
+#include <string>
 #include <thread>
 #include <atomic>
 #include <sstream>
@@ -34,6 +38,33 @@ static std::string BuildInfo()
     return ss.str();
 }
 
+// Prometheus scrapes ask for OpenMetrics in Accept; anything else gets the
+// classic text format.
+static bool WantsOpenMetrics(const std::string& req)
+{
+    std::string lower(req);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    const size_t accept = lower.find("\r\naccept:");
+    if (accept == std::string::npos)
+        return false;
+    const size_t end = lower.find("\r\n", accept + 2);
+    return lower.substr(accept, end - accept).find("application/openmetrics-text") != std::string::npos;
+}
+
+template <typename Socket>
+static void SendAll(Socket client, const std::string& data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        const int n = send(client, data.c_str() + sent, static_cast<int>(data.size() - sent), 0);
+        if (n <= 0)
+            return;
+        sent += static_cast<size_t>(n);
+    }
+}
+
 static bool ParseRequestLine(const std::string& req, std::string& method, std::string& path)
 {
     size_t endline = req.find("\r\n");
@@ -96,7 +127,7 @@ static void Loop()
         if (client < 0)
             continue;
 #endif
-        char buf[256];
+        char buf[1024];
         int len = recv(client,
 #ifdef _WIN32
                         buf,
@@ -140,6 +171,17 @@ static void Loop()
             send(client, hdr.c_str(), static_cast<int>(hdr.size()), 0);
             send(client, body.c_str(), static_cast<int>(body.size()), 0);
         }
+        else if (path == "/metrics")
+        {
+            const bool openMetrics = WantsOpenMetrics(req);
+            const std::string body = GetMetrics().Render(openMetrics);
+            std::string hdr = "HTTP/1.1 200 OK\r\nContent-Type: ";
+            hdr += openMetrics ? "application/openmetrics-text; version=1.0.0; charset=utf-8"
+                               : "text/plain; version=0.0.4; charset=utf-8";
+            hdr += "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+            SendAll(client, hdr);
+            SendAll(client, body);
+        }
         else
         {
             const char* resp = "HTTP/1.1 404 Not Found\r\n\r\n";
@@ -1,5 +1,8 @@
 #include "NpcController.hpp"
+#include "NpcStore.hpp"
 #include "../core/Hash.hpp"
+#include "../core/TaskGraph.hpp"
+#include "../core/TickProfiler.hpp"
 #include "../net/Connection.hpp"
 #include "../net/InterestGrid.hpp"
 #include "../net/Net.hpp"
@@ -8,36 +11,40 @@
 #include <RED4ext/RED4ext.hpp>
 #include <algorithm>
 #include <cmath>
-#include <cstring>
-#include <iostream>
+#include <cstdlib>
 #include <unordered_map>
+#include <vector>
 #include <mutex>
 
 namespace CoopNet
 {
 
-static uint32_t g_seed = 123456u;
 static std::unordered_map<uint64_t, uint32_t> g_sectorSeeds;
-static NpcSnap g_npc{1u,
-                     0u,
-                     0ull,
-                     RED4ext::Vector3{0.f, 0.f, 0.f},
-                     RED4ext::Quaternion{0.f, 0.f, 0.f, 1.f},
-                     NpcState::Idle,
-                     100u,
-                     static_cast<uint8_t>(PoliceAIState::Idle),
-                     0u,
-                     {0, 0}};
-static bool g_alwaysRelevant = false;
-static NpcSnap g_prevSnap = g_npc;
+// Server-driven NPCs; id 1 is the original single roaming NPC.
+static constexpr uint32_t kPrimaryNpcId = 1u;
+static const NpcSnap kPrimaryNpc{kPrimaryNpcId,
+                                 0u,
+                                 0ull,
+                                 RED4ext::Vector3{0.f, 0.f, 0.f},
+                                 RED4ext::Quaternion{0.f, 0.f, 0.f, 1.f},
+                                 NpcState::Idle,
+                                 100u,
+                                 static_cast<uint8_t>(PoliceAIState::Idle),
+                                 0u,
+                                 {0, 0},
+                                 0u};
+// Slots integrated per TaskGraph chunk; large enough that a chunk outweighs
+// the cost of handing it to a worker.
+static constexpr size_t kNpcTickGrain = 512;
+static NpcStore g_store;
+static TaskGraph* g_taskGraph = nullptr;
 static bool g_gridInit = false;
-static float g_walkDir = 0.f;
-static float g_dirTimer = 0.f;
 static float g_healthMult = 1.f;
 static float g_damageMult = 1.f;
 static float g_waveTimer = 0.f;
 static uint8_t g_waveCount = 0;
 static uint32_t g_nextId = 2u;
+static uint32_t g_interestTick = 0;
 static std::mutex g_npcMutex;
 
 static uint32_t GetSectorSeed(uint64_t hash)
@@ -63,85 +70,167 @@ uint32_t NpcController_GetSectorSeed(uint64_t hash)
     return GetSectorSeed(hash);
 }
 
-void NpcController_ServerTick(float dt)
+size_t NpcController_Replicate(Connection* conn, uint32_t npcId)
 {
-    auto conns = Net_GetConnections();
-    size_t playerCount = conns.size();
+    NpcSnapshotPacket pkt;
     {
         std::lock_guard lock(g_npcMutex);
-        g_healthMult = (std::min)(2.0f, 1.0f + 0.25f * (static_cast<float>(playerCount) - 1.f));
-        g_damageMult = (std::min)(1.6f, 1.0f + 0.15f * (static_cast<float>(playerCount) - 1.f));
+        const ptrdiff_t slot = g_store.IndexOf(npcId);
+        if (slot < 0)
+            return 0;
+        pkt = NpcSnapshotPacket_Pack(g_store.GetSnap(static_cast<size_t>(slot)));
     }
+    Net_Send(conn, EMsg::NpcSnapshot, &pkt, sizeof(pkt));
+    conn->snapBytes += sizeof(pkt);
+    return sizeof(pkt);
+}
 
-    if (!g_gridInit)
+void NpcController_MarkForReplication(Connection* conn, const uint32_t* ids, size_t count)
+{
+    std::lock_guard lock(g_npcMutex);
+    for (size_t i = 0; i < count; ++i)
     {
-        std::lock_guard lock(g_npcMutex);
-        g_npc.sectorHash = Fnv1a64Pos(g_npc.pos.X, g_npc.pos.Y);
-        g_interestGrid.Insert(g_npc.npcId, g_npc.pos);
-        g_gridInit = true;
-        g_npc.health = static_cast<uint16_t>(100u * g_healthMult);
+        const ptrdiff_t slot = g_store.IndexOf(ids[i]);
+        if (slot < 0)
+            continue;
+        conn->replication.Mark(ReplicationClass::Npc, ids[i], g_store.GetPos(static_cast<size_t>(slot)),
+                               g_store.GetPhase(static_cast<size_t>(slot)), sizeof(NpcSnapshotPacket));
     }
-    // NR-2: deterministic AI walk routine
+}
+
+void NpcController_SetTaskGraph(TaskGraph* graph)
+{
+    std::lock_guard lock(g_npcMutex);
+    g_taskGraph = graph;
+}
+
+void NpcController_ServerTick(float dt)
+{
+    COOP_PROFILE_SCOPE("NpcController_ServerTick");
+    auto conns = Net_GetConnections();
+    size_t playerCount = conns.size();
+    const float dtSec = dt / 1000.f;
+    std::vector<uint32_t> slots, movedIds;
+    std::vector<RED4ext::Vector3> movedPos;
     {
         std::lock_guard lock(g_npcMutex);
-        g_dirTimer += dt;
-        if (g_dirTimer >= 3.f)
+        g_healthMult = (std::min)(2.0f, 1.0f + 0.25f * (static_cast<float>(playerCount) - 1.f));
+        g_damageMult = (std::min)(1.6f, 1.0f + 0.15f * (static_cast<float>(playerCount) - 1.f));
+        if (!g_gridInit)
         {
-            g_seed = g_seed * 1664525u + 1013904223u;
-            g_walkDir = static_cast<float>(g_seed & 0xFFFF) / 65535.f * 6.283185f;
-            g_dirTimer = 0.f;
+            NpcSnap s = kPrimaryNpc;
+            s.sectorHash = Fnv1a64Pos(s.pos.X, s.pos.Y);
+            s.health = static_cast<uint16_t>(100u * g_healthMult);
+            g_store.Spawn(s);
+            g_gridInit = true;
         }
-        float speed = 0.5f; // m/s
-        g_npc.pos.X += std::cos(g_walkDir) * speed * dt;
-        g_npc.pos.Y += std::sin(g_walkDir) * speed * dt;
-    }
-    g_interestGrid.Move(g_npc.npcId, g_npc.pos);
 
-    std::cout << "[NPC] tick seed=" << g_seed << " pos=" << g_npc.pos.X << std::endl;
+        // NR-2: deterministic AI walk routine, split across workers by slot range.
+        const size_t count = g_store.Size();
+        if (g_taskGraph)
+            g_taskGraph->ParallelFor(count, kNpcTickGrain,
+                                     [dtSec](size_t begin, size_t end) { g_store.Integrate(begin, end, dtSec); });
+        else
+            g_store.Integrate(0, count, dtSec);
 
-    bool changed = false;
-    {
-        std::lock_guard lock(g_npcMutex);
-        changed = std::memcmp(&g_prevSnap, &g_npc, sizeof(NpcSnap)) != 0;
+        g_store.CollectDirty(NpcDirty_Pos | NpcDirty_Spawn, slots);
+        movedIds.reserve(slots.size());
+        movedPos.reserve(slots.size());
+        for (uint32_t slot : slots)
+        {
+            movedIds.push_back(g_store.GetId(slot));
+            movedPos.push_back(g_store.GetPos(slot));
+        }
     }
+    g_interestGrid.MoveMany(movedIds.data(), movedPos.data(), movedIds.size());
 
+    // Re-evaluate interest only for players who crossed a cell or whose
+    // neighbourhood had an NPC cross one, then one batched grid query for all
+    // of them.
+    std::vector<InterestGrid::CellId> dirty;
+    g_interestGrid.TakeDirtyCells(dirty);
+    const int32_t reach = g_interestGrid.CellReach(kNpcInterestLeaveRadius);
+    const bool fullPass = ++g_interestTick % kNpcInterestRefreshTicks == 0;
+    std::vector<Connection*> stale;
+    std::vector<RED4ext::Vector3> centers;
     for (auto* c : conns)
     {
         if (!c->sectorReady)
+        {
+            c->interestCellValid = false;
             continue;
-        c->RefreshNpcInterest();
-        if (c->subscribedNpcs.count(g_npc.npcId) && changed)
+        }
+        const InterestGrid::CellId cell = g_interestGrid.CellOf(c->avatarPos);
+        bool reevaluate = fullPass || !c->interestCellValid || cell.x != c->interestCellX ||
+                          cell.y != c->interestCellY;
+        for (size_t i = 0; !reevaluate && i < dirty.size(); ++i)
+            reevaluate = std::abs(dirty[i].x - cell.x) <= reach && std::abs(dirty[i].y - cell.y) <= reach;
+        c->interestCellX = cell.x;
+        c->interestCellY = cell.y;
+        c->interestCellValid = true;
+        if (reevaluate)
         {
-            NpcSnapshotPacket pkt{g_npc};
-            Net_Send(c, EMsg::NpcSnapshot, &pkt, sizeof(pkt));
-            c->snapBytes += sizeof(pkt);
+            stale.push_back(c);
+            centers.push_back(c->avatarPos);
         }
     }
-
-    if (changed)
+    if (!stale.empty())
     {
-        std::lock_guard lock(g_npcMutex);
-        g_prevSnap = g_npc;
+        std::vector<uint32_t> enter, enterOffsets, keep, keepOffsets;
+        g_interestGrid.QueryHysteresis(centers.data(), centers.size(), kNpcInterestEnterRadius,
+                                       kNpcInterestLeaveRadius, enter, enterOffsets, keep, keepOffsets);
+        for (size_t i = 0; i < stale.size(); ++i)
+        {
+            stale[i]->RefreshNpcInterest(enter.data() + enterOffsets[i], enterOffsets[i + 1] - enterOffsets[i],
+                                         keep.data() + keepOffsets[i], keepOffsets[i + 1] - keepOffsets[i]);
+        }
     }
 
-    if (playerCount > 2 && g_npc.state == NpcState::Combat)
+    std::lock_guard lock(g_npcMutex);
+    // Queue every subscribed NPC with a dirty field; each connection only
+    // touches its own scheduler, so connections are marked in parallel.
+    // NpcSnapshot travels unsequenced and unacked, so the full interest pass
+    // also queues the clean ones: an NPC whose last update (its death, say)
+    // was lost still converges within kNpcInterestRefreshTicks.
+    auto markRange = [&conns, fullPass](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Connection* c = conns[i];
+            if (!c->sectorReady)
+                continue;
+            for (uint32_t id : c->subscribedNpcs)
+            {
+                const ptrdiff_t slot = g_store.IndexOf(id);
+                if (slot < 0 || (!fullPass && g_store.GetDirty(static_cast<size_t>(slot)) == 0))
+                    continue;
+                c->replication.Mark(ReplicationClass::Npc, id, g_store.GetPos(static_cast<size_t>(slot)),
+                                    g_store.GetPhase(static_cast<size_t>(slot)), sizeof(NpcSnapshotPacket));
+            }
+        }
+    };
+    if (g_taskGraph)
+        g_taskGraph->ParallelFor(conns.size(), 1, markRange);
+    else
+        markRange(0, conns.size());
+    g_store.ClearDirty();
+
+    const ptrdiff_t primary = g_store.IndexOf(kPrimaryNpcId);
+    if (playerCount > 2 && primary >= 0 && g_store.GetState(static_cast<size_t>(primary)) == NpcState::Combat)
     {
         g_waveTimer += dt;
         if (g_waveTimer >= 30000.f && g_waveCount < 3)
         {
             g_waveTimer = 0.f;
             g_waveCount++;
+            const NpcSnap leader = g_store.GetSnap(static_cast<size_t>(primary));
             for (int i = 0; i < 2; ++i)
             {
-                NpcSnap s = g_npc;
-                {
-                    std::lock_guard lock(g_npcMutex);
-                    s.npcId = g_nextId++;
-                    s.health = static_cast<uint16_t>(100u * g_healthMult);
-                }
+                NpcSnap s = leader;
+                s.npcId = g_nextId++;
+                s.health = static_cast<uint16_t>(100u * g_healthMult);
+                g_store.Spawn(s); // joins the grid with next tick's moves
                 NpcSpawnPacket pkt{s};
-                Net_Broadcast(EMsg::NpcSpawn, &pkt, sizeof(pkt));
-                g_interestGrid.Insert(s.npcId, s.pos);
+                Net_BroadcastPhase(EMsg::NpcSpawn, &pkt, sizeof(pkt), s.phaseId);
             }
         }
     }
@@ -149,7 +238,6 @@ void NpcController_ServerTick(float dt)
     {
         g_waveTimer = 0.f;
     }
-    // Spatial grid reduces search complexity for interest checks
 }
 
 void NpcController_ClientApplySnap(const NpcSnap& snap)
@@ -165,15 +253,45 @@ void NpcController_ApplyCrowdSeed(uint64_t hash, uint32_t seed)
 void NpcController_Despawn(uint32_t id)
 {
     RED4EXT_EXECUTE("NpcController", "DespawnNpc", nullptr, id);
+    {
+        std::lock_guard lock(g_npcMutex);
+        g_store.Despawn(id);
+    }
     g_interestGrid.Remove(id);
 }
 
-const NpcSnap& NpcController_GetSnap()
+size_t NpcController_DespawnPhase(uint32_t phaseId)
+{
+    std::vector<uint32_t> removed;
+    {
+        std::lock_guard lock(g_npcMutex);
+        g_store.DespawnPhase(phaseId, &removed);
+    }
+    for (uint32_t id : removed)
+    {
+        g_interestGrid.Remove(id);
+        NpcDespawnPacket pkt{id};
+        Net_BroadcastPhase(EMsg::NpcDespawn, &pkt, sizeof(pkt), phaseId);
+    }
+    return removed.size();
+}
+
+size_t NpcController_CollectPhase(uint32_t phaseId, NpcSnap* out, size_t maxCount)
+{
+    std::lock_guard lock(g_npcMutex);
+    size_t n = 0;
+    for (size_t slot = 0; slot < g_store.Size() && n < maxCount; ++slot)
+    {
+        if (g_store.GetPhase(slot) == phaseId)
+            out[n++] = g_store.GetSnap(slot);
+    }
+    return n;
+}
+
+size_t NpcController_GetCount()
 {
-    static thread_local NpcSnap s_copy;
     std::lock_guard lock(g_npcMutex);
-    s_copy = g_npc;
-    return s_copy;
+    return g_store.Size();
 }
 
 } // namespace CoopNet
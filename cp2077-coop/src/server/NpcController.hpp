@@ -3,12 +3,28 @@
 
 namespace CoopNet {
 
-void NpcController_ServerTick(float dt);
+class Connection;
+class TaskGraph;
+
+// Splits NPC integration and replication marking across `graph`'s workers;
+// null (the default) runs the tick serially.
+void NpcController_SetTaskGraph(TaskGraph* graph);
+void NpcController_ServerTick(float dt); // dt in milliseconds
+// Sends the NPC's current snapshot to `conn` (ReplicationScheduler callback);
+// returns bytes sent, 0 if the NPC no longer exists.
+size_t NpcController_Replicate(Connection* conn, uint32_t npcId);
+// Queues the current state of each listed NPC on `conn`'s replication
+// scheduler whatever its dirty bits; for NPCs that just entered its interest.
+void NpcController_MarkForReplication(Connection* conn, const uint32_t* ids, size_t count);
 void NpcController_ClientApplySnap(const NpcSnap& snap);
 void NpcController_Despawn(uint32_t id);
+// Removes every server NPC in `phaseId` and tells that phase; returns how many.
+size_t NpcController_DespawnPhase(uint32_t phaseId);
 void NpcController_OnPlayerEnterSector(uint32_t peerId, uint64_t hash);
 uint32_t NpcController_GetSectorSeed(uint64_t hash);
 void NpcController_ApplyCrowdSeed(uint64_t hash, uint32_t seed);
-const NpcSnap& NpcController_GetSnap();
+// Copies up to `maxCount` snapshots of NPCs in `phaseId`; returns how many.
+size_t NpcController_CollectPhase(uint32_t phaseId, NpcSnap* out, size_t maxCount);
+size_t NpcController_GetCount();
 
 }
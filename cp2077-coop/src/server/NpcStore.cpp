@@ -0,0 +1,232 @@
+#include "NpcStore.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace CoopNet
+{
+namespace
+{
+// Id 1 (the original single server NPC) keeps the historic walk seed.
+uint32_t WalkSeedFor(uint32_t npcId)
+{
+    return kNpcWalkSeed ^ ((npcId - 1u) * 2654435761u);
+}
+
+template <typename T>
+void SwapPop(std::vector<T>& v, size_t slot)
+{
+    v[slot] = v.back();
+    v.pop_back();
+}
+} // namespace
+
+size_t NpcStore::Spawn(const NpcSnap& snap)
+{
+    size_t slot;
+    auto it = m_slotOf.find(snap.npcId);
+    if (it != m_slotOf.end())
+    {
+        slot = it->second;
+    }
+    else
+    {
+        slot = m_ids.size();
+        m_slotOf.emplace(snap.npcId, static_cast<uint32_t>(slot));
+        m_posX.emplace_back();
+        m_posY.emplace_back();
+        m_posZ.emplace_back();
+        m_velX.emplace_back();
+        m_velY.emplace_back();
+        m_turnTimer.emplace_back();
+        m_dirty.emplace_back();
+        m_ids.emplace_back();
+        m_seed.emplace_back();
+        m_rot.emplace_back();
+        m_state.emplace_back();
+        m_health.emplace_back();
+        m_aiState.emplace_back();
+        m_templateId.emplace_back();
+        m_appearanceSeed.emplace_back();
+        m_sectorHash.emplace_back();
+        m_phase.emplace_back();
+    }
+    m_posX[slot] = snap.pos.X;
+    m_posY[slot] = snap.pos.Y;
+    m_posZ[slot] = snap.pos.Z;
+    m_velX[slot] = snap.health ? kNpcWalkSpeed : 0.f;
+    m_velY[slot] = 0.f;
+    m_turnTimer[slot] = 0.f;
+    m_dirty[slot] = NpcDirty_Spawn | NpcDirty_Pos | NpcDirty_Rot | NpcDirty_State | NpcDirty_Health;
+    m_ids[slot] = snap.npcId;
+    m_seed[slot] = WalkSeedFor(snap.npcId);
+    m_rot[slot] = snap.rot;
+    m_state[slot] = snap.state;
+    m_health[slot] = snap.health;
+    m_aiState[slot] = snap.aiState;
+    m_templateId[slot] = snap.templateId;
+    m_appearanceSeed[slot] = snap.appearanceSeed;
+    m_sectorHash[slot] = snap.sectorHash;
+    m_phase[slot] = snap.phaseId;
+    return slot;
+}
+
+bool NpcStore::Despawn(uint32_t npcId)
+{
+    auto it = m_slotOf.find(npcId);
+    if (it == m_slotOf.end())
+        return false;
+    const size_t slot = it->second;
+    m_slotOf.erase(it);
+    if (slot + 1 != m_ids.size())
+        m_slotOf[m_ids.back()] = static_cast<uint32_t>(slot);
+    SwapPop(m_posX, slot);
+    SwapPop(m_posY, slot);
+    SwapPop(m_posZ, slot);
+    SwapPop(m_velX, slot);
+    SwapPop(m_velY, slot);
+    SwapPop(m_turnTimer, slot);
+    SwapPop(m_dirty, slot);
+    SwapPop(m_ids, slot);
+    SwapPop(m_seed, slot);
+    SwapPop(m_rot, slot);
+    SwapPop(m_state, slot);
+    SwapPop(m_health, slot);
+    SwapPop(m_aiState, slot);
+    SwapPop(m_templateId, slot);
+    SwapPop(m_appearanceSeed, slot);
+    SwapPop(m_sectorHash, slot);
+    SwapPop(m_phase, slot);
+    return true;
+}
+
+size_t NpcStore::DespawnPhase(uint32_t phaseId, std::vector<uint32_t>* removedIds)
+{
+    size_t removed = 0;
+    // Walk backwards so the swap-removed tail has already been visited.
+    for (size_t slot = m_ids.size(); slot-- > 0;)
+    {
+        if (m_phase[slot] != phaseId)
+            continue;
+        if (removedIds)
+            removedIds->push_back(m_ids[slot]);
+        Despawn(m_ids[slot]);
+        ++removed;
+    }
+    return removed;
+}
+
+void NpcStore::Clear()
+{
+    *this = NpcStore();
+}
+
+ptrdiff_t NpcStore::IndexOf(uint32_t npcId) const
+{
+    auto it = m_slotOf.find(npcId);
+    return it == m_slotOf.end() ? -1 : static_cast<ptrdiff_t>(it->second);
+}
+
+NpcSnap NpcStore::GetSnap(size_t slot) const
+{
+    NpcSnap s{};
+    s.npcId = m_ids[slot];
+    s.templateId = m_templateId[slot];
+    s.sectorHash = m_sectorHash[slot];
+    s.pos = RED4ext::Vector3{m_posX[slot], m_posY[slot], m_posZ[slot]};
+    s.rot = m_rot[slot];
+    s.state = m_state[slot];
+    s.health = m_health[slot];
+    s.aiState = m_aiState[slot];
+    s.appearanceSeed = m_appearanceSeed[slot];
+    s.phaseId = m_phase[slot];
+    return s;
+}
+
+void NpcStore::SetState(size_t slot, NpcState state)
+{
+    if (m_state[slot] == state)
+        return;
+    m_state[slot] = state;
+    m_dirty[slot] |= NpcDirty_State;
+}
+
+void NpcStore::SetHealth(size_t slot, uint16_t health)
+{
+    if (m_health[slot] == health)
+        return;
+    m_health[slot] = health;
+    m_dirty[slot] |= NpcDirty_Health;
+    if (health == 0)
+    {
+        m_velX[slot] = 0.f;
+        m_velY[slot] = 0.f;
+    }
+}
+
+void NpcStore::SetAiState(size_t slot, uint8_t aiState)
+{
+    if (m_aiState[slot] == aiState)
+        return;
+    m_aiState[slot] = aiState;
+    m_dirty[slot] |= NpcDirty_State;
+}
+
+void NpcStore::SetHeading(size_t slot, float yaw)
+{
+    if (m_health[slot] != 0)
+    {
+        m_velX[slot] = std::cos(yaw) * kNpcWalkSpeed;
+        m_velY[slot] = std::sin(yaw) * kNpcWalkSpeed;
+    }
+    m_rot[slot] = RED4ext::Quaternion{0.f, 0.f, std::sin(yaw * 0.5f), std::cos(yaw * 0.5f)};
+    m_dirty[slot] |= NpcDirty_Rot;
+}
+
+void NpcStore::Integrate(size_t begin, size_t end, float dtSec)
+{
+    end = (std::min)(end, m_ids.size());
+    if (begin >= end)
+        return;
+
+    // Heading turns are rare (every kNpcWalkTurnSec), so they get their own
+    // pass and keep the position loop branch-free.
+    float* timer = m_turnTimer.data();
+    for (size_t i = begin; i < end; ++i)
+    {
+        timer[i] += dtSec;
+        if (timer[i] >= kNpcWalkTurnSec)
+        {
+            m_seed[i] = m_seed[i] * 1664525u + 1013904223u;
+            SetHeading(i, static_cast<float>(m_seed[i] & 0xFFFF) / 65535.f * 6.283185f);
+            timer[i] = 0.f;
+        }
+    }
+
+    float* __restrict px = m_posX.data();
+    float* __restrict py = m_posY.data();
+    const float* __restrict vx = m_velX.data();
+    const float* __restrict vy = m_velY.data();
+    uint8_t* __restrict dirty = m_dirty.data();
+    for (size_t i = begin; i < end; ++i)
+    {
+        px[i] += vx[i] * dtSec;
+        py[i] += vy[i] * dtSec;
+    }
+    for (size_t i = begin; i < end; ++i)
+        dirty[i] |= static_cast<uint8_t>((vx[i] != 0.f) | (vy[i] != 0.f)) * NpcDirty_Pos;
+}
+
+void NpcStore::CollectDirty(uint8_t mask, std::vector<uint32_t>& outSlots) const
+{
+    for (size_t i = 0; i < m_dirty.size(); ++i)
+    {
+        if (m_dirty[i] & mask)
+            outSlots.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void NpcStore::ClearDirty()
+{
+    std::fill(m_dirty.begin(), m_dirty.end(), uint8_t{0});
+}
+} // namespace CoopNet
@@ -0,0 +1,89 @@
+#pragma once
+
+// Server-side NPC state in structure-of-arrays layout.
+// Each replicated field lives in its own contiguous array indexed by a dense
+// slot, so the per-tick walk integration streams through positions and
+// velocities only and vectorises, and a range of slots can be integrated on
+// one worker without touching any other range. Every slot carries a dirty
+// mask using the NpcSnap delta bits; writers set bits, the tick consumes them
+// to decide what moves in the interest grid and what gets replicated.
+// Despawn swap-removes, so slot indices are not stable across despawns.
+
+#include "../net/Snapshot.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace CoopNet
+{
+// Dirty bits, matching the NpcSnap delta bit numbering.
+enum NpcDirty : uint8_t
+{
+    NpcDirty_Pos = 1u << 0,
+    NpcDirty_Rot = 1u << 1,
+    NpcDirty_State = 1u << 2,
+    NpcDirty_Health = 1u << 3,
+    NpcDirty_Spawn = 1u << 7, // inserted since the last ClearDirty
+};
+
+constexpr float kNpcWalkSpeed = 0.5f;   // m/s
+constexpr float kNpcWalkTurnSec = 3.f;  // seconds between deterministic heading changes
+constexpr uint32_t kNpcWalkSeed = 123456u;
+
+class NpcStore
+{
+public:
+    // Adds an NPC (or overwrites the slot of an existing id) heading along +X;
+    // its walk seed is derived from the id. Returns the slot.
+    size_t Spawn(const NpcSnap& snap);
+    bool Despawn(uint32_t npcId);
+    // Removes every NPC in `phaseId`; returns how many.
+    size_t DespawnPhase(uint32_t phaseId, std::vector<uint32_t>* removedIds = nullptr);
+    void Clear();
+
+    size_t Size() const { return m_ids.size(); }
+    // Slot of `npcId`, or -1.
+    ptrdiff_t IndexOf(uint32_t npcId) const;
+    NpcSnap GetSnap(size_t slot) const;
+
+    uint32_t GetId(size_t slot) const { return m_ids[slot]; }
+    uint32_t GetPhase(size_t slot) const { return m_phase[slot]; }
+    NpcState GetState(size_t slot) const { return m_state[slot]; }
+    RED4ext::Vector3 GetPos(size_t slot) const { return {m_posX[slot], m_posY[slot], m_posZ[slot]}; }
+    uint8_t GetDirty(size_t slot) const { return m_dirty[slot]; }
+
+    void SetState(size_t slot, NpcState state);
+    void SetHealth(size_t slot, uint16_t health);
+    void SetAiState(size_t slot, uint8_t aiState);
+
+    // Advances the deterministic walk for slots [begin, end). Touches only
+    // those slots, so disjoint ranges may run concurrently.
+    void Integrate(size_t begin, size_t end, float dtSec);
+
+    // Appends slots whose dirty mask intersects `mask`.
+    void CollectDirty(uint8_t mask, std::vector<uint32_t>& outSlots) const;
+    void ClearDirty();
+
+private:
+    void SetHeading(size_t slot, float yaw);
+
+    // Hot: read and written by every Integrate.
+    std::vector<float> m_posX, m_posY, m_posZ;
+    std::vector<float> m_velX, m_velY;
+    std::vector<float> m_turnTimer;
+    std::vector<uint8_t> m_dirty;
+    // Cold: change on heading turns, spawns and gameplay events.
+    std::vector<uint32_t> m_ids;
+    std::vector<uint32_t> m_seed;
+    std::vector<RED4ext::Quaternion> m_rot;
+    std::vector<NpcState> m_state;
+    std::vector<uint16_t> m_health;
+    std::vector<uint8_t> m_aiState;
+    std::vector<uint16_t> m_templateId;
+    std::vector<uint8_t> m_appearanceSeed;
+    std::vector<uint64_t> m_sectorHash;
+    std::vector<uint32_t> m_phase;
+    std::unordered_map<uint32_t, uint32_t> m_slotOf; // npcId -> slot
+};
+} // namespace CoopNet
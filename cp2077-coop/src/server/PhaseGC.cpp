@@ -1,5 +1,6 @@
 #include "PhaseGC.hpp"
 #include "../core/GameClock.hpp"
+#include "../core/TickProfiler.hpp"
 #include "../net/Connection.hpp"
 #include "../net/Net.hpp"
 #include "NpcController.hpp"
@@ -24,6 +25,7 @@ void PhaseGC_Touch(uint32_t phaseId)
 
 void PhaseGC_Tick(uint64_t nowTick)
 {
+    COOP_PROFILE_SCOPE("PhaseGC_Tick");
     float tickMs = GameClock::GetTickMs();
     if (tickMs <= 0.f)
         return;
@@ -63,8 +65,8 @@ void PhaseGC_Tick(uint64_t nowTick)
     for (uint32_t id : toClear)
     {
         PhaseTrigger_Clear(id);
-        NpcController_Despawn(id);
-        SnapshotStore_PurgeOld(0.f);
+        NpcController_DespawnPhase(id);
+        SnapshotStore_ForgetEntity(id);
         std::cout << "[PhaseGC] cleaned phase " << id << std::endl;
     }
 }
@@ -93,12 +93,7 @@ void QuestWatchdog_BuildFullSync(uint32_t phaseId, QuestFullSyncPacket& outPkt)
         }
     }
 
-    const NpcSnap& npc = NpcController_GetSnap();
-    if (npc.phaseId == phaseId && outPkt.npcCount < 16)
-    {
-        outPkt.npcs[outPkt.npcCount] = npc;
-        ++outPkt.npcCount;
-    }
+    outPkt.npcCount = static_cast<uint16_t>(NpcController_CollectPhase(phaseId, outPkt.npcs, 16));
 
     for (const auto& e : SessionState_GetEvents())
     {
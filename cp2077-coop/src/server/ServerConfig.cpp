@@ -1,6 +1,8 @@
 #include "ServerConfig.hpp"
+#include "../net/NetChannels.hpp"
 #include <algorithm>
 #include <fstream>
+#include <iostream>
 #include <string>
 
 namespace CoopNet
@@ -17,6 +19,24 @@ static bool ParseBool(const std::string& s)
     return v == "1" || v == "true" || v == "yes";
 }
 
+bool ServerConfig_ApplyChannelOption(const std::string& key, const std::string& val)
+{
+    if (key == "net_single_channel")
+    {
+        NetChannel_SetSingleChannel(ParseBool(val));
+        return true;
+    }
+    if (key.rfind("channel_", 0) != 0)
+        return false;
+    NetChannel ch;
+    NetDelivery delivery;
+    if (NetChannel_Parse(key.substr(8), ch) && NetDelivery_Parse(val, delivery))
+        NetChannel_SetDelivery(ch, delivery);
+    else
+        std::cerr << "[ServerConfig] invalid channel setting " << key << "=" << val << std::endl;
+    return true;
+}
+
 void ServerConfig_Load()
 {
     g_cfgFriendlyFire = false;
@@ -37,6 +57,8 @@ void ServerConfig_Load()
             g_cfgMasterHost = val;
         else if (key == "master_port")
             g_cfgMasterPort = std::atoi(val.c_str());
+        else
+            ServerConfig_ApplyChannelOption(key, val);
     }
 }
 
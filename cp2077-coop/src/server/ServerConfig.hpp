@@ -7,4 +7,7 @@ extern bool g_cfgFriendlyFire;
 extern std::string g_cfgMasterHost;
 extern int g_cfgMasterPort;
 void ServerConfig_Load();
+// Applies net_single_channel and channel_<name>=<delivery>; returns false if
+// `key` is not a channel option. Shared by both config file readers.
+bool ServerConfig_ApplyChannelOption(const std::string& key, const std::string& val);
 } // namespace CoopNet
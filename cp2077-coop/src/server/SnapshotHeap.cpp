@@ -1,64 +1,44 @@
 #include "SnapshotHeap.hpp"
-#include "../core/GameClock.hpp"
-#include <algorithm>
-#include <chrono>
+#include "../net/Connection.hpp"
+#include "../net/Net.hpp"
+#include "../net/Snapshot.hpp"
 #include <iostream>
-#include <malloc.h>
-#ifdef _WIN32
-#include <windows.h>
-#include <psapi.h>
-#pragma comment(lib, "Psapi.lib")
-#endif
-#include <vector>
 
 namespace CoopNet
 {
-struct Entry
-{
-    uint64_t time;
-    size_t bytes;
-};
-static std::vector<Entry> g_entries;
+// Arenas never grow, so this only fires if the connection count itself is
+// far beyond what the server was sized for.
+static constexpr size_t kSnapshotMemBudget = size_t(256) << 20;
 
-void SnapshotStore_Add(size_t bytes)
+size_t SnapshotStore_GetMemory()
 {
-    g_entries.push_back({GameClock::GetTimeMs(), bytes});
+    return SnapshotBaselineArena::TotalBytes();
 }
 
-void SnapshotStore_PurgeOld(float ageSec)
+size_t SnapshotStore_GetOccupied()
 {
-    uint64_t now = GameClock::GetTimeMs();
-    g_entries.erase(std::remove_if(g_entries.begin(), g_entries.end(), [&](const Entry& e)
-                                   { return now - e.time > static_cast<uint64_t>(ageSec * 1000.f); }),
-                    g_entries.end());
+    size_t total = 0;
+    for (Connection* c : Net_GetConnections())
+        total += c->snapshotOut.GetArena().Occupied() + c->snapshotIn.GetArena().Occupied();
+    return total;
 }
 
-size_t SnapshotStore_GetMemory()
+void SnapshotStore_ForgetEntity(uint32_t entityId)
 {
-    size_t total = 0;
-    for (auto& e : g_entries)
-        total += e.bytes;
-    return total;
+    for (Connection* c : Net_GetConnections())
+    {
+        c->snapshotOut.Forget(entityId);
+        c->snapshotIn.Forget(entityId);
+    }
 }
 
 void SnapshotMemCheck()
 {
-#ifdef __GLIBC__
-    struct mallinfo mi = mallinfo();
-    size_t used = static_cast<size_t>(mi.uordblks);
-#elif defined(_WIN32)
-    PROCESS_MEMORY_COUNTERS_EX pm{};
-    size_t used = 0;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pm), sizeof(pm)))
-        used = static_cast<size_t>(pm.WorkingSetSize);
-#else
-    size_t used = 0;
-#endif
-    used = (std::max)(used, SnapshotStore_GetMemory());
-    if (used > (size_t(2) << 30))
+    const size_t used = SnapshotStore_GetMemory();
+    if (used > kSnapshotMemBudget)
     {
-        SnapshotStore_PurgeOld(300.f);
-        std::cerr << "[MemGuard] snapshot heap high, purged old baselines" << std::endl;
+        std::cerr << "[MemGuard] snapshot baselines use " << (used >> 20) << " MiB across "
+                  << Net_GetConnections().size() << " connections" << std::endl;
     }
 }
 
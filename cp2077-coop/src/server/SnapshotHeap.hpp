@@ -1,10 +1,14 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 
 namespace CoopNet
 {
-void SnapshotStore_Add(size_t bytes);
-void SnapshotStore_PurgeOld(float ageSec);
-size_t SnapshotStore_GetMemory();
+// Snapshot baselines live in fixed-capacity SnapshotBaselineArena instances,
+// one per peer and direction (see net/Snapshot.hpp); these helpers report and
+// maintain them across all connections.
+size_t SnapshotStore_GetMemory();   // bytes reserved by all arenas, O(1)
+size_t SnapshotStore_GetOccupied(); // baselines currently held
+void SnapshotStore_ForgetEntity(uint32_t entityId);
 void SnapshotMemCheck();
 } // namespace CoopNet
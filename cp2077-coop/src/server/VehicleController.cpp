@@ -512,7 +512,7 @@ void VehicleController_SpawnPhaseVehicle(uint32_t archetype, uint32_t paint, con
     }
 
     VehicleSpawnPacket pkt{id, archetype, paint, phaseId, t};
-    Net_Broadcast(EMsg::VehicleSpawn, &pkt, sizeof(pkt));
+    Net_BroadcastPhase(EMsg::VehicleSpawn, &pkt, sizeof(pkt), phaseId);
 
     // Register with MultiOccupancyManager
     auto& vehicleController = VehicleController::GetInstance();
@@ -581,17 +581,19 @@ void VehicleController_HandleHit(uint32_t vehicleId, uint16_t dmg, bool side)
     v.lastHit = now;
     uint16_t apply = std::min<uint16_t>(dmg, 500u);
     v.damage = static_cast<uint16_t>(std::min<int>(1000, v.damage + apply));
+    // A lost part and a wreck outlast the hit, so they go to everyone who
+    // was sent the vehicle, not only to players nearby.
     if (side && apply > 300u)
     {
         VehiclePartDetachPacket dpkt{v.id, 0, {0, 0, 0}};
-        Net_Broadcast(EMsg::VehiclePartDetach, &dpkt, sizeof(dpkt));
+        Net_BroadcastPhase(EMsg::VehiclePartDetach, &dpkt, sizeof(dpkt), v.phaseId);
     }
     if (v.damage >= 1000u)
     {
         uint32_t vfx = Fnv1a32("veh_explosion_big.ent");
         uint32_t seed = v.damage * 1664525u + 1013904223u;
         VehicleExplodePacket epkt{v.id, vfx, seed};
-        Net_Broadcast(EMsg::VehicleExplode, &epkt, sizeof(epkt));
+        Net_BroadcastPhase(EMsg::VehicleExplode, &epkt, sizeof(epkt), v.phaseId);
         v.destroyed = true;
         v.despawn = 10.f;
         v.towTimer = 300.f;
@@ -603,7 +605,7 @@ void VehicleController_HandleHit(uint32_t vehicleId, uint16_t dmg, bool side)
         SaveCarParking(SessionState_GetId(), v.owner, cp);
     }
     VehicleHitPacket pkt{vehicleId, apply, side ? 1 : 0, 0};
-    Net_Broadcast(EMsg::VehicleHit, &pkt, sizeof(pkt));
+    Net_BroadcastNear(EMsg::VehicleHit, &pkt, sizeof(pkt), v.snap.pos);
 }
 
 void VehicleController_HandleSummon(CoopNet::Connection* c, uint32_t vehId, const TransformSnap& t)
@@ -661,7 +663,7 @@ void VehicleController_HandleTowRequest(CoopNet::Connection* c, const RED4ext::V
         v.despawn = 0.f;
         v.towTimer = 0.f;
         VehicleSpawnPacket pkt{v.id, v.archetype, v.paint, v.phaseId, t};
-        Net_Broadcast(EMsg::VehicleSpawn, &pkt, sizeof(pkt));
+        Net_BroadcastPhase(EMsg::VehicleSpawn, &pkt, sizeof(pkt), v.phaseId);
         std::cout << "[Tow] Car respawn" << std::endl;
     }
     else
@@ -697,6 +699,17 @@ uint32_t VehicleController_GetPeerVehicleId(uint32_t peerId)
     return 0;
 }
 
+bool VehicleController_GetPlacement(uint32_t vehicleId, RED4ext::Vector3& pos, uint32_t& phaseId)
+{
+    std::lock_guard lock(VehicleController::g_vehicleMutex);
+    auto it = VehicleController::g_vehicles.find(vehicleId);
+    if (it == VehicleController::g_vehicles.end())
+        return false;
+    pos = it->second.snap.pos;
+    phaseId = it->second.phaseId;
+    return true;
+}
+
 void VehicleController_ApplyHitValidated(uint32_t attackerPeerId, uint32_t vehicleId, uint16_t dmg, bool side)
 {
     // Basic provenance and rate checks; extend as needed
@@ -742,7 +755,7 @@ void VehicleController_ServerTick(float dt)
         {
             RED4ext::Vector3 launch = v.prevVel;
             EjectOccupantPacket pkt{v.seat[0], launch};
-            Net_Broadcast(EMsg::EjectOccupant, &pkt, sizeof(pkt));
+            Net_BroadcastNear(EMsg::EjectOccupant, &pkt, sizeof(pkt), v.snap.pos);
             v.seat[0] = 0;
         }
         v.prevVel = v.snap.vel;
@@ -116,6 +116,8 @@ void VehicleController_HandleSummon(CoopNet::Connection* c, uint32_t vehId, cons
 void VehicleController_HandleTowRequest(CoopNet::Connection* c, const RED4ext::Vector3& pos);
 void VehicleController_PhysicsStep(float dt);
 uint32_t VehicleController_GetPeerVehicleId(uint32_t peerId);
+// Position and phase of a server-side vehicle; false if it is unknown.
+bool VehicleController_GetPlacement(uint32_t vehicleId, RED4ext::Vector3& pos, uint32_t& phaseId);
 void VehicleController_ApplyHitValidated(uint32_t attackerPeerId, uint32_t vehicleId, uint16_t dmg, bool side);
 
 } // namespace CoopNet
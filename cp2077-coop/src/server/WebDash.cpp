@@ -2,7 +2,7 @@
 #include "../net/Net.hpp"
 #include "../net/Connection.hpp"
 #include "../core/GameClock.hpp"
-#include "../core/ThreadSafeQueue.hpp"
+#include "../core/MpscRing.hpp"
 #include <openssl/sha.h>
 #include <openssl/evp.h>
 #include <thread>
@@ -37,7 +37,9 @@ static SOCKET g_listenSock = INVALID_SOCKET;
 static int g_listenSock = -1;
 #endif
 static std::vector<SocketType> g_wsClients;
-static ThreadSafeQueue<std::string> g_events;
+// Pushed from the tick and admin threads; dropped when the dashboard falls
+// behind rather than stalling the pusher.
+static MpscRing<std::string, 256> g_events;
 
 static bool GetHeaderValue(const std::string& req, const char* key, std::string& out)
 {
@@ -232,12 +234,13 @@ static void ServerLoop()
         close(client);
 #endif
     }
+    std::vector<std::string> events;
+    g_events.DrainTo(events);
+    const std::string status = BuildStatus();
     for (SocketType ws : g_wsClients)
     {
-        std::string status = BuildStatus();
         SendWSFrame(ws, status);
-        std::string evt;
-        while (g_events.Pop(evt))
+        for (const std::string& evt : events)
         {
             SendWSFrame(ws, evt);
         }
@@ -276,7 +279,7 @@ void WebDash_Stop()
 
 void WebDash_PushEvent(const std::string& json)
 {
-    g_events.Push(json);
+    g_events.TryPush(json);
 }
 
 } // namespace CoopNet
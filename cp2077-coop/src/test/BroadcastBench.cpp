@@ -0,0 +1,99 @@
+// Broadcast Encode Microbenchmark
+// Compares the legacy per-peer Net_Send encode (vector + secretbox_easy + copy
+// into a fresh ENetPacket) with the in-place detached seal used by
+// Net_Broadcast. Reports payload bytes/sec for a 32 peer fan-out.
+
+#include "../net/PacketCrypto.hpp"
+#include "../net/Packets.hpp"
+#include <enet/enet.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sodium.h>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using Key = std::array<uint8_t, crypto_secretbox_KEYBYTES>;
+
+constexpr int kPeers = 32;
+constexpr int kIterations = 20000;
+
+ENetPacket* EncodeLegacy(const Key& key, uint32_t nonce, const void* data, uint16_t size)
+{
+    std::vector<uint8_t> outBuf;
+    unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
+    memcpy(nbuf, &nonce, 4);
+    outBuf.resize(4 + size + crypto_secretbox_MACBYTES);
+    memcpy(outBuf.data(), &nonce, 4);
+    crypto_secretbox_easy(outBuf.data() + 4, static_cast<const unsigned char*>(data), size, nbuf, key.data());
+    uint16_t finalSize = static_cast<uint16_t>(outBuf.size());
+    ENetPacket* pkt = enet_packet_create(nullptr, sizeof(CoopNet::PacketHeader) + finalSize, ENET_PACKET_FLAG_RELIABLE);
+    CoopNet::PacketHeader hdr{static_cast<uint16_t>(CoopNet::EMsg::Snapshot), finalSize};
+    std::memcpy(pkt->data, &hdr, sizeof(hdr));
+    std::memcpy(pkt->data + sizeof(hdr), outBuf.data(), finalSize);
+    return pkt;
+}
+
+ENetPacket* EncodeInPlace(const Key& key, uint32_t nonce, const void* data, uint16_t size)
+{
+    const uint16_t finalSize = static_cast<uint16_t>(CoopNet::PacketCrypto_SealedSize(size));
+    ENetPacket* pkt = enet_packet_create(nullptr, sizeof(CoopNet::PacketHeader) + finalSize, ENET_PACKET_FLAG_RELIABLE);
+    CoopNet::PacketHeader hdr{static_cast<uint16_t>(CoopNet::EMsg::Snapshot), finalSize};
+    std::memcpy(pkt->data, &hdr, sizeof(hdr));
+    CoopNet::PacketCrypto_SealInto(pkt->data + sizeof(hdr), nonce, data, size, key.data());
+    return pkt;
+}
+
+template<typename Fn>
+double MeasureBytesPerSec(Fn encode, const std::vector<Key>& keys, const std::vector<uint8_t>& payload)
+{
+    std::array<ENetPacket*, kPeers> pkts{};
+    uint32_t nonce = 0;
+    auto begin = Clock::now();
+    for (int i = 0; i < kIterations; ++i)
+    {
+        for (int p = 0; p < kPeers; ++p)
+            pkts[p] = encode(keys[p], nonce++, payload.data(), static_cast<uint16_t>(payload.size()));
+        for (int p = 0; p < kPeers; ++p)
+            enet_packet_destroy(pkts[p]);
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - begin).count();
+    double bytes = static_cast<double>(payload.size()) * kPeers * kIterations;
+    return sec > 0.0 ? bytes / sec : 0.0;
+}
+} // namespace
+
+extern "C" int RunBroadcastBench() {
+    std::cout << "=== CP2077-Coop Broadcast Encode Benchmark ===" << std::endl;
+    if (sodium_init() < 0 || enet_initialize() != 0) {
+        std::cout << "❌ init failed" << std::endl;
+        return 1;
+    }
+
+    std::vector<Key> keys(kPeers);
+    for (auto& k : keys)
+        crypto_secretbox_keygen(k.data());
+
+    const uint16_t sizes[] = {16, 64, 256, 1024};
+    for (uint16_t size : sizes) {
+        std::vector<uint8_t> payload(size);
+        randombytes_buf(payload.data(), payload.size());
+        double legacy = MeasureBytesPerSec(EncodeLegacy, keys, payload);
+        double inPlace = MeasureBytesPerSec(EncodeInPlace, keys, payload);
+        std::cout << "✓ payload " << size << "B: legacy " << legacy / (1024.0 * 1024.0) << " MiB/s, in-place "
+                  << inPlace / (1024.0 * 1024.0) << " MiB/s (x" << (legacy > 0.0 ? inPlace / legacy : 0.0) << ")"
+                  << std::endl;
+    }
+
+    enet_deinitialize();
+    return 0;
+}
+
+#ifdef BROADCAST_BENCH_STANDALONE
+int main() {
+    return RunBroadcastBench();
+}
+#endif
@@ -0,0 +1,220 @@
+// Channel Loss-Injection Test
+// Runs a loopback ENet session with ~3% inbound datagram loss and checks that
+// snapshot latency stays flat while reliable quest traffic is retransmitted.
+
+#include "../net/NetChannels.hpp"
+#include "../net/Packets.hpp"
+#include <enet/enet.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kTicks = 600;
+constexpr float kLossRate = 0.03f;
+
+std::mt19937 g_lossRng(1234u);
+bool g_lossEnabled = false;
+
+int ENET_CALLBACK DropInbound(ENetHost*, ENetEvent*)
+{
+    if (!g_lossEnabled)
+        return 0;
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    return dist(g_lossRng) < kLossRate ? 1 : 0;
+}
+
+struct TickPayload
+{
+    uint32_t tick;
+    int64_t sentUs;
+};
+
+struct RunResult
+{
+    float snapP50Ms = 0.f;
+    float snapP99Ms = 0.f;
+    uint32_t snapsRecv = 0;
+    uint32_t questSent = 0;
+    uint32_t questRecv = 0;
+    uint32_t retransmits = 0;
+};
+
+int64_t NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void SendMsg(ENetPeer* peer, CoopNet::EMsg type, const TickPayload& body)
+{
+    const CoopNet::NetRoute route = CoopNet::NetChannel_Route(type);
+    ENetPacket* pkt = enet_packet_create(nullptr, sizeof(CoopNet::PacketHeader) + sizeof(body), route.flags);
+    CoopNet::PacketHeader hdr{static_cast<uint16_t>(type), static_cast<uint16_t>(sizeof(body))};
+    std::memcpy(pkt->data, &hdr, sizeof(hdr));
+    std::memcpy(pkt->data + sizeof(hdr), &body, sizeof(body));
+    enet_peer_send(peer, route.channel, pkt);
+}
+
+void Drain(ENetHost* host, std::vector<float>& snapLatMs, uint32_t& questRecv, ENetPeer** connected)
+{
+    ENetEvent evt;
+    while (enet_host_service(host, &evt, 0) > 0)
+    {
+        if (evt.type == ENET_EVENT_TYPE_CONNECT && connected)
+        {
+            *connected = evt.peer;
+        }
+        else if (evt.type == ENET_EVENT_TYPE_RECEIVE)
+        {
+            CoopNet::PacketHeader hdr;
+            TickPayload body;
+            std::memcpy(&hdr, evt.packet->data, sizeof(hdr));
+            std::memcpy(&body, evt.packet->data + sizeof(hdr), sizeof(body));
+            if (hdr.type == static_cast<uint16_t>(CoopNet::EMsg::Snapshot))
+                snapLatMs.push_back(static_cast<float>(NowUs() - body.sentUs) / 1000.f);
+            else if (hdr.type == static_cast<uint16_t>(CoopNet::EMsg::QuestStage))
+                ++questRecv;
+            enet_packet_destroy(evt.packet);
+        }
+    }
+}
+
+bool RunSession(bool singleChannel, RunResult& out)
+{
+    CoopNet::NetChannel_SetSingleChannel(singleChannel);
+    g_lossEnabled = false;
+
+    ENetAddress bind{};
+    bind.host = ENET_HOST_ANY;
+    bind.port = 0;
+    ENetHost* server = enet_host_create(&bind, 1, CoopNet::kNetChannelCount, 0, 0);
+    ENetHost* client = enet_host_create(nullptr, 1, CoopNet::kNetChannelCount, 0, 0);
+    if (!server || !client)
+        return false;
+    ENetAddress bound{};
+    enet_socket_get_address(server->socket, &bound);
+    ENetAddress target{};
+    enet_address_set_host(&target, "127.0.0.1");
+    target.port = bound.port;
+    enet_host_connect(client, &target, CoopNet::kNetChannelCount, 0);
+
+    std::vector<float> snapLat;
+    ENetPeer* serverPeer = nullptr;
+    auto deadline = Clock::now() + std::chrono::seconds(3);
+    while (!serverPeer && Clock::now() < deadline)
+    {
+        Drain(server, snapLat, out.questRecv, &serverPeer);
+        Drain(client, snapLat, out.questRecv, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (!serverPeer)
+        return false;
+
+    client->intercept = DropInbound;
+    g_lossEnabled = true;
+    for (uint32_t tick = 0; tick < kTicks; ++tick)
+    {
+        TickPayload body{tick, NowUs()};
+        SendMsg(serverPeer, CoopNet::EMsg::Snapshot, body);
+        if (tick % 4 == 0)
+        {
+            SendMsg(serverPeer, CoopNet::EMsg::QuestStage, body);
+            ++out.questSent;
+        }
+        Drain(server, snapLat, out.questRecv, nullptr);
+        Drain(client, snapLat, out.questRecv, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    // Give reliable traffic time to finish retransmitting.
+    g_lossEnabled = false;
+    deadline = Clock::now() + std::chrono::seconds(5);
+    while (out.questRecv < out.questSent && Clock::now() < deadline)
+    {
+        Drain(server, snapLat, out.questRecv, nullptr);
+        Drain(client, snapLat, out.questRecv, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    out.retransmits = serverPeer->packetsLost;
+    out.snapsRecv = static_cast<uint32_t>(snapLat.size());
+    if (!snapLat.empty())
+    {
+        std::sort(snapLat.begin(), snapLat.end());
+        out.snapP50Ms = snapLat[snapLat.size() / 2];
+        out.snapP99Ms = snapLat[(snapLat.size() * 99) / 100];
+    }
+
+    enet_host_destroy(client);
+    enet_host_destroy(server);
+    CoopNet::NetChannel_SetSingleChannel(false);
+    return true;
+}
+} // namespace
+
+class ChannelLossTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Channel Loss Test ===" << std::endl;
+
+        if (enet_initialize() != 0) {
+            std::cout << "❌ enet_initialize failed" << std::endl;
+            return false;
+        }
+
+        RunResult legacy;
+        RunResult split;
+        bool ok = RunSession(true, legacy) && RunSession(false, split);
+        enet_deinitialize();
+        if (!ok) {
+            std::cout << "❌ Loopback session failed to connect" << std::endl;
+            return false;
+        }
+
+        Report("single channel", legacy);
+        Report("split channels", split);
+
+        bool passed = true;
+        if (split.questRecv != split.questSent) {
+            std::cout << "❌ Reliable quest traffic lost: " << split.questRecv << "/" << split.questSent << std::endl;
+            passed = false;
+        }
+        if (split.snapP99Ms > legacy.snapP99Ms) {
+            std::cout << "❌ Snapshot p99 latency regressed with split channels" << std::endl;
+            passed = false;
+        }
+        if (split.snapP99Ms > 20.f) {
+            std::cout << "❌ Snapshot p99 latency not flat under loss" << std::endl;
+            passed = false;
+        }
+
+        if (passed) {
+            std::cout << "✅ Channel loss test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    static void Report(const char* label, const RunResult& r) {
+        std::cout << "✓ " << label << ": snapshots " << r.snapsRecv << "/" << kTicks
+                  << " p50=" << r.snapP50Ms << "ms p99=" << r.snapP99Ms << "ms"
+                  << " | quest " << r.questRecv << "/" << r.questSent
+                  << " retransmits=" << r.retransmits << std::endl;
+    }
+};
+
+extern "C" int RunChannelLossTests() {
+    ChannelLossTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef CHANNEL_LOSS_TEST_STANDALONE
+int main() {
+    return RunChannelLossTests();
+}
+#endif
@@ -0,0 +1,220 @@
+// Entity Snapshot Store Test
+// Checks EntitySnapStore's publish semantics (writes stay invisible until
+// Publish, phase moves and swap-removes keep the id -> slot map valid), then
+// runs reader threads against a writer publishing every tick and verifies no
+// reader ever sees a torn frame. Finally times building one phase's snapshot
+// against the previous mutex-guarded linear filter over every entity.
+
+#include "../net/SnapshotWriter.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using CoopNet::EntitySnap;
+using CoopNet::EntitySnapStore;
+using CoopNet::TransformSnap;
+
+constexpr uint32_t kEntities = 4096;
+constexpr uint32_t kPhases = 32;
+constexpr uint32_t kStressTicks = 2000;
+constexpr uint32_t kReaders = 3;
+constexpr uint32_t kBenchBuilds = 2000;
+
+TransformSnap Snap(uint16_t seq, float x = 0.f)
+{
+    TransformSnap s{};
+    s.pos.X = x;
+    s.seq = seq;
+    return s;
+}
+
+std::vector<EntitySnap> Phase(const EntitySnapStore& store, uint32_t phaseId)
+{
+    std::vector<EntitySnap> out;
+    store.Read([&](const EntitySnapStore::Frame& f) { f.AppendPhase(phaseId, out); });
+    return out;
+}
+
+// The previous BuildSnapshot: one vector, one mutex, filter everything.
+struct LegacyStore
+{
+    std::vector<EntitySnap> snaps;
+    std::mutex mutex;
+
+    void Build(uint32_t phaseId, std::vector<EntitySnap>& out)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& e : snaps)
+        {
+            if (e.phaseId != phaseId)
+                continue;
+            out.push_back(e);
+        }
+    }
+};
+} // namespace
+
+class EntitySnapStoreTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Entity Snapshot Store Test ===" << std::endl;
+        bool passed = TestPublishVisibility();
+        passed = TestPhaseMoveAndRemove() && passed;
+        passed = TestConcurrentReaders() && passed;
+        passed = BenchPhaseBuild() && passed;
+        if (passed) {
+            std::cout << "✅ Entity snapshot store test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestPublishVisibility() {
+        EntitySnapStore store;
+        store.Write(1, 7, Snap(1));
+        if (!Phase(store, 7).empty()) {
+            std::cout << "❌ write visible before Publish" << std::endl;
+            return false;
+        }
+        store.Publish();
+        store.Write(1, 7, Snap(2));
+        auto seen = Phase(store, 7);
+        if (seen.size() != 1 || seen[0].snap.seq != 1) {
+            std::cout << "❌ published frame changed before the next Publish" << std::endl;
+            return false;
+        }
+        store.Publish();
+        // Nothing written this tick: the published state must carry over.
+        store.Publish();
+        seen = Phase(store, 7);
+        if (seen.size() != 1 || seen[0].snap.seq != 2) {
+            std::cout << "❌ state lost across an idle Publish" << std::endl;
+            return false;
+        }
+        std::cout << "✓ publish: writes land on the next Publish and persist" << std::endl;
+        return true;
+    }
+
+    bool TestPhaseMoveAndRemove() {
+        EntitySnapStore store;
+        for (uint32_t id = 1; id <= 5; ++id)
+            store.Write(id, 1, Snap(static_cast<uint16_t>(id)));
+        store.Publish();
+        store.Write(2, 3, Snap(20)); // move to phase 3
+        store.Remove(1);             // swap-remove from phase 1
+        store.Write(5, 1, Snap(50)); // the row moved by the removal
+        store.Publish();
+        auto p1 = Phase(store, 1);
+        auto p3 = Phase(store, 3);
+        bool ok = p1.size() == 3 && p3.size() == 1 && p3[0].id == 2 && p3[0].snap.seq == 20;
+        for (const auto& e : p1)
+            ok = ok && e.id != 1 && e.id != 2 && e.snap.seq == (e.id == 5 ? 50 : e.id);
+        if (!ok || store.GetSize() != 4) {
+            std::cout << "❌ phase move / removal corrupted the store" << std::endl;
+            return false;
+        }
+        std::cout << "✓ phase move and swap-remove keep slots consistent" << std::endl;
+        return true;
+    }
+
+    // Every tick the writer stamps all entities with the tick number; a reader
+    // must see one tick's stamp across the whole frame and a full partition.
+    bool TestConcurrentReaders() {
+        EntitySnapStore store;
+        constexpr uint32_t kPerPhase = kEntities / kPhases;
+        for (uint32_t id = 0; id < kEntities; ++id)
+            store.Write(id, id % kPhases, Snap(0));
+        store.Publish();
+
+        std::atomic<bool> done{false};
+        std::atomic<uint32_t> torn{0};
+        std::atomic<uint64_t> reads{0};
+        std::vector<std::thread> readers;
+        for (uint32_t r = 0; r < kReaders; ++r) {
+            readers.emplace_back([&, r] {
+                std::vector<EntitySnap> out;
+                uint32_t phase = r;
+                while (!done.load(std::memory_order_relaxed)) {
+                    out.clear();
+                    store.Read([&](const EntitySnapStore::Frame& f) {
+                        f.AppendPhase(phase, out);
+                        f.AppendPhase((phase + 1) % kPhases, out);
+                    });
+                    bool ok = out.size() == 2 * kPerPhase;
+                    for (const auto& e : out)
+                        ok = ok && e.snap.seq == out[0].snap.seq;
+                    if (!ok)
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    reads.fetch_add(1, std::memory_order_relaxed);
+                    phase = (phase + 1) % kPhases;
+                }
+            });
+        }
+        for (uint32_t tick = 1; tick <= kStressTicks; ++tick) {
+            for (uint32_t id = 0; id < kEntities; ++id)
+                store.Write(id, id % kPhases, Snap(static_cast<uint16_t>(tick)));
+            store.Publish();
+        }
+        done = true;
+        for (auto& t : readers)
+            t.join();
+
+        std::cout << "✓ concurrent readers: " << reads.load() << " reads over " << kStressTicks << " publishes, "
+                  << torn.load() << " torn" << std::endl;
+        if (torn.load() != 0) {
+            std::cout << "❌ a reader saw a partially written frame" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool BenchPhaseBuild() {
+        EntitySnapStore store;
+        LegacyStore legacy;
+        for (uint32_t id = 0; id < kEntities; ++id) {
+            store.Write(id, id % kPhases, Snap(1, static_cast<float>(id)));
+            legacy.snaps.push_back({id, id % kPhases, Snap(1, static_cast<float>(id))});
+        }
+        store.Publish();
+
+        std::vector<EntitySnap> out;
+        out.reserve(kEntities);
+        size_t sink = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kBenchBuilds; ++i) {
+            out.clear();
+            legacy.Build(i % kPhases, out);
+            sink += out.size();
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kBenchBuilds; ++i) {
+            out.clear();
+            store.Read([&](const EntitySnapStore::Frame& f) { f.AppendPhase(i % kPhases, out); });
+            sink += out.size();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        const double legacyUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / kBenchBuilds;
+        const double storeUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / kBenchBuilds;
+        std::cout << "✓ build one phase of " << kEntities << " entities / " << kPhases << " phases: linear filter "
+                  << legacyUs << " us, partitioned " << storeUs << " us (" << sink / (2 * kBenchBuilds)
+                  << " entities per build)" << std::endl;
+        return true;
+    }
+};
+
+extern "C" int RunEntitySnapStoreTests() {
+    EntitySnapStoreTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef ENTITY_SNAP_STORE_TEST_STANDALONE
+int main() {
+    return RunEntitySnapStoreTests();
+}
+#endif
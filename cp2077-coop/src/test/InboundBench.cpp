@@ -0,0 +1,184 @@
+// Inbound Handoff Microbenchmark
+// Compares the legacy receive path (decrypt into a fresh vector, copy through
+// ThreadSafeQueue) with the zero-copy path (open the sealed payload in place
+// inside the ENetPacket and move the packet reference through an SpscRing).
+// Reports received messages/sec per payload size.
+
+#include "../core/SpscRing.hpp"
+#include "../core/ThreadSafeQueue.hpp"
+#include "../net/PacketCrypto.hpp"
+#include "../net/Packets.hpp"
+#include <enet/enet.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sodium.h>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using Key = std::array<uint8_t, crypto_secretbox_KEYBYTES>;
+
+constexpr int kBatch = 256; // messages per simulated tick
+constexpr int kBatches = 400;
+
+struct LegacyPacket
+{
+    CoopNet::PacketHeader hdr;
+    std::vector<uint8_t> data;
+};
+
+// Move-only packet reference, as Connection::RawPacket.
+struct PacketRef
+{
+    CoopNet::PacketHeader hdr{};
+    ENetPacket* packet = nullptr;
+    uint32_t offset = 0;
+    uint16_t size = 0;
+
+    PacketRef() = default;
+    PacketRef(PacketRef&& o) noexcept : hdr(o.hdr), packet(o.packet), offset(o.offset), size(o.size) { o.packet = nullptr; }
+    PacketRef& operator=(PacketRef&& o) noexcept
+    {
+        if (packet)
+            enet_packet_destroy(packet);
+        hdr = o.hdr;
+        packet = o.packet;
+        offset = o.offset;
+        size = o.size;
+        o.packet = nullptr;
+        return *this;
+    }
+    ~PacketRef()
+    {
+        if (packet)
+            enet_packet_destroy(packet);
+    }
+};
+
+ENetPacket* MakeSealed(const Key& key, uint32_t nonce, const std::vector<uint8_t>& plain)
+{
+    const size_t body = CoopNet::PacketCrypto_SealedSize(plain.size());
+    ENetPacket* pkt = enet_packet_create(nullptr, sizeof(CoopNet::PacketHeader) + body, 0);
+    CoopNet::PacketHeader hdr{static_cast<uint16_t>(CoopNet::EMsg::Snapshot), static_cast<uint16_t>(body)};
+    std::memcpy(pkt->data, &hdr, sizeof(hdr));
+    CoopNet::PacketCrypto_SealInto(pkt->data + sizeof(hdr), nonce, plain.data(), plain.size(), key.data());
+    return pkt;
+}
+
+uint64_t Consume(const uint8_t* data, size_t size)
+{
+    return size ? data[0] + data[size - 1] : 0;
+}
+
+double RunLegacy(const Key& key, std::vector<ENetPacket*>& pkts)
+{
+    CoopNet::ThreadSafeQueue<LegacyPacket> queue;
+    uint64_t sink = 0;
+    auto begin = Clock::now();
+    for (ENetPacket* packet : pkts)
+    {
+        LegacyPacket pkt;
+        std::memcpy(&pkt.hdr, packet->data, sizeof(pkt.hdr));
+        const uint8_t* payload = packet->data + sizeof(pkt.hdr);
+        const size_t psize = packet->dataLength - sizeof(pkt.hdr);
+        unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
+        std::memcpy(nbuf, payload, 4);
+        std::vector<uint8_t> plain(psize - CoopNet::kSealOverhead);
+        crypto_secretbox_open_easy(plain.data(), payload + 4, psize - 4, nbuf, key.data());
+        pkt.data = std::move(plain);
+        enet_packet_destroy(packet);
+        queue.Push(static_cast<const LegacyPacket&>(pkt)); // old EnqueuePacket(const RawPacket&)
+        if (queue.Size() >= kBatch)
+        {
+            LegacyPacket out;
+            while (!queue.Empty())
+            {
+                // Old TryPop: item = m_queue.front();
+                queue.TryPop(out);
+                LegacyPacket copy = out;
+                sink += Consume(copy.data.data(), copy.data.size());
+            }
+        }
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - begin).count();
+    if (sink == 42)
+        std::cout << "";
+    return sec > 0.0 ? pkts.size() / sec : 0.0;
+}
+
+double RunZeroCopy(const Key& key, std::vector<ENetPacket*>& pkts)
+{
+    static CoopNet::SpscRing<PacketRef, 1024> ring;
+    uint64_t sink = 0;
+    auto begin = Clock::now();
+    for (ENetPacket* packet : pkts)
+    {
+        PacketRef pkt;
+        pkt.packet = packet;
+        std::memcpy(&pkt.hdr, packet->data, sizeof(pkt.hdr));
+        uint8_t* payload = packet->data + sizeof(pkt.hdr);
+        const size_t psize = packet->dataLength - sizeof(pkt.hdr);
+        CoopNet::PacketCrypto_OpenInPlace(payload, psize, key.data());
+        pkt.offset = static_cast<uint32_t>(sizeof(pkt.hdr) + CoopNet::kSealOverhead);
+        pkt.size = static_cast<uint16_t>(psize - CoopNet::kSealOverhead);
+        ring.TryPush(std::move(pkt));
+        if (ring.SizeApprox() >= kBatch)
+        {
+            PacketRef out;
+            while (ring.TryPop(out))
+                sink += Consume(out.packet->data + out.offset, out.size);
+        }
+    }
+    PacketRef out;
+    while (ring.TryPop(out))
+        sink += Consume(out.packet->data + out.offset, out.size);
+    double sec = std::chrono::duration<double>(Clock::now() - begin).count();
+    if (sink == 42)
+        std::cout << "";
+    return sec > 0.0 ? pkts.size() / sec : 0.0;
+}
+
+std::vector<ENetPacket*> MakeBatch(const Key& key, size_t size)
+{
+    std::vector<uint8_t> plain(size);
+    randombytes_buf(plain.data(), plain.size());
+    std::vector<ENetPacket*> pkts;
+    pkts.reserve(kBatch * kBatches);
+    for (int i = 0; i < kBatch * kBatches; ++i)
+        pkts.push_back(MakeSealed(key, static_cast<uint32_t>(i), plain));
+    return pkts;
+}
+} // namespace
+
+extern "C" int RunInboundBench() {
+    std::cout << "=== CP2077-Coop Inbound Handoff Benchmark ===" << std::endl;
+    if (sodium_init() < 0 || enet_initialize() != 0) {
+        std::cout << "❌ init failed" << std::endl;
+        return 1;
+    }
+    Key key;
+    crypto_secretbox_keygen(key.data());
+
+    const size_t sizes[] = {16, 64, 256, 1024};
+    for (size_t size : sizes) {
+        auto legacyPkts = MakeBatch(key, size);
+        double legacy = RunLegacy(key, legacyPkts);
+        auto zeroPkts = MakeBatch(key, size);
+        double zero = RunZeroCopy(key, zeroPkts);
+        std::cout << "✓ payload " << size << "B: legacy " << static_cast<uint64_t>(legacy) << " msg/s, zero-copy "
+                  << static_cast<uint64_t>(zero) << " msg/s (x" << (legacy > 0.0 ? zero / legacy : 0.0) << ")"
+                  << std::endl;
+    }
+
+    enet_deinitialize();
+    return 0;
+}
+
+#ifdef INBOUND_BENCH_STANDALONE
+int main() {
+    return RunInboundBench();
+}
+#endif
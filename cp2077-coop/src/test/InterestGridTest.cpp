@@ -0,0 +1,183 @@
+// Interest Grid Test
+// Checks the pieces behind incremental NPC interest: the grid reports only
+// real cell crossings, enter/leave radii stop an NPC pacing on the boundary
+// from flapping in and out, and a crowd simulation driven by dirty cells
+// re-evaluates far fewer clients than a full pass every tick while ending up
+// with the same subscriptions after each periodic full pass.
+
+#include "../net/InterestGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+using CoopNet::InterestGrid;
+using RED4ext::Vector3;
+
+constexpr uint32_t kClients = 64;
+constexpr uint32_t kNpcs = 2000;
+constexpr uint32_t kTicks = 256;
+constexpr float kArea = 1500.f;
+constexpr float kNpcStep = 0.05f; // metres per tick, walking pace at 32 ms ticks
+
+void Evaluate(InterestGrid& grid, const Vector3& pos, std::unordered_set<uint32_t>& subscribed, size_t& changes)
+{
+    std::vector<uint32_t> enter, enterOff, keep, keepOff, added, removed;
+    grid.QueryHysteresis(&pos, 1, CoopNet::kNpcInterestEnterRadius, CoopNet::kNpcInterestLeaveRadius, enter,
+                         enterOff, keep, keepOff);
+    CoopNet::Interest_Diff(subscribed, enter.data(), enter.size(), keep.data(), keep.size(), added, removed);
+    changes += added.size() + removed.size();
+}
+} // namespace
+
+class InterestGridTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Interest Grid Test ===" << std::endl;
+        bool passed = TestDirtyCells();
+        passed = TestBoundaryHysteresis() && passed;
+        passed = TestIncrementalCrowd() && passed;
+        if (passed) {
+            std::cout << "✅ Interest grid test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestDirtyCells() {
+        InterestGrid grid;
+        std::vector<InterestGrid::CellId> dirty;
+        grid.Insert(1, {5.f, 5.f, 0.f});
+        grid.Insert(2, {6.f, 5.f, 0.f});
+        grid.TakeDirtyCells(dirty);
+        bool ok = dirty.size() == 1; // both landed in the same cell
+        grid.Move(1, {9.f, 9.f, 0.f}); // same cell
+        grid.TakeDirtyCells(dirty);
+        ok = ok && dirty.empty();
+        grid.Move(1, {40.f, 5.f, 0.f}); // crosses into the next cell
+        grid.TakeDirtyCells(dirty);
+        ok = ok && dirty.size() == 2;
+        grid.Remove(2);
+        grid.Remove(2); // unknown by now: no event
+        grid.TakeDirtyCells(dirty);
+        ok = ok && dirty.size() == 1 && dirty[0] == grid.CellOf({6.f, 5.f, 0.f});
+        if (!ok) {
+            std::cout << "❌ dirty cells do not match cell crossings" << std::endl;
+            return false;
+        }
+        std::cout << "✓ only inserts, removals and cell crossings mark cells dirty" << std::endl;
+        return true;
+    }
+
+    // An NPC paces 3 m either side of the enter radius for 200 ticks.
+    bool TestBoundaryHysteresis() {
+        InterestGrid grid;
+        const Vector3 viewer{0.f, 0.f, 0.f};
+        std::unordered_set<uint32_t> hysteresis, single;
+        size_t hysteresisChanges = 0, singleChanges = 0;
+        std::vector<uint32_t> ids, added, removed;
+        for (int t = 0; t < 200; ++t) {
+            const float x = CoopNet::kNpcInterestEnterRadius + 3.f * std::sin(t * 0.3f);
+            grid.Move(7, {x, 0.f, 0.f});
+            Evaluate(grid, viewer, hysteresis, hysteresisChanges);
+
+            grid.Query(viewer, CoopNet::kNpcInterestEnterRadius, ids);
+            added.clear();
+            removed.clear();
+            CoopNet::Interest_Diff(single, ids.data(), ids.size(), ids.data(), ids.size(), added, removed);
+            singleChanges += added.size() + removed.size();
+        }
+        std::cout << "✓ NPC pacing on the boundary: " << singleChanges << " interest changes with one radius, "
+                  << hysteresisChanges << " with enter/leave radii" << std::endl;
+        if (hysteresisChanges != 1 || singleChanges < 10) {
+            std::cout << "❌ hysteresis did not stop the flapping" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool TestIncrementalCrowd() {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> d(-kArea, kArea);
+        std::uniform_real_distribution<float> dir(0.f, 6.2831853f);
+        InterestGrid grid;
+        std::vector<Vector3> npc(kNpcs), heading(kNpcs), clients(kClients);
+        for (uint32_t i = 0; i < kNpcs; ++i) {
+            npc[i] = {d(rng), d(rng), 0.f};
+            const float a = dir(rng);
+            heading[i] = {std::cos(a) * kNpcStep, std::sin(a) * kNpcStep, 0.f};
+            grid.Insert(i, npc[i]);
+        }
+        for (auto& c : clients)
+            c = npc[rng() % kNpcs];
+
+        std::vector<std::unordered_set<uint32_t>> incremental(kClients), everyTick(kClients);
+        std::vector<InterestGrid::CellId> lastCell(kClients);
+        std::vector<bool> valid(kClients, false);
+        std::vector<InterestGrid::CellId> dirty;
+        const int32_t reach = grid.CellReach(CoopNet::kNpcInterestLeaveRadius);
+        size_t evaluations = 0, incChanges = 0, fullChanges = 0;
+        bool ok = true;
+
+        for (uint32_t t = 1; t <= kTicks; ++t) {
+            for (uint32_t i = 0; i < kNpcs; ++i) {
+                npc[i].X += heading[i].X;
+                npc[i].Y += heading[i].Y;
+                grid.Move(i, npc[i]);
+            }
+            for (uint32_t c = 0; c < kClients; ++c)
+                clients[c].X += 0.1f; // players drift slowly east
+
+            grid.TakeDirtyCells(dirty);
+            const bool fullPass = t % CoopNet::kNpcInterestRefreshTicks == 0;
+            for (uint32_t c = 0; c < kClients; ++c) {
+                const auto cell = grid.CellOf(clients[c]);
+                bool stale = fullPass || !valid[c] || cell != lastCell[c];
+                for (size_t i = 0; !stale && i < dirty.size(); ++i)
+                    stale = std::abs(dirty[i].x - cell.x) <= reach && std::abs(dirty[i].y - cell.y) <= reach;
+                lastCell[c] = cell;
+                valid[c] = true;
+                if (stale) {
+                    ++evaluations;
+                    Evaluate(grid, clients[c], incremental[c], incChanges);
+                }
+                Evaluate(grid, clients[c], everyTick[c], fullChanges);
+            }
+            if (fullPass) {
+                for (uint32_t c = 0; c < kClients; ++c)
+                    ok = ok && incremental[c] == everyTick[c];
+            }
+        }
+
+        const size_t possible = static_cast<size_t>(kClients) * kTicks;
+        std::cout << "✓ " << kClients << " clients, " << kNpcs << " walking NPCs, " << kTicks << " ticks: "
+                  << evaluations << "/" << possible << " client evaluations (" << 100 * evaluations / possible
+                  << "%), " << incChanges << " interest changes vs " << fullChanges << " evaluating every tick"
+                  << std::endl;
+        if (!ok) {
+            std::cout << "❌ incremental subscriptions diverged after a full pass" << std::endl;
+            return false;
+        }
+        if (evaluations * 2 > possible) {
+            std::cout << "❌ cell tracking skipped too few evaluations" << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+extern "C" int RunInterestGridTests() {
+    InterestGridTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef INTEREST_GRID_TEST_STANDALONE
+int main() {
+    return RunInterestGridTests();
+}
+#endif
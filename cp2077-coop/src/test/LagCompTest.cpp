@@ -0,0 +1,231 @@
+// Lag Compensation Test
+// Drives players along scripted zig-zag paths (direction flips every few
+// ticks) and checks that rewinding the history ring lands on the scripted
+// position, where the previous pos - vel * rtt extrapolation misses whenever a
+// turn falls inside the RTT window. Also checks fractional-tick interpolation,
+// clamping outside the window and that the batch APIs agree with Rewind, then
+// times rewinds with 64 players and 60 ticks of history.
+
+#include "../physics/LagComp.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+using CoopNet::LagCompHistory;
+using CoopNet::LagCompSample;
+using RED4ext::Vector3;
+
+constexpr uint32_t kPlayers = 64;
+constexpr uint32_t kBenchTicks = 60;
+constexpr uint32_t kBenchRewinds = 200000;
+constexpr float kTickSec = 1.f / 64.f;
+constexpr float kSpeed = 6.f; // m/s, sprinting
+constexpr uint32_t kLegTicks = 8; // direction flips every 125 ms
+
+// Scripted zig-zag: runs along +Y while alternating +X/-X every kLegTicks.
+// Continuous in time so fractional ticks have an exact answer.
+Vector3 ZigZag(uint32_t player, double tick)
+{
+    const double leg = tick / kLegTicks;
+    const double whole = std::floor(leg);
+    const double frac = leg - whole;
+    // Triangle wave: distance along X oscillates between 0 and one leg.
+    const bool odd = static_cast<uint64_t>(whole) % 2 == 1;
+    const double x = (odd ? 1.0 - frac : frac) * kLegTicks * kTickSec * kSpeed;
+    const double y = tick * kTickSec * kSpeed * 0.5;
+    return Vector3(static_cast<float>(x + player * 5.0), static_cast<float>(y), 0.f);
+}
+
+Vector3 ZigZagVel(uint32_t player, double tick)
+{
+    const Vector3 a = ZigZag(player, tick);
+    const Vector3 b = ZigZag(player, tick + 0.01);
+    return Vector3((b.X - a.X) / (0.01f * kTickSec), (b.Y - a.Y) / (0.01f * kTickSec), 0.f);
+}
+
+float Dist(const Vector3& a, const Vector3& b)
+{
+    const float dx = a.X - b.X, dy = a.Y - b.Y, dz = a.Z - b.Z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// The extrapolation this history replaces.
+Vector3 Extrapolate(const Vector3& pos, const Vector3& vel, float rttSec)
+{
+    return Vector3(pos.X - vel.X * rttSec, pos.Y - vel.Y * rttSec, pos.Z - vel.Z * rttSec);
+}
+} // namespace
+
+class LagCompTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Lag Compensation Test ===" << std::endl;
+        bool passed = TestZigZagRewind();
+        passed = TestInterpolationAndClamp() && passed;
+        passed = TestBatchMatchesSingle() && passed;
+        passed = BenchRewind() && passed;
+        if (passed) {
+            std::cout << "✅ Lag compensation test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestZigZagRewind() {
+        LagCompHistory history;
+        constexpr uint64_t kTicks = 256; // several laps of the 64-tick ring
+        const float rttSec[] = {0.05f, 0.1f, 0.2f};
+        float worstHistory = 0.f;
+        float worstExtrap = 0.f;
+        for (uint64_t tick = 1; tick <= kTicks; ++tick) {
+            history.Record(0, tick, ZigZag(0, static_cast<double>(tick)));
+            if (tick < history.GetCapacity())
+                continue;
+            for (float rtt : rttSec) {
+                const double view = static_cast<double>(tick) - rtt / kTickSec;
+                const Vector3 truth = ZigZag(0, view);
+                Vector3 rewound;
+                if (!history.Rewind(0, view, rewound)) {
+                    std::cout << "❌ no history for a recorded entity" << std::endl;
+                    return false;
+                }
+                worstHistory = std::max(worstHistory, Dist(rewound, truth));
+                const double now = static_cast<double>(tick);
+                worstExtrap = std::max(worstExtrap, Dist(Extrapolate(ZigZag(0, now), ZigZagVel(0, now), rtt), truth));
+            }
+        }
+        std::cout << "✓ zig-zag rewind error: history " << worstHistory << " m, velocity extrapolation "
+                  << worstExtrap << " m" << std::endl;
+        if (worstHistory > 0.01f) {
+            std::cout << "❌ rewound position strays from the scripted path" << std::endl;
+            return false;
+        }
+        if (worstExtrap <= CoopNet::kLagCompHitTolerance) {
+            std::cout << "❌ scenario does not exercise direction changes inside the RTT" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool TestInterpolationAndClamp() {
+        LagCompHistory history(16);
+        for (uint64_t tick = 10; tick <= 40; ++tick)
+            history.Record(7, tick, Vector3(static_cast<float>(tick), 0.f, 0.f));
+        // Drop one sample to check bracketing across a gap.
+        history.Record(7, 41, Vector3(41.f, 0.f, 0.f));
+        history.Record(7, 43, Vector3(43.f, 0.f, 0.f));
+
+        Vector3 p;
+        bool ok = history.Rewind(7, 35.25, p) && std::fabs(p.X - 35.25f) < 1e-4f;
+        ok = ok && history.Rewind(7, 42.5, p) && std::fabs(p.X - 42.5f) < 1e-4f;
+        // Newest is 43 and capacity 16: ticks before 28 have been overwritten.
+        ok = ok && history.Rewind(7, 5.0, p) && std::fabs(p.X - 28.f) < 1e-4f;
+        ok = ok && history.Rewind(7, 99.0, p) && std::fabs(p.X - 43.f) < 1e-4f;
+        ok = ok && !history.Rewind(8, 30.0, p);
+        history.Remove(7);
+        ok = ok && !history.Rewind(7, 30.0, p) && history.GetEntityCount() == 0;
+        history.Record(9, 50, Vector3(1.f, 2.f, 3.f)); // reuses the freed row
+        ok = ok && history.Rewind(9, 30.0, p) && p.X == 1.f && p.Y == 2.f && p.Z == 3.f;
+        if (!ok) {
+            std::cout << "❌ interpolation, clamping or row reuse is wrong" << std::endl;
+            return false;
+        }
+        std::cout << "✓ fractional ticks interpolate, gaps bracket, out-of-window ticks clamp" << std::endl;
+        return true;
+    }
+
+    bool TestBatchMatchesSingle() {
+        LagCompHistory history;
+        Fill(history, kBenchTicks);
+        const double view = kBenchTicks - 9.4;
+
+        std::vector<uint32_t> ids(kPlayers + 1);
+        for (uint32_t i = 0; i < kPlayers; ++i)
+            ids[i] = i;
+        ids[kPlayers] = 999; // unknown
+        std::vector<Vector3> out(ids.size());
+        std::unique_ptr<bool[]> found(new bool[ids.size()]);
+        const size_t hits = history.RewindBatch(ids.data(), ids.size(), view, out.data(), found.get());
+        bool ok = hits == kPlayers && !found[kPlayers];
+        for (uint32_t i = 0; ok && i < kPlayers; ++i) {
+            Vector3 single;
+            ok = found[i] && history.Rewind(i, view, single) && Dist(single, out[i]) == 0.f;
+        }
+
+        // Shot near player 10: 5 m spacing means only it and its neighbours qualify.
+        std::vector<LagCompSample> near;
+        history.RewindNear(ZigZag(10, view), 6.f, view, near);
+        ok = ok && near.size() == 3;
+        for (const auto& s : near)
+            ok = ok && (s.entityId >= 9 && s.entityId <= 11) && Dist(s.pos, out[s.entityId]) == 0.f;
+        if (!ok) {
+            std::cout << "❌ batch rewind disagrees with single rewind" << std::endl;
+            return false;
+        }
+        std::cout << "✓ RewindBatch and RewindNear match Rewind" << std::endl;
+        return true;
+    }
+
+    bool BenchRewind() {
+        LagCompHistory history;
+        Fill(history, kBenchTicks);
+        std::vector<uint32_t> ids(kPlayers);
+        for (uint32_t i = 0; i < kPlayers; ++i)
+            ids[i] = i;
+        std::vector<Vector3> out(kPlayers);
+        std::unique_ptr<bool[]> found(new bool[kPlayers]);
+        std::vector<LagCompSample> near;
+        float sink = 0.f;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kBenchRewinds; ++i) {
+            Vector3 p;
+            history.Rewind(i % kPlayers, kBenchTicks - 1.0 - (i % 50) * 0.9, p);
+            sink += p.X;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        constexpr uint32_t kBatches = kBenchRewinds / kPlayers;
+        for (uint32_t i = 0; i < kBatches; ++i) {
+            history.RewindBatch(ids.data(), kPlayers, kBenchTicks - 1.0 - (i % 50) * 0.9, out.data(), found.get());
+            sink += out[i % kPlayers].X;
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kBatches; ++i) {
+            near.clear();
+            const double view = kBenchTicks - 1.0 - (i % 50) * 0.9;
+            history.RewindNear(ZigZag(i % kPlayers, view), 10.f, view, near);
+            sink += static_cast<float>(near.size());
+        }
+        auto t3 = std::chrono::steady_clock::now();
+
+        auto ns = [](auto a, auto b, double n) { return std::chrono::duration<double, std::nano>(b - a).count() / n; };
+        std::cout << "✓ " << kPlayers << " players x " << kBenchTicks << " ticks: Rewind " << ns(t0, t1, kBenchRewinds)
+                  << " ns/entity, RewindBatch " << ns(t1, t2, double(kBatches) * kPlayers)
+                  << " ns/entity, RewindNear " << ns(t2, t3, kBatches) << " ns/shot (sink " << (sink != 0.f)
+                  << ")" << std::endl;
+        return true;
+    }
+
+    static void Fill(LagCompHistory& history, uint32_t ticks) {
+        for (uint64_t tick = 1; tick <= ticks; ++tick) {
+            for (uint32_t p = 0; p < kPlayers; ++p)
+                history.Record(p, tick, ZigZag(p, static_cast<double>(tick)));
+        }
+    }
+};
+
+extern "C" int RunLagCompTests() {
+    LagCompTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef LAG_COMP_TEST_STANDALONE
+int main() {
+    return RunLagCompTests();
+}
+#endif
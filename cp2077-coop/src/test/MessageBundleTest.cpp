@@ -0,0 +1,205 @@
+// Message Bundle Test
+// Builds one tick of typical small server messages for a peer, sends them
+// unbundled and coalesced through MessageBundler, and checks that the bundle
+// decrypts and demultiplexes back into the same messages in the same order.
+// Reports packets, wire bytes and secretbox operations for both paths.
+
+#include "../net/MessageBundle.hpp"
+#include "../net/NetChannels.hpp"
+#include "../net/PacketCrypto.hpp"
+#include "../net/Packets.hpp"
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <sodium.h>
+#include <vector>
+
+namespace
+{
+using CoopNet::EMsg;
+
+constexpr size_t kBudget = 1392 - 48 - sizeof(CoopNet::PacketHeader) - CoopNet::kSealOverhead;
+
+struct Msg
+{
+    EMsg type;
+    std::vector<uint8_t> body;
+};
+
+template<typename T>
+Msg MakeMsg(EMsg type, const T& pkt)
+{
+    Msg m{type, std::vector<uint8_t>(sizeof(T))};
+    std::memcpy(m.body.data(), &pkt, sizeof(T));
+    return m;
+}
+
+std::vector<Msg> BuildTick()
+{
+    std::vector<Msg> msgs;
+    msgs.push_back(MakeMsg(EMsg::Ping, CoopNet::PingPacket{1234u}));
+    for (uint32_t id = 0; id < 24; ++id)
+        msgs.push_back(MakeMsg(id % 3 ? EMsg::InterestAdd : EMsg::InterestRemove, CoopNet::InterestPacket{id}));
+    for (uint32_t p = 0; p < 8; ++p)
+        msgs.push_back(MakeMsg(EMsg::ScoreUpdate, CoopNet::ScoreUpdatePacket{p, uint16_t(p * 2), uint16_t(p)}));
+    msgs.push_back(MakeMsg(EMsg::SeatAssign, CoopNet::SeatAssignPacket{3u, 77u, 1u}));
+    return msgs;
+}
+
+std::vector<uint8_t> Seal(const std::array<uint8_t, crypto_secretbox_KEYBYTES>& key, uint32_t nonce,
+                          const std::vector<uint8_t>& plain)
+{
+    std::vector<uint8_t> out(sizeof(CoopNet::PacketHeader) + CoopNet::PacketCrypto_SealedSize(plain.size()));
+    CoopNet::PacketCrypto_SealInto(out.data() + sizeof(CoopNet::PacketHeader), nonce, plain.data(), plain.size(),
+                                   key.data());
+    return out;
+}
+} // namespace
+
+class MessageBundleTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Message Bundle Test ===" << std::endl;
+        if (sodium_init() < 0) {
+            std::cout << "❌ sodium_init failed" << std::endl;
+            return false;
+        }
+        bool passed = TestRoundTrip();
+        passed = TestMalformedRejected() && passed;
+        passed = TestFlagsNotMixed() && passed;
+        if (passed) {
+            std::cout << "✅ Message bundle test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestRoundTrip() {
+        std::array<uint8_t, crypto_secretbox_KEYBYTES> key;
+        crypto_secretbox_keygen(key.data());
+        const std::vector<Msg> msgs = BuildTick();
+
+        // Unbundled: one sealed packet per message.
+        size_t singleBytes = 0;
+        uint32_t nonce = 0;
+        for (const Msg& m : msgs)
+            singleBytes += Seal(key, nonce++, m.body).size();
+
+        // Bundled: lanes flushed whenever the MTU budget is reached.
+        CoopNet::MessageBundler bundler;
+        std::vector<std::vector<uint8_t>> wire;
+        std::vector<std::vector<uint8_t>> plains;
+        auto flush = [&](uint8_t ch) {
+            auto& lane = bundler.GetLane(ch);
+            if (lane.count == 0)
+                return;
+            plains.push_back(lane.bytes);
+            wire.push_back(Seal(key, nonce++, lane.bytes));
+            CoopNet::MessageBundler::Reset(lane);
+        };
+        for (const Msg& m : msgs) {
+            const CoopNet::NetRoute route = CoopNet::NetChannel_Route(m.type);
+            const uint16_t size = static_cast<uint16_t>(m.body.size());
+            if (!bundler.Fits(route, size, kBudget))
+                flush(route.channel);
+            bundler.Append(route, m.type, m.body.data(), size);
+        }
+        for (uint8_t ch = 0; ch < CoopNet::kNetChannelCount; ++ch)
+            flush(ch);
+
+        size_t bundledBytes = 0;
+        for (const auto& w : wire)
+            bundledBytes += w.size();
+
+        // Decrypt and demultiplex; order must match within the control lane.
+        std::vector<Msg> seen;
+        for (size_t i = 0; i < wire.size(); ++i) {
+            const uint8_t* sealed = wire[i].data() + sizeof(CoopNet::PacketHeader);
+            const size_t sealedSize = wire[i].size() - sizeof(CoopNet::PacketHeader);
+            uint32_t n;
+            std::memcpy(&n, sealed, 4);
+            unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
+            std::memcpy(nbuf, &n, 4);
+            std::vector<uint8_t> plain(sealedSize - CoopNet::kSealOverhead);
+            if (crypto_secretbox_open_easy(plain.data(), sealed + 4, sealedSize - 4, nbuf, key.data()) != 0) {
+                std::cout << "❌ bundle failed to open" << std::endl;
+                return false;
+            }
+            bool ok = CoopNet::MessageBundle_ForEach(plain.data(), plain.size(),
+                [&](const CoopNet::PacketHeader& hdr, const uint8_t* data, uint16_t len) {
+                    seen.push_back({static_cast<EMsg>(hdr.type), std::vector<uint8_t>(data, data + len)});
+                });
+            if (!ok) {
+                std::cout << "❌ bundle demux failed" << std::endl;
+                return false;
+            }
+        }
+        if (seen.size() != msgs.size()) {
+            std::cout << "❌ message count mismatch " << seen.size() << "/" << msgs.size() << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < msgs.size(); ++i) {
+            if (seen[i].type != msgs[i].type || seen[i].body != msgs[i].body) {
+                std::cout << "❌ message " << i << " differs after demux" << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << "✓ " << msgs.size() << " messages: unbundled " << msgs.size() << " packets/" << singleBytes
+                  << "B/" << msgs.size() << " seals, bundled " << wire.size() << " packets/" << bundledBytes << "B/"
+                  << wire.size() << " seals" << std::endl;
+        if (wire.size() >= msgs.size() || bundledBytes >= singleBytes) {
+            std::cout << "❌ coalescing did not reduce packets or bytes" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool TestMalformedRejected() {
+        std::vector<uint8_t> buf(sizeof(CoopNet::PacketHeader) + 2);
+        CoopNet::PacketHeader hdr{static_cast<uint16_t>(EMsg::Ping), 40}; // claims more than present
+        std::memcpy(buf.data(), &hdr, sizeof(hdr));
+        int calls = 0;
+        bool ok = CoopNet::MessageBundle_ForEach(buf.data(), buf.size(),
+            [&](const CoopNet::PacketHeader&, const uint8_t*, uint16_t) { ++calls; });
+        if (ok || calls != 0) {
+            std::cout << "❌ truncated frame accepted" << std::endl;
+            return false;
+        }
+        CoopNet::PacketHeader nested{static_cast<uint16_t>(EMsg::Bundle), 0};
+        std::memcpy(buf.data(), &nested, sizeof(nested));
+        ok = CoopNet::MessageBundle_ForEach(buf.data(), sizeof(nested),
+            [&](const CoopNet::PacketHeader&, const uint8_t*, uint16_t) { ++calls; });
+        if (ok || calls != 0) {
+            std::cout << "❌ nested bundle accepted" << std::endl;
+            return false;
+        }
+        std::cout << "✓ malformed bundles rejected" << std::endl;
+        return true;
+    }
+
+    bool TestFlagsNotMixed() {
+        CoopNet::MessageBundler bundler;
+        CoopNet::NetRoute reliable{0, 1u};
+        CoopNet::NetRoute other{0, 0u};
+        uint32_t v = 0;
+        bundler.Append(reliable, EMsg::Ping, &v, sizeof(v));
+        if (bundler.Fits(other, sizeof(v), kBudget)) {
+            std::cout << "❌ lane accepted a message with different delivery flags" << std::endl;
+            return false;
+        }
+        std::cout << "✓ lanes keep delivery flags uniform" << std::endl;
+        return true;
+    }
+};
+
+extern "C" int RunMessageBundleTests() {
+    MessageBundleTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef MESSAGE_BUNDLE_TEST_STANDALONE
+int main() {
+    return RunMessageBundleTests();
+}
+#endif
@@ -0,0 +1,188 @@
+// Metrics Registry Test
+// Counts from several threads at once and checks the totals are exact, then
+// checks histogram buckets, sum and count, labelled series, sampled gauges
+// and both exposition formats. Finally compares the sharded counter with a
+// single shared atomic under the same contention.
+
+#include "../core/Metrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int kThreads = 8;
+constexpr uint64_t kAddsPerThread = 1000000;
+
+bool Contains(const std::string& text, const std::string& needle)
+{
+    return text.find(needle) != std::string::npos;
+}
+
+template <typename Fn> double SecondsToRun(Fn&& addOnce)
+{
+    std::vector<std::thread> threads;
+    const auto start = Clock::now();
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&addOnce] {
+            for (uint64_t i = 0; i < kAddsPerThread; ++i)
+                addOnce();
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+} // namespace
+
+class MetricsRegistryTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Metrics Registry Test ===" << std::endl;
+        bool passed = TestConcurrentCounter();
+        passed = TestHistogram() && passed;
+        passed = TestLabelsAndGauges() && passed;
+        passed = TestExposition() && passed;
+        passed = TestContention() && passed;
+        if (passed)
+            std::cout << "✅ Metrics registry test PASSED" << std::endl;
+        return passed;
+    }
+
+private:
+    CoopNet::MetricsRegistry m_registry;
+
+    bool TestConcurrentCounter() {
+        auto& counter = m_registry.Counter("test_events", "Events counted by the test");
+        SecondsToRun([&counter] { counter.Add(); });
+        if (counter.Value() != kThreads * kAddsPerThread) {
+            std::cout << "❌ counter lost updates: " << counter.Value() << std::endl;
+            return false;
+        }
+        if (&m_registry.Counter("test_events", "Events counted by the test") != &counter) {
+            std::cout << "❌ registering a counter again did not return the same one" << std::endl;
+            return false;
+        }
+        std::cout << "✓ " << kThreads << " threads counted " << counter.Value() << " events exactly" << std::endl;
+        return true;
+    }
+
+    bool TestHistogram() {
+        auto& hist = m_registry.Histogram("test_latency_seconds", "Latency", {0.1, 0.01, 1.0});
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&hist] {
+                for (int i = 0; i < 1000; ++i) {
+                    hist.Observe(0.005); // first bucket
+                    hist.Observe(0.1);   // bounds are inclusive
+                    hist.Observe(5.0);   // +Inf only
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        const auto snap = hist.Read();
+        const uint64_t n = kThreads * 1000;
+        const bool bucketsOk = snap.cumulative.size() == 4 && snap.cumulative[0] == n && snap.cumulative[1] == 2 * n &&
+                               snap.cumulative[2] == 2 * n && snap.cumulative[3] == 3 * n && snap.count == 3 * n;
+        const double expectSum = static_cast<double>(n) * (0.005 + 0.1 + 5.0);
+        if (!bucketsOk || std::fabs(snap.sum - expectSum) > 1e-6 * expectSum) {
+            std::cout << "❌ histogram buckets or sum are wrong (count " << snap.count << ", sum " << snap.sum << ")"
+                      << std::endl;
+            return false;
+        }
+        std::cout << "✓ histogram buckets, sum and count add up across threads" << std::endl;
+        return true;
+    }
+
+    bool TestLabelsAndGauges() {
+        auto& voice = m_registry.Counter("test_payload_bytes", "Payload bytes", "kind=\"voice\"");
+        auto& snap = m_registry.Counter("test_payload_bytes", "Payload bytes", "kind=\"snapshot\"");
+        voice.Add(10);
+        snap.Add(32);
+        m_registry.Gauge("test_temperature", "A set gauge").Set(21.5);
+        int players = 3;
+        m_registry.GaugeFn("test_players", "A sampled gauge", [&players] { return static_cast<double>(players); });
+        players = 4;
+
+        const std::string text = m_registry.Render();
+        if (&voice == &snap || !Contains(text, "test_payload_bytes_total{kind=\"voice\"} 10\n") ||
+            !Contains(text, "test_payload_bytes_total{kind=\"snapshot\"} 32\n")) {
+            std::cout << "❌ labelled series are missing or merged" << std::endl;
+            return false;
+        }
+        if (!Contains(text, "test_temperature 21.5\n") || !Contains(text, "test_players 4\n")) {
+            std::cout << "❌ gauge values are wrong" << std::endl;
+            return false;
+        }
+        std::cout << "✓ labelled series and gauges render their values" << std::endl;
+        return true;
+    }
+
+    bool TestExposition() {
+        const std::string text = m_registry.Render(false);
+        const std::string om = m_registry.Render(true);
+        const char* classic[] = {
+            "# HELP test_events_total Events counted by the test\n",
+            "# TYPE test_events_total counter\n",
+            "# TYPE test_latency_seconds histogram\n",
+            "test_latency_seconds_bucket{le=\"0.01\"} ",
+            "test_latency_seconds_bucket{le=\"+Inf\"} 24000\n",
+            "test_latency_seconds_count 24000\n",
+            "test_latency_seconds_sum ",
+            "# TYPE test_players gauge\n",
+        };
+        for (const char* line : classic) {
+            if (!Contains(text, line)) {
+                std::cout << "❌ text format is missing: " << line << std::endl;
+                return false;
+            }
+        }
+        if (Contains(text, "# EOF")) {
+            std::cout << "❌ text format must not end with # EOF" << std::endl;
+            return false;
+        }
+        // OpenMetrics names the counter family without the suffix and ends
+        // the exposition with # EOF.
+        if (!Contains(om, "# TYPE test_events counter\n") || !Contains(om, "test_events_total 8000000\n") ||
+            om.size() < 6 || om.compare(om.size() - 6, 6, "# EOF\n") != 0) {
+            std::cout << "❌ OpenMetrics format is malformed" << std::endl;
+            return false;
+        }
+        std::cout << "✓ text and OpenMetrics expositions are well formed" << std::endl;
+        return true;
+    }
+
+    bool TestContention() {
+        auto& sharded = m_registry.Counter("test_contention", "Contention test");
+        std::atomic<uint64_t> single{0};
+        const double shardedSec = SecondsToRun([&sharded] { sharded.Add(); });
+        const double singleSec = SecondsToRun([&single] { single.fetch_add(1, std::memory_order_relaxed); });
+        const double total = static_cast<double>(kThreads * kAddsPerThread);
+        std::printf("  %d threads: sharded counter %.1f ns/add, single atomic %.1f ns/add\n", kThreads,
+                    shardedSec * 1e9 / total, singleSec * 1e9 / total);
+        // Informational: on one core the two are the same, so only the
+        // totals are checked.
+        return sharded.Value() == kThreads * kAddsPerThread && single.load() == kThreads * kAddsPerThread;
+    }
+};
+
+extern "C" int RunMetricsRegistryTest() {
+    MetricsRegistryTestSuite suite;
+    return suite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef METRICS_REGISTRY_TEST_STANDALONE
+int main() {
+    return RunMetricsRegistryTest();
+}
+#endif
@@ -0,0 +1,160 @@
+// ENet Pool Allocator Test
+// Registers the slab allocator with ENet, creates packets on producer threads
+// and destroys them on a consumer thread (the I/O -> tick pattern), then
+// checks that every size class returns to zero blocks in use and that
+// payloads were never clobbered. Also times packet churn against malloc.
+
+#include "../core/SpscRing.hpp"
+#include "../net/NetAllocator.hpp"
+#include <enet/enet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int kProducers = 3;
+constexpr int kPacketsPerProducer = 200000;
+const size_t kSizes[] = {12, 40, 100, 220, 600, 1400, 3000, 9000};
+
+bool CrossThreadChurn()
+{
+    std::vector<CoopNet::SpscRing<ENetPacket*, 1024>*> rings;
+    for (int i = 0; i < kProducers; ++i)
+        rings.push_back(new CoopNet::SpscRing<ENetPacket*, 1024>());
+    std::atomic<int> done{0};
+    std::atomic<uint64_t> corrupt{0};
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back(
+            [&, p]
+            {
+                for (int i = 0; i < kPacketsPerProducer; ++i)
+                {
+                    const size_t size = kSizes[(i + p) % (sizeof(kSizes) / sizeof(kSizes[0]))];
+                    ENetPacket* pkt = enet_packet_create(nullptr, size, 0);
+                    std::memset(pkt->data, static_cast<int>(size & 0xFF), size);
+                    while (!rings[p]->TryPush(pkt))
+                        std::this_thread::yield();
+                }
+                done.fetch_add(1);
+            });
+    }
+
+    std::thread consumer(
+        [&]
+        {
+            for (;;)
+            {
+                bool any = false;
+                for (auto* ring : rings)
+                {
+                    ENetPacket* pkt;
+                    while (ring->TryPop(pkt))
+                    {
+                        any = true;
+                        const uint8_t expect = static_cast<uint8_t>(pkt->dataLength & 0xFF);
+                        if (pkt->data[0] != expect || pkt->data[pkt->dataLength - 1] != expect)
+                            corrupt.fetch_add(1);
+                        enet_packet_destroy(pkt);
+                    }
+                }
+                if (!any && done.load() == kProducers)
+                {
+                    bool empty = true;
+                    for (auto* ring : rings)
+                        empty = empty && ring->EmptyApprox();
+                    if (empty)
+                        break;
+                }
+            }
+        });
+
+    for (auto& t : producers)
+        t.join();
+    consumer.join();
+    for (auto* ring : rings)
+        delete ring;
+    if (corrupt.load() != 0)
+    {
+        std::cout << "❌ " << corrupt.load() << " packets corrupted" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double ChurnMsPerMillion(bool pooled)
+{
+    std::vector<void*> live(64, nullptr);
+    auto begin = Clock::now();
+    for (int i = 0; i < 1000000; ++i)
+    {
+        const size_t slot = i & 63;
+        const size_t size = kSizes[i % 6];
+        if (pooled)
+        {
+            CoopNet::NetAlloc_Free(live[slot]);
+            live[slot] = CoopNet::NetAlloc_Malloc(size);
+        }
+        else
+        {
+            std::free(live[slot]);
+            live[slot] = std::malloc(size);
+        }
+        static_cast<uint8_t*>(live[slot])[0] = 1;
+    }
+    for (void* p : live)
+        pooled ? CoopNet::NetAlloc_Free(p) : std::free(p);
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+} // namespace
+
+class NetAllocatorTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop ENet Pool Allocator Test ===" << std::endl;
+        if (enet_initialize_with_callbacks(ENET_VERSION, &CoopNet::NetAlloc_EnetCallbacks()) != 0) {
+            std::cout << "❌ enet_initialize_with_callbacks failed" << std::endl;
+            return false;
+        }
+
+        bool passed = CrossThreadChurn();
+        for (const auto& s : CoopNet::NetAlloc_GetStats()) {
+            std::cout << "✓ class " << (s.blockSize ? std::to_string(s.blockSize) : std::string("large"))
+                      << ": allocs " << s.allocs << " in use " << s.inUse << " peak " << s.peakInUse
+                      << " slabs " << s.slabBytes / 1024 << " KiB" << std::endl;
+            if (s.inUse != 0 || s.allocs != s.frees) {
+                std::cout << "❌ blocks leaked in class " << s.blockSize << std::endl;
+                passed = false;
+            }
+        }
+
+        double pool = ChurnMsPerMillion(true);
+        double sys = ChurnMsPerMillion(false);
+        std::cout << "✓ 1M alloc/free: pool " << pool << " ms, malloc " << sys << " ms" << std::endl;
+
+        enet_deinitialize();
+        if (passed) {
+            std::cout << "✅ ENet pool allocator test PASSED" << std::endl;
+        }
+        return passed;
+    }
+};
+
+extern "C" int RunNetAllocatorTests() {
+    NetAllocatorTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef NET_ALLOCATOR_TEST_STANDALONE
+int main() {
+    return RunNetAllocatorTests();
+}
+#endif
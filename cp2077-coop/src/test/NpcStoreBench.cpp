@@ -0,0 +1,214 @@
+// NPC Store Benchmark
+// Checks that the structure-of-arrays store reproduces the original single
+// NPC walk, that dirty bits only flag what changed and survive swap-removal,
+// and that a tick split across TaskGraph workers ends in exactly the serial
+// state. Then ticks 5,000 NPCs with the old per-NPC NpcSnap walk (cos/sin and
+// a whole-snapshot memcmp every tick), the SoA store serially, and the SoA
+// store on a TaskGraph, reporting ns/NPC for each.
+
+#include "../core/TaskGraph.hpp"
+#include "../server/NpcStore.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using CoopNet::NpcSnap;
+using CoopNet::NpcStore;
+
+constexpr uint32_t kNpcs = 5000;
+constexpr uint32_t kTicks = 400;
+constexpr float kDtSec = 1.f / 32.f;
+
+NpcSnap MakeNpc(uint32_t id)
+{
+    NpcSnap s{};
+    s.npcId = id;
+    s.pos = RED4ext::Vector3{static_cast<float>(id % 100) * 4.f, static_cast<float>(id / 100) * 4.f, 0.f};
+    s.rot = RED4ext::Quaternion{0.f, 0.f, 0.f, 1.f};
+    s.state = CoopNet::NpcState::Wander;
+    s.health = 100;
+    s.phaseId = id % 4;
+    return s;
+}
+
+// The walk NpcController ran on its single global NpcSnap before the store.
+struct LegacyNpc
+{
+    NpcSnap snap;
+    NpcSnap prev;
+    uint32_t seed;
+    float walkDir = 0.f;
+    float dirTimer = 0.f;
+};
+
+bool LegacyTick(LegacyNpc& n, float dt)
+{
+    n.dirTimer += dt;
+    if (n.dirTimer >= 3.f)
+    {
+        n.seed = n.seed * 1664525u + 1013904223u;
+        n.walkDir = static_cast<float>(n.seed & 0xFFFF) / 65535.f * 6.283185f;
+        n.dirTimer = 0.f;
+    }
+    n.snap.pos.X += std::cos(n.walkDir) * 0.5f * dt;
+    n.snap.pos.Y += std::sin(n.walkDir) * 0.5f * dt;
+    const bool changed = std::memcmp(&n.prev, &n.snap, sizeof(NpcSnap)) != 0;
+    if (changed)
+        n.prev = n.snap;
+    return changed;
+}
+} // namespace
+
+class NpcStoreBenchSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop NPC Store Benchmark ===" << std::endl;
+        bool passed = TestMatchesLegacyWalk();
+        passed = TestDirtyBits() && passed;
+        passed = TestParallelMatchesSerial() && passed;
+        passed = BenchTick() && passed;
+        if (passed) {
+            std::cout << "✅ NPC store benchmark PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestMatchesLegacyWalk() {
+        NpcStore store;
+        store.Spawn(MakeNpc(1));
+        LegacyNpc legacy{MakeNpc(1), MakeNpc(1), CoopNet::kNpcWalkSeed};
+        float worst = 0.f;
+        for (uint32_t t = 0; t < 2000; ++t) { // ~60 s, 20 heading changes
+            store.Integrate(0, store.Size(), kDtSec);
+            LegacyTick(legacy, kDtSec);
+            const RED4ext::Vector3 p = store.GetPos(0);
+            worst = (std::max)(worst, std::hypot(p.X - legacy.snap.pos.X, p.Y - legacy.snap.pos.Y));
+        }
+        std::cout << "✓ NPC 1 follows the original walk, worst drift " << worst << " m over 2000 ticks" << std::endl;
+        if (worst > 1e-3f) {
+            std::cout << "❌ SoA walk diverged from the original routine" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool TestDirtyBits() {
+        NpcStore store;
+        for (uint32_t id = 1; id <= 4; ++id)
+            store.Spawn(MakeNpc(id));
+        store.ClearDirty();
+        store.SetState(2, CoopNet::NpcState::Combat);
+        store.SetHealth(3, 0); // dead: stops walking
+        store.Integrate(0, store.Size(), kDtSec);
+        bool ok = store.GetDirty(0) == CoopNet::NpcDirty_Pos;
+        ok = ok && store.GetDirty(2) == (CoopNet::NpcDirty_Pos | CoopNet::NpcDirty_State);
+        ok = ok && store.GetDirty(3) == CoopNet::NpcDirty_Health;
+        // Despawning id 1 moves id 4 into slot 0 along with its dirty mask.
+        ok = ok && store.Despawn(1) && store.GetId(0) == 4 && store.IndexOf(4) == 0 &&
+             store.GetDirty(0) == CoopNet::NpcDirty_Health;
+        std::vector<uint32_t> removed;
+        ok = ok && store.DespawnPhase(2, &removed) == 1 && removed[0] == 2 && store.IndexOf(2) < 0;
+        ok = ok && store.Size() == 2 && store.GetSnap(static_cast<size_t>(store.IndexOf(3))).npcId == 3;
+        if (!ok) {
+            std::cout << "❌ dirty bits or swap-removal are wrong" << std::endl;
+            return false;
+        }
+        std::cout << "✓ dirty bits flag only changed fields and follow swap-removal" << std::endl;
+        return true;
+    }
+
+    bool TestParallelMatchesSerial() {
+        NpcStore serial, parallel;
+        Fill(serial);
+        Fill(parallel);
+        CoopNet::TaskGraph graph;
+        graph.Start(3);
+        for (uint32_t t = 0; t < 200; ++t) {
+            serial.Integrate(0, serial.Size(), kDtSec);
+            graph.ParallelFor(parallel.Size(), 512,
+                              [&](size_t b, size_t e) { parallel.Integrate(b, e, kDtSec); });
+        }
+        graph.Stop();
+        bool ok = true;
+        for (size_t i = 0; ok && i < serial.Size(); ++i) {
+            const NpcSnap a = serial.GetSnap(i);
+            const NpcSnap b = parallel.GetSnap(i);
+            ok = std::memcmp(&a, &b, sizeof(NpcSnap)) == 0 && serial.GetDirty(i) == parallel.GetDirty(i);
+        }
+        if (!ok) {
+            std::cout << "❌ parallel tick differs from serial tick" << std::endl;
+            return false;
+        }
+        std::cout << "✓ TaskGraph tick matches the serial tick bit for bit" << std::endl;
+        return true;
+    }
+
+    bool BenchTick() {
+        std::vector<LegacyNpc> legacy(kNpcs);
+        for (uint32_t i = 0; i < kNpcs; ++i)
+            legacy[i] = {MakeNpc(i + 1), MakeNpc(i + 1), CoopNet::kNpcWalkSeed ^ (i * 2654435761u)};
+        NpcStore serial, parallel;
+        Fill(serial);
+        Fill(parallel);
+        const size_t workers = (std::max)(1u, std::thread::hardware_concurrency()) - 1;
+        CoopNet::TaskGraph graph;
+        graph.Start(workers);
+        size_t sink = 0;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < kTicks; ++t)
+            for (auto& n : legacy)
+                sink += LegacyTick(n, kDtSec);
+        auto t1 = std::chrono::steady_clock::now();
+        std::vector<uint32_t> dirty;
+        for (uint32_t t = 0; t < kTicks; ++t) {
+            serial.Integrate(0, serial.Size(), kDtSec);
+            dirty.clear();
+            serial.CollectDirty(CoopNet::NpcDirty_Pos, dirty);
+            serial.ClearDirty();
+            sink += dirty.size();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < kTicks; ++t) {
+            graph.ParallelFor(parallel.Size(), 512,
+                              [&](size_t b, size_t e) { parallel.Integrate(b, e, kDtSec); });
+            dirty.clear();
+            parallel.CollectDirty(CoopNet::NpcDirty_Pos, dirty);
+            parallel.ClearDirty();
+            sink += dirty.size();
+        }
+        auto t3 = std::chrono::steady_clock::now();
+        graph.Stop();
+
+        auto ns = [](auto a, auto b) {
+            return std::chrono::duration<double, std::nano>(b - a).count() / (double(kTicks) * kNpcs);
+        };
+        std::cout << "✓ " << kNpcs << " NPCs x " << kTicks << " ticks: legacy AoS " << ns(t0, t1)
+                  << " ns/NPC, SoA serial " << ns(t1, t2) << " ns/NPC, SoA on " << workers << " workers "
+                  << ns(t2, t3) << " ns/NPC (sink " << (sink != 0) << ")" << std::endl;
+        return true;
+    }
+
+    static void Fill(NpcStore& store) {
+        for (uint32_t i = 0; i < kNpcs; ++i)
+            store.Spawn(MakeNpc(i + 1));
+    }
+};
+
+extern "C" int RunNpcStoreBench() {
+    NpcStoreBenchSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef NPC_STORE_BENCH_STANDALONE
+int main() {
+    return RunNpcStoreBench();
+}
+#endif
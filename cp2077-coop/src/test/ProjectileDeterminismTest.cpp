@@ -0,0 +1,201 @@
+// Projectile Determinism Test
+// A grenade is replicated once (ProjectileSpawnPacket) and then simulated
+// independently by the server at its fixed tick and by a client at a jittery
+// frame rate. The test checks that both hold bit-identical state at every
+// step, that a bounce correction delivered late lands on the same state as
+// the server's, that the trajectory matches a recorded checksum (so another
+// compiler or CPU cannot drift), and compares wire bytes per grenade against
+// the old 20 Hz GrenadeSnap stream.
+
+#include "../net/Packets.hpp"
+#include "../physics/Projectile.hpp"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+using CoopNet::ProjectileEventPacket;
+using CoopNet::ProjectileSpawnPacket;
+using CoopNet::ProjectileState;
+
+constexpr uint32_t kBounceStep = 70;
+constexpr uint32_t kCorrectionDelaySteps = 9; // client is this far ahead when the bounce arrives
+// FNV-1a of every state from launch to fuse for MakeSpawn()'s grenade.
+constexpr uint64_t kGoldenTrajectoryHash = 0xd7e0c4fcafea94f4ull;
+
+ProjectileSpawnPacket MakeSpawn()
+{
+    ProjectileSpawnPacket pkt{};
+    pkt.entityId = 77;
+    pkt.spawnTick = 1000;
+    pkt.seed = 0x9E3779B9u;
+    pkt.origin = RED4ext::Vector3(-1532.37f, 842.91f, 17.25f);
+    pkt.velocity = RED4ext::Vector3(8.3f, -5.1f, 6.7f);
+    return pkt;
+}
+
+// What the server would send when its physics saw the grenade hit a wall.
+ProjectileEventPacket MakeBounce(const ProjectileState& s)
+{
+    ProjectileEventPacket pkt{};
+    pkt.entityId = 77;
+    pkt.step = s.step;
+    pkt.kind = static_cast<uint8_t>(CoopNet::ProjectileEventKind::Bounce);
+    pkt.pos = CoopNet::Projectile_Position(s);
+    const RED4ext::Vector3 v = CoopNet::Projectile_Velocity(s);
+    pkt.vel = RED4ext::Vector3(-v.X * 0.6f, v.Y * 0.6f, v.Z);
+    return pkt;
+}
+
+// Both sides apply a correction the same way GrenadeController does.
+void ApplyBounce(ProjectileState& s, const ProjectileEventPacket& pkt)
+{
+    const uint32_t current = s.step;
+    s = CoopNet::Projectile_Make(pkt.pos, pkt.vel, pkt.step);
+    CoopNet::Projectile_AdvanceTo(s, current);
+}
+
+static_assert(sizeof(ProjectileState) == 40, "ProjectileState must have no padding to hash it bytewise");
+
+uint64_t Fnv(uint64_t h, const ProjectileState& s)
+{
+    const auto* p = reinterpret_cast<const uint8_t*>(&s);
+    for (size_t i = 0; i < sizeof(s); ++i)
+        h = (h ^ p[i]) * 1099511628211ull;
+    return h;
+}
+
+bool SameState(const ProjectileState& a, const ProjectileState& b)
+{
+    return std::memcmp(a.pos, b.pos, sizeof(a.pos)) == 0 && std::memcmp(a.vel, b.vel, sizeof(a.vel)) == 0 &&
+           a.step == b.step;
+}
+} // namespace
+
+class ProjectileDeterminismTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Projectile Determinism Test ===" << std::endl;
+        bool passed = TestServerClientLockstep();
+        passed = TestGoldenTrajectory() && passed;
+        passed = TestBandwidth() && passed;
+        if (passed) {
+            std::cout << "✅ Projectile determinism test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestServerClientLockstep() {
+        const ProjectileSpawnPacket spawn = MakeSpawn();
+        const uint32_t fuse = CoopNet::Projectile_FuseSteps(spawn.seed);
+
+        // Server: one step per fixed tick, bounce at kBounceStep.
+        std::vector<ProjectileState> server;
+        ProjectileState s = CoopNet::Projectile_Make(spawn.origin, spawn.velocity, 0);
+        ProjectileEventPacket bounce{};
+        server.push_back(s);
+        while (s.step < fuse) {
+            CoopNet::Projectile_Step(s);
+            if (s.step == kBounceStep) {
+                bounce = MakeBounce(s);
+                ApplyBounce(s, bounce);
+            }
+            server.push_back(s);
+        }
+
+        // Client: gets the spawn off the wire, renders at 25-170 fps and
+        // hears about the bounce kCorrectionDelaySteps late.
+        ProjectileSpawnPacket wire{};
+        wire = spawn;
+        ProjectileState c = CoopNet::Projectile_Make(wire.origin, wire.velocity, 0);
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> frameMs(6.f, 40.f);
+        float accumMs = 0.f;
+        bool corrected = false;
+        uint32_t mismatches = 0, compared = 0;
+        while (c.step < fuse) {
+            accumMs += frameMs(rng);
+            while (accumMs >= CoopNet::kProjectileStepMs && c.step < fuse) {
+                CoopNet::Projectile_Step(c);
+                accumMs -= CoopNet::kProjectileStepMs;
+                if (!corrected && c.step == kBounceStep + kCorrectionDelaySteps) {
+                    ProjectileEventPacket late{};
+                    late = bounce;
+                    ApplyBounce(c, late);
+                    corrected = true;
+                }
+                // Before the correction arrives the client is knowingly on
+                // the pre-bounce path; from then on it must be exact.
+                if (c.step < kBounceStep || corrected) {
+                    ++compared;
+                    mismatches += !SameState(c, server[c.step]);
+                }
+            }
+        }
+        if (mismatches != 0 || !corrected) {
+            std::cout << "❌ client diverged from server at " << mismatches << "/" << compared << " steps" << std::endl;
+            return false;
+        }
+        std::cout << "✓ client at jittery frame rate matched the server bit for bit on " << compared
+                  << " steps, including a bounce applied " << kCorrectionDelaySteps << " steps late" << std::endl;
+        return true;
+    }
+
+    bool TestGoldenTrajectory() {
+        const ProjectileSpawnPacket spawn = MakeSpawn();
+        ProjectileState s = CoopNet::Projectile_Make(spawn.origin, spawn.velocity, 0);
+        uint64_t h = Fnv(1469598103934665603ull, s);
+        const uint32_t fuse = CoopNet::Projectile_FuseSteps(spawn.seed);
+        while (s.step < fuse) {
+            CoopNet::Projectile_Step(s);
+            h = Fnv(h, s);
+        }
+        const RED4ext::Vector3 end = CoopNet::Projectile_Position(s);
+        std::cout << "  trajectory hash 0x" << std::hex << h << std::dec << ", lands at (" << end.X << ", "
+                  << end.Y << ", " << end.Z << ") after " << fuse << " steps" << std::endl;
+        if (h != kGoldenTrajectoryHash) {
+            std::cout << "❌ trajectory differs from the recorded one; integrator is not platform-exact" << std::endl;
+            return false;
+        }
+        // Sanity: near the drag-free ballistic drop over the same time (drag
+        // makes up the difference).
+        const float t = static_cast<float>(fuse) / CoopNet::kProjectileStepsPerSec;
+        const float ideal = spawn.origin.Z + spawn.velocity.Z * t - 0.5f * 9.81f * t * t;
+        if (std::fabs(end.Z - ideal) > 2.f) {
+            std::cout << "❌ integrator drifted from ballistic motion: z " << end.Z << " vs " << ideal << std::endl;
+            return false;
+        }
+        std::cout << "✓ trajectory matches the recorded checksum" << std::endl;
+        return true;
+    }
+
+    bool TestBandwidth() {
+        constexpr size_t kHeader = sizeof(CoopNet::PacketHeader);
+        const uint32_t fuse = CoopNet::Projectile_FuseSteps(MakeSpawn().seed);
+        const float lifeSec = static_cast<float>(fuse) / CoopNet::kProjectileStepsPerSec;
+        const size_t snaps = static_cast<size_t>(std::ceil(lifeSec * 20.f));
+        const size_t oldBytes = sizeof(CoopNet::GrenadePrimePacket) + kHeader +
+                                snaps * (kHeader + sizeof(CoopNet::GrenadeSnapPacket));
+        // Spawn, one bounce, detonation.
+        const size_t newBytes = sizeof(CoopNet::GrenadePrimePacket) + kHeader + (kHeader + sizeof(ProjectileSpawnPacket)) +
+                                2 * (kHeader + sizeof(ProjectileEventPacket));
+        std::cout << "✓ per grenade per viewer over " << lifeSec << " s: 20 Hz snaps " << oldBytes
+                  << " B, spawn+events " << newBytes << " B (" << static_cast<float>(oldBytes) / newBytes << "x less)"
+                  << std::endl;
+        return newBytes * 4 < oldBytes;
+    }
+};
+
+extern "C" int RunProjectileDeterminismTest() {
+    ProjectileDeterminismTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef PROJECTILE_DETERMINISM_TEST_STANDALONE
+int main() {
+    return RunProjectileDeterminismTest();
+}
+#endif
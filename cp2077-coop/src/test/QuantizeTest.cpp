@@ -0,0 +1,192 @@
+// Transform Quantisation Test
+// Property test for the error budget in net/Quantize.hpp: random positions,
+// velocities and rotations (plus hand-picked edge cases such as sector
+// boundaries and ties between quaternion components) must decode within
+// kQuantPosMaxError / kQuantVelMaxError / kQuantRotMaxErrorDeg. Prints the
+// worst case seen for each property and the first counterexample on failure.
+
+#include "../net/Quantize.hpp"
+#include "../net/Snapshot.hpp"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+using CoopNet::kQuantPosMaxCoord;
+using CoopNet::kQuantVelRange;
+
+constexpr uint32_t kSamples = 200000;
+constexpr uint32_t kSeed = 20240611;
+constexpr double kPi = 3.14159265358979323846;
+
+double AxisError(const RED4ext::Vector3& a, const RED4ext::Vector3& b)
+{
+    return std::max({std::fabs(static_cast<double>(a.X) - b.X), std::fabs(static_cast<double>(a.Y) - b.Y),
+                     std::fabs(static_cast<double>(a.Z) - b.Z)});
+}
+
+// Angle of the rotation taking `a` to `b`, in degrees; q and -q are equal.
+double AngleDeg(const RED4ext::Quaternion& a, const RED4ext::Quaternion& b)
+{
+    const double la = std::sqrt(double(a.i) * a.i + double(a.j) * a.j + double(a.k) * a.k + double(a.r) * a.r);
+    const double lb = std::sqrt(double(b.i) * b.i + double(b.j) * b.j + double(b.k) * b.k + double(b.r) * b.r);
+    const double dot = (double(a.i) * b.i + double(a.j) * b.j + double(a.k) * b.k + double(a.r) * b.r) / (la * lb);
+    return 2.0 * std::acos(std::min(1.0, std::fabs(dot))) * 180.0 / kPi;
+}
+
+// Uniformly distributed unit quaternion (Shoemake).
+RED4ext::Quaternion RandomRotation(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double u1 = unit(rng), u2 = unit(rng), u3 = unit(rng);
+    RED4ext::Quaternion q;
+    q.i = static_cast<float>(std::sqrt(1 - u1) * std::sin(2 * kPi * u2));
+    q.j = static_cast<float>(std::sqrt(1 - u1) * std::cos(2 * kPi * u2));
+    q.k = static_cast<float>(std::sqrt(u1) * std::sin(2 * kPi * u3));
+    q.r = static_cast<float>(std::sqrt(u1) * std::cos(2 * kPi * u3));
+    return q;
+}
+
+RED4ext::Quaternion Quat(float i, float j, float k, float r)
+{
+    RED4ext::Quaternion q;
+    q.i = i;
+    q.j = j;
+    q.k = k;
+    q.r = r;
+    return q;
+}
+} // namespace
+
+class QuantizeTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Transform Quantisation Test ===" << std::endl;
+        bool passed = TestPositionBound();
+        passed = TestVelocityBound() && passed;
+        passed = TestRotationBound() && passed;
+        passed = TestWireSize() && passed;
+        if (passed) {
+            std::cout << "✅ Transform quantisation test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestPositionBound() {
+        std::mt19937 rng(kSeed);
+        std::uniform_real_distribution<float> coord(-kQuantPosMaxCoord, kQuantPosMaxCoord);
+        std::vector<RED4ext::Vector3> cases = {
+            {0.f, 0.f, 0.f}, {-0.f, -0.f, -0.f}, {63.9999f, 64.f, 64.0001f}, {-64.f, -63.9996f, -64.0004f},
+            {kQuantPosMaxCoord, -kQuantPosMaxCoord, 8191.9995f}, {0.0005f, -0.0005f, 0.0015f}};
+        for (uint32_t i = 0; i < kSamples; ++i)
+            cases.push_back({coord(rng), coord(rng), coord(rng) * 0.1f});
+
+        double worst = 0.0;
+        for (const auto& p : cases) {
+            CoopNet::QuantCell cell;
+            CoopNet::QuantLocal local;
+            CoopNet::Quant_PackPos(p, cell, local);
+            const RED4ext::Vector3 back = CoopNet::Quant_UnpackPos(cell, local);
+            const double err = AxisError(p, back);
+            worst = std::max(worst, err);
+            if (err > CoopNet::kQuantPosMaxError) {
+                std::cout << "❌ position (" << p.X << ", " << p.Y << ", " << p.Z << ") error " << err * 1000.0
+                          << " mm" << std::endl;
+                return false;
+            }
+        }
+        std::cout << "✓ position: " << cases.size() << " samples, worst " << worst * 1000.0 << " mm (budget "
+                  << CoopNet::kQuantPosMaxError * 1000.0f << " mm)" << std::endl;
+        return true;
+    }
+
+    bool TestVelocityBound() {
+        std::mt19937 rng(kSeed + 1);
+        std::uniform_real_distribution<float> in(-kQuantVelRange, kQuantVelRange);
+        double worst = 0.0;
+        for (uint32_t i = 0; i < kSamples; ++i) {
+            const RED4ext::Vector3 v(in(rng), in(rng), in(rng));
+            const double err = AxisError(v, CoopNet::Quant_UnpackVel(CoopNet::Quant_PackVel(v)));
+            worst = std::max(worst, err);
+            if (err > CoopNet::kQuantVelMaxError) {
+                std::cout << "❌ velocity (" << v.X << ", " << v.Y << ", " << v.Z << ") error " << err << std::endl;
+                return false;
+            }
+        }
+        // Outside the range the value saturates instead of wrapping.
+        const RED4ext::Vector3 fast(1000.f, -1000.f, 0.f);
+        const RED4ext::Vector3 clamped = CoopNet::Quant_UnpackVel(CoopNet::Quant_PackVel(fast));
+        if (std::fabs(clamped.X - kQuantVelRange) > CoopNet::kQuantVelMaxError ||
+            std::fabs(clamped.Y + kQuantVelRange) > CoopNet::kQuantVelMaxError) {
+            std::cout << "❌ out-of-range velocity did not saturate" << std::endl;
+            return false;
+        }
+        std::cout << "✓ velocity: " << kSamples << " samples, worst " << worst * 1000.0 << " mm/s (budget "
+                  << CoopNet::kQuantVelMaxError * 1000.0f << " mm/s)" << std::endl;
+        return true;
+    }
+
+    bool TestRotationBound() {
+        std::mt19937 rng(kSeed + 2);
+        const float h = 0.70710678f;
+        std::vector<RED4ext::Quaternion> cases = {
+            Quat(0, 0, 0, 1), Quat(0, 0, 0, -1), Quat(1, 0, 0, 0), Quat(h, h, 0, 0), Quat(0, -h, 0, h),
+            Quat(0.5f, 0.5f, 0.5f, 0.5f), Quat(-0.5f, 0.5f, -0.5f, 0.5f), Quat(0, 0, 2.f, 2.f) /* unnormalised */};
+        if (AngleDeg(Quat(0, 0, 0, 1), CoopNet::Quant_UnpackRot(CoopNet::Quant_PackRot(Quat(0, 0, 0, 0)))) >
+            CoopNet::kQuantRotMaxErrorDeg) {
+            std::cout << "❌ zero quaternion did not decode as identity" << std::endl;
+            return false;
+        }
+        for (uint32_t i = 0; i < kSamples; ++i)
+            cases.push_back(RandomRotation(rng));
+
+        double worst = 0.0;
+        for (const auto& q : cases) {
+            const uint32_t packed = CoopNet::Quant_PackRot(q);
+            const double err = AngleDeg(q, CoopNet::Quant_UnpackRot(packed));
+            worst = std::max(worst, err);
+            if (err > CoopNet::kQuantRotMaxErrorDeg) {
+                std::cout << "❌ rotation (" << q.i << ", " << q.j << ", " << q.k << ", " << q.r << ") error " << err
+                          << " deg" << std::endl;
+                return false;
+            }
+            RED4ext::Quaternion neg = Quat(-q.i, -q.j, -q.k, -q.r);
+            if (CoopNet::Quant_PackRot(neg) != packed && AngleDeg(q, CoopNet::Quant_UnpackRot(CoopNet::Quant_PackRot(neg))) >
+                                                              CoopNet::kQuantRotMaxErrorDeg) {
+                std::cout << "❌ q and -q decode to different rotations" << std::endl;
+                return false;
+            }
+        }
+        std::cout << "✓ rotation: " << cases.size() << " samples, worst " << worst << " deg (budget "
+                  << CoopNet::kQuantRotMaxErrorDeg << " deg, " << 2 + 3 * CoopNet::kQuantRotBits << " bits)"
+                  << std::endl;
+        return true;
+    }
+
+    bool TestWireSize() {
+        const size_t raw = sizeof(RED4ext::Vector3) * 2 + sizeof(RED4ext::Quaternion);
+        const size_t quant = sizeof(CoopNet::QuantLocal) + sizeof(CoopNet::QuantVel) + sizeof(uint32_t);
+        std::cout << "✓ pos+vel+rot: " << raw << " -> " << quant << " bytes (+" << sizeof(CoopNet::QuantCell)
+                  << " when the sector changes); TransformSnap " << sizeof(CoopNet::TransformSnap) << " -> "
+                  << sizeof(CoopNet::TransformQuant) << " bytes" << std::endl;
+        if (quant * 2 > raw) {
+            std::cout << "❌ quantised transform is not at least half the size" << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+extern "C" int RunQuantizeTests() {
+    QuantizeTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef QUANTIZE_TEST_STANDALONE
+int main() {
+    return RunQuantizeTests();
+}
+#endif
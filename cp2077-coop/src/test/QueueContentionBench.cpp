@@ -0,0 +1,134 @@
+// Queue Contention Benchmark
+// Pushes the same stream of items through ThreadSafeQueue (mutex + condition
+// variable), MpscRing and, with a single producer, SpscRing. One consumer
+// drains with DrainTo, as WebDash and the tick loop do. Runs at 1, 4 and 16
+// producers, reports items/sec and checks that every item arrives exactly
+// once and in order per producer.
+
+#include "../core/MpscRing.hpp"
+#include "../core/SpscRing.hpp"
+#include "../core/ThreadSafeQueue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kItemsTotal = 400000;
+constexpr size_t kRingSize = 1024;
+
+struct Item
+{
+    uint32_t producer = 0;
+    uint32_t seq = 0;
+};
+
+struct Result
+{
+    double itemsPerSec = 0.0;
+    bool ordered = true;
+};
+
+template <typename Q>
+Result Run(Q& queue, uint32_t producers)
+{
+    const uint32_t perProducer = kItemsTotal / producers;
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back(
+            [&, p]
+            {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                for (uint32_t i = 0; i < perProducer; ++i)
+                    queue.Push(Item{p, i}); // rings yield while full
+            });
+    }
+    while (ready.load() != producers)
+        std::this_thread::yield();
+
+    std::vector<uint32_t> next(producers, 0);
+    std::vector<Item> batch;
+    batch.reserve(kRingSize);
+    Result r;
+    uint64_t received = 0;
+    const uint64_t expected = uint64_t(perProducer) * producers;
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    while (received < expected)
+    {
+        batch.clear();
+        if (queue.DrainTo(batch) == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        for (const Item& it : batch)
+        {
+            if (it.producer >= producers || it.seq != next[it.producer])
+                r.ordered = false;
+            else
+                ++next[it.producer];
+        }
+        received += batch.size();
+    }
+    const double sec = std::chrono::duration<double>(Clock::now() - start).count();
+    for (auto& t : threads)
+        t.join();
+    r.itemsPerSec = static_cast<double>(received) / sec;
+    r.ordered = r.ordered && queue.Empty();
+    return r;
+}
+} // namespace
+
+class QueueContentionBenchSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Queue Contention Benchmark ===" << std::endl;
+        bool passed = true;
+        for (uint32_t producers : {1u, 4u, 16u}) {
+            CoopNet::ThreadSafeQueue<Item> locked;
+            const Result a = Run(locked, producers);
+            auto* mpsc = new CoopNet::MpscRing<Item, kRingSize>();
+            const Result b = Run(*mpsc, producers);
+            delete mpsc;
+            std::cout << "  " << producers << " producer(s): ThreadSafeQueue " << static_cast<uint64_t>(a.itemsPerSec)
+                      << " items/s, MpscRing " << static_cast<uint64_t>(b.itemsPerSec) << " items/s";
+            passed = passed && a.ordered && b.ordered;
+            if (producers == 1) {
+                auto* spsc = new CoopNet::SpscRing<Item, kRingSize>();
+                const Result c = Run(*spsc, producers);
+                delete spsc;
+                std::cout << ", SpscRing " << static_cast<uint64_t>(c.itemsPerSec) << " items/s";
+                passed = passed && c.ordered;
+            }
+            std::cout << std::endl;
+        }
+        if (!passed) {
+            std::cout << "❌ an item was lost, duplicated or reordered" << std::endl;
+            return false;
+        }
+        std::cout << "✅ Queue contention benchmark PASSED" << std::endl;
+        return true;
+    }
+};
+
+extern "C" int RunQueueContentionBench() {
+    QueueContentionBenchSuite suite;
+    return suite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef QUEUE_CONTENTION_BENCH_STANDALONE
+int main() {
+    return RunQueueContentionBench();
+}
+#endif
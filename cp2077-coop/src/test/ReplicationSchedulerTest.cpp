@@ -0,0 +1,219 @@
+// Replication Scheduler Test
+// Drives one client's ReplicationScheduler through a crowded firefight: 31
+// other players, 48 NPCs in combat and a steady stream of grenades, all
+// changing every tick at 30 Hz for 60 s. Demand is several times the client
+// budget, so the test checks that what goes out stays inside the per-client
+// budget (BandwidthManager's 256 kbps default), that nearby players still
+// update at a useful rate, and that even the farthest NPC in another phase is
+// never starved.
+
+#include "../net/Packets.hpp"
+#include "../net/ReplicationScheduler.hpp"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+using CoopNet::ReplicationClass;
+
+constexpr uint32_t kTickHz = 30;
+constexpr uint32_t kTicks = 60 * kTickHz;
+constexpr uint32_t kPlayers = 31;
+constexpr uint32_t kNpcs = 48;
+constexpr uint32_t kGrenadeSlots = 12;
+constexpr uint32_t kViewerPhase = 1;
+constexpr uint64_t kTargetBytesPerSec = 256 * 1000 / 8; // BandwidthManager::clientReplicationBudget
+constexpr float kMaxStarveSec = 3.f;     // longest any entity may wait for an update
+constexpr float kMinNearPlayerHz = 10.f; // players inside kReplicationNearDistance
+
+constexpr size_t kHeader = sizeof(CoopNet::PacketHeader);
+constexpr size_t kPlayerBytes = kHeader + 28; // typical quantised delta incl. entity prefix
+constexpr size_t kNpcBytes = kHeader + sizeof(CoopNet::NpcSnapshotPacket);
+constexpr size_t kGrenadeBytes = kHeader + sizeof(CoopNet::GrenadeSnapPacket);
+
+struct SimEntity
+{
+    ReplicationClass cls;
+    uint32_t id;
+    RED4ext::Vector3 pos;
+    uint32_t phaseId;
+    uint16_t bytes;
+    uint32_t lastSentTick = 0;
+    uint32_t longestGap = 0;
+    uint32_t sends = 0;
+};
+
+float Distance(const RED4ext::Vector3& a, const RED4ext::Vector3& b)
+{
+    const float dx = a.X - b.X, dy = a.Y - b.Y, dz = a.Z - b.Z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+} // namespace
+
+class ReplicationSchedulerTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Replication Scheduler Test ===" << std::endl;
+        bool passed = TestPriorityOrder();
+        passed = TestCarryForward() && passed;
+        passed = TestFirefightBudget() && passed;
+        if (passed) {
+            std::cout << "✅ Replication scheduler test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    // With room for one update, the near player beats the far NPC.
+    bool TestPriorityOrder() {
+        CoopNet::ReplicationScheduler sched;
+        const RED4ext::Vector3 viewer(0.f, 0.f, 0.f);
+        sched.Mark(ReplicationClass::Npc, 7, RED4ext::Vector3(200.f, 0.f, 0.f), 0, 40);
+        sched.Mark(ReplicationClass::Player, 2, RED4ext::Vector3(5.f, 0.f, 0.f), 0, 40);
+        std::vector<uint32_t> sent;
+        sched.Flush(viewer, kViewerPhase, 1.f / kTickHz, 40, [&](ReplicationClass, uint32_t id) -> size_t {
+            sent.push_back(id);
+            return 40;
+        });
+        if (sent.size() != 1 || sent[0] != 2 || sched.GetPending() != 1) {
+            std::cout << "❌ near player was not sent ahead of the far NPC" << std::endl;
+            return false;
+        }
+        std::cout << "✓ priority order: near player first, far NPC carried over" << std::endl;
+        return true;
+    }
+
+    // A low-weight entity that keeps losing eventually outranks a fresh
+    // high-weight one, and a send callback reporting 0 drops the entry.
+    bool TestCarryForward() {
+        CoopNet::ReplicationScheduler sched;
+        const RED4ext::Vector3 viewer(0.f, 0.f, 0.f);
+        const float dt = 1.f / kTickHz;
+        sched.Mark(ReplicationClass::Npc, 9, RED4ext::Vector3(500.f, 0.f, 0.f), 2, 40);
+        uint32_t tick = 0;
+        bool npcSent = false;
+        for (; tick < 10 * kTickHz && !npcSent; ++tick) {
+            sched.Mark(ReplicationClass::Player, 3, RED4ext::Vector3(1.f, 0.f, 0.f), 0, 40);
+            sched.Flush(viewer, kViewerPhase, dt, 40, [&](ReplicationClass cls, uint32_t) -> size_t {
+                npcSent = npcSent || cls == ReplicationClass::Npc;
+                return 40;
+            });
+        }
+        if (!npcSent) {
+            std::cout << "❌ far NPC starved behind a player updating every tick" << std::endl;
+            return false;
+        }
+        sched.Flush(viewer, kViewerPhase, dt, 1000, [](ReplicationClass, uint32_t) -> size_t { return 0; });
+        if (sched.GetPending() != 0) {
+            std::cout << "❌ vanished entity was kept in the queue" << std::endl;
+            return false;
+        }
+        std::cout << "✓ carry-forward: far NPC in another phase sent after " << tick << " ticks" << std::endl;
+        return true;
+    }
+
+    bool TestFirefightBudget() {
+        const uint64_t perSec = kTargetBytesPerSec;
+        const float dt = 1.f / kTickHz;
+        const size_t budget = static_cast<size_t>(static_cast<float>(perSec) * dt);
+
+        std::mt19937 rng(424242);
+        std::uniform_real_distribution<float> spread(-60.f, 60.f);
+        std::uniform_real_distribution<float> step(-0.25f, 0.25f);
+        std::vector<SimEntity> ents;
+        for (uint32_t i = 0; i < kPlayers; ++i) {
+            // The first few fight right next to the viewer.
+            const RED4ext::Vector3 pos = i < 4 ? RED4ext::Vector3(2.f + i, 1.f, 0.f)
+                                               : RED4ext::Vector3(spread(rng), spread(rng), 0.f);
+            ents.push_back({ReplicationClass::Player, 100 + i, pos, 0, static_cast<uint16_t>(kPlayerBytes)});
+        }
+        for (uint32_t i = 0; i < kNpcs; ++i) {
+            // A quarter of the NPCs fight in someone else's phase, far away.
+            const bool other = i % 4 == 0;
+            const RED4ext::Vector3 pos = other ? RED4ext::Vector3(400.f + i, 300.f, 0.f)
+                                               : RED4ext::Vector3(spread(rng), spread(rng), 0.f);
+            ents.push_back({ReplicationClass::Npc, 1000 + i, pos, other ? 2u : 0u, static_cast<uint16_t>(kNpcBytes)});
+        }
+        for (uint32_t i = 0; i < kGrenadeSlots; ++i)
+            ents.push_back({ReplicationClass::Projectile, 5000 + i, RED4ext::Vector3(spread(rng), spread(rng), 2.f), 0,
+                            static_cast<uint16_t>(kGrenadeBytes)});
+
+        CoopNet::ReplicationScheduler sched;
+        const RED4ext::Vector3 viewer(0.f, 0.f, 0.f);
+        uint64_t demand = 0;
+        uint64_t sentBytes = 0;
+        size_t worstTick = 0;
+        for (uint32_t tick = 1; tick <= kTicks; ++tick) {
+            for (SimEntity& e : ents) {
+                e.pos.X += step(rng);
+                e.pos.Y += step(rng);
+                sched.Mark(e.cls, e.id, e.pos, e.phaseId, e.bytes);
+                demand += e.bytes;
+            }
+            const size_t used = sched.Flush(viewer, kViewerPhase, dt, budget, [&](ReplicationClass cls, uint32_t id) {
+                for (SimEntity& e : ents) {
+                    if (e.cls == cls && e.id == id) {
+                        e.longestGap = std::max(e.longestGap, tick - e.lastSentTick);
+                        e.lastSentTick = tick;
+                        ++e.sends;
+                        return static_cast<size_t>(e.bytes);
+                    }
+                }
+                return size_t(0);
+            });
+            sentBytes += used;
+            worstTick = std::max(worstTick, used);
+        }
+
+        const float seconds = static_cast<float>(kTicks) / kTickHz;
+        const float kbps = sentBytes * 8.f / seconds / 1000.f;
+        const float demandKbps = demand * 8.f / seconds / 1000.f;
+        const float targetKbps = perSec * 8.f / 1000.f;
+        uint32_t starved = 0;
+        float worstGapSec = 0.f;
+        float slowestNearHz = 1e9f;
+        for (const SimEntity& e : ents) {
+            const uint32_t gap = std::max(e.longestGap, kTicks + 1 - e.lastSentTick);
+            worstGapSec = std::max(worstGapSec, static_cast<float>(gap) / kTickHz);
+            if (static_cast<float>(gap) / kTickHz > kMaxStarveSec)
+                ++starved;
+            if (e.cls == ReplicationClass::Player && Distance(e.pos, viewer) < CoopNet::kReplicationNearDistance)
+                slowestNearHz = std::min(slowestNearHz, e.sends / seconds);
+        }
+
+        std::cout << "✓ firefight: " << ents.size() << " entities, demand " << demandKbps << " kbit/s, sent " << kbps
+                  << " kbit/s (target " << targetKbps << "), worst tick " << worstTick << " B of " << budget
+                  << " B budget" << std::endl;
+        std::cout << "  longest wait " << worstGapSec << " s, slowest near player "
+                  << (slowestNearHz > 1e8f ? 0.f : slowestNearHz) << " Hz, max wait "
+                  << sched.GetStats().maxWaitTicks << " ticks" << std::endl;
+
+        // The top candidate may overshoot by one update; nothing else may.
+        if (worstTick > budget + kNpcBytes || kbps > targetKbps) {
+            std::cout << "❌ replication exceeded the per-client budget" << std::endl;
+            return false;
+        }
+        if (starved > 0) {
+            std::cout << "❌ " << starved << " entities waited longer than " << kMaxStarveSec << " s" << std::endl;
+            return false;
+        }
+        if (slowestNearHz < 1e8f && slowestNearHz < kMinNearPlayerHz) {
+            std::cout << "❌ near players updated below " << kMinNearPlayerHz << " Hz" << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+extern "C" int RunReplicationSchedulerTests() {
+    ReplicationSchedulerTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef REPLICATION_SCHEDULER_TEST_STANDALONE
+int main() {
+    return RunReplicationSchedulerTests();
+}
+#endif
@@ -0,0 +1,358 @@
+// Snapshot Delta Test
+// Checks the packed snapshot wire format against the static fixture in
+// tests/static/snapshot_roundtrip.json, then runs a 32-player scene through
+// per-entity delta streams with packet and ack loss and verifies the receiver
+// rebuilds every applied state exactly. Reports bandwidth for full snapshots
+// (the previous Net_BroadcastPlayerUpdate encoding) against quantised deltas.
+
+#include "../net/Snapshot.hpp"
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using CoopNet::SnapshotDecodeResult;
+using CoopNet::TransformSnap;
+
+constexpr uint32_t kPlayers = 32;
+constexpr uint32_t kTicks = 900; // 30 s at 30 Hz
+constexpr uint32_t kTickHz = 30;
+constexpr uint32_t kAckDelayTicks = 3;
+
+// Previous encoding: header + 16-byte mask + every field, every time.
+constexpr size_t kLegacySnapshotBytes = sizeof(uint32_t) + sizeof(CoopNet::SnapshotHeader) +
+                                        sizeof(CoopNet::SnapshotFieldFlags) + sizeof(RED4ext::Vector3) * 2 +
+                                        sizeof(RED4ext::Quaternion) + sizeof(uint16_t) * 2 + sizeof(uint32_t) +
+                                        sizeof(uint16_t);
+
+bool LoadFixture(nlohmann::json& out)
+{
+    const char* paths[] = {"tests/static/snapshot_roundtrip.json", "../tests/static/snapshot_roundtrip.json",
+                           "../../tests/static/snapshot_roundtrip.json", "cp2077-coop/tests/static/snapshot_roundtrip.json"};
+    for (const char* path : paths)
+    {
+        std::ifstream in(path);
+        if (in)
+        {
+            out = nlohmann::json::parse(in, nullptr, false);
+            return !out.is_discarded();
+        }
+    }
+    return false;
+}
+
+std::string ToHex(const uint8_t* data, size_t size)
+{
+    std::string hex;
+    char byte[3];
+    for (size_t i = 0; i < size; ++i)
+    {
+        std::snprintf(byte, sizeof(byte), "%02x", data[i]);
+        hex += byte;
+    }
+    return hex;
+}
+
+// Compares against what the receiver can reconstruct: the quantised value.
+bool SameTransform(const TransformSnap& got, const TransformSnap& sent)
+{
+    const TransformSnap a = got;
+    const TransformSnap b = CoopNet::TransformSnap_Dequantize(CoopNet::TransformSnap_Quantize(sent));
+    return std::memcmp(&a.pos, &b.pos, sizeof(a.pos)) == 0 && std::memcmp(&a.vel, &b.vel, sizeof(a.vel)) == 0 &&
+           std::memcmp(&a.rot, &b.rot, sizeof(a.rot)) == 0 && a.health == b.health && a.armor == b.armor &&
+           a.ownerId == b.ownerId;
+}
+
+bool SameRaw(const TransformSnap& a, const TransformSnap& b)
+{
+    return std::memcmp(&a.pos, &b.pos, sizeof(a.pos)) == 0 && std::memcmp(&a.vel, &b.vel, sizeof(a.vel)) == 0 &&
+           std::memcmp(&a.rot, &b.rot, sizeof(a.rot)) == 0 && a.health == b.health && a.armor == b.armor &&
+           a.ownerId == b.ownerId;
+}
+
+// Typical lobby/combat mix: most players move every tick, some stand still,
+// rotation changes when turning, health/armor change occasionally.
+struct Scene
+{
+    std::mt19937 rng{1234};
+    std::vector<TransformSnap> players;
+    std::vector<bool> moving;
+
+    Scene()
+    {
+        players.resize(kPlayers);
+        moving.resize(kPlayers);
+        for (uint32_t i = 0; i < kPlayers; ++i)
+        {
+            TransformSnap& p = players[i];
+            p.pos = {100.f + i * 3.f, -40.f + i, 12.f};
+            p.rot = {0.f, 0.f, 0.f, 1.f};
+            p.health = 100;
+            p.armor = 50;
+            p.ownerId = i + 1;
+            moving[i] = i % 3 != 0;
+        }
+    }
+
+    void Step()
+    {
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+        for (uint32_t i = 0; i < kPlayers; ++i)
+        {
+            TransformSnap& p = players[i];
+            if (unit(rng) < 0.02f)
+                moving[i] = !moving[i];
+            if (moving[i])
+            {
+                p.vel = {4.f * std::cos(i * 0.3f), 4.f * std::sin(i * 0.3f), 0.f};
+                p.pos.X += p.vel.X / kTickHz;
+                p.pos.Y += p.vel.Y / kTickHz;
+                if (unit(rng) < 0.4f)
+                {
+                    const float yaw = unit(rng) * 6.28f;
+                    p.rot = {0.f, 0.f, std::sin(yaw / 2.f), std::cos(yaw / 2.f)};
+                }
+            }
+            else
+            {
+                p.vel = {0.f, 0.f, 0.f};
+            }
+            if (unit(rng) < 0.01f)
+                p.health = static_cast<uint16_t>(p.health > 10 ? p.health - 7 : 100);
+            if (unit(rng) < 0.005f)
+                p.armor = static_cast<uint16_t>(p.armor > 5 ? p.armor - 5 : 50);
+        }
+    }
+};
+} // namespace
+
+class SnapshotDeltaTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Snapshot Delta Test ===" << std::endl;
+        bool passed = TestFixtureRoundTrip();
+        passed = TestIdleDeltaIsHeaderOnly() && passed;
+        passed = TestLossyStream() && passed;
+        passed = TestArenaEviction() && passed;
+        if (passed) {
+            std::cout << "✅ Snapshot delta test PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestFixtureRoundTrip() {
+        nlohmann::json fx;
+        if (!LoadFixture(fx)) {
+            std::cout << "❌ could not load tests/static/snapshot_roundtrip.json" << std::endl;
+            return false;
+        }
+        CoopNet::SnapshotHeader hdr{fx["header"]["id"].get<uint32_t>(), fx["header"]["baseId"].get<uint32_t>()};
+        CoopNet::SnapshotFieldFlags flags{};
+        for (size_t i = 0; i < 4; ++i)
+            flags.bits[i] = fx["flags"][i].get<uint32_t>();
+        const auto& payload = fx["payload"];
+        TransformSnap want{};
+        want.pos = {payload["pos"][0].get<float>(), payload["pos"][1].get<float>(), payload["pos"][2].get<float>()};
+        want.health = payload["health"].get<uint16_t>();
+        want.seq = payload["seq"].get<uint16_t>();
+
+        CoopNet::SnapshotWriter writer;
+        writer.Begin(hdr);
+        if (flags.bits[0] & (1u << 0))
+            writer.Write(0, want.pos);
+        if (flags.bits[0] & (1u << 3))
+            writer.Write(3, want.health);
+        uint8_t buf[CoopNet::kSnapshotMaxOverhead + sizeof(TransformSnap)];
+        const size_t bytes = writer.End(buf, sizeof(buf));
+        const std::string hex = ToHex(buf, bytes);
+        if (hex != fx["bytes_hex"].get<std::string>()) {
+            std::cout << "❌ fixture bytes differ: " << hex << std::endl;
+            return false;
+        }
+
+        CoopNet::SnapshotReader reader;
+        if (!reader.Attach(buf, bytes) || std::memcmp(&reader.GetFlags(), &flags, sizeof(flags)) != 0) {
+            std::cout << "❌ fixture mask did not round-trip" << std::endl;
+            return false;
+        }
+        TransformSnap got{};
+        got.pos = reader.ReadOr(0, got.pos);
+        got.health = reader.ReadOr(3, got.health);
+        if (!reader.Ok() || !SameRaw(got, want) || reader.GetId() != hdr.id ||
+            reader.GetBaseId() != hdr.baseId) {
+            std::cout << "❌ fixture payload did not round-trip" << std::endl;
+            return false;
+        }
+        bool truncatedOk = reader.Attach(buf, sizeof(CoopNet::SnapshotHeader));
+        if (reader.Attach(buf, bytes - 1)) {
+            reader.Read<RED4ext::Vector3>();
+            reader.Read<uint16_t>();
+            truncatedOk = truncatedOk || reader.Ok();
+        }
+        if (truncatedOk) {
+            std::cout << "❌ truncated snapshot accepted" << std::endl;
+            return false;
+        }
+        std::cout << "✓ fixture: " << bytes << " bytes (was " << bytes + sizeof(flags) - 2
+                  << " with the 16-byte mask)" << std::endl;
+        return true;
+    }
+
+    bool TestIdleDeltaIsHeaderOnly() {
+        CoopNet::SnapshotDeltaEncoder enc;
+        CoopNet::SnapshotDeltaDecoder dec;
+        TransformSnap snap{};
+        snap.pos = {1.f, 2.f, 3.f};
+        snap.health = 100;
+        snap.ownerId = 7;
+        uint8_t buf[CoopNet::SnapshotDeltaEncoder::kMaxMessage];
+        uint32_t entity = 0;
+        TransformSnap out{};
+        size_t full = enc.Encode(7, snap, buf, sizeof(buf));
+        if (dec.Decode(buf, full, entity, out) != SnapshotDecodeResult::Applied || !SameTransform(out, snap)) {
+            std::cout << "❌ full snapshot failed to decode" << std::endl;
+            return false;
+        }
+        CoopNet::SnapshotAckEntry ack{};
+        if (dec.TakeAcks(&ack, 1) != 1 || !enc.OnAck(ack.entityId, ack.snapshotId)) {
+            std::cout << "❌ ack not produced or not accepted" << std::endl;
+            return false;
+        }
+        const size_t idle = enc.Encode(7, snap, buf, sizeof(buf));
+        const size_t minimal = sizeof(uint32_t) + sizeof(CoopNet::SnapshotHeader) + 1;
+        if (idle != minimal || dec.Decode(buf, idle, entity, out) != SnapshotDecodeResult::Applied ||
+            !SameTransform(out, snap)) {
+            std::cout << "❌ unchanged transform encoded to " << idle << " bytes" << std::endl;
+            return false;
+        }
+        std::cout << "✓ full " << full << " bytes, unchanged delta " << idle << " bytes" << std::endl;
+        return true;
+    }
+
+    bool TestLossyStream() {
+        Scene scene;
+        CoopNet::SnapshotDeltaEncoder enc;
+        CoopNet::SnapshotDeltaDecoder dec;
+        std::mt19937 loss(99);
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+        std::deque<std::vector<CoopNet::SnapshotAckEntry>> ackPipe(kAckDelayTicks);
+
+        uint64_t deltaBytes = 0;
+        uint64_t sent = 0;
+        uint64_t applied = 0;
+        uint64_t missing = 0;
+        uint8_t buf[CoopNet::SnapshotDeltaEncoder::kMaxMessage];
+        for (uint32_t tick = 0; tick < kTicks; ++tick) {
+            scene.Step();
+            for (uint32_t i = 0; i < kPlayers; ++i) {
+                const size_t bytes = enc.Encode(i + 1, scene.players[i], buf, sizeof(buf));
+                if (bytes == 0) {
+                    std::cout << "❌ encode failed" << std::endl;
+                    return false;
+                }
+                deltaBytes += bytes;
+                ++sent;
+                if (unit(loss) < 0.1f)
+                    continue; // dropped on the unreliable snapshot channel
+                uint32_t entity = 0;
+                TransformSnap out{};
+                switch (dec.Decode(buf, bytes, entity, out)) {
+                case SnapshotDecodeResult::Applied:
+                    ++applied;
+                    if (entity != i + 1 || !SameTransform(out, scene.players[i])) {
+                        std::cout << "❌ tick " << tick << " entity " << entity << " rebuilt wrong state" << std::endl;
+                        return false;
+                    }
+                    break;
+                case SnapshotDecodeResult::MissingBaseline:
+                    ++missing;
+                    break;
+                default:
+                    std::cout << "❌ tick " << tick << " snapshot rejected" << std::endl;
+                    return false;
+                }
+            }
+
+            // One ack message per tick, delayed and occasionally lost.
+            std::vector<CoopNet::SnapshotAckEntry> acks(kPlayers);
+            acks.resize(dec.TakeAcks(acks.data(), acks.size()));
+            if (unit(loss) < 0.1f)
+                acks.clear();
+            ackPipe.push_back(std::move(acks));
+            for (const auto& a : ackPipe.front())
+                enc.OnAck(a.entityId, a.snapshotId);
+            ackPipe.pop_front();
+        }
+
+        const uint64_t legacyBytes = sent * kLegacySnapshotBytes;
+        const double seconds = static_cast<double>(kTicks) / kTickHz;
+        const double legacyKbps = legacyBytes * 8.0 / seconds / 1000.0;
+        const double deltaKbps = deltaBytes * 8.0 / seconds / 1000.0;
+        std::cout << "✓ " << kPlayers << " players @ " << kTickHz << " Hz, 10% loss: " << applied << "/" << sent
+                  << " applied, " << missing << " waiting on baseline, " << enc.GetDeltaCount() << " deltas / "
+                  << enc.GetFullCount() << " full" << std::endl;
+        std::cout << "✓ per client: full " << legacyKbps << " kbit/s (" << kLegacySnapshotBytes
+                  << " B/snap), delta " << deltaKbps << " kbit/s ("
+                  << static_cast<double>(deltaBytes) / sent << " B/snap); 32 clients: "
+                  << legacyKbps * kPlayers / 1000.0 << " -> " << deltaKbps * kPlayers / 1000.0 << " Mbit/s"
+                  << std::endl;
+        if (missing != 0) {
+            std::cout << "❌ receiver lost a baseline the sender still used" << std::endl;
+            return false;
+        }
+        if (deltaBytes * 2 > legacyBytes) {
+            std::cout << "❌ delta encoding saved less than half the bandwidth" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool TestArenaEviction() {
+        const size_t before = CoopNet::SnapshotBaselineArena::TotalBytes();
+        {
+            CoopNet::SnapshotBaselineArena arena(64);
+            if (CoopNet::SnapshotBaselineArena::TotalBytes() != before + arena.Bytes()) {
+                std::cout << "❌ arena footprint not accounted" << std::endl;
+                return false;
+            }
+            CoopNet::TransformQuant q{};
+            for (CoopNet::SnapshotId id = 1; id <= 200; ++id) {
+                q.health = static_cast<uint16_t>(id);
+                arena.Store(id, id % 4, q);
+            }
+            const CoopNet::TransformQuant* newest = arena.Find(200, 0);
+            if (!newest || newest->health != 200 || arena.Find(200, 1) || arena.Find(136, 0) ||
+                !arena.Find(137, 1) || arena.Occupied() != 64 || arena.Evictions() != 200 - 64) {
+                std::cout << "❌ arena lookup/eviction wrong" << std::endl;
+                return false;
+            }
+        }
+        if (CoopNet::SnapshotBaselineArena::TotalBytes() != before) {
+            std::cout << "❌ arena footprint not released" << std::endl;
+            return false;
+        }
+        std::cout << "✓ arena evicts oldest, " << CoopNet::kSnapshotArenaCapacity << " slots = "
+                  << CoopNet::SnapshotDeltaEncoder().GetArena().Bytes() / 1024 << " KiB per peer and direction"
+                  << std::endl;
+        return true;
+    }
+};
+
+extern "C" int RunSnapshotDeltaTests() {
+    SnapshotDeltaTestSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef SNAPSHOT_DELTA_TEST_STANDALONE
+int main() {
+    return RunSnapshotDeltaTests();
+}
+#endif
@@ -0,0 +1,356 @@
+// Spatial Grid Benchmark
+// Replaces the Python quadtree mirror (tests/test_spatial_grid.py). Scatters
+// NPCs over a Night City sized area (several km, well outside the old
+// +/-512 m quadtree root), checks circle and AABB queries against brute force
+// and batched queries against single ones, then times per-tick moves and the
+// interest queries of 64 players against the previous quadtree.
+
+#include "../core/SpatialGrid.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+using CoopNet::SpatialGrid;
+using RED4ext::Vector3;
+
+constexpr uint32_t kEntities = 5000;
+constexpr uint32_t kViewers = 64;
+constexpr float kWorldHalf = 3000.f; // metres
+constexpr float kRadius = 80.f;      // NPC interest radius
+constexpr uint32_t kTicks = 200;
+
+// The previous quadtree: fixed -512..512 root, max depth 6, unique_ptr
+// nodes, linear find on removal.
+struct LegacyQuadtree
+{
+    struct Node
+    {
+        Vector3 min{};
+        Vector3 max{};
+        std::vector<uint32_t> ids;
+        std::unique_ptr<Node> child[4];
+    };
+
+    std::unique_ptr<Node> root = std::make_unique<Node>();
+
+    LegacyQuadtree()
+    {
+        root->min = {-512.f, -512.f, -100.f};
+        root->max = {512.f, 512.f, 100.f};
+    }
+
+    static bool Inside(const Node& n, const Vector3& p)
+    {
+        return p.X >= n.min.X && p.X <= n.max.X && p.Y >= n.min.Y && p.Y <= n.max.Y;
+    }
+
+    void Insert(Node* n, uint32_t id, const Vector3& p, uint32_t depth)
+    {
+        if (depth >= 6 || (!n->child[0] && n->ids.size() < 32))
+        {
+            n->ids.push_back(id);
+            return;
+        }
+        if (!n->child[0])
+        {
+            const float hx = (n->max.X - n->min.X) * 0.5f, hy = (n->max.Y - n->min.Y) * 0.5f;
+            for (int i = 0; i < 4; ++i)
+            {
+                n->child[i] = std::make_unique<Node>();
+                n->child[i]->min = {n->min.X + ((i % 2) ? hx : 0.f), n->min.Y + ((i < 2) ? 0.f : hy), n->min.Z};
+                n->child[i]->max = {n->child[i]->min.X + hx, n->child[i]->min.Y + hy, n->max.Z};
+            }
+        }
+        for (auto& c : n->child)
+        {
+            if (Inside(*c, p))
+            {
+                Insert(c.get(), id, p, depth + 1);
+                return;
+            }
+        }
+        n->ids.push_back(id);
+    }
+
+    bool Remove(Node* n, uint32_t id, const Vector3& p)
+    {
+        auto it = std::find(n->ids.begin(), n->ids.end(), id);
+        if (it != n->ids.end())
+        {
+            n->ids.erase(it);
+            return true;
+        }
+        for (auto& c : n->child)
+        {
+            if (c && Inside(*c, p) && Remove(c.get(), id, p))
+                return true;
+        }
+        return false;
+    }
+
+    void Query(const Node* n, const Vector3& c, float r, std::vector<uint32_t>& out) const
+    {
+        const float x = std::clamp(c.X, n->min.X, n->max.X), y = std::clamp(c.Y, n->min.Y, n->max.Y);
+        if ((c.X - x) * (c.X - x) + (c.Y - y) * (c.Y - y) > r * r)
+            return;
+        out.insert(out.end(), n->ids.begin(), n->ids.end());
+        for (auto& ch : n->child)
+        {
+            if (ch)
+                Query(ch.get(), c, r, out);
+        }
+    }
+};
+
+std::vector<uint32_t> BruteCircle(const std::vector<Vector3>& pos, const Vector3& c, float r)
+{
+    std::vector<uint32_t> out;
+    for (uint32_t i = 0; i < pos.size(); ++i)
+    {
+        const float dx = pos[i].X - c.X, dy = pos[i].Y - c.Y;
+        if (dx * dx + dy * dy <= r * r)
+            out.push_back(i);
+    }
+    return out;
+}
+
+std::vector<uint32_t> BruteBox(const std::vector<Vector3>& pos, const Vector3& mn, const Vector3& mx)
+{
+    std::vector<uint32_t> out;
+    for (uint32_t i = 0; i < pos.size(); ++i)
+    {
+        if (pos[i].X >= mn.X && pos[i].X <= mx.X && pos[i].Y >= mn.Y && pos[i].Y <= mx.Y)
+            out.push_back(i);
+    }
+    return out;
+}
+
+bool SameSet(std::vector<uint32_t> a, std::vector<uint32_t> b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+} // namespace
+
+class SpatialGridBenchSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Spatial Grid Benchmark ===" << std::endl;
+        Scatter();
+        bool passed = TestQueriesMatchBruteForce();
+        passed = TestBatchMatchesSingle() && passed;
+        passed = TestMoveAndRemove() && passed;
+        passed = BenchTick() && passed;
+        if (passed) {
+            std::cout << "✅ Spatial grid benchmark PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    std::mt19937 m_rng{0};
+    std::vector<Vector3> m_pos;
+    std::vector<Vector3> m_viewers;
+
+    void Scatter() {
+        std::uniform_real_distribution<float> d(-kWorldHalf, kWorldHalf);
+        m_pos.resize(kEntities);
+        for (auto& p : m_pos)
+            p = {d(m_rng), d(m_rng), 0.f};
+        // Viewers play in squads of four next to random NPCs, so queries are
+        // not empty and squad mates share cells.
+        for (uint32_t i = 0; i < kViewers; ++i) {
+            const Vector3& anchor = m_pos[((i / 4) * 7919u) % kEntities];
+            m_viewers.push_back({anchor.X + 3.f * (i % 4), anchor.Y, 0.f});
+        }
+    }
+
+    bool TestQueriesMatchBruteForce() {
+        SpatialGrid grid;
+        for (uint32_t i = 0; i < kEntities; ++i)
+            grid.Insert(i, m_pos[i]);
+        std::uniform_real_distribution<float> d(-kWorldHalf, kWorldHalf);
+        std::uniform_real_distribution<float> r(10.f, 400.f);
+        std::vector<uint32_t> ids;
+        for (int q = 0; q < 200; ++q) {
+            const Vector3 c{d(m_rng), d(m_rng), 0.f};
+            const float radius = r(m_rng);
+            grid.QueryCircle(c, radius, ids);
+            if (!SameSet(ids, BruteCircle(m_pos, c, radius))) {
+                std::cout << "❌ circle query mismatch at (" << c.X << ", " << c.Y << ")" << std::endl;
+                return false;
+            }
+            const Vector3 mn{c.X - radius, c.Y - radius * 0.5f, 0.f}, mx{c.X + radius * 0.5f, c.Y + radius, 0.f};
+            grid.QueryAABB(mn, mx, ids);
+            if (!SameSet(ids, BruteBox(m_pos, mn, mx))) {
+                std::cout << "❌ AABB query mismatch" << std::endl;
+                return false;
+            }
+        }
+        // A radius covering the whole world takes the occupied-cell path.
+        grid.QueryCircle({0.f, 0.f, 0.f}, 10.f * kWorldHalf, ids);
+        if (ids.size() != kEntities) {
+            std::cout << "❌ world-sized query returned " << ids.size() << std::endl;
+            return false;
+        }
+        std::cout << "✓ circle and AABB queries match brute force over " << 2 * kWorldHalf << " m ("
+                  << grid.GetCellCount() << " cells)" << std::endl;
+        return true;
+    }
+
+    bool TestBatchMatchesSingle() {
+        SpatialGrid grid;
+        for (uint32_t i = 0; i < kEntities; ++i)
+            grid.Insert(i, m_pos[i]);
+        std::vector<uint32_t> ids, offsets, single;
+        grid.QueryCircles(m_viewers.data(), m_viewers.size(), kRadius, ids, offsets);
+        if (offsets.size() != kViewers + 1 || offsets.back() != ids.size())
+            return false;
+        for (uint32_t v = 0; v < kViewers; ++v) {
+            grid.QueryCircle(m_viewers[v], kRadius, single);
+            if (!SameSet({ids.begin() + offsets[v], ids.begin() + offsets[v + 1]}, single)) {
+                std::cout << "❌ batched circle result differs for viewer " << v << std::endl;
+                return false;
+            }
+        }
+        std::vector<Vector3> mins, maxs;
+        for (const auto& c : m_viewers) {
+            mins.push_back({c.X - kRadius, c.Y - kRadius, 0.f});
+            maxs.push_back({c.X + kRadius, c.Y + kRadius, 0.f});
+        }
+        grid.QueryAABBs(mins.data(), maxs.data(), kViewers, ids, offsets);
+        for (uint32_t v = 0; v < kViewers; ++v) {
+            grid.QueryAABB(mins[v], maxs[v], single);
+            if (!SameSet({ids.begin() + offsets[v], ids.begin() + offsets[v + 1]}, single)) {
+                std::cout << "❌ batched AABB result differs for viewer " << v << std::endl;
+                return false;
+            }
+        }
+        std::cout << "✓ batched circle and AABB queries match single queries" << std::endl;
+        return true;
+    }
+
+    bool TestMoveAndRemove() {
+        SpatialGrid grid;
+        std::vector<Vector3> pos = m_pos;
+        for (uint32_t i = 0; i < kEntities; ++i)
+            grid.Insert(i, pos[i]);
+        std::uniform_real_distribution<float> d(-kWorldHalf, kWorldHalf);
+        for (uint32_t i = 0; i < kEntities; i += 2) {
+            pos[i] = {d(m_rng), d(m_rng), 0.f};
+            grid.Move(i, pos[i]);
+        }
+        for (uint32_t i = 1; i < kEntities; i += 3)
+            grid.Remove(i);
+        std::vector<uint32_t> ids;
+        grid.QueryCircle({0.f, 0.f, 0.f}, 10.f * kWorldHalf, ids);
+        std::vector<uint32_t> expect;
+        for (uint32_t i = 0; i < kEntities; ++i) {
+            if (i % 3 != 1)
+                expect.push_back(i);
+        }
+        bool ok = SameSet(ids, expect) && grid.GetSize() == expect.size() && !grid.Contains(1);
+        for (int q = 0; ok && q < 50; ++q) {
+            const Vector3 c{d(m_rng), d(m_rng), 0.f};
+            grid.QueryCircle(c, 250.f, ids);
+            auto brute = BruteCircle(pos, c, 250.f);
+            brute.erase(std::remove_if(brute.begin(), brute.end(), [](uint32_t i) { return i % 3 == 1; }),
+                        brute.end());
+            ok = SameSet(ids, brute);
+        }
+        if (!ok) {
+            std::cout << "❌ move/remove left the grid inconsistent" << std::endl;
+            return false;
+        }
+        std::cout << "✓ move and remove keep the id -> cell map consistent" << std::endl;
+        return true;
+    }
+
+    // Per tick: every NPC walks a little, then every viewer queries its
+    // interest radius.
+    bool BenchTick() {
+        SpatialGrid grid;
+        LegacyQuadtree legacy;
+        std::vector<Vector3> gridPos = m_pos, legacyPos = m_pos;
+        for (uint32_t i = 0; i < kEntities; ++i) {
+            grid.Insert(i, gridPos[i]);
+            legacy.Insert(legacy.root.get(), i, legacyPos[i], 0);
+        }
+        std::vector<Vector3> steps(kEntities);
+        std::uniform_real_distribution<float> s(-0.5f, 0.5f);
+        for (auto& st : steps)
+            st = {s(m_rng), s(m_rng), 0.f};
+
+        size_t legacyHits = 0, gridHits = 0, batchHits = 0;
+        std::vector<uint32_t> ids, offsets;
+        using Clock = std::chrono::steady_clock;
+        Clock::duration legacyMove{}, legacyQuery{}, gridMove{}, gridQuery{}, batchQuery{};
+        for (uint32_t t = 0; t < kTicks; ++t) {
+            auto t0 = Clock::now();
+            for (uint32_t i = 0; i < kEntities; ++i) {
+                legacy.Remove(legacy.root.get(), i, legacyPos[i]);
+                legacyPos[i].X += steps[i].X;
+                legacyPos[i].Y += steps[i].Y;
+                legacy.Insert(legacy.root.get(), i, legacyPos[i], 0);
+            }
+            auto t1 = Clock::now();
+            for (const auto& v : m_viewers) {
+                ids.clear();
+                legacy.Query(legacy.root.get(), v, kRadius, ids);
+                for (uint32_t id : ids) {
+                    const float dx = legacyPos[id].X - v.X, dy = legacyPos[id].Y - v.Y;
+                    legacyHits += dx * dx + dy * dy <= kRadius * kRadius;
+                }
+            }
+            auto t2 = Clock::now();
+            for (uint32_t i = 0; i < kEntities; ++i) {
+                gridPos[i].X += steps[i].X;
+                gridPos[i].Y += steps[i].Y;
+                grid.Move(i, gridPos[i]);
+            }
+            auto t3 = Clock::now();
+            for (const auto& v : m_viewers) {
+                grid.QueryCircle(v, kRadius, ids);
+                gridHits += ids.size();
+            }
+            auto t4 = Clock::now();
+            grid.QueryCircles(m_viewers.data(), m_viewers.size(), kRadius, ids, offsets);
+            batchHits += ids.size();
+            auto t5 = Clock::now();
+            legacyMove += t1 - t0;
+            legacyQuery += t2 - t1;
+            gridMove += t3 - t2;
+            gridQuery += t4 - t3;
+            batchQuery += t5 - t4;
+        }
+
+        auto us = [](Clock::duration d) { return std::chrono::duration<double, std::micro>(d).count() / kTicks; };
+        std::cout << "✓ " << kEntities << " NPCs, " << kViewers << " viewers, per tick:" << std::endl;
+        std::cout << "    quadtree: move " << us(legacyMove) << " us, query " << us(legacyQuery) << " us ("
+                  << legacyHits / kTicks << " hits; viewers outside +/-512 m miss the root)" << std::endl;
+        std::cout << "    hashed grid: move " << us(gridMove) << " us, query " << us(gridQuery) << " us, batched "
+                  << us(batchQuery) << " us (" << gridHits / kTicks << " exact hits)" << std::endl;
+        if (gridHits != batchHits) {
+            std::cout << "❌ batched and single queries disagree during the benchmark" << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+extern "C" int RunSpatialGridBench() {
+    SpatialGridBenchSuite suite;
+    return suite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef SPATIAL_GRID_BENCH_STANDALONE
+int main() {
+    return RunSpatialGridBench();
+}
+#endif
@@ -0,0 +1,141 @@
+// Startup Graph Test
+// Builds a start-up shaped like the dedicated server's: a config step, a
+// network step behind it, slow content loads that depend on nothing and a
+// step pinned to the caller thread. Checks that dependencies are honoured,
+// that independent loads overlap, that the network step can be awaited
+// before the content is done, and that the timeline and Chrome trace cover
+// every step.
+
+#include "../core/StartupGraph.hpp"
+#include "../core/TaskGraph.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+void SleepMs(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+} // namespace
+
+class StartupGraphTestSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Startup Graph Test ===" << std::endl;
+        bool passed = true;
+        passed = TestParallelStartup() && passed;
+        passed = TestInline() && passed;
+        if (passed)
+            std::cout << "✅ Startup graph test PASSED" << std::endl;
+        return passed;
+    }
+
+private:
+    bool Fail(const char* what) {
+        std::cout << "❌ " << what << std::endl;
+        return false;
+    }
+
+    bool TestParallelStartup() {
+        using Graph = CoopNet::StartupGraph;
+        CoopNet::TaskGraph tasks;
+        tasks.Start(4);
+        Graph startup;
+        std::atomic<int> configDone{0};
+        std::atomic<bool> orderOk{true};
+        const auto config = startup.Add("config", [&] { SleepMs(5); configDone = 1; });
+        const auto net = startup.Add("net", [&] { orderOk = orderOk && configDone == 1; SleepMs(5); }, {config});
+        const auto questA = startup.Add("quests-a", [] { SleepMs(60); });
+        const auto questB = startup.Add("quests-b", [] { SleepMs(60); });
+        std::thread::id pinnedThread;
+        const auto plugins = startup.Add("plugins", [&] { pinnedThread = std::this_thread::get_id(); }, {config},
+                                         Graph::Affinity::Caller);
+        const auto afterPlugins = startup.Add("after-plugins", [] {}, {plugins, questA});
+        startup.Launch(&tasks);
+
+        startup.Wait(net);
+        if (!orderOk)
+            return Fail("net ran before config finished");
+        if (startup.IsDone(questA) && startup.IsDone(questB))
+            return Fail("waiting for net also waited for the content loads");
+
+        while (!startup.RunCallerSteps())
+            SleepMs(1);
+        startup.WaitAll();
+        tasks.Stop();
+
+        if (!startup.AllDone() || !startup.IsDone(afterPlugins))
+            return Fail("steps left after WaitAll");
+        if (pinnedThread != std::this_thread::get_id())
+            return Fail("pinned step ran on a worker");
+
+        const auto timings = startup.GetTimings();
+        const Graph::StepTiming* a = nullptr;
+        const Graph::StepTiming* b = nullptr;
+        const Graph::StepTiming* after = nullptr;
+        for (const auto& t : timings) {
+            if (t.name == "quests-a") a = &t;
+            if (t.name == "quests-b") b = &t;
+            if (t.name == "after-plugins") after = &t;
+        }
+        if (timings.size() != 6 || !a || !b || !after)
+            return Fail("timings do not cover every step");
+        if (!after->pinned || after->thread != 0 || after->startNs < a->endNs)
+            return Fail("a step behind a pinned one did not run after its dependencies on the caller thread");
+        if (a->startNs >= b->endNs || b->startNs >= a->endNs)
+            return Fail("independent loads did not overlap");
+        if (startup.GetWallNs() >= startup.GetSerialNs())
+            return Fail("start-up took as long as running every step in turn");
+
+        std::cout << startup.Timeline();
+
+        const std::string path = "startup_trace_test.json";
+        if (!startup.WriteChromeTrace(path))
+            return Fail("could not write the Chrome trace");
+        std::ifstream in(path);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        in.close();
+        std::remove(path.c_str());
+        const std::string json = ss.str();
+        if (json.find("\"traceEvents\"") == std::string::npos || json.find("\"quests-b\"") == std::string::npos ||
+            json.find("\"ph\":\"X\"") == std::string::npos)
+            return Fail("Chrome trace is missing events");
+        std::cout << "  parallel start-up: wall " << startup.GetWallNs() / 1000000 << " ms, work "
+                  << startup.GetSerialNs() / 1000000 << " ms" << std::endl;
+        return true;
+    }
+
+    bool TestInline() {
+        // Without workers every step runs during Launch, in the order added.
+        CoopNet::StartupGraph startup;
+        std::string order;
+        startup.Add("a", [&] { order += 'a'; });
+        const auto b = startup.Add("b", [&] { order += 'b'; });
+        startup.Add("c", [&] { order += 'c'; }, {b}, CoopNet::StartupGraph::Affinity::Caller);
+        startup.Launch(nullptr);
+        if (order != "ab")
+            return Fail("inline launch ran pinned steps or the wrong order");
+        startup.WaitAll();
+        if (order != "abc" || !startup.AllDone())
+            return Fail("inline WaitAll did not finish the pinned step");
+        return true;
+    }
+};
+
+extern "C" int RunStartupGraphTest() {
+    StartupGraphTestSuite suite;
+    return suite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef STARTUP_GRAPH_TEST_STANDALONE
+int main() {
+    return RunStartupGraphTest();
+}
+#endif
@@ -20,6 +20,7 @@ public:
         allPassed &= TestConfigurationSystem();
         allPassed &= TestEventSystem();
         allPassed &= TestSystemHealthMonitoring();
+        allPassed &= TestParallelUpdate();
         allPassed &= TestGracefulShutdown();
 
         std::cout << std::endl << "=== Test Results ===" << std::endl;
@@ -303,6 +304,54 @@ private:
         }
     }
 
+    static bool TestParallelUpdate() {
+        std::cout << "\n[TEST] Parallel Update..." << std::endl;
+
+        try {
+            auto& core = CoopNetCore::Instance();
+            core.Initialize();
+            auto& systemManager = SystemManager::Instance();
+            const uint64_t firstFrame = systemManager.GetLastUpdateProfile().frame;
+
+            for (int i = 0; i < 10; ++i) {
+                core.Update();
+            }
+
+            const UpdateFrameProfile profile = systemManager.GetLastUpdateProfile();
+            if (profile.frame != firstFrame + 10 || profile.criticalPath.empty()) {
+                std::cout << "FAILED: No update profile recorded" << std::endl;
+                core.Shutdown();
+                return false;
+            }
+
+            // Every system depends on ErrorManager, so any chain starts there
+            if (profile.criticalPath.front() != SystemType::ErrorManager) {
+                std::cout << "FAILED: Critical path does not start at ErrorManager" << std::endl;
+                core.Shutdown();
+                return false;
+            }
+
+            // A chain can never take longer than running everything in sequence
+            if (profile.criticalPathTime > profile.serialTime) {
+                std::cout << "FAILED: Critical path longer than serial time" << std::endl;
+                core.Shutdown();
+                return false;
+            }
+
+            std::cout << "Critical path: " << profile.criticalPathTime.count() << "us of "
+                      << profile.serialTime.count() << "us serial, " << profile.wallTime.count() << "us wall"
+                      << std::endl;
+            core.Shutdown();
+
+            std::cout << "PASSED: Parallel update profiled" << std::endl;
+            return true;
+
+        } catch (const std::exception& ex) {
+            std::cout << "FAILED: Exception during parallel update test: " << ex.what() << std::endl;
+            return false;
+        }
+    }
+
     static bool TestGracefulShutdown() {
         std::cout << "\n[TEST] Graceful Shutdown..." << std::endl;
 
@@ -0,0 +1,445 @@
+// Task Graph Benchmark
+// Checks the work-stealing TaskGraph: dependencies and continuations run in
+// order, ParallelFor visits every index exactly once (from outside the graph
+// and nested inside a task), Wait works without workers, Resize and Stop lose
+// no tasks, and oversized callables fall back to the heap. Then compares it
+// with the previous scheduler (one mutex-guarded std::function queue polled
+// with a 1 ms sleep) on task throughput, fork-join depth, ParallelFor,
+// wake-up latency after idling and CPU burnt while idle.
+
+#include "../core/TaskGraph.hpp"
+#include "../core/ThreadSafeQueue.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using CoopNet::TaskGraph;
+using CoopNet::TaskHandle;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kWorkers = 3;
+constexpr uint32_t kThroughputTasks = 100000;
+constexpr int kForkDepth = 14;
+constexpr size_t kSumCount = 1 << 22;
+constexpr int kWakeSamples = 50;
+
+double MsSince(Clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// The scheduler TaskGraph used before work stealing, kept for comparison.
+class LegacyTaskGraph
+{
+public:
+    ~LegacyTaskGraph() { Stop(); }
+
+    void Start(size_t workers)
+    {
+        m_running = true;
+        for (size_t i = 0; i < workers; ++i)
+            m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+
+    void Stop()
+    {
+        m_running = false;
+        for (auto& t : m_workers)
+            if (t.joinable())
+                t.join();
+        m_workers.clear();
+    }
+
+    void Submit(const std::function<void()>& task) { m_tasks.Push(task); }
+
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body)
+    {
+        struct Job
+        {
+            std::function<void(size_t, size_t)> body;
+            size_t count, grain, chunks;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+        };
+        auto job = std::make_shared<Job>();
+        job->body = body;
+        job->count = count;
+        job->grain = grain;
+        job->chunks = (count + grain - 1) / grain;
+        auto drain = [](Job& j) {
+            for (;;)
+            {
+                const size_t c = j.next.fetch_add(1);
+                if (c >= j.chunks)
+                    return;
+                j.body(c * j.grain, (std::min)(c * j.grain + j.grain, j.count));
+                j.done.fetch_add(1);
+            }
+        };
+        const size_t helpers = (std::min)(job->chunks - 1, m_workers.size());
+        for (size_t i = 0; i < helpers; ++i)
+            Submit([job, drain] { drain(*job); });
+        drain(*job);
+        while (job->done.load() < job->chunks)
+            std::this_thread::yield();
+    }
+
+private:
+    void WorkerLoop()
+    {
+        while (m_running)
+        {
+            std::function<void()> task;
+            if (m_tasks.Pop(task))
+                task();
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    CoopNet::ThreadSafeQueue<std::function<void()>> m_tasks;
+    std::vector<std::jthread> m_workers;
+    std::atomic<bool> m_running{false};
+};
+
+void SpinUntil(const std::atomic<uint32_t>& counter, uint32_t target)
+{
+    while (counter.load(std::memory_order_acquire) < target)
+        std::this_thread::yield();
+}
+
+void ForkNew(TaskGraph& graph, int depth, std::atomic<uint32_t>& leaves)
+{
+    if (depth == 0)
+    {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TaskHandle left = graph.Submit([&graph, depth, &leaves] { ForkNew(graph, depth - 1, leaves); });
+    ForkNew(graph, depth - 1, leaves);
+    graph.Wait(left);
+}
+
+// The old graph cannot await a task, so its only fork-join primitive is a
+// two-chunk ParallelFor.
+void ForkLegacy(LegacyTaskGraph& graph, int depth, std::atomic<uint32_t>& leaves)
+{
+    if (depth == 0)
+    {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    graph.ParallelFor(2, 1, [&graph, depth, &leaves](size_t, size_t) { ForkLegacy(graph, depth - 1, leaves); });
+}
+
+double CpuMs()
+{
+    return 1000.0 * static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+} // namespace
+
+class TaskGraphBenchSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Task Graph Benchmark ===" << std::endl;
+        bool passed = TestDependencies();
+        passed = TestParallelForCoverage() && passed;
+        passed = TestWaitWithoutWorkers() && passed;
+        passed = TestResizeAndStop() && passed;
+        passed = TestLargeCallable() && passed;
+        passed = BenchThroughput() && passed;
+        passed = BenchForkJoin() && passed;
+        passed = BenchParallelFor() && passed;
+        passed = BenchIdle() && passed;
+        if (passed) {
+            std::cout << "✅ Task graph benchmark PASSED" << std::endl;
+        }
+        return passed;
+    }
+
+private:
+    bool TestDependencies() {
+        TaskGraph graph;
+        graph.Start(kWorkers);
+        bool ok = true;
+        for (int round = 0; round < 200 && ok; ++round) {
+            std::atomic<uint32_t> clock{0};
+            std::array<uint32_t, 5> at{};
+            auto stamp = [&clock, &at](size_t i) { return [&clock, &at, i] { at[i] = ++clock; }; };
+            TaskHandle a = graph.Submit(stamp(0));
+            TaskHandle b = graph.Then(a, stamp(1));
+            TaskHandle c = graph.Then(a, stamp(2));
+            TaskHandle d = graph.Submit(stamp(3), {b, c});
+            TaskHandle e = graph.Then(d, stamp(4)); // d may already be done
+            graph.Wait(e);
+            ok = a.IsDone() && d.IsDone() && at[0] < at[1] && at[0] < at[2] && at[1] < at[3] && at[2] < at[3] &&
+                 at[3] < at[4];
+        }
+        graph.Stop();
+        if (!ok) {
+            std::cout << "❌ a task ran before one of its dependencies" << std::endl;
+            return false;
+        }
+        std::cout << "✓ diamond dependencies and continuations ran in order (200 rounds)" << std::endl;
+        return true;
+    }
+
+    bool TestParallelForCoverage() {
+        TaskGraph graph;
+        graph.Start(kWorkers);
+        bool ok = true;
+        for (size_t count : {size_t{1}, size_t{7}, size_t{1000}, size_t{100003}}) {
+            for (size_t grain : {size_t{1}, size_t{16}, size_t{4096}}) {
+                ok = ok && Covers(graph, count, grain);
+                // Nested: the same loop issued from inside a task.
+                bool nested = false;
+                graph.Wait(graph.Submit([&] { nested = Covers(graph, count, grain); }));
+                ok = ok && nested;
+            }
+        }
+        graph.Stop();
+        if (!ok) {
+            std::cout << "❌ ParallelFor missed or repeated an index" << std::endl;
+            return false;
+        }
+        std::cout << "✓ ParallelFor visits each index once, from outside and inside the graph" << std::endl;
+        return true;
+    }
+
+    static bool Covers(TaskGraph& graph, size_t count, size_t grain) {
+        std::vector<std::atomic<uint8_t>> hits(count);
+        std::atomic<bool> oversized{false};
+        graph.ParallelFor(count, grain, [&](size_t b, size_t e) {
+            if (e - b > grain)
+                oversized = true;
+            for (size_t i = b; i < e; ++i)
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        return !oversized && std::all_of(hits.begin(), hits.end(), [](const auto& h) { return h.load() == 1; });
+    }
+
+    bool TestWaitWithoutWorkers() {
+        TaskGraph graph; // never started
+        int ran = 0;
+        TaskHandle first = graph.Submit([&] { ++ran; });
+        TaskHandle second = graph.Then(first, [&] { ran *= 10; });
+        graph.Wait(second);
+        graph.ParallelFor(100, 10, [&](size_t b, size_t e) { ran += static_cast<int>(e - b); });
+        if (ran != 110) {
+            std::cout << "❌ Wait/ParallelFor without workers did not run inline" << std::endl;
+            return false;
+        }
+        std::cout << "✓ Wait and ParallelFor run inline on a graph without workers" << std::endl;
+        return true;
+    }
+
+    bool TestResizeAndStop() {
+        TaskGraph graph;
+        graph.Start(2);
+        std::atomic<uint32_t> counter{0};
+        constexpr uint32_t kTasks = 20000;
+        for (uint32_t i = 0; i < kTasks; ++i) {
+            graph.Submit([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+            if (i == kTasks / 4)
+                graph.Resize(6);
+            if (i == kTasks / 2)
+                graph.Resize(1);
+        }
+        const size_t workers = graph.GetWorkerCount();
+        graph.Stop(); // runs whatever is still queued
+        if (counter.load() != kTasks || workers != 1) {
+            std::cout << "❌ Resize/Stop lost tasks: " << counter.load() << "/" << kTasks << std::endl;
+            return false;
+        }
+        std::cout << "✓ growing, shrinking and stopping mid-stream ran all " << kTasks << " tasks" << std::endl;
+        return true;
+    }
+
+    bool TestLargeCallable() {
+        TaskGraph graph;
+        graph.Start(kWorkers);
+        std::array<uint64_t, 32> big{};
+        std::iota(big.begin(), big.end(), 1);
+        uint64_t sum = 0;
+        graph.Wait(graph.Submit([big, &sum] { sum = std::accumulate(big.begin(), big.end(), uint64_t{0}); }));
+        graph.Stop();
+        if (sum != 528) {
+            std::cout << "❌ oversized callable lost its captures" << std::endl;
+            return false;
+        }
+        std::cout << "✓ callables over " << CoopNet::detail::kTaskInlineBytes << " bytes fall back to the heap"
+                  << std::endl;
+        return true;
+    }
+
+    bool BenchThroughput() {
+        std::atomic<uint32_t> counter{0};
+        auto work = [&counter] { counter.fetch_add(1, std::memory_order_relaxed); };
+
+        LegacyTaskGraph legacy;
+        legacy.Start(kWorkers);
+        auto t0 = Clock::now();
+        for (uint32_t i = 0; i < kThroughputTasks; ++i)
+            legacy.Submit(work);
+        SpinUntil(counter, kThroughputTasks);
+        const double legacyMs = MsSince(t0);
+        legacy.Stop();
+
+        TaskGraph graph;
+        graph.Start(kWorkers);
+        double externalMs = 0;
+        for (int pass = 0; pass < 2; ++pass) { // the first pass fills the node pool
+            counter = 0;
+            t0 = Clock::now();
+            for (uint32_t i = 0; i < kThroughputTasks; ++i)
+                graph.Submit(work);
+            SpinUntil(counter, kThroughputTasks);
+            externalMs = MsSince(t0);
+        }
+
+        // Submitted from a worker: straight onto its deque, stolen by the rest.
+        counter = 0;
+        t0 = Clock::now();
+        graph.Submit([&] {
+            for (uint32_t i = 0; i < kThroughputTasks; ++i)
+                graph.Submit(work);
+        });
+        SpinUntil(counter, kThroughputTasks);
+        const double internalMs = MsSince(t0);
+        graph.Stop();
+
+        std::cout << "✓ " << kThroughputTasks << " tasks on " << kWorkers << " workers: legacy " << legacyMs
+                  << " ms, stealing (outside submit) " << externalMs << " ms, stealing (worker submit) "
+                  << internalMs << " ms" << std::endl;
+        return true;
+    }
+
+    bool BenchForkJoin() {
+        const uint32_t expected = 1u << kForkDepth;
+        std::atomic<uint32_t> leaves{0};
+
+        LegacyTaskGraph legacy;
+        legacy.Start(kWorkers);
+        auto t0 = Clock::now();
+        ForkLegacy(legacy, kForkDepth, leaves);
+        const double legacyMs = MsSince(t0);
+        legacy.Stop();
+        const bool legacyOk = leaves.load() == expected;
+
+        leaves = 0;
+        TaskGraph graph;
+        graph.Start(kWorkers);
+        t0 = Clock::now();
+        graph.Wait(graph.Submit([&] { ForkNew(graph, kForkDepth, leaves); }));
+        const double newMs = MsSince(t0);
+        graph.Stop();
+
+        if (!legacyOk || leaves.load() != expected) {
+            std::cout << "❌ fork-join tree lost leaves" << std::endl;
+            return false;
+        }
+        std::cout << "✓ fork-join tree of depth " << kForkDepth << " (" << expected << " leaves): legacy " << legacyMs
+                  << " ms, stealing " << newMs << " ms" << std::endl;
+        return true;
+    }
+
+    bool BenchParallelFor() {
+        std::vector<float> data(kSumCount);
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<float>(i & 1023);
+        std::vector<double> partial((kSumCount + 4095) / 4096);
+        auto body = [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; i += 4096)
+                partial[i / 4096] = std::accumulate(data.begin() + i, data.begin() + (std::min)(i + 4096, e), 0.0);
+        };
+        const double expected = std::accumulate(data.begin(), data.end(), 0.0);
+
+        LegacyTaskGraph legacy;
+        legacy.Start(kWorkers);
+        auto t0 = Clock::now();
+        for (int r = 0; r < 20; ++r)
+            legacy.ParallelFor(kSumCount, 4096, body);
+        const double legacyMs = MsSince(t0) / 20;
+        legacy.Stop();
+        const bool legacyOk = std::accumulate(partial.begin(), partial.end(), 0.0) == expected;
+
+        std::fill(partial.begin(), partial.end(), 0.0);
+        TaskGraph graph;
+        graph.Start(kWorkers);
+        t0 = Clock::now();
+        for (int r = 0; r < 20; ++r)
+            graph.ParallelFor(kSumCount, 4096, body);
+        const double newMs = MsSince(t0) / 20;
+        graph.Stop();
+
+        if (!legacyOk || std::accumulate(partial.begin(), partial.end(), 0.0) != expected) {
+            std::cout << "❌ ParallelFor sum is wrong" << std::endl;
+            return false;
+        }
+        std::cout << "✓ ParallelFor over " << kSumCount << " floats (grain 4096): legacy " << legacyMs
+                  << " ms, stealing " << newMs << " ms" << std::endl;
+        return true;
+    }
+
+    bool BenchIdle() {
+        auto wakeLatency = [](auto& graph) {
+            double total = 0;
+            for (int i = 0; i < kWakeSamples; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(3)); // let the workers go idle
+                std::atomic<uint32_t> ran{0};
+                const auto t0 = Clock::now();
+                Clock::time_point started;
+                graph.Submit([&] {
+                    started = Clock::now();
+                    ran.store(1, std::memory_order_release);
+                });
+                SpinUntil(ran, 1);
+                total += std::chrono::duration<double, std::micro>(started - t0).count();
+            }
+            return total / kWakeSamples;
+        };
+        auto idleCpu = [] {
+            const double c0 = CpuMs();
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            return CpuMs() - c0;
+        };
+
+        LegacyTaskGraph legacy;
+        legacy.Start(kWorkers);
+        const double legacyWakeUs = wakeLatency(legacy);
+        const double legacyCpu = idleCpu();
+        legacy.Stop();
+
+        TaskGraph graph;
+        graph.Start(kWorkers);
+        const double newWakeUs = wakeLatency(graph);
+        const double newCpu = idleCpu();
+        graph.Stop();
+
+        std::cout << "✓ after idling: wake latency legacy " << legacyWakeUs << " us, parked " << newWakeUs
+                  << " us; CPU over 300 ms idle legacy " << legacyCpu << " ms, parked " << newCpu << " ms"
+                  << std::endl;
+        return true;
+    }
+};
+
+extern "C" int RunTaskGraphBench() {
+    TaskGraphBenchSuite testSuite;
+    return testSuite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef TASK_GRAPH_BENCH_STANDALONE
+int main() {
+    return RunTaskGraphBench();
+}
+#endif
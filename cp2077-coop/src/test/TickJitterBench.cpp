@@ -0,0 +1,303 @@
+// Tick Jitter Benchmark
+// Drives a 64 Hz server tick against a loopback ENet client flooding sealed
+// packets, once with the legacy single-thread loop (tick, Net_Poll(5), sleep 1),
+// once with a dedicated I/O thread handing decrypted packets to the tick over
+// an SPSC ring, and once single-threaded on TickScheduler (timerfd + socket in
+// one epoll set). Prints a tick-interval jitter histogram for each, and checks
+// that the scheduler makes up an overrun tick for tick and drops after a
+// long stall.
+
+#include "../core/LatencyHistogram.hpp"
+#include "../core/SpscRing.hpp"
+#include "../core/TickScheduler.hpp"
+#include "../net/PacketCrypto.hpp"
+#include <enet/enet.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sodium.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kTickRate = 64;
+constexpr uint32_t kRunTicks = 256;
+constexpr uint32_t kClientPeers = 8;
+constexpr uint32_t kPayloadBytes = 192;
+constexpr auto kSendPeriod = std::chrono::microseconds(500); // per peer
+
+std::array<uint8_t, crypto_secretbox_KEYBYTES> g_key{};
+
+struct Inbound
+{
+    std::vector<uint8_t> data;
+};
+
+struct Server
+{
+    ENetHost* host = nullptr;
+    uint64_t received = 0;
+};
+
+// Mirrors Net.cpp HandleReceive: open the sealed payload into a fresh buffer.
+bool OpenPacket(const ENetPacket* packet, Inbound& out)
+{
+    if (packet->dataLength < CoopNet::kSealOverhead)
+        return false;
+    uint32_t nonce;
+    std::memcpy(&nonce, packet->data, 4);
+    unsigned char nbuf[crypto_secretbox_NONCEBYTES] = {0};
+    std::memcpy(nbuf, &nonce, 4);
+    out.data.resize(packet->dataLength - CoopNet::kSealOverhead);
+    return crypto_secretbox_open_easy(out.data.data(), packet->data + 4, packet->dataLength - 4, nbuf,
+                                      g_key.data()) == 0;
+}
+
+// Stand-in for ProcessServerTick: a fixed slice of CPU work.
+void SimulateTick()
+{
+    volatile uint64_t acc = 0;
+    auto until = Clock::now() + std::chrono::microseconds(1500);
+    while (Clock::now() < until)
+        acc = acc + 1;
+}
+
+void ClientFlood(uint16_t port, std::atomic<bool>& stop)
+{
+    ENetHost* client = enet_host_create(nullptr, kClientPeers, 1, 0, 0);
+    ENetAddress addr{};
+    enet_address_set_host(&addr, "127.0.0.1");
+    addr.port = port;
+    std::vector<ENetPeer*> peers;
+    for (uint32_t i = 0; i < kClientPeers; ++i)
+        peers.push_back(enet_host_connect(client, &addr, 1, 0));
+
+    std::vector<uint8_t> plain(kPayloadBytes, 0x5a);
+    uint32_t nonce = 0;
+    auto next = Clock::now();
+    while (!stop.load())
+    {
+        ENetEvent evt;
+        while (enet_host_service(client, &evt, 0) > 0)
+        {
+            if (evt.type == ENET_EVENT_TYPE_RECEIVE)
+                enet_packet_destroy(evt.packet);
+        }
+        for (ENetPeer* p : peers)
+        {
+            if (p->state != ENET_PEER_STATE_CONNECTED)
+                continue;
+            ENetPacket* pkt = enet_packet_create(nullptr, CoopNet::PacketCrypto_SealedSize(plain.size()), 0);
+            CoopNet::PacketCrypto_SealInto(pkt->data, nonce++, plain.data(), plain.size(), g_key.data());
+            enet_peer_send(p, 0, pkt);
+        }
+        enet_host_flush(client);
+        next += kSendPeriod;
+        std::this_thread::sleep_until(next);
+    }
+    for (ENetPeer* p : peers)
+        enet_peer_disconnect_now(p, 0);
+    enet_host_destroy(client);
+}
+
+void RecordInterval(CoopNet::LatencyHistogram& hist, Clock::time_point& last, float intervalMs)
+{
+    auto now = Clock::now();
+    if (last != Clock::time_point{})
+        hist.Record(std::chrono::duration<float, std::milli>(now - last).count() - intervalMs);
+    last = now;
+}
+
+// Old DedicatedServer::ServerLoop shape.
+void RunLegacy(Server& srv, CoopNet::LatencyHistogram& hist)
+{
+    const uint64_t intervalMs = 1000 / kTickRate;
+    uint64_t lastTick = 0;
+    uint32_t ticks = 0;
+    Clock::time_point last{};
+    while (ticks < kRunTicks)
+    {
+        uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+        if (now - lastTick >= intervalMs)
+        {
+            RecordInterval(hist, last, static_cast<float>(intervalMs));
+            SimulateTick();
+            lastTick = now;
+            ++ticks;
+        }
+        ENetEvent evt;
+        if (enet_host_service(srv.host, &evt, 5) > 0)
+        {
+            do
+            {
+                if (evt.type == ENET_EVENT_TYPE_RECEIVE)
+                {
+                    Inbound in;
+                    if (OpenPacket(evt.packet, in))
+                        ++srv.received;
+                    enet_packet_destroy(evt.packet);
+                }
+            } while (enet_host_service(srv.host, &evt, 0) > 0);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// I/O thread + SPSC handoff + absolute tick deadlines.
+void RunThreaded(Server& srv, CoopNet::LatencyHistogram& hist)
+{
+    CoopNet::SpscRing<Inbound, 4096> ring;
+    std::atomic<bool> ioRunning{true};
+    std::thread io(
+        [&]
+        {
+            while (ioRunning.load())
+            {
+                ENetEvent evt;
+                while (enet_host_service(srv.host, &evt, 0) > 0)
+                {
+                    if (evt.type != ENET_EVENT_TYPE_RECEIVE)
+                        continue;
+                    Inbound in;
+                    if (OpenPacket(evt.packet, in))
+                        ring.TryPush(std::move(in));
+                    enet_packet_destroy(evt.packet);
+                }
+                enet_uint32 cond = ENET_SOCKET_WAIT_RECEIVE;
+                enet_socket_wait(srv.host->socket, &cond, 1);
+            }
+        });
+
+    const auto interval = std::chrono::microseconds(1000000 / kTickRate);
+    const float intervalMs = std::chrono::duration<float, std::milli>(interval).count();
+    auto next = Clock::now();
+    Clock::time_point last{};
+    for (uint32_t ticks = 0; ticks < kRunTicks; ++ticks)
+    {
+        std::this_thread::sleep_until(next);
+        RecordInterval(hist, last, intervalMs);
+        next += interval;
+        Inbound in;
+        while (ring.TryPop(in))
+            ++srv.received;
+        SimulateTick();
+    }
+    ioRunning.store(false);
+    io.join();
+}
+
+// DedicatedMain shape: one thread, woken by the tick timer or the socket.
+void RunScheduled(Server& srv, CoopNet::LatencyHistogram& hist)
+{
+    CoopNet::TickScheduler ticker(1000000000ull / kTickRate);
+    auto service = [&]
+    {
+        ENetEvent evt;
+        while (enet_host_service(srv.host, &evt, 0) > 0)
+        {
+            if (evt.type != ENET_EVENT_TYPE_RECEIVE)
+                continue;
+            Inbound in;
+            if (OpenPacket(evt.packet, in))
+                ++srv.received;
+            enet_packet_destroy(evt.packet);
+        }
+    };
+    const bool watched = ticker.Watch(static_cast<intptr_t>(srv.host->socket), service);
+    const float intervalMs = 1000.f / kTickRate;
+    Clock::time_point last{};
+    for (uint32_t ticks = 0; ticks < kRunTicks; ++ticks)
+    {
+        ticker.WaitNext();
+        RecordInterval(hist, last, intervalMs);
+        if (!watched)
+            service();
+        SimulateTick();
+    }
+    std::cout << "  schedule " << ticker.Summary() << std::endl;
+}
+
+// A tick that runs 3.5 periods long leaves three deadlines overdue: they must
+// come back immediately, one at a time, and then the schedule is on time
+// again. A 20-period stall keeps only maxCatchUp of them.
+bool CheckCatchUp()
+{
+    constexpr uint64_t kPeriodNs = 1000000000ull / kTickRate;
+    const auto period = std::chrono::nanoseconds(kPeriodNs);
+    CoopNet::TickScheduler ticker(kPeriodNs, 4);
+    ticker.WaitNext();
+    ticker.WaitNext();
+    std::this_thread::sleep_for(period * 7 / 2);
+    for (int i = 0; i < 3; ++i)
+        ticker.WaitNext();
+    const uint64_t caughtUp = ticker.GetStats().catchUpTicks;
+    const uint64_t before = CoopNet::TickScheduler::NowNs();
+    ticker.WaitNext(); // back on schedule: this one has to wait
+    const uint64_t waitedNs = CoopNet::TickScheduler::NowNs() - before;
+    std::this_thread::sleep_for(period * 20);
+    const uint64_t index = ticker.WaitNext();
+    const CoopNet::TickSchedulerStats& st = ticker.GetStats();
+    std::cout << "  catch-up: " << caughtUp << " overdue ticks run back to back, next waited "
+              << waitedNs / 1000 << " us; after 20-period stall resumed at tick " << index << ", dropped "
+              << st.droppedTicks << std::endl;
+    return caughtUp == 3 && waitedNs > kPeriodNs / 4 && st.droppedTicks >= 14 && st.droppedTicks <= 16;
+}
+
+template<typename Fn>
+bool RunMode(const char* label, Fn run)
+{
+    ENetAddress bind{};
+    bind.host = ENET_HOST_ANY;
+    bind.port = 0;
+    Server srv;
+    srv.host = enet_host_create(&bind, kClientPeers, 1, 0, 0);
+    if (!srv.host)
+        return false;
+    ENetAddress bound{};
+    enet_socket_get_address(srv.host->socket, &bound);
+
+    std::atomic<bool> stop{false};
+    std::thread client(ClientFlood, bound.port, std::ref(stop));
+    CoopNet::LatencyHistogram hist;
+    run(srv, hist);
+    stop.store(true);
+    client.join();
+    enet_host_destroy(srv.host);
+
+    std::cout << "✓ " << label << ": packets " << srv.received << " | jitter " << hist.Summary() << std::endl;
+    return true;
+}
+} // namespace
+
+extern "C" int RunTickJitterBench() {
+    std::cout << "=== CP2077-Coop Tick Jitter Benchmark ===" << std::endl;
+    if (sodium_init() < 0 || enet_initialize() != 0) {
+        std::cout << "❌ init failed" << std::endl;
+        return 1;
+    }
+    crypto_secretbox_keygen(g_key.data());
+
+    bool ok = RunMode("legacy loop", RunLegacy) && RunMode("I/O thread", RunThreaded) &&
+              RunMode("TickScheduler", RunScheduled);
+    enet_deinitialize();
+    if (!ok) {
+        std::cout << "❌ failed to create loopback host" << std::endl;
+        return 1;
+    }
+    if (!CheckCatchUp()) {
+        std::cout << "❌ TickScheduler did not catch up tick for tick" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#ifdef TICK_JITTER_BENCH_STANDALONE
+int main() {
+    return RunTickJitterBench();
+}
+#endif
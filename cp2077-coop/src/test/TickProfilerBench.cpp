@@ -0,0 +1,227 @@
+// Tick Profiler Benchmark
+// Measures what a COOP_PROFILE_SCOPE costs, enabled and switched off at run
+// time, and fails if an enabled scope takes 50 ns or more (or, where the
+// clock itself is slower than usual, as under some hypervisors, more than
+// two clock reads plus 10 ns). Then records
+// nested scopes on several threads while another thread dumps them, and
+// checks that the summary and the Chrome trace contain every thread and
+// scope with inner scopes inside their parents.
+
+#include "../core/TickProfiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int kScopes = 1000000;
+constexpr int kThreads = 4;
+constexpr double kBudgetNs = 50.0;
+const char* const kThreadNames[kThreads] = {"tick-0", "tick-1", "tick-2", "tick-3"};
+const char* const kScopeNames[] = {"Tick", "Net_Poll", "UpdateGameWorld", "NpcController_ServerTick"};
+
+std::atomic<uint64_t> g_sink{0};
+
+// Best of several rounds so a descheduled round does not decide the result.
+double NsPerScope()
+{
+    double best = 1e9;
+    for (int round = 0; round < 5; ++round)
+    {
+        const auto start = Clock::now();
+        for (int i = 0; i < kScopes; ++i)
+        {
+            COOP_PROFILE_SCOPE("bench");
+            g_sink.fetch_add(1, std::memory_order_relaxed);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kScopes;
+        best = (std::min)(best, ns);
+    }
+    return best;
+}
+
+double NsPerClockRead()
+{
+    double best = 1e9;
+    uint64_t sum = 0;
+    for (int round = 0; round < 5; ++round)
+    {
+        const auto start = Clock::now();
+        for (int i = 0; i < kScopes; ++i)
+            sum += CoopNet::detail::ProfileClock();
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kScopes;
+        best = (std::min)(best, ns);
+    }
+    g_sink.fetch_add(sum & 1, std::memory_order_relaxed);
+    return best;
+}
+
+double NsPerEmptyLoop()
+{
+    double best = 1e9;
+    for (int round = 0; round < 5; ++round)
+    {
+        const auto start = Clock::now();
+        for (int i = 0; i < kScopes; ++i)
+            g_sink.fetch_add(1, std::memory_order_relaxed);
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kScopes;
+        best = (std::min)(best, ns);
+    }
+    return best;
+}
+
+void SimulatedTick()
+{
+    COOP_PROFILE_SCOPE("Tick");
+    {
+        COOP_PROFILE_SCOPE("Net_Poll");
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    {
+        COOP_PROFILE_SCOPE("UpdateGameWorld");
+        COOP_PROFILE_SCOPE("NpcController_ServerTick");
+        std::this_thread::sleep_for(std::chrono::microseconds(300));
+    }
+}
+} // namespace
+
+class TickProfilerBenchSuite {
+public:
+    bool RunAllTests() {
+        std::cout << "=== CP2077-Coop Tick Profiler Benchmark ===" << std::endl;
+#if !COOP_TICK_PROFILER
+        std::cout << "  scopes are compiled out (COOP_TICK_PROFILER=0), nothing to measure" << std::endl;
+        return true;
+#endif
+        bool passed = TestOverhead();
+        passed = TestConcurrentDump() && passed;
+        if (passed)
+            std::cout << "✅ Tick profiler benchmark PASSED" << std::endl;
+        return passed;
+    }
+
+private:
+    bool TestOverhead() {
+        const double base = NsPerEmptyLoop();
+        CoopNet::TickProfiler_SetEnabled(true);
+        const double enabled = NsPerScope() - base;
+        CoopNet::TickProfiler_SetEnabled(false);
+        const double disabled = NsPerScope() - base;
+        CoopNet::TickProfiler_SetEnabled(true);
+        const double clock = NsPerClockRead();
+        std::printf("  scope cost: %.1f ns enabled, %.1f ns switched off (clock read %.1f ns)\n", enabled, disabled,
+                    clock);
+        if (enabled >= (std::max)(kBudgetNs, 2.0 * clock + 10.0)) {
+            std::cout << "❌ an enabled scope costs more than 50 ns" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool TestConcurrentDump() {
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&stop, t] {
+                CoopNet::TickProfiler_SetThreadName(kThreadNames[t]);
+                while (!stop.load())
+                    SimulatedTick();
+            });
+        }
+        // Dump while the threads keep writing.
+        std::string summary;
+        for (int i = 0; i < 5; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(40));
+            summary = CoopNet::TickProfiler_Summary(1.f);
+        }
+        const std::string path = "tick_profile_test.json";
+        const bool written = CoopNet::TickProfiler_WriteChromeTrace(path, 1.f);
+        stop = true;
+        for (auto& t : threads)
+            t.join();
+        std::cout << summary;
+
+        std::ifstream in(path);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        in.close();
+        std::remove(path.c_str());
+        const std::string json = ss.str();
+        if (!written || json.find("\"traceEvents\"") == std::string::npos) {
+            std::cout << "❌ Chrome trace was not written" << std::endl;
+            return false;
+        }
+        for (const char* scope : kScopeNames) {
+            if (json.find("\"" + std::string(scope) + "\"") == std::string::npos ||
+                summary.find(std::string(scope) + " ") == std::string::npos) {
+                std::cout << "❌ trace or summary is missing scope " << scope << std::endl;
+                return false;
+            }
+        }
+        for (const char* thread : kThreadNames) {
+            if (json.find("\"" + std::string(thread) + "\"") == std::string::npos) {
+                std::cout << "❌ trace is missing thread " << thread << std::endl;
+                return false;
+            }
+        }
+        if (!NestingHolds(json)) {
+            std::cout << "❌ an inner scope is not inside its parent" << std::endl;
+            return false;
+        }
+        std::cout << "✓ " << kThreads << " threads recorded while the trace was dumped" << std::endl;
+        return true;
+    }
+
+    // Every NpcController_ServerTick event sits inside an UpdateGameWorld
+    // event of the same thread.
+    static bool NestingHolds(const std::string& json) {
+        struct Ev { std::string name; double ts, dur; unsigned tid; };
+        std::vector<Ev> events;
+        size_t pos = 0;
+        while ((pos = json.find("{\"name\":\"", pos)) != std::string::npos) {
+            Ev e{};
+            const size_t nameEnd = json.find('"', pos + 9);
+            e.name = json.substr(pos + 9, nameEnd - pos - 9);
+            const size_t ts = json.find("\"ts\":", nameEnd);
+            const size_t next = json.find('\n', nameEnd);
+            if (ts != std::string::npos && ts < next &&
+                std::sscanf(json.c_str() + ts, "\"ts\":%lf,\"dur\":%lf,\"pid\":1,\"tid\":%u", &e.ts, &e.dur, &e.tid) == 3)
+                events.push_back(e);
+            pos = nameEnd;
+        }
+        size_t checked = 0;
+        for (const Ev& inner : events) {
+            if (inner.name != "NpcController_ServerTick")
+                continue;
+            const bool inside = std::any_of(events.begin(), events.end(), [&](const Ev& outer) {
+                return outer.name == "UpdateGameWorld" && outer.tid == inner.tid && outer.ts <= inner.ts + 0.01 &&
+                       outer.ts + outer.dur + 0.01 >= inner.ts + inner.dur;
+            });
+            // The window edge can clip a parent; only count whole pairs.
+            if (!inside && inner.ts > 1.0)
+                return false;
+            ++checked;
+        }
+        return checked > 0;
+    }
+};
+
+extern "C" int RunTickProfilerBench() {
+    TickProfilerBenchSuite suite;
+    return suite.RunAllTests() ? 0 : 1;
+}
+
+#ifdef TICK_PROFILER_BENCH_STANDALONE
+int main() {
+    return RunTickProfilerBench();
+}
+#endif